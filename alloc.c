@@ -0,0 +1,127 @@
+// alloc.c — veri bloğu ayırma politikaları ve boş alan özeti
+//
+// Kalıcı bir boş alan listesi tutulmaz: çağıran metadata'dan bir blok haritası
+// kurar (MAX_FILES kayıt, DATA_BLOCKS bayt), politikalar haritayı tek geçişte
+// tarar. Disk küçük olduğundan bu, liste tutarlılığıyla uğraşmaktan ucuzdur.
+#include "alloc.h"
+#include "fserr.h"
+
+#include <string.h>
+
+static AllocPolicy policy = ALLOC_FIRST_FIT;
+static uint32_t    next_fit;        // Son ayırmanın bittiği blok
+
+static const char *policy_names[ALLOC_POLICY_COUNT] = {
+    "first-fit", "best-fit", "next-fit", "size-class"
+};
+
+void alloc_set_policy(AllocPolicy p) {
+    if ((unsigned)p < ALLOC_POLICY_COUNT) policy = p;
+}
+
+AllocPolicy alloc_get_policy(void) {
+    return policy;
+}
+
+const char *alloc_policy_name(AllocPolicy p) {
+    return (unsigned)p < ALLOC_POLICY_COUNT ? policy_names[p] : "unknown";
+}
+
+int alloc_policy_parse(const char *name) {
+    for (int i = 0; name && i < ALLOC_POLICY_COUNT; ++i) {
+        if (strcmp(name, policy_names[i]) == 0) return i;
+    }
+    return FS_ERR_INVALID;
+}
+
+void alloc_reset(void) {
+    next_fit = 0;
+}
+
+// Boy sınıfı: floor(log2(blocks)), son kovada toplanır
+static int size_class(uint32_t blocks) {
+    int c = 0;
+    while (blocks > 1 && c < ALLOC_HIST_BUCKETS - 1) {
+        blocks >>= 1;
+        c++;
+    }
+    return c;
+}
+
+// from'dan itibaren ilk boş alan; *len uzunluğu (0 = kalmadı)
+static uint32_t next_run(const uint8_t *used, uint32_t from, uint32_t *len) {
+    while (from < DATA_BLOCKS && used[from]) from++;
+    uint32_t end = from;
+    while (end < DATA_BLOCKS && !used[end]) end++;
+    *len = end - from;
+    return from;
+}
+
+static int64_t first_fit(const uint8_t *used, uint32_t from, uint32_t to, uint32_t count) {
+    uint32_t len;
+    for (uint32_t b = next_run(used, from, &len); len; b = next_run(used, b + len, &len)) {
+        if (b >= to) break;
+        if (len >= count) return b;
+    }
+    return FS_ERR_NO_SPACE;
+}
+
+int64_t alloc_find(const uint8_t *used, uint32_t count) {
+    if (count == 0 || count > DATA_BLOCKS) return FS_ERR_NO_SPACE;
+    int64_t best = FS_ERR_NO_SPACE;
+    uint32_t best_len = 0, len;
+    int want = size_class(count), best_class = ALLOC_HIST_BUCKETS;
+
+    switch (policy) {
+        case ALLOC_FIRST_FIT:
+            best = first_fit(used, 0, DATA_BLOCKS, count);
+            break;
+        case ALLOC_NEXT_FIT:
+            // İmleçten sona, bulunamazsa baştan imlece; imleç bir alanın
+            // ortasındaysa o alanın kalanı da değerlendirilir
+            best = first_fit(used, next_fit < DATA_BLOCKS ? next_fit : 0, DATA_BLOCKS, count);
+            if (best < 0) best = first_fit(used, 0, next_fit, count);
+            break;
+        case ALLOC_BEST_FIT:
+            for (uint32_t b = next_run(used, 0, &len); len; b = next_run(used, b + len, &len)) {
+                if (len >= count && (best < 0 || len < best_len)) {
+                    best = b;
+                    best_len = len;
+                    if (len == count) break;
+                }
+            }
+            break;
+        case ALLOC_SIZE_CLASS:
+            // En küçük uygun sınıftaki ilk alan: aynı boydaki dosyalar bir
+            // arada kalır, büyük alanlar küçük isteklerle bölünmez
+            for (uint32_t b = next_run(used, 0, &len); len; b = next_run(used, b + len, &len)) {
+                if (len < count) continue;
+                int c = size_class(len);
+                if (c < best_class) {
+                    best = b;
+                    best_class = c;
+                    if (c == want) break;
+                }
+            }
+            break;
+        default:
+            break;
+    }
+    if (best >= 0) next_fit = (uint32_t)best + count;
+    return best;
+}
+
+void alloc_space_stats(const uint8_t *used, SpaceStats *out) {
+    memset(out, 0, sizeof(*out));
+    out->total_blocks = DATA_BLOCKS;
+    uint32_t len;
+    for (uint32_t b = next_run(used, 0, &len); len; b = next_run(used, b + len, &len)) {
+        out->free_blocks += len;
+        out->free_extents++;
+        out->free_hist[size_class(len)]++;
+        if (len > out->largest_free) out->largest_free = len;
+    }
+    out->used_blocks = DATA_BLOCKS - out->free_blocks;
+    out->fragmentation = out->free_blocks
+                         ? 1.0 - (double)out->largest_free / out->free_blocks : 0.0;
+}
@@ -0,0 +1,43 @@
+#ifndef ALLOC_H
+#define ALLOC_H
+
+#include <stdint.h>     // uint8_t, uint32_t, int64_t
+#include "disk.h"       // DATA_BLOCKS
+
+// Veri bloğu ayırma politikaları. Her dosya tek bitişik alanda durur; alan
+// dosya büyürken yerinde uzatılamazsa dosya seçili politikanın bulduğu yeni
+// bir alana taşınır. Politikalar blok haritası üzerinde çalışır (0 = boş).
+typedef enum {
+    ALLOC_FIRST_FIT = 0,    // En düşük adresteki yeterli boş alan
+    ALLOC_BEST_FIT,         // Yeterli boş alanların en küçüğü
+    ALLOC_NEXT_FIT,         // Son ayırmanın bittiği yerden devam eden first-fit
+    ALLOC_SIZE_CLASS,       // Boy sınıfı kovaları: isteğin sınıfındaki ilk alan, yoksa üst sınıflar
+    ALLOC_POLICY_COUNT
+} AllocPolicy;
+
+// Boş alan histogramı: kova k, [2^k, 2^(k+1)) blokluk alanları sayar (son kova ve üstü)
+#define ALLOC_HIST_BUCKETS 12
+
+typedef struct {
+    uint32_t total_blocks;      // Veri bölgesindeki blok sayısı
+    uint32_t used_blocks;       // Dosyalara ayrılmış bloklar
+    uint32_t free_blocks;
+    uint32_t free_extents;      // Bitişik boş alan sayısı
+    uint32_t largest_free;      // En büyük boş alan (blok)
+    uint32_t free_hist[ALLOC_HIST_BUCKETS];
+    double   fragmentation;     // 1 - largest_free / free_blocks (0 = boş alan tek parça)
+} SpaceStats;
+
+void        alloc_set_policy(AllocPolicy policy);
+AllocPolicy alloc_get_policy(void);
+const char *alloc_policy_name(AllocPolicy policy);
+int         alloc_policy_parse(const char *name);     // AllocPolicy ya da FS_ERR_INVALID
+void        alloc_reset(void);                        // next-fit imlecini başa al
+
+// count bloğa yetecek bitişik boş alanın ilk bloğu; yoksa FS_ERR_NO_SPACE
+int64_t alloc_find(const uint8_t *used, uint32_t count);
+
+// Blok haritasından boş alan özeti
+void alloc_space_stats(const uint8_t *used, SpaceStats *out);
+
+#endif // ALLOC_H
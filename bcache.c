@@ -0,0 +1,253 @@
+// bcache.c — blok önbelleği ve arka plan ileri okuma
+//
+// Önbellek doğrudan eşlemelidir: mantıksal blok lba, lba % BCACHE_SLOTS
+// yuvasında tutulur; ardışık bloklar farklı yuvalara düştüğünden sıralı
+// taranan bir bölge kendi bloklarını dışarı atmaz. İleri okuma istekleri
+// küçük bir kuyruğa eklenir ve tek bir iş parçacığı tarafından tek pread ile
+// okunur. Okuma sürerken aynı aralığa yazım veya geçersiz kılma gelirse
+// sonuç önbelleğe alınmaz; ıska veren okuma, kendi bloğu kuyruktaysa veya
+// okunmaktaysa aynı bloğu ikinci kez okumak yerine bitmesini bekler.
+#define _POSIX_C_SOURCE 200809L
+
+#include "bcache.h"
+#include "disk.h"
+
+#include <pthread.h>
+#include <string.h>
+
+#define RA_QUEUE 8
+
+typedef struct {
+    uint32_t tag;                 // lba + 1 (0 = boş yuva)
+    int      prefetched;          // İleri okumayla geldi, henüz okunmadı
+    uint8_t  data[BLOCK_SIZE];
+} Slot;
+
+typedef struct {
+    uint32_t first;
+    uint32_t count;
+} RaRequest;
+
+static Slot        slots[BCACHE_SLOTS];
+static int         enabled = 1;
+static BCacheStats st;
+
+static RaRequest   queue[RA_QUEUE];
+static unsigned    q_head, q_len;
+static uint32_t    busy_first, busy_count;   // Okunmakta olan istek (count 0 = boşta)
+static int         busy_stale;               // Okuma sırasında aralık değişti
+static int         started, stopping;
+
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  work = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t  done = PTHREAD_COND_INITIALIZER;
+static pthread_t       worker;
+static uint8_t         ra_buf[BCACHE_RA_MAX * BLOCK_SIZE];
+
+static int overlaps(uint32_t a, uint32_t an, uint32_t b, uint32_t bn) {
+    return a < b + bn && b < a + an;
+}
+
+// Kilit tutulurken: lba kuyruktaki veya okunmakta olan bir isteğin içinde mi
+static int pending(uint32_t lba) {
+    if (busy_count && overlaps(lba, 1, busy_first, busy_count)) return 1;
+    for (unsigned i = 0; i < q_len; ++i) {
+        const RaRequest *r = &queue[(q_head + i) % RA_QUEUE];
+        if (overlaps(lba, 1, r->first, r->count)) return 1;
+    }
+    return 0;
+}
+
+// Kilit tutulurken: aralık değişti, süren ileri okumanın sonucu bayat
+static void mark_stale(uint32_t first, uint32_t count) {
+    if (busy_count && overlaps(first, count, busy_first, busy_count)) busy_stale = 1;
+}
+
+static void clear_locked(void) {
+    q_len = 0;
+    while (busy_count) pthread_cond_wait(&done, &lock);
+    memset(slots, 0, sizeof(slots));
+    pthread_cond_broadcast(&done);
+}
+
+int bcache_enabled(void) {
+    return enabled;
+}
+
+void bcache_set_enabled(int on) {
+    pthread_mutex_lock(&lock);
+    if (!on) clear_locked();
+    enabled = on ? 1 : 0;
+    pthread_mutex_unlock(&lock);
+}
+
+int bcache_lookup(uint32_t lba, void *out) {
+    pthread_mutex_lock(&lock);
+    if (!enabled) {
+        pthread_mutex_unlock(&lock);
+        return 0;
+    }
+    Slot *s = &slots[lba % BCACHE_SLOTS];
+    if (s->tag != lba + 1 && pending(lba)) {
+        st.readahead_waits++;
+        while (pending(lba)) pthread_cond_wait(&done, &lock);
+    }
+    int hit = s->tag == lba + 1;
+    if (hit) {
+        memcpy(out, s->data, BLOCK_SIZE);
+        st.hits++;
+        if (s->prefetched) {
+            s->prefetched = 0;
+            st.readahead_hits++;
+        }
+    } else {
+        st.misses++;
+    }
+    pthread_mutex_unlock(&lock);
+    return hit;
+}
+
+int bcache_contains(uint32_t lba) {
+    pthread_mutex_lock(&lock);
+    int hit = enabled && slots[lba % BCACHE_SLOTS].tag == lba + 1;
+    pthread_mutex_unlock(&lock);
+    return hit;
+}
+
+void bcache_insert(uint32_t lba, const void *data) {
+    pthread_mutex_lock(&lock);
+    if (enabled) {
+        Slot *s = &slots[lba % BCACHE_SLOTS];
+        s->tag = lba + 1;
+        s->prefetched = 0;
+        memcpy(s->data, data, BLOCK_SIZE);
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+void bcache_write(uint64_t offset, const void *data, size_t size) {
+    if (size == 0) return;
+    uint32_t first = (uint32_t)(offset / BLOCK_SIZE);
+    uint32_t last  = (uint32_t)((offset + size - 1) / BLOCK_SIZE);
+    const uint8_t *in = data;
+
+    pthread_mutex_lock(&lock);
+    mark_stale(first, last - first + 1);
+    for (uint32_t lba = first; lba <= last; ++lba) {
+        Slot *s = &slots[lba % BCACHE_SLOTS];
+        if (s->tag != lba + 1) continue;
+        uint64_t lo = (uint64_t)lba * BLOCK_SIZE, hi = lo + BLOCK_SIZE;
+        if (lo < offset) lo = offset;
+        if (hi > offset + size) hi = offset + size;
+        memcpy(s->data + (lo % BLOCK_SIZE), in + (lo - offset), (size_t)(hi - lo));
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+void bcache_invalidate(uint32_t first, uint32_t count) {
+    if (count == 0) return;
+    pthread_mutex_lock(&lock);
+    mark_stale(first, count);
+    for (unsigned i = 0; i < BCACHE_SLOTS; ++i) {
+        uint32_t tag = slots[i].tag;
+        if (tag && tag - 1 >= first && tag - 1 - first < count) slots[i].tag = 0;
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+void bcache_clear(void) {
+    pthread_mutex_lock(&lock);
+    clear_locked();
+    pthread_mutex_unlock(&lock);
+}
+
+static void *worker_main(void *arg) {
+    (void)arg;
+    pthread_mutex_lock(&lock);
+    for (;;) {
+        while (!stopping && q_len == 0) pthread_cond_wait(&work, &lock);
+        if (stopping) break;
+        RaRequest r = queue[q_head];
+        q_head = (q_head + 1) % RA_QUEUE;
+        q_len--;
+        busy_first = r.first;
+        busy_count = r.count;
+        busy_stale = 0;
+        pthread_mutex_unlock(&lock);
+
+        int rc = disk_phys_read(r.first, r.count, ra_buf);
+
+        pthread_mutex_lock(&lock);
+        if (rc == 0 && !busy_stale && enabled) {
+            for (uint32_t i = 0; i < r.count; ++i) {
+                uint32_t lba = r.first + i;
+                Slot *s = &slots[lba % BCACHE_SLOTS];
+                if (s->tag == lba + 1) continue;    // Önbellekteki kopya en az bu kadar yeni
+                s->tag = lba + 1;
+                s->prefetched = 1;
+                memcpy(s->data, ra_buf + (size_t)i * BLOCK_SIZE, BLOCK_SIZE);
+                st.readahead_blocks++;
+            }
+        }
+        busy_count = 0;
+        pthread_cond_broadcast(&done);
+    }
+    q_len = 0;
+    pthread_cond_broadcast(&done);
+    pthread_mutex_unlock(&lock);
+    return NULL;
+}
+
+void bcache_prefetch(uint32_t first, uint32_t count) {
+    if (first >= DATA_BLOCKS || count == 0) return;
+    if (count > BCACHE_RA_MAX) count = BCACHE_RA_MAX;
+    if (count > DATA_BLOCKS - first) count = DATA_BLOCKS - first;
+
+    pthread_mutex_lock(&lock);
+    // Zaten önbellekte olan baştaki ve sondaki blokları okumaya gerek yok
+    while (count && slots[first % BCACHE_SLOTS].tag == first + 1) {
+        first++;
+        count--;
+    }
+    while (count && slots[(first + count - 1) % BCACHE_SLOTS].tag == first + count) count--;
+
+    if (enabled && !stopping && count && q_len < RA_QUEUE) {
+        if (!started && pthread_create(&worker, NULL, worker_main, NULL) == 0) started = 1;
+        if (started) {
+            queue[(q_head + q_len) % RA_QUEUE] = (RaRequest){ first, count };
+            q_len++;
+            pthread_cond_signal(&work);
+        }
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+void bcache_stats(BCacheStats *out) {
+    pthread_mutex_lock(&lock);
+    *out = st;
+    pthread_mutex_unlock(&lock);
+}
+
+void bcache_reset_stats(void) {
+    pthread_mutex_lock(&lock);
+    memset(&st, 0, sizeof(st));
+    pthread_mutex_unlock(&lock);
+}
+
+void bcache_shutdown(void) {
+    pthread_mutex_lock(&lock);
+    if (!started || stopping) {
+        pthread_mutex_unlock(&lock);
+        return;
+    }
+    stopping = 1;
+    pthread_cond_signal(&work);
+    pthread_mutex_unlock(&lock);
+    pthread_join(worker, NULL);
+}
+
+// Program bittiğinde ileri okuma iş parçacığını durdur
+__attribute__((destructor))
+static void cleanup_bcache(void) {
+    bcache_shutdown();
+}
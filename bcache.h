@@ -0,0 +1,41 @@
+#ifndef BCACHE_H
+#define BCACHE_H
+
+#include <stdint.h>     // uint32_t, uint64_t
+#include <stddef.h>     // size_t
+
+// Veri bölgesinin mantıksal blokları için bellek içi önbellek.
+// Yazımlar diske doğrudan gider ve önbellekteki kopyaya da yansıtılır
+// (write-through), bu yüzden önbellek hiçbir zaman kirli blok tutmaz.
+#define BCACHE_SLOTS   256      // Önbellekteki blok sayısı (256 * 512 = 128 KB)
+#define BCACHE_RA_MIN  4        // İlk ileri okuma penceresi (blok)
+#define BCACHE_RA_MAX  64       // Pencerenin büyüyebileceği en fazla blok
+
+typedef struct {
+    uint64_t hits;              // Önbellekten karşılanan blok okumaları
+    uint64_t misses;            // Diske gitmesi gereken blok okumaları
+    uint64_t readahead_blocks;  // İleri okumayla önbelleğe alınan bloklar
+    uint64_t readahead_hits;    // Bunlardan daha sonra gerçekten okunanlar
+    uint64_t readahead_waits;   // Okumanın süren bir ileri okumayı beklediği durumlar
+} BCacheStats;
+
+int  bcache_enabled(void);
+void bcache_set_enabled(int on);                    // Kapatmak önbelleği boşaltır
+
+int  bcache_lookup(uint32_t lba, void *out);        // 1: isabet (blok kopyalandı), 0: ıska
+int  bcache_contains(uint32_t lba);                 // Sayaçlara dokunmadan varlık sorgusu
+void bcache_insert(uint32_t lba, const void *data);
+void bcache_write(uint64_t offset, const void *data, size_t size); // Yazılan baytları kopyalara yansıt
+void bcache_invalidate(uint32_t first, uint32_t count);
+void bcache_clear(void);                            // Bekleyen ileri okumaları bitir, her şeyi bırak
+
+// Blokları arka planda disk_phys_read ile önbelleğe okur (yalnızca mantıksal
+// blok == fiziksel blok olan düz modda kullanılır). İstek kuyruğu doluysa
+// ipucu sessizce düşürülür.
+void bcache_prefetch(uint32_t first, uint32_t count);
+
+void bcache_stats(BCacheStats *out);
+void bcache_reset_stats(void);
+void bcache_shutdown(void);                         // İleri okuma iş parçacığını durdur
+
+#endif // BCACHE_H
@@ -0,0 +1,512 @@
+// bench.c — SimpleFS performans ölçüm programı
+//
+// fs.h işlemlerini farklı dosya sayısı ve boyutlarıyla çalıştırır, her çağrının
+// gecikmesini ölçer ve her iş yükü için bir satır makine-okunur sonuç yazar
+// (JSON lines veya CSV). Kullanıcının disk.sim imajına dokunmaz.
+#define _POSIX_C_SOURCE 200809L
+
+#include "fs.h"
+#include "stripe.h"     // STRIPE_DEFAULT_BLOCKS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BENCH_IMAGE   "bench.sim"
+#define BENCH_BACKUP  "bench_backup.sim"
+#define READ_CHUNK    BLOCK_SIZE
+#define APPEND_RECORD 64
+#define RECORD_HEADER 16      // read_rec / read_recv: kayıt = başlık + gövde (APPEND_RECORD bayt)
+#define CHURN_OPS     256     // churn: tur başına oluştur/yaz/sil adımı
+#define CHURN_MAX     64      // churn: en büyük dosya (blok)
+
+typedef struct {
+    const char *name;
+    double     *lat;          // saniye cinsinden gecikmeler
+    size_t      count;
+    size_t      cap;
+    uint64_t    bytes;
+    uint32_t    errors;
+} Workload;
+
+enum { W_CREATE, W_WRITE, W_READ_SEQ, W_READ_SEQ_FD, W_READ_ALL, W_READ_RAND, W_REWRITE, W_READ_REC,
+       W_READ_RECV, W_LOOKUP, W_LOOKUP_MAP, W_APPEND, W_APPEND_FD, W_APPEND_MIX,
+       W_APPEND_PREALLOC, W_COPY, W_MV,
+       W_CHURN, W_DEFRAG, W_BACKUP, W_COUNT };
+
+static const char *workload_names[W_COUNT] = {
+    "create", "write", "read_seq", "read_seq_fd", "read_all", "read_rand", "rewrite", "read_rec",
+    "read_recv", "lookup", "lookup_map", "append", "append_fd", "append_mix",
+    "append_prealloc", "copy", "mv",
+    "churn", "defragment", "backup"
+};
+
+static int  csv_output = 0;
+static int  dedup_mode    = 0;
+static int  inline_mode   = 0;
+static int  log_mode      = 0;
+static int  no_cache      = 0;
+static int  no_append_buf = 0;
+static int  delayed_alloc = 0;
+static int  direct_io     = 0;
+static int  batch_trim    = 0;
+static const char *only = NULL;     // virgülle ayrılmış iş yükü filtresi
+static int  policy_tag    = 0;      // -P verildi: mod adına politika eklenir
+static uint32_t tier_kb   = 0;      // -T: bellek katmanı sınırı (KB, 0 = kapalı)
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int enabled(int w) {
+    if (!only) return 1;
+    size_t len = strlen(workload_names[w]);
+    for (const char *p = only; (p = strstr(p, workload_names[w])) != NULL; p += len) {
+        if ((p == only || p[-1] == ',') && (p[len] == '\0' || p[len] == ',')) return 1;
+    }
+    return 0;
+}
+
+static void record(Workload *w, double secs, uint64_t bytes, int ok) {
+    if (w->count == w->cap) {
+        w->cap = w->cap ? w->cap * 2 : 256;
+        w->lat = realloc(w->lat, w->cap * sizeof(*w->lat));
+        if (!w->lat) { perror("bench: realloc"); exit(EXIT_FAILURE); }
+    }
+    w->lat[w->count++] = secs;
+    if (ok) w->bytes += bytes;
+    else    w->errors++;
+}
+
+// Tek bir çağrıyı zamanla; başarı için ret >= 0 beklenir
+#define TIMED(wl, nbytes, call) do {                          \
+        double t0_ = now_sec();                               \
+        long long r_ = (long long)(call);                     \
+        record((wl), now_sec() - t0_, (nbytes), r_ >= 0);     \
+    } while (0)
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile(const double *sorted, size_t n, double p) {
+    if (n == 0) return 0;
+    size_t idx = (size_t)(p * n + 0.999999);
+    if (idx == 0) idx = 1;
+    if (idx > n) idx = n;
+    return sorted[idx - 1];
+}
+
+static void report(const Workload *w, uint32_t files, uint32_t size) {
+    if (w->count == 0) return;
+    double *s = malloc(w->count * sizeof(*s));
+    if (!s) { perror("bench: malloc"); exit(EXIT_FAILURE); }
+    memcpy(s, w->lat, w->count * sizeof(*s));
+    qsort(s, w->count, sizeof(*s), cmp_double);
+
+    double total = 0;
+    for (size_t i = 0; i < w->count; ++i) total += s[i];
+    double ops_sec = total > 0 ? w->count / total : 0;
+    double mb_sec  = total > 0 ? (w->bytes / (1024.0 * 1024.0)) / total : 0;
+    double p50 = percentile(s, w->count, 0.50) * 1e6;
+    double p99 = percentile(s, w->count, 0.99) * 1e6;
+    double p999 = percentile(s, w->count, 0.999) * 1e6;
+    double max = s[w->count - 1] * 1e6;
+    char mode[96];
+    char stripe[32] = "", tier[24] = "";
+    if (disk_devices() > 1) snprintf(stripe, sizeof(stripe), "-stripe%dx%u", disk_devices(), disk_stripe_blocks());
+    if (tier_kb) snprintf(tier, sizeof(tier), "-tier%uk", tier_kb);
+    snprintf(mode, sizeof(mode), "%s%s%s%s%s%s%s%s%s%s",
+             dedup_mode ? "dedup" : inline_mode ? "inline" : log_mode ? "log" : "plain", stripe, tier,
+             no_cache ? "-nocache" : "", no_append_buf ? "-noappendbuf" : "",
+             delayed_alloc ? "-delalloc" : "", disk_direct() ? "-direct" : "",
+             batch_trim ? "-trimbatch" : "", policy_tag ? "-" : "", policy_tag ? alloc_policy_name(fs_alloc_policy()) : "");
+
+    if (csv_output) {
+        printf("%s,%s,%u,%u,%zu,%u,%llu,%.6f,%.1f,%.3f,%.2f,%.2f,%.2f,%.2f\n",
+               w->name, mode, files, size, w->count, w->errors,
+               (unsigned long long)w->bytes, total, ops_sec, mb_sec,
+               p50, p99, p999, max);
+    } else {
+        printf("{\"workload\":\"%s\",\"mode\":\"%s\",\"files\":%u,\"file_size\":%u,"
+               "\"ops\":%zu,\"errors\":%u,\"bytes\":%llu,\"seconds\":%.6f,"
+               "\"ops_per_sec\":%.1f,\"mb_per_sec\":%.3f,"
+               "\"p50_us\":%.2f,\"p99_us\":%.2f,\"p999_us\":%.2f,\"max_us\":%.2f}\n",
+               w->name, mode, files, size, w->count, w->errors,
+               (unsigned long long)w->bytes, total, ops_sec, mb_sec,
+               p50, p99, p999, max);
+    }
+    free(s);
+}
+
+static void file_name(char *out, size_t len, const char *prefix, uint32_t i) {
+    snprintf(out, len, "%s%u", prefix, i);
+}
+
+// Kaydı ayrı başlık ve gövde tamponlarına iki fs_read ile okur
+static ssize_t read_record(const char *name, uint32_t off, char *hdr, char *body) {
+    ssize_t a = fs_read(name, off, RECORD_HEADER, hdr);
+    if (a < 0) return a;
+    ssize_t b = fs_read(name, off + RECORD_HEADER, APPEND_RECORD - RECORD_HEADER, body);
+    return b < 0 ? b : a + b;
+}
+
+// Aynı kayıt tek fs_readv ile (bitişik iki aralık tek disk okumasında birleşir)
+static ssize_t read_record_v(const char *name, uint32_t off, char *hdr, char *body) {
+    FsIoVec v[2] = {
+        { name, off, hdr, RECORD_HEADER },
+        { name, off + RECORD_HEADER, body, APPEND_RECORD - RECORD_HEADER }
+    };
+    return fs_readv(v, 2);
+}
+
+// Eşlenmiş dosyadaki kaydı kopyalamadan okur (baytların toplamı)
+static int record_sum(const unsigned char *rec) {
+    int sum = 0;
+    for (int i = 0; i < APPEND_RECORD; ++i) sum += rec[i];
+    return sum;
+}
+
+// Bir (dosya sayısı, boyut) kombinasyonu için tüm iş yüklerini bir kez çalıştır
+static void run_round(Workload *w, uint32_t files, uint32_t size, unsigned *seed) {
+    char name[32], other[32];
+    char *data = malloc(size);
+    char *buf  = malloc(size > READ_CHUNK ? size : READ_CHUNK);
+    if (!data || !buf) { perror("bench: malloc"); exit(EXIT_FAILURE); }
+    for (uint32_t i = 0; i < size; ++i) data[i] = (char)('a' + (i * 7 + i / 13) % 26);
+
+    if (fs_format_mode(dedup_mode ? FS_FORMAT_DEDUP : inline_mode ? FS_FORMAT_INLINE
+                       : log_mode ? FS_FORMAT_LOG : 0) < 0) {
+        fprintf(stderr, "bench: format failed\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (uint32_t i = 0; i < files; ++i) {
+        file_name(name, sizeof(name), "f", i);
+        if (enabled(W_CREATE)) TIMED(&w[W_CREATE], 0, fs_create(name));
+        else fs_create(name);
+    }
+
+    for (uint32_t i = 0; i < files; ++i) {
+        file_name(name, sizeof(name), "f", i);
+        if (enabled(W_WRITE)) TIMED(&w[W_WRITE], size, fs_write(name, data, size));
+        else fs_write(name, data, size);
+    }
+
+    if (enabled(W_READ_SEQ)) {
+        for (uint32_t i = 0; i < files; ++i) {
+            file_name(name, sizeof(name), "f", i);
+            for (uint32_t off = 0; off < size; off += READ_CHUNK) {
+                uint32_t n = size - off < READ_CHUNK ? size - off : READ_CHUNK;
+                TIMED(&w[W_READ_SEQ], n, fs_read(name, off, n, buf));
+            }
+        }
+    }
+
+    // Aynı okuma, ad çözümlemesi bir kez yapılarak (tanıtıcı + imleç)
+    if (enabled(W_READ_SEQ_FD)) {
+        for (uint32_t i = 0; i < files; ++i) {
+            file_name(name, sizeof(name), "f", i);
+            int fd = fs_open(name, FS_O_READ);
+            for (uint32_t off = 0; off < size; off += READ_CHUNK) {
+                uint32_t n = size - off < READ_CHUNK ? size - off : READ_CHUNK;
+                TIMED(&w[W_READ_SEQ_FD], n, fs_fread(fd, buf, n));
+            }
+            fs_close(fd);
+        }
+    }
+
+    // Dosyanın tamamı tek çağrıda (şeritli kümede aygıtlar paralel okunur)
+    if (enabled(W_READ_ALL)) {
+        for (uint32_t i = 0; i < files; ++i) {
+            file_name(name, sizeof(name), "f", i);
+            TIMED(&w[W_READ_ALL], size, fs_read(name, 0, size, buf));
+        }
+    }
+
+    if (enabled(W_READ_RAND)) {
+        uint32_t reads = files * ((size + READ_CHUNK - 1) / READ_CHUNK);
+        for (uint32_t r = 0; r < reads; ++r) {
+            file_name(name, sizeof(name), "f", (uint32_t)rand_r(seed) % files);
+            uint32_t n = size < READ_CHUNK ? size : READ_CHUNK;
+            uint32_t off = (uint32_t)rand_r(seed) % (size - n + 1);
+            TIMED(&w[W_READ_RAND], n, fs_read(name, off, n, buf));
+        }
+    }
+
+    // Yerinde küçük güncellemeler (sık değişen yapılandırma / geçici dosyalar)
+    if (enabled(W_REWRITE)) {
+        uint32_t writes = files * ((size + READ_CHUNK - 1) / READ_CHUNK);
+        for (uint32_t r = 0; r < writes; ++r) {
+            file_name(name, sizeof(name), "f", (uint32_t)rand_r(seed) % files);
+            uint32_t n = size < APPEND_RECORD ? size : APPEND_RECORD;
+            uint32_t off = (uint32_t)rand_r(seed) % (size - n + 1);
+            int fd = fs_open(name, FS_O_WRITE);
+            TIMED(&w[W_REWRITE], n, fs_pwrite(fd, data + off, n, off));
+            fs_close(fd);
+        }
+    }
+
+    if (enabled(W_READ_REC) || enabled(W_READ_RECV)) {
+        char hdr[RECORD_HEADER], body[APPEND_RECORD - RECORD_HEADER];
+        for (int v = 0; v < 2; ++v) {
+            int wl = v ? W_READ_RECV : W_READ_REC;
+            if (!enabled(wl)) continue;
+            for (uint32_t i = 0; i < files; ++i) {
+                file_name(name, sizeof(name), "f", i);
+                for (uint32_t off = 0; off + APPEND_RECORD <= size; off += APPEND_RECORD) {
+                    TIMED(&w[wl], APPEND_RECORD, v ? read_record_v(name, off, hdr, body)
+                                                   : read_record(name, off, hdr, body));
+                }
+            }
+        }
+    }
+
+    // Kayıt tablosu araması: rastgele bir kayıt fs_read ile tampona kopyalanır
+    // ya da fs_map ile eşlenen dosyada yerinde okunur
+    if ((enabled(W_LOOKUP) || enabled(W_LOOKUP_MAP)) && size >= APPEND_RECORD) {
+        uint32_t recs = size / APPEND_RECORD;
+        for (int m = 0; m < 2; ++m) {
+            int wl = m ? W_LOOKUP_MAP : W_LOOKUP;
+            if (!enabled(wl) || (m && disk_direct())) continue;     // doğrudan G/Ç'de fs_map yok
+            for (uint32_t i = 0; i < files; ++i) {
+                file_name(name, sizeof(name), "f", i);
+                void *map = NULL;
+                int rc = m ? fs_map(name, 0, 0, FS_MAP_READ, &map) : 0;
+                if (rc == FS_ERR_UNSUPPORTED && i == 0) break;   // dedup, günlük ya da şeritli imaj
+                if (rc < 0) {
+                    record(&w[wl], 0, 0, 0);
+                    continue;
+                }
+                const unsigned char *table = map;
+                for (uint32_t r = 0; r < recs; ++r) {
+                    uint32_t off = ((uint32_t)rand_r(seed) % recs) * APPEND_RECORD;
+                    TIMED(&w[wl], APPEND_RECORD, m ? record_sum(table + off)
+                                                   : fs_read(name, off, APPEND_RECORD, buf));
+                }
+                if (m) fs_unmap(map);
+            }
+        }
+    }
+
+    if (enabled(W_APPEND)) {
+        for (uint32_t i = 0; i < files; ++i) {
+            file_name(name, sizeof(name), "f", i);
+            fs_truncate(name, 0);
+            for (uint32_t off = 0; off < size; off += APPEND_RECORD) {
+                uint32_t n = size - off < APPEND_RECORD ? size - off : APPEND_RECORD;
+                TIMED(&w[W_APPEND], n, fs_append(name, data + off, n));
+            }
+        }
+    }
+
+    if (enabled(W_APPEND_FD)) {
+        for (uint32_t i = 0; i < files; ++i) {
+            file_name(name, sizeof(name), "f", i);
+            int fd = fs_open(name, FS_O_WRITE | FS_O_TRUNC | FS_O_APPEND);
+            for (uint32_t off = 0; off < size; off += APPEND_RECORD) {
+                uint32_t n = size - off < APPEND_RECORD ? size - off : APPEND_RECORD;
+                TIMED(&w[W_APPEND_FD], n, fs_fwrite(fd, data + off, n));
+            }
+            fs_close(fd);
+        }
+    }
+
+    // Günlük dosyaları gibi tüm dosyalara sırayla eklenir: dosyalar birbirinin
+    // ardında büyür. Ön ayırma (append_prealloc) ya da ertelenmiş ayırma (-L)
+    // olmadan ardı dolan dosya büyüdükçe taşınır. Son fs_sync de ölçülür.
+    for (int pre = 0; pre < 2; ++pre) {
+        int wl = pre ? W_APPEND_PREALLOC : W_APPEND_MIX;
+        if (!enabled(wl)) continue;
+        for (uint32_t i = 0; i < files; ++i) {
+            file_name(name, sizeof(name), "f", i);
+            fs_truncate(name, 0);
+            if (pre) fs_fallocate(name, 0, size, FS_FALLOC_KEEP_SIZE);
+        }
+        for (uint32_t off = 0; off < size; off += APPEND_RECORD) {
+            uint32_t n = size - off < APPEND_RECORD ? size - off : APPEND_RECORD;
+            for (uint32_t i = 0; i < files; ++i) {
+                file_name(name, sizeof(name), "f", i);
+                TIMED(&w[wl], n, fs_append(name, data + off, n));
+            }
+        }
+        TIMED(&w[wl], 0, fs_sync());
+    }
+
+    if (enabled(W_COPY)) {
+        uint32_t copies = files;
+        if (copies > MAX_FILES - files) copies = MAX_FILES - files;
+        for (uint32_t i = 0; i < copies; ++i) {
+            file_name(name, sizeof(name), "f", i);
+            file_name(other, sizeof(other), "c", i);
+            TIMED(&w[W_COPY], size, fs_copy(name, other));
+        }
+        for (uint32_t i = 0; i < copies; ++i) {
+            file_name(other, sizeof(other), "c", i);
+            fs_delete(other);
+        }
+    }
+
+    // Karışık boyutlu dosyalar rastgele oluşturulup silinir; boş alan parçalanır
+    // ve ayırma politikaları arasındaki fark görünür (hatalar = yer bulunamadı)
+    if (enabled(W_CHURN)) {
+        static char block[CHURN_MAX * BLOCK_SIZE];
+        uint32_t slots = MAX_FILES - files;
+        if (slots > 32) slots = 32;
+        for (uint32_t op = 0; op < CHURN_OPS && slots; ++op) {
+            file_name(name, sizeof(name), "k", (uint32_t)rand_r(seed) % slots);
+            if (fs_exists(name) > 0) {
+                TIMED(&w[W_CHURN], 0, fs_delete(name));
+                continue;
+            }
+            // Çoğu küçük, arada büyük dosyalar
+            uint32_t blocks = 1 + (uint32_t)rand_r(seed) % (rand_r(seed) % 4 ? 4 : CHURN_MAX);
+            uint32_t n = blocks * BLOCK_SIZE - (uint32_t)rand_r(seed) % BLOCK_SIZE;
+            if (fs_create(name) < 0) continue;
+            TIMED(&w[W_CHURN], n, fs_write(name, block, n));
+        }
+        for (uint32_t i = 0; i < slots; ++i) {
+            file_name(name, sizeof(name), "k", i);
+            fs_delete(name);
+        }
+    }
+
+    if (enabled(W_MV)) {
+        for (uint32_t i = 0; i < files; ++i) {
+            file_name(name, sizeof(name), "f", i);
+            file_name(other, sizeof(other), "m", i);
+            TIMED(&w[W_MV], size, fs_mv(name, other));
+        }
+    }
+
+    if (enabled(W_DEFRAG)) TIMED(&w[W_DEFRAG], (uint64_t)files * size, fs_defragment());
+    if (enabled(W_BACKUP)) TIMED(&w[W_BACKUP], DISK_SIZE, fs_backup(BENCH_BACKUP));
+
+    free(data);
+    free(buf);
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s [-r ROUNDS] [-o json|csv] [-w WORKLOADS] [-D | -I | -G] [-C] [-A] [-L] [-O] [-B] [-P POLICIES]\n"
+            "          [-d IMAGE[,IMAGE...]] [-S BLOCKS] [-T KB]\n"
+            "  -r ROUNDS     repeat every combination ROUNDS times (default 3)\n"
+            "  -o FORMAT     json (JSON lines, default) or csv\n"
+            "  -w LIST       comma-separated workloads to run (default: all)\n"
+            "  -D            format the bench image in dedup mode\n"
+            "  -I            format the bench image with inline small files\n"
+            "  -G            format the bench image in log-structured mode\n"
+            "  -C            disable the block cache and read-ahead\n"
+            "  -A            disable append buffering (every fs_append writes through)\n"
+            "  -L            delayed allocation: buffered appends get blocks when written\n"
+            "  -O            direct I/O: bypass the host page cache (O_DIRECT)\n"
+            "  -B            batch hole punching of freed blocks in a background thread\n"
+            "  -P LIST       run everything once per allocation policy (comma-separated,\n"
+            "                or 'all'): first-fit,best-fit,next-fit,size-class\n"
+            "  -d IMAGE      bench image path (default %s); a comma-separated list\n"
+            "                stripes the image across several files\n"
+            "  -S BLOCKS     stripe unit in blocks for a striped image (default %d)\n"
+            "  -T KB         keep hot files in a memory tier of at most KB kilobytes\n"
+            "Workloads: create,write,read_seq,read_seq_fd,read_all,read_rand,rewrite,read_rec,read_recv,\n"
+            "           lookup,lookup_map,append,append_fd,append_mix,append_prealloc,copy,mv,\n"
+            "           churn,defragment,backup\n",
+            prog, BENCH_IMAGE, STRIPE_DEFAULT_BLOCKS);
+}
+
+int main(int argc, char **argv) {
+    static const uint32_t file_counts[] = { 1, 8, 64 };
+    static const uint32_t file_sizes[]  = { 64, 512, 4096, 32768, 262144 };
+    const char *image = BENCH_IMAGE;
+    const char *policy_list = NULL;
+    AllocPolicy policies[ALLOC_POLICY_COUNT];
+    int npolicies = 0;
+    unsigned rounds = 3;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "r:o:w:DIGCALOBP:d:S:T:h")) != -1) {
+        switch (opt) {
+            case 'r': rounds = (unsigned)strtoul(optarg, NULL, 10); break;
+            case 'o': csv_output = strcmp(optarg, "csv") == 0; break;
+            case 'w': only = optarg; break;
+            case 'D': dedup_mode = 1; break;
+            case 'I': inline_mode = 1; break;
+            case 'G': log_mode = 1; break;
+            case 'C': no_cache = 1; break;
+            case 'A': no_append_buf = 1; break;
+            case 'L': delayed_alloc = 1; break;
+            case 'O': direct_io = 1; break;
+            case 'B': batch_trim = 1; break;
+            case 'P': policy_list = optarg; break;
+            case 'd': image = optarg; break;
+            case 'S':
+                if (disk_set_stripe_width((uint32_t)strtoul(optarg, NULL, 10)) < 0) return EXIT_FAILURE;
+                break;
+            case 'T': tier_kb = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'h': usage(argv[0]); return EXIT_SUCCESS;
+            default:  usage(argv[0]); return EXIT_FAILURE;
+        }
+    }
+    if (rounds == 0) rounds = 1;
+
+    if (!policy_list) {
+        policies[npolicies++] = fs_alloc_policy();
+    } else if (strcmp(policy_list, "all") == 0) {
+        for (int p = 0; p < ALLOC_POLICY_COUNT; ++p) policies[npolicies++] = (AllocPolicy)p;
+        policy_tag = 1;
+    } else {
+        char list[128];
+        snprintf(list, sizeof(list), "%s", policy_list);
+        for (char *tok = strtok(list, ","); tok; tok = strtok(NULL, ",")) {
+            int p = alloc_policy_parse(tok);
+            if (p < 0) {
+                fprintf(stderr, "bench: unknown allocation policy '%s'\n", tok);
+                return EXIT_FAILURE;
+            }
+            if (npolicies < ALLOC_POLICY_COUNT) policies[npolicies++] = (AllocPolicy)p;
+        }
+        policy_tag = 1;
+    }
+    if (disk_set_path(image) < 0) return EXIT_FAILURE;
+    fs_cache_enable(!no_cache);
+    fs_append_buffer_enable(!no_append_buf);
+    fs_delayed_alloc_enable(delayed_alloc);
+    fs_trim_batch_enable(batch_trim);
+    if (fs_tier_set_limit((uint64_t)tier_kb * 1024) < 0) return EXIT_FAILURE;
+    if (fs_direct_io_enable(direct_io) < 0) return EXIT_FAILURE;
+
+    if (csv_output) {
+        printf("workload,mode,files,file_size,ops,errors,bytes,seconds,"
+               "ops_per_sec,mb_per_sec,p50_us,p99_us,p999_us,max_us\n");
+    }
+
+    for (int p = 0; p < npolicies; ++p) {
+    fs_set_alloc_policy(policies[p]);
+    unsigned seed = 12345;     // Her politika aynı işlem dizisini görür
+    for (size_t c = 0; c < sizeof(file_counts) / sizeof(file_counts[0]); ++c) {
+        for (size_t s = 0; s < sizeof(file_sizes) / sizeof(file_sizes[0]); ++s) {
+            uint32_t files = file_counts[c], size = file_sizes[s];
+            // Kopyalar için yer kalsın: toplam veri diskin yarısını geçmesin
+            if ((uint64_t)files * size > DATA_SIZE / 2) continue;
+
+            Workload w[W_COUNT];
+            memset(w, 0, sizeof(w));
+            for (int i = 0; i < W_COUNT; ++i) w[i].name = workload_names[i];
+
+            for (unsigned r = 0; r < rounds; ++r) run_round(w, files, size, &seed);
+            for (int i = 0; i < W_COUNT; ++i) {
+                report(&w[i], files, size);
+                free(w[i].lat);
+            }
+            fflush(stdout);
+        }
+    }
+    }
+
+    unlink(BENCH_BACKUP);
+    return EXIT_SUCCESS;
+}
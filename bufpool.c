@@ -0,0 +1,149 @@
+// bufpool.c — iş parçacığı başına tampon listeleri ve karalama alanı
+//
+// Her iş parçacığının önbelleği ilk kullanımda ayrılır ve bir pthread
+// anahtarına bağlanır; iş parçacığı bittiğinde anahtarın yıkıcısı listedeki
+// tamponları, karalama alanını ve taşan istekleri bırakır. Bir iş
+// parçacığında alınan tampon başka birinde bırakılırsa o iş parçacığının
+// listesine girer. Sayaçlar tüm iş parçacıkları için ortaktır.
+#define _POSIX_C_SOURCE 200809L
+
+#include "bufpool.h"
+#include "disk.h"       // BLOCK_SIZE, METADATA_SIZE
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ADD(var, n) __atomic_fetch_add(&(var), (n), __ATOMIC_RELAXED)
+#define OVERFLOW_HDR 16         // Taşan isteğin başlığı; veri 16 bayt hizalı kalır
+
+// Karalama alanına sığmayan istek: başlık verinin önünde durur, liste en
+// yeniden eskiye sıralıdır
+typedef struct Overflow {
+    struct Overflow *next;
+} Overflow;
+
+typedef struct {
+    void     *free[BUF_CLASS_COUNT][BUFPOOL_PER_THREAD];
+    int       count[BUF_CLASS_COUNT];
+    uint8_t  *scratch;          // SCRATCH_SIZE bayt, ilk scratch_alloc'ta ayrılır
+    size_t    used;
+    Overflow *overflow;
+} ThreadCache;
+
+static const size_t class_size[BUF_CLASS_COUNT] = { BLOCK_SIZE, METADATA_SIZE, BUF_CHUNK_SIZE };
+
+static _Thread_local ThreadCache *tc;
+static pthread_key_t  tc_key;
+static pthread_once_t tc_once = PTHREAD_ONCE_INIT;
+static BufPoolStats   st;
+
+static void tc_free(void *arg) {
+    ThreadCache *c = arg;
+    for (int cls = 0; cls < BUF_CLASS_COUNT; ++cls) {
+        for (int i = 0; i < c->count[cls]; ++i) free(c->free[cls][i]);
+    }
+    while (c->overflow) {
+        Overflow *o = c->overflow;
+        c->overflow = o->next;
+        free(o);
+    }
+    free(c->scratch);
+    free(c);
+}
+
+static void tc_key_init(void) {
+    pthread_key_create(&tc_key, tc_free);
+}
+
+static ThreadCache *cache(void) {
+    if (tc) return tc;
+    pthread_once(&tc_once, tc_key_init);
+    ThreadCache *c = calloc(1, sizeof(*c));
+    if (!c) return NULL;
+    ADD(st.heap_allocs, 1);
+    pthread_setspecific(tc_key, c);
+    tc = c;
+    return c;
+}
+
+size_t buf_size(BufClass cls) {
+    return class_size[cls];
+}
+
+void *buf_get(BufClass cls) {
+    ThreadCache *c = cache();
+    if (c && c->count[cls] > 0) {
+        ADD(st.pool_hits, 1);
+        return c->free[cls][--c->count[cls]];
+    }
+    ADD(st.heap_allocs, 1);
+    return malloc(class_size[cls]);
+}
+
+void buf_put(BufClass cls, void *buf) {
+    if (!buf) return;
+    ThreadCache *c = cache();
+    if (c && c->count[cls] < BUFPOOL_PER_THREAD) {
+        c->free[cls][c->count[cls]++] = buf;
+        return;
+    }
+    ADD(st.heap_frees, 1);
+    free(buf);
+}
+
+ScratchMark scratch_mark(void) {
+    ThreadCache *c = cache();
+    ScratchMark m = { c ? c->used : 0, c ? c->overflow : NULL };
+    return m;
+}
+
+void *scratch_alloc(size_t size) {
+    ThreadCache *c = cache();
+    if (!c) return NULL;
+    size = (size + 15) & ~(size_t)15;
+    if (!c->scratch && size <= SCRATCH_SIZE && (c->scratch = malloc(SCRATCH_SIZE)) != NULL) {
+        ADD(st.heap_allocs, 1);
+    }
+    if (c->scratch && size <= SCRATCH_SIZE - c->used) {
+        void *p = c->scratch + c->used;
+        c->used += size;
+        ADD(st.scratch_allocs, 1);
+        return p;
+    }
+    Overflow *o = malloc(OVERFLOW_HDR + size);
+    if (!o) return NULL;
+    ADD(st.heap_allocs, 1);
+    ADD(st.scratch_overflows, 1);
+    o->next = c->overflow;
+    c->overflow = o;
+    return (uint8_t *)o + OVERFLOW_HDR;
+}
+
+void scratch_release(ScratchMark mark) {
+    ThreadCache *c = tc;
+    if (!c) return;
+    while (c->overflow && c->overflow != mark.overflow) {
+        Overflow *o = c->overflow;
+        c->overflow = o->next;
+        free(o);
+        ADD(st.heap_frees, 1);
+    }
+    c->used = mark.used;
+}
+
+void bufpool_stats(BufPoolStats *out) {
+    out->pool_hits         = __atomic_load_n(&st.pool_hits, __ATOMIC_RELAXED);
+    out->heap_allocs       = __atomic_load_n(&st.heap_allocs, __ATOMIC_RELAXED);
+    out->heap_frees        = __atomic_load_n(&st.heap_frees, __ATOMIC_RELAXED);
+    out->scratch_allocs    = __atomic_load_n(&st.scratch_allocs, __ATOMIC_RELAXED);
+    out->scratch_overflows = __atomic_load_n(&st.scratch_overflows, __ATOMIC_RELAXED);
+}
+
+void bufpool_reset_stats(void) {
+    __atomic_store_n(&st.pool_hits, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&st.heap_allocs, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&st.heap_frees, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&st.scratch_allocs, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&st.scratch_overflows, 0, __ATOMIC_RELAXED);
+}
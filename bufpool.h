@@ -0,0 +1,52 @@
+#ifndef BUFPOOL_H
+#define BUFPOOL_H
+
+#include <stdint.h>     // uint64_t
+#include <stddef.h>     // size_t
+
+// İşlem başına geçici tamponlar: her çağrıda malloc/free yerine sabit boyutlu
+// sınıflardan (blok, metadata, parça) iş parçacığı başına boş listelerden
+// verilir. Listede BUFPOOL_PER_THREAD'den fazla tampon birikirse fazlası
+// free edilir; iş parçacığı bittiğinde listesi bırakılır. Değişken boyutlu
+// geçici diziler (iovec/parça tabloları, raporlar) iş parçacığı başına
+// SCRATCH_SIZE baytlık karalama alanından yığın düzeninde alınır:
+// scratch_mark ile işaretlenir, scratch_release ile o noktaya kadar
+// bırakılır. Alan dolarsa istek heap'ten karşılanır ve release'de free edilir.
+// Isınmadan sonra okuma/yazma/ekleme yolunda heap ayırması yapılmamalıdır;
+// BufPoolStats.heap_allocs bunu ölçer.
+typedef enum {
+    BUF_BLOCK,                  // BLOCK_SIZE
+    BUF_META,                   // METADATA_SIZE
+    BUF_CHUNK,                  // BUF_CHUNK_SIZE (kopya, yedekleme, birleştirme)
+    BUF_CLASS_COUNT
+} BufClass;
+
+#define BUF_CHUNK_SIZE      (256 * 1024)
+#define BUFPOOL_PER_THREAD  4
+#define SCRATCH_SIZE        (64 * 1024)
+
+void  *buf_get(BufClass cls);               // NULL: bellek yok
+void   buf_put(BufClass cls, void *buf);
+size_t buf_size(BufClass cls);
+
+typedef struct {
+    size_t used;
+    void  *overflow;
+} ScratchMark;
+
+ScratchMark scratch_mark(void);
+void       *scratch_alloc(size_t size);     // 16 bayt hizalı; NULL: bellek yok
+void        scratch_release(ScratchMark mark);
+
+typedef struct {
+    uint64_t pool_hits;         // Boş listeden verilen tamponlar
+    uint64_t heap_allocs;       // malloc'a giden istekler (liste boş, alan dolu, ilk kullanım)
+    uint64_t heap_frees;        // Liste dolu olduğu için free edilenler
+    uint64_t scratch_allocs;    // Karalama alanından verilen diziler
+    uint64_t scratch_overflows; // Alana sığmayıp heap'ten alınanlar (heap_allocs'a dahil)
+} BufPoolStats;
+
+void bufpool_stats(BufPoolStats *out);
+void bufpool_reset_stats(void);
+
+#endif // BUFPOOL_H
@@ -0,0 +1,526 @@
+// bulk.c — toplu içe/dışa aktarma boru hattının ana makine tarafı
+//
+// Her boru bir iş parçacığı ve bayt sınırlı bir kuyruktan oluşur. Okuyucuda
+// iş parçacığı dizin ağacını dolaşıp (ya da tar akışını çözüp) dosyaları
+// kuyruğa koyar; yazıcıda kuyruktan aldıklarını dosya ya da tar kaydı olarak
+// yazar. Böylece ana makinedeki G/Ç, imaj tarafındaki ayırma ve yazımla
+// üst üste biner. Kuyruk dolunca üretici, boşalınca tüketici bekler.
+#define _POSIX_C_SOURCE 200809L
+
+#include "bulk.h"
+#include "disk.h"
+#include "fserr.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define TAR_BLOCK 512
+#define NAME_LEN  31                    // FileEntry.name - NUL
+
+typedef struct BulkNode {
+    BulkItem         item;
+    struct BulkNode *next;
+} BulkNode;
+
+struct BulkPipe {
+    int             writer;             // 1: kuyruktan ana makineye yazar
+    int             tar;                // 1: tar akışı, 0: dizin ağacı
+    int             fd;
+    char            dir[PATH_MAX];
+    pthread_t       thread;
+    pthread_mutex_t lock;
+    pthread_cond_t  changed;            // Kuyruk ya da durum değişti
+    BulkNode       *head, *tail;
+    size_t          queued;             // Kuyruktaki veri (bayt)
+    int             done;               // Üretici bitti
+    int             stopping;           // Tüketici vazgeçti
+    int             err;                // İş parçacığının ilk hatası
+};
+
+// ---------------------------------------------------------------------------
+// Kuyruk
+// ---------------------------------------------------------------------------
+
+// Öğeyi kuyruğa koyar; tüketici vazgeçtiyse öğeyi bırakır ve 1 döner
+static int pipe_push(BulkPipe *p, const BulkItem *item) {
+    BulkNode *n = malloc(sizeof(*n));
+    if (!n) {
+        free(item->data);
+        return FS_ERR_NO_MEMORY;
+    }
+    n->item = *item;
+    n->next = NULL;
+
+    pthread_mutex_lock(&p->lock);
+    // Tek başına sınırı aşan öğe de boş kuyruğa girebilir
+    while (!p->stopping && p->head && p->queued + item->size > BULK_QUEUE_BYTES)
+        pthread_cond_wait(&p->changed, &p->lock);
+    if (p->stopping) {
+        pthread_mutex_unlock(&p->lock);
+        free(item->data);
+        free(n);
+        return 1;
+    }
+    if (p->tail) p->tail->next = n;
+    else         p->head = n;
+    p->tail = n;
+    p->queued += item->size;
+    pthread_cond_broadcast(&p->changed);
+    pthread_mutex_unlock(&p->lock);
+    return 0;
+}
+
+// 1: öğe alındı, 0: üretici bitti ve kuyruk boş
+static int pipe_pop(BulkPipe *p, BulkItem *item) {
+    pthread_mutex_lock(&p->lock);
+    while (!p->head && !p->done) pthread_cond_wait(&p->changed, &p->lock);
+    BulkNode *n = p->head;
+    if (n) {
+        p->head = n->next;
+        if (!p->head) p->tail = NULL;
+        p->queued -= n->item.size;
+        pthread_cond_broadcast(&p->changed);
+    }
+    pthread_mutex_unlock(&p->lock);
+    if (!n) return 0;
+    *item = n->item;
+    free(n);
+    return 1;
+}
+
+static void pipe_fail(BulkPipe *p, int err) {
+    pthread_mutex_lock(&p->lock);
+    if (err < 0 && p->err == 0) p->err = err;
+    pthread_mutex_unlock(&p->lock);
+}
+
+static void pipe_drain(BulkPipe *p) {
+    while (p->head) {
+        BulkNode *n = p->head;
+        p->head = n->next;
+        free(n->item.data);
+        free(n);
+    }
+    p->tail   = NULL;
+    p->queued = 0;
+}
+
+// ---------------------------------------------------------------------------
+// Ana makine G/Ç yardımcıları
+// ---------------------------------------------------------------------------
+
+// Tam okuma: okunan bayt (EOF'ta eksik olabilir) ya da FS_ERR_IO
+static ssize_t read_full(int fd, void *buf, size_t len) {
+    size_t done = 0;
+    while (done < len) {
+        ssize_t r = read(fd, (uint8_t *)buf + done, len - done);
+        if (r < 0 && errno == EINTR) continue;
+        if (r < 0) return FS_ERR_IO;
+        if (r == 0) break;
+        done += (size_t)r;
+    }
+    return (ssize_t)done;
+}
+
+static int write_full(int fd, const void *buf, size_t len) {
+    size_t done = 0;
+    while (done < len) {
+        ssize_t w = write(fd, (const uint8_t *)buf + done, len - done);
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) return FS_ERR_IO;
+        done += (size_t)w;
+    }
+    return 0;
+}
+
+static int check_name(const char *name) {
+    if (!name[0]) FS_FAIL(FS_ERR_INVALID, "bulk: empty file name");
+    if (strlen(name) > NAME_LEN)
+        FS_FAIL(FS_ERR_INVALID, "bulk: name '%s' is longer than %d characters", name, NAME_LEN);
+    return 0;
+}
+
+static int check_size(const char *name, uint64_t size) {
+    if (size > DATA_SIZE) FS_FAIL(FS_ERR_NO_SPACE, "bulk: '%s' does not fit on the disk", name);
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// Dizin okuyucu
+// ---------------------------------------------------------------------------
+
+static int name_cmp(const void *a, const void *b) {
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+static int read_host_file(const char *path, const char *name, time_t mtime,
+                          uint64_t size, BulkItem *item) {
+    int rc = check_size(name, size);
+    if (rc < 0) return rc;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) FS_FAIL(FS_ERR_IO, "bulk: open '%s': %s", path, strerror(errno));
+    uint8_t *data = malloc(size ? size : 1);
+    if (!data) {
+        close(fd);
+        FS_FAIL(FS_ERR_NO_MEMORY, "bulk: out of memory");
+    }
+    ssize_t r = read_full(fd, data, size);
+    close(fd);
+    if (r != (ssize_t)size) {
+        free(data);
+        FS_FAIL(FS_ERR_IO, "bulk: read '%s' failed", path);
+    }
+    memset(item, 0, sizeof(*item));
+    memcpy(item->name, name, strlen(name) + 1);
+    item->data  = data;
+    item->size  = (uint32_t)size;
+    item->mtime = mtime;
+    return 0;
+}
+
+// Girdiler ad sırasıyla gezilir: aynı ağaç her seferinde aynı yerleşimi verir
+static int walk_dir(BulkPipe *p, const char *path, const char *prefix) {
+    DIR *d = opendir(path);
+    if (!d) FS_FAIL(FS_ERR_IO, "bulk: opendir '%s': %s", path, strerror(errno));
+
+    char  **names = NULL;
+    size_t  count = 0, cap = 0;
+    int     rc    = 0;
+    struct dirent *de;
+    while ((de = readdir(d)) != NULL) {
+        if (!strcmp(de->d_name, ".") || !strcmp(de->d_name, "..")) continue;
+        if (count == cap) {
+            size_t ncap = cap ? cap * 2 : 64;
+            char **n = realloc(names, ncap * sizeof(*names));
+            if (!n) { rc = FS_ERR_NO_MEMORY; break; }
+            names = n;
+            cap   = ncap;
+        }
+        if (!(names[count] = strdup(de->d_name))) { rc = FS_ERR_NO_MEMORY; break; }
+        count++;
+    }
+    closedir(d);
+    if (rc == 0) qsort(names, count, sizeof(*names), name_cmp);
+
+    char full[PATH_MAX], rel[PATH_MAX];
+    for (size_t i = 0; i < count && rc == 0; i++) {
+        if (snprintf(full, sizeof(full), "%s/%s", path, names[i]) >= (int)sizeof(full) ||
+            snprintf(rel, sizeof(rel), "%s%s%s", prefix, *prefix ? "/" : "", names[i]) >= (int)sizeof(rel)) {
+            rc = FS_ERR_INVALID;
+            FS_ERROR("bulk: path '%s/%s' is too long", path, names[i]);
+            break;
+        }
+        struct stat st;
+        if (lstat(full, &st) != 0) {
+            rc = FS_ERR_IO;
+            FS_ERROR("bulk: stat '%s': %s", full, strerror(errno));
+        } else if (S_ISDIR(st.st_mode)) {
+            rc = walk_dir(p, full, rel);
+        } else if (S_ISREG(st.st_mode)) {
+            BulkItem item;
+            if ((rc = check_name(rel)) == 0 &&
+                (rc = read_host_file(full, rel, st.st_mtime, (uint64_t)st.st_size, &item)) == 0)
+                rc = pipe_push(p, &item);            // 1: tüketici durdu, sessizce bitir
+        }
+        // Bağlantılar, aygıtlar vb. atlanır
+    }
+    for (size_t i = 0; i < count; i++) free(names[i]);
+    free(names);
+    return rc;
+}
+
+// ---------------------------------------------------------------------------
+// Tar (ustar) okuyucu
+// ---------------------------------------------------------------------------
+
+static uint64_t tar_get_octal(const uint8_t *f, size_t n) {
+    uint64_t v = 0;
+    size_t   i = 0;
+    while (i < n && f[i] == ' ') i++;
+    for (; i < n && f[i] >= '0' && f[i] <= '7'; i++) v = v * 8 + (uint64_t)(f[i] - '0');
+    return v;
+}
+
+static void tar_put_octal(uint8_t *f, size_t n, uint64_t v) {
+    f[n - 1] = '\0';
+    for (size_t i = n - 1; i-- > 0; v >>= 3) f[i] = (uint8_t)('0' + (v & 7));
+}
+
+static unsigned tar_checksum(const uint8_t *hdr) {
+    unsigned sum = 0;
+    for (int i = 0; i < TAR_BLOCK; i++)
+        sum += (i >= 148 && i < 156) ? (unsigned)' ' : hdr[i];
+    return sum;
+}
+
+static int tar_skip(int fd, uint64_t len) {
+    uint8_t buf[16 * TAR_BLOCK];
+    while (len) {
+        size_t  n = len < sizeof(buf) ? (size_t)len : sizeof(buf);
+        ssize_t r = read_full(fd, buf, n);
+        if (r != (ssize_t)n) FS_FAIL(FS_ERR_CORRUPT, "bulk: truncated tar stream");
+        len -= n;
+    }
+    return 0;
+}
+
+static int tar_read_all(BulkPipe *p) {
+    uint8_t hdr[TAR_BLOCK];
+    for (;;) {
+        ssize_t r = read_full(p->fd, hdr, TAR_BLOCK);
+        if (r == 0) return 0;                        // Son bloklar olmadan biten akış
+        if (r != TAR_BLOCK) FS_FAIL(FS_ERR_CORRUPT, "bulk: truncated tar header");
+
+        int zero = 1;
+        for (int i = 0; i < TAR_BLOCK && zero; i++) zero = hdr[i] == 0;
+        if (zero) return 0;
+
+        if (tar_get_octal(hdr + 148, 8) != tar_checksum(hdr))
+            FS_FAIL(FS_ERR_CORRUPT, "bulk: bad tar header checksum");
+
+        uint64_t size   = tar_get_octal(hdr + 124, 12);
+        uint64_t padded = (size + TAR_BLOCK - 1) / TAR_BLOCK * TAR_BLOCK;
+        uint8_t  type   = hdr[156];
+        if (type != '0' && type != '\0' && type != '7') {
+            // Dizinler, bağlantılar ve uzantı kayıtları atlanır
+            int rc = tar_skip(p->fd, padded);
+            if (rc < 0) return rc;
+            continue;
+        }
+
+        char full[257];                              // önek (155) + "/" + ad (100) + NUL
+        if (!memcmp(hdr + 257, "ustar", 5) && hdr[345])
+            snprintf(full, sizeof(full), "%.155s/%.100s", (const char *)hdr + 345, (const char *)hdr);
+        else
+            snprintf(full, sizeof(full), "%.100s", (const char *)hdr);
+        const char *name = full;
+        while (name[0] == '.' && name[1] == '/') name += 2;
+
+        int rc = check_name(name);
+        if (rc == 0) rc = check_size(name, size);
+        if (rc < 0) return rc;
+
+        BulkItem item;
+        memset(&item, 0, sizeof(item));
+        memcpy(item.name, name, strlen(name) + 1);
+        item.size  = (uint32_t)size;
+        item.mtime = (time_t)tar_get_octal(hdr + 136, 12);
+        if (!(item.data = malloc(size ? size : 1))) FS_FAIL(FS_ERR_NO_MEMORY, "bulk: out of memory");
+        if (read_full(p->fd, item.data, size) != (ssize_t)size) {
+            free(item.data);
+            FS_FAIL(FS_ERR_CORRUPT, "bulk: truncated tar entry '%s'", name);
+        }
+        if ((rc = tar_skip(p->fd, padded - size)) < 0) {
+            free(item.data);
+            return rc;
+        }
+        if ((rc = pipe_push(p, &item)) != 0) return rc < 0 ? rc : 0;
+    }
+}
+
+static void *reader_main(void *arg) {
+    BulkPipe *p  = arg;
+    int       rc = p->tar ? tar_read_all(p) : walk_dir(p, p->dir, "");
+    pthread_mutex_lock(&p->lock);
+    if (rc < 0 && p->err == 0) p->err = rc;
+    p->done = 1;
+    pthread_cond_broadcast(&p->changed);
+    pthread_mutex_unlock(&p->lock);
+    return NULL;
+}
+
+// ---------------------------------------------------------------------------
+// Yazıcılar
+// ---------------------------------------------------------------------------
+
+// İmajdaki ad ana makinede dizin dışına çıkmamalı
+static int safe_name(const char *name) {
+    if (name[0] == '/' || name[0] == '\0') return 0;
+    for (const char *s = name; *s; ) {
+        size_t n = strcspn(s, "/");
+        if (n == 0 || (n == 1 && s[0] == '.') || (n == 2 && s[0] == '.' && s[1] == '.'))
+            return 0;
+        s += n;
+        if (*s == '/') s++;
+    }
+    return 1;
+}
+
+static int write_host_file(BulkPipe *p, const BulkItem *item) {
+    if (!safe_name(item->name))
+        FS_FAIL(FS_ERR_INVALID, "bulk: refusing to export '%s' outside the directory", item->name);
+
+    char path[PATH_MAX];
+    int  len = snprintf(path, sizeof(path), "%s/%s", p->dir, item->name);
+    if (len >= (int)sizeof(path)) FS_FAIL(FS_ERR_INVALID, "bulk: path for '%s' is too long", item->name);
+
+    // Ara dizinleri oluştur
+    for (char *s = path + strlen(p->dir) + 1; (s = strchr(s, '/')) != NULL; s++) {
+        *s = '\0';
+        int rc = mkdir(path, 0777);
+        *s = '/';
+        if (rc != 0 && errno != EEXIST) FS_FAIL(FS_ERR_IO, "bulk: mkdir for '%s': %s", path, strerror(errno));
+    }
+
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (fd < 0) FS_FAIL(FS_ERR_IO, "bulk: create '%s': %s", path, strerror(errno));
+    int rc = write_full(fd, item->data, item->size);
+    if (close(fd) != 0 && rc == 0) rc = FS_ERR_IO;
+    if (rc < 0) FS_FAIL(rc, "bulk: write '%s' failed", path);
+    return 0;
+}
+
+static int write_tar_entry(BulkPipe *p, const BulkItem *item) {
+    static const uint8_t pad[TAR_BLOCK];
+    uint8_t hdr[TAR_BLOCK];
+    memset(hdr, 0, sizeof(hdr));
+    memcpy(hdr, item->name, strnlen(item->name, sizeof(item->name)));
+    tar_put_octal(hdr + 100, 8, 0644);
+    tar_put_octal(hdr + 108, 8, 0);
+    tar_put_octal(hdr + 116, 8, 0);
+    tar_put_octal(hdr + 124, 12, item->size);
+    tar_put_octal(hdr + 136, 12, item->mtime > 0 ? (uint64_t)item->mtime : 0);
+    hdr[156] = '0';
+    memcpy(hdr + 257, "ustar", 6);
+    memcpy(hdr + 263, "00", 2);
+    tar_put_octal(hdr + 148, 7, tar_checksum(hdr));
+    hdr[155] = ' ';
+
+    size_t tail = (TAR_BLOCK - item->size % TAR_BLOCK) % TAR_BLOCK;
+    if (write_full(p->fd, hdr, sizeof(hdr)) < 0 ||
+        write_full(p->fd, item->data, item->size) < 0 ||
+        write_full(p->fd, pad, tail) < 0)
+        FS_FAIL(FS_ERR_IO, "bulk: tar write for '%s' failed", item->name);
+    return 0;
+}
+
+static void *writer_main(void *arg) {
+    BulkPipe *p  = arg;
+    int       rc = 0;
+    BulkItem  item;
+    while (pipe_pop(p, &item) > 0) {
+        if (rc == 0) {
+            rc = p->tar ? write_tar_entry(p, &item) : write_host_file(p, &item);
+            if (rc < 0) {
+                // Üreticiyi hemen durdur; kalan öğeler yalnızca bırakılır
+                pthread_mutex_lock(&p->lock);
+                p->err      = rc;
+                p->stopping = 1;
+                pthread_cond_broadcast(&p->changed);
+                pthread_mutex_unlock(&p->lock);
+            }
+        }
+        free(item.data);
+    }
+    if (rc == 0 && p->tar) {
+        static const uint8_t end[2 * TAR_BLOCK];
+        if (write_full(p->fd, end, sizeof(end)) < 0) {
+            FS_ERROR("bulk: tar write failed");
+            pipe_fail(p, FS_ERR_IO);
+        }
+    }
+    return NULL;
+}
+
+// ---------------------------------------------------------------------------
+// Açma / kapama
+// ---------------------------------------------------------------------------
+
+static int pipe_open(int writer, int tar, int fd, const char *dir, BulkPipe **out) {
+    BulkPipe *p = calloc(1, sizeof(*p));
+    if (!p) FS_FAIL(FS_ERR_NO_MEMORY, "bulk: out of memory");
+    p->writer = writer;
+    p->tar    = tar;
+    p->fd     = fd;
+    if (dir) snprintf(p->dir, sizeof(p->dir), "%s", dir);
+    pthread_mutex_init(&p->lock, NULL);
+    pthread_cond_init(&p->changed, NULL);
+    if (pthread_create(&p->thread, NULL, writer ? writer_main : reader_main, p) != 0) {
+        pthread_cond_destroy(&p->changed);
+        pthread_mutex_destroy(&p->lock);
+        free(p);
+        FS_FAIL(FS_ERR_IO, "bulk: cannot start worker thread");
+    }
+    *out = p;
+    return 0;
+}
+
+int bulk_open_dir_reader(const char *dir, BulkPipe **out) {
+    struct stat st;
+    if (!dir || !out) FS_FAIL(FS_ERR_INVALID, "bulk: invalid arguments");
+    if (stat(dir, &st) != 0 || !S_ISDIR(st.st_mode))
+        FS_FAIL(FS_ERR_NOT_FOUND, "bulk: '%s' is not a directory", dir);
+    if (strlen(dir) >= PATH_MAX) FS_FAIL(FS_ERR_INVALID, "bulk: path '%s' is too long", dir);
+    return pipe_open(0, 0, -1, dir, out);
+}
+
+int bulk_open_tar_reader(int fd, BulkPipe **out) {
+    if (fd < 0 || !out) FS_FAIL(FS_ERR_INVALID, "bulk: invalid arguments");
+    return pipe_open(0, 1, fd, NULL, out);
+}
+
+int bulk_open_dir_writer(const char *dir, BulkPipe **out) {
+    if (!dir || !out) FS_FAIL(FS_ERR_INVALID, "bulk: invalid arguments");
+    if (strlen(dir) >= PATH_MAX) FS_FAIL(FS_ERR_INVALID, "bulk: path '%s' is too long", dir);
+    if (mkdir(dir, 0777) != 0 && errno != EEXIST)
+        FS_FAIL(FS_ERR_IO, "bulk: mkdir '%s': %s", dir, strerror(errno));
+    return pipe_open(1, 0, -1, dir, out);
+}
+
+int bulk_open_tar_writer(int fd, BulkPipe **out) {
+    if (fd < 0 || !out) FS_FAIL(FS_ERR_INVALID, "bulk: invalid arguments");
+    return pipe_open(1, 1, fd, NULL, out);
+}
+
+int bulk_next(BulkPipe *p, BulkItem *item) {
+    if (pipe_pop(p, item) > 0) return 1;
+    pthread_mutex_lock(&p->lock);
+    int err = p->err;
+    pthread_mutex_unlock(&p->lock);
+    return err;
+}
+
+int bulk_put(BulkPipe *p, BulkItem *item) {
+    pthread_mutex_lock(&p->lock);
+    int err = p->err;
+    pthread_mutex_unlock(&p->lock);
+    if (err < 0) {
+        free(item->data);
+        return err;
+    }
+    int rc = pipe_push(p, item);
+    if (rc < 0) return rc;
+    if (rc > 0) {
+        pthread_mutex_lock(&p->lock);
+        err = p->err;
+        pthread_mutex_unlock(&p->lock);
+        return err < 0 ? err : FS_ERR_IO;
+    }
+    item->data = NULL;
+    return 0;
+}
+
+int bulk_close(BulkPipe *p) {
+    if (!p) return 0;
+    pthread_mutex_lock(&p->lock);
+    if (p->writer) p->done = 1;           // Yazıcı kalan kuyruğu bitirir
+    else           p->stopping = 1;       // Okuyucu ilk fırsatta durur
+    pthread_cond_broadcast(&p->changed);
+    pthread_mutex_unlock(&p->lock);
+    pthread_join(p->thread, NULL);
+
+    pipe_drain(p);
+    int err = p->err;
+    pthread_cond_destroy(&p->changed);
+    pthread_mutex_destroy(&p->lock);
+    free(p);
+    return err;
+}
@@ -0,0 +1,38 @@
+#ifndef BULK_H
+#define BULK_H
+
+#include <stdint.h>     // uint8_t, uint32_t
+#include <time.h>       // time_t
+
+// Toplu içe/dışa aktarma boru hattı: ana makine tarafı (dizin ağacı veya tar
+// akışı) ayrı bir iş parçacığında okunur ya da yazılır, imaj tarafı çağıranda
+// kalır; ikisi arasında en fazla BULK_QUEUE_BYTES veri taşıyan bir kuyruk
+// vardır. Alt dizinlerdeki dosyalar imajda "dizin/dosya" adını alır; ad
+// FileEntry'ye sığmalıdır (31 karakter).
+#define BULK_QUEUE_BYTES (4 * 1024 * 1024)
+
+typedef struct {
+    char     name[32];          // İmajdaki ad
+    uint8_t *data;              // malloc ile ayrılmış içerik (size 0 ise NULL olabilir)
+    uint32_t size;
+    time_t   mtime;             // tar başlığı için
+} BulkItem;
+
+typedef struct BulkPipe BulkPipe;
+
+// Okuyucular: iş parçacığı dosyaları kuyruğa koyar, bulk_next sırayla alır
+int bulk_open_dir_reader(const char *dir, BulkPipe **out);
+int bulk_open_tar_reader(int fd, BulkPipe **out);
+int bulk_next(BulkPipe *p, BulkItem *item);   // 1: öğe (data çağıranın), 0: son, <0: FsError
+
+// Yazıcılar: bulk_put öğeyi kuyruğa koyar (data'nın sahipliği kuyruğa geçer),
+// iş parçacığı dizine dosya olarak ya da tar kaydı olarak yazar
+int bulk_open_dir_writer(const char *dir, BulkPipe **out);
+int bulk_open_tar_writer(int fd, BulkPipe **out);
+int bulk_put(BulkPipe *p, BulkItem *item);
+
+// Okuyucuyu durdurur / yazıcının kuyruğu bitirmesini bekler (tar sonu yazılır);
+// iş parçacığının ilk hatasını döndürür. fd kapatılmaz.
+int bulk_close(BulkPipe *p);
+
+#endif // BULK_H
@@ -0,0 +1,645 @@
+// cmd.c — batch/script modu için komut yorumlayıcısı
+//
+// Menüden farklı olarak hiçbir istem yazdırmaz: stdout'a yalnızca komut
+// sonuçları (okunan veri, ls satırları, boyutlar...) gider, hatalar stderr'e.
+#define _POSIX_C_SOURCE 200809L
+
+#include "cmd.h"
+#include "fs.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define CMD_MAX_ARGS 64
+
+typedef int (*cmd_fn)(int argc, char **argv);
+
+typedef struct {
+    const char *name;
+    int         min_args;     // komut adı hariç
+    int         max_args;     // -1 = sınırsız
+    cmd_fn      fn;
+    const char *usage;
+} Command;
+
+static int parse_u32(const char *s, uint32_t *out) {
+    char *end;
+    errno = 0;
+    unsigned long v = strtoul(s, &end, 0);
+    if (errno || end == s || *end || v > UINT32_MAX) {
+        fprintf(stderr, "invalid number: '%s'\n", s);
+        return -1;
+    }
+    *out = (uint32_t)v;
+    return 0;
+}
+
+// argv[first..argc) argümanlarını tek boşlukla birleştirir
+static char *join_args(int argc, char **argv, int first, size_t *len_out) {
+    size_t len = 0;
+    for (int i = first; i < argc; ++i) len += strlen(argv[i]) + 1;
+    char *data = malloc(len + 1);
+    if (!data) return NULL;
+    size_t pos = 0;
+    for (int i = first; i < argc; ++i) {
+        size_t n = strlen(argv[i]);
+        memcpy(data + pos, argv[i], n);
+        pos += n;
+        if (i + 1 < argc) data[pos++] = ' ';
+    }
+    data[pos] = '\0';
+    *len_out = pos;
+    return data;
+}
+
+// Dosyanın tamamını (veya bir aralığını) belleğe okur
+static char *read_file(const char *name, uint32_t offset, uint32_t *len) {
+    uint32_t size;
+    if (fs_size(name, &size) < 0) return NULL;
+    if (offset >= size) {
+        *len = 0;
+        return malloc(1);
+    }
+    if (*len == 0 || *len > size - offset) *len = size - offset;
+    char *buf = malloc(*len ? *len : 1);
+    if (!buf) {
+        perror("read: malloc");
+        return NULL;
+    }
+    ssize_t rd = fs_read(name, offset, *len, buf);
+    if (rd < 0) {
+        free(buf);
+        return NULL;
+    }
+    *len = (uint32_t)rd;
+    return buf;
+}
+
+static int c_create(int argc, char **argv) {
+    (void)argc;
+    if (fs_create(argv[1]) < 0) return -1;
+    fs_log("create", argv[1]);
+    return 0;
+}
+
+static int c_delete(int argc, char **argv) {
+    (void)argc;
+    if (fs_delete(argv[1]) < 0) return -1;
+    fs_log("delete", argv[1]);
+    return 0;
+}
+
+static int c_write(int argc, char **argv) {
+    size_t len;
+    char *data = join_args(argc, argv, 2, &len);
+    if (!data) return -1;
+    int rc = 0;
+    if (strcmp(argv[0], "append") == 0) {
+        rc = len ? (fs_append(argv[1], data, len) < 0 ? -1 : 0) : 0;
+    } else {
+        rc = fs_write(argv[1], data, len) < 0 ? -1 : 0;
+    }
+    free(data);
+    if (rc == 0) fs_log(argv[0], argv[1]);
+    return rc;
+}
+
+static int c_read(int argc, char **argv) {
+    uint32_t offset = 0, len = 0;
+    if (argc > 2 && parse_u32(argv[2], &offset) < 0) return -1;
+    if (argc > 3 && parse_u32(argv[3], &len) < 0) return -1;
+    char *buf = read_file(argv[1], offset, &len);
+    if (!buf) return -1;
+    fwrite(buf, 1, len, stdout);
+    free(buf);
+    fs_log("read", argv[1]);
+    return 0;
+}
+
+static int c_ls(int argc, char **argv) {
+    (void)argc; (void)argv;
+    static FileEntry entries[MAX_FILES];
+    int n = fs_list(entries, MAX_FILES);
+    if (n < 0) return -1;
+    for (int i = 0; i < n; ++i) {
+        printf("%s %u\n", entries[i].name, entries[i].size);
+    }
+    fs_log("ls", NULL);
+    return 0;
+}
+
+static int c_format(int argc, char **argv) {
+    uint32_t flags = 0;
+    if (argc > 1) {
+        if (strcmp(argv[1], "dedup") == 0) {
+            flags |= FS_FORMAT_DEDUP;
+        } else if (strcmp(argv[1], "inline") == 0) {
+            flags |= FS_FORMAT_INLINE;
+        } else if (strcmp(argv[1], "log") == 0) {
+            flags |= FS_FORMAT_LOG;
+        } else {
+            fprintf(stderr, "format: unknown mode '%s'\n", argv[1]);
+            return -1;
+        }
+    }
+    if (fs_format_mode(flags) < 0) return -1;
+    fs_log(flags & FS_FORMAT_DEDUP ? "format_dedup" : flags & FS_FORMAT_LOG ? "format_log"
+           : flags ? "format_inline" : "format", NULL);
+    return 0;
+}
+
+static int c_rename(int argc, char **argv) {
+    (void)argc;
+    if (fs_rename(argv[1], argv[2]) < 0) return -1;
+    fs_log("rename", argv[1]);
+    return 0;
+}
+
+static int c_copy(int argc, char **argv) {
+    (void)argc;
+    if (fs_copy(argv[1], argv[2]) < 0) return -1;
+    fs_log("copy", argv[1]);
+    return 0;
+}
+
+static int c_move(int argc, char **argv) {
+    (void)argc;
+    if (fs_mv(argv[1], argv[2]) < 0) return -1;
+    fs_log("move", argv[1]);
+    return 0;
+}
+
+static int c_exists(int argc, char **argv) {
+    (void)argc;
+    printf("%d\n", fs_exists(argv[1]));
+    fs_log("exists", argv[1]);
+    return 0;
+}
+
+static int c_size(int argc, char **argv) {
+    (void)argc;
+    uint32_t size;
+    if (fs_size(argv[1], &size) < 0) return -1;
+    printf("%u\n", size);
+    fs_log("size", argv[1]);
+    return 0;
+}
+
+static int c_truncate(int argc, char **argv) {
+    (void)argc;
+    uint32_t size;
+    if (parse_u32(argv[2], &size) < 0) return -1;
+    if (fs_truncate(argv[1], size) < 0) return -1;
+    fs_log("truncate", argv[1]);
+    return 0;
+}
+
+static int c_punch(int argc, char **argv) {
+    (void)argc;
+    uint32_t offset, len;
+    if (parse_u32(argv[2], &offset) < 0 || parse_u32(argv[3], &len) < 0) return -1;
+    if (fs_punch_hole(argv[1], offset, len) < 0) return -1;
+    fs_log("punch", argv[1]);
+    return 0;
+}
+
+// fallocate NAME OFFSET LEN [keep]
+static int c_fallocate(int argc, char **argv) {
+    uint32_t offset, len;
+    int flags = 0;
+    if (parse_u32(argv[2], &offset) < 0 || parse_u32(argv[3], &len) < 0) return -1;
+    if (argc > 4) {
+        if (strcmp(argv[4], "keep") != 0) {
+            fprintf(stderr, "fallocate: unknown mode '%s'\n", argv[4]);
+            return -1;
+        }
+        flags |= FS_FALLOC_KEEP_SIZE;
+    }
+    if (fs_fallocate(argv[1], offset, len, flags) < 0) return -1;
+    fs_log("fallocate", argv[1]);
+    return 0;
+}
+
+static int c_defrag(int argc, char **argv) {
+    (void)argc; (void)argv;
+    if (fs_defragment() < 0) return -1;
+    fs_log("defragment", NULL);
+    return 0;
+}
+
+static int c_sync(int argc, char **argv) {
+    (void)argc; (void)argv;
+    if (fs_sync() < 0) return -1;
+    fs_log("sync", NULL);
+    return 0;
+}
+
+static int c_check(int argc, char **argv) {
+    (void)argc; (void)argv;
+    if (fs_check_integrity() < 0) return -1;
+    fs_log("check_integrity", NULL);
+    return 0;
+}
+
+static int c_backup(int argc, char **argv) {
+    (void)argc;
+    if (fs_backup(argv[1]) < 0) return -1;
+    fs_log("backup", argv[1]);
+    return 0;
+}
+
+static int c_restore(int argc, char **argv) {
+    (void)argc;
+    if (fs_restore(argv[1]) < 0) return -1;
+    fs_log("restore", argv[1]);
+    return 0;
+}
+
+static int c_diff(int argc, char **argv) {
+    (void)argc;
+    int rc = fs_diff(argv[1], argv[2]);
+    if (rc < 0) return -1;
+    fs_log("diff", argv[1]);
+    return 0;
+}
+
+// Host dosyasını imaja aktarır (varsa üzerine yazılır)
+static int c_import(int argc, char **argv) {
+    (void)argc;
+    const char *host = argv[1], *name = argv[2];
+    FILE *f = fopen(host, "rb");
+    if (!f) {
+        perror("import: fopen");
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fileno(f), &st) < 0 || st.st_size > DATA_SIZE) {
+        fprintf(stderr, "import: '%s' is too large for the disk\n", host);
+        fclose(f);
+        return -1;
+    }
+    size_t len = (size_t)st.st_size;
+    char *buf = malloc(len ? len : 1);
+    if (!buf || fread(buf, 1, len, f) != len) {
+        fprintf(stderr, "import: cannot read '%s'\n", host);
+        free(buf);
+        fclose(f);
+        return -1;
+    }
+    fclose(f);
+
+    int rc = fs_exists(name) ? fs_truncate(name, 0) : fs_create(name);
+    if (rc == 0 && len && fs_write(name, buf, len) != (ssize_t)len) rc = -1;
+    free(buf);
+    if (rc == 0) fs_log("import", name);
+    return rc;
+}
+
+// İmajdaki dosyayı host dosyasına aktarır
+static int c_export(int argc, char **argv) {
+    (void)argc;
+    const char *name = argv[1], *host = argv[2];
+    uint32_t len = 0;
+    char *buf = read_file(name, 0, &len);
+    if (!buf) return -1;
+    FILE *f = fopen(host, "wb");
+    if (!f) {
+        perror("export: fopen");
+        free(buf);
+        return -1;
+    }
+    int rc = (fwrite(buf, 1, len, f) == len) ? 0 : -1;
+    if (fclose(f) != 0) rc = -1;
+    free(buf);
+    if (rc < 0) fprintf(stderr, "export: cannot write '%s'\n", host);
+    else fs_log("export", name);
+    return rc;
+}
+
+// import-dir DIR / export-dir DIR
+static int c_bulk_dir(int argc, char **argv) {
+    (void)argc;
+    int export = strcmp(argv[0], "export-dir") == 0;
+    int n = export ? fs_export_dir(argv[1]) : fs_import_dir(argv[1]);
+    if (n < 0) return -1;
+    fs_log(argv[0], argv[1]);
+    return 0;
+}
+
+// import-tar FILE|- / export-tar FILE|-   ("-": stdin / stdout)
+static int c_bulk_tar(int argc, char **argv) {
+    (void)argc;
+    int export = strcmp(argv[0], "export-tar") == 0;
+    int std = strcmp(argv[1], "-") == 0;
+    int fd;
+    if (std) {
+        fflush(stdout);
+        fd = export ? 1 : 0;
+    } else {
+        fd = export ? open(argv[1], O_WRONLY | O_CREAT | O_TRUNC, 0666) : open(argv[1], O_RDONLY);
+        if (fd < 0) {
+            perror(argv[0]);
+            return -1;
+        }
+    }
+    int n = export ? fs_export_tar(fd) : fs_import_tar(fd);
+    if (!std && close(fd) != 0 && n >= 0) {
+        perror(argv[0]);
+        n = -1;
+    }
+    if (n < 0) return -1;
+    fs_log(argv[0], argv[1]);
+    return 0;
+}
+
+static int c_dedup_stats(int argc, char **argv) {
+    (void)argc; (void)argv;
+    return fs_dedup_report();
+}
+
+static int c_lfs_stats(int argc, char **argv) {
+    (void)argc; (void)argv;
+    return fs_lfs_report();
+}
+
+// stats [on|off|reset|json [FILE]]
+static int c_stats(int argc, char **argv) {
+    if (argc == 1) return fs_stats_report();
+    if (strcmp(argv[1], "on") == 0)    { fs_stats_enable(1); return 0; }
+    if (strcmp(argv[1], "off") == 0)   { fs_stats_enable(0); return 0; }
+    if (strcmp(argv[1], "reset") == 0) { fs_stats_reset(); return 0; }
+    if (strcmp(argv[1], "json") == 0)  return fs_stats_dump_json(argc > 2 ? argv[2] : NULL);
+    fprintf(stderr, "stats: unknown subcommand '%s'\n", argv[1]);
+    return -1;
+}
+
+// trace start FILE | trace stop
+static int c_trace(int argc, char **argv) {
+    if (strcmp(argv[1], "start") == 0 && argc == 3) return fs_trace_start(argv[2]);
+    if (strcmp(argv[1], "stop") == 0 && argc == 2)  return fs_trace_stop();
+    fprintf(stderr, "usage: trace start FILE | trace stop\n");
+    return -1;
+}
+
+static int c_space(int argc, char **argv) {
+    (void)argc; (void)argv;
+    return fs_space_report();
+}
+
+// alloc [POLICY]: politikayı göster / seç
+static int c_alloc(int argc, char **argv) {
+    if (argc == 1) {
+        printf("%s\n", alloc_policy_name(fs_alloc_policy()));
+        return 0;
+    }
+    int p = alloc_policy_parse(argv[1]);
+    if (p < 0) {
+        fprintf(stderr, "alloc: unknown policy '%s' (first-fit, best-fit, next-fit, size-class)\n", argv[1]);
+        return -1;
+    }
+    return fs_set_alloc_policy((AllocPolicy)p);
+}
+
+// stripe [BLOCKS]: şerit parçası; sonraki format/restore'da uygulanır
+static int c_stripe(int argc, char **argv) {
+    if (argc == 1) {
+        printf("%d device(s), stripe %u blocks\n", disk_devices(), disk_stripe_blocks());
+        return 0;
+    }
+    uint32_t blocks;
+    if (parse_u32(argv[1], &blocks) < 0) return -1;
+    return disk_set_stripe_width(blocks);
+}
+
+// tier [KB]: bellek katmanı sınırı (0 = kapalı)
+static int c_tier(int argc, char **argv) {
+    if (argc == 1) {
+        MemTierStats ts;
+        fs_tier_stats(&ts);
+        printf("memory tier: %llu KB limit, %u files resident (%llu KB)\n",
+               (unsigned long long)(ts.limit / 1024), ts.resident,
+               (unsigned long long)(ts.resident_bytes / 1024));
+        return 0;
+    }
+    uint32_t kb;
+    if (parse_u32(argv[1], &kb) < 0) return -1;
+    return fs_tier_set_limit((uint64_t)kb * 1024);
+}
+
+// resize KB: imajın toplam boyutu (metadata dahil)
+static int c_resize(int argc, char **argv) {
+    (void)argc;
+    uint32_t kb;
+    if (parse_u32(argv[1], &kb) < 0) return -1;
+    if (kb > UINT32_MAX / 1024) {
+        fprintf(stderr, "resize: %u KB is too large\n", kb);
+        return -1;
+    }
+    return fs_resize(kb * 1024);
+}
+
+// trim [on|off]: toplu delme; argümansız sayaçları gösterir
+static int c_trim(int argc, char **argv) {
+    if (argc == 1) {
+        TrimStats ts;
+        fs_trim_stats(&ts);
+        printf("trim: %s, %llu blocks freed, %llu punched in %llu calls, %llu cancelled, %u pending\n",
+               trim_batching() ? "batched" : "immediate", (unsigned long long)ts.queued,
+               (unsigned long long)ts.punched, (unsigned long long)ts.punch_calls,
+               (unsigned long long)ts.cancelled, ts.pending);
+        return 0;
+    }
+    if (strcmp(argv[1], "on") != 0 && strcmp(argv[1], "off") != 0) {
+        fprintf(stderr, "trim: expected on or off\n");
+        return -1;
+    }
+    fs_trim_batch_enable(strcmp(argv[1], "on") == 0);
+    return 0;
+}
+
+// delalloc on|off
+static int c_delalloc(int argc, char **argv) {
+    (void)argc;
+    if (strcmp(argv[1], "on") != 0 && strcmp(argv[1], "off") != 0) {
+        fprintf(stderr, "delalloc: expected on or off\n");
+        return -1;
+    }
+    return fs_delayed_alloc_enable(strcmp(argv[1], "on") == 0);
+}
+
+// direct on|off
+static int c_direct(int argc, char **argv) {
+    (void)argc;
+    if (strcmp(argv[1], "on") != 0 && strcmp(argv[1], "off") != 0) {
+        fprintf(stderr, "direct: expected on or off\n");
+        return -1;
+    }
+    return fs_direct_io_enable(strcmp(argv[1], "on") == 0);
+}
+
+static int c_log(int argc, char **argv) {
+    (void)argc; (void)argv;
+    return oplog_export(stdout);
+}
+
+static int c_help(int argc, char **argv) {
+    (void)argc; (void)argv;
+    cmd_print_help(stdout);
+    return 0;
+}
+
+static const Command commands[] = {
+    { "create",      1, 1,  c_create,      "create NAME" },
+    { "rm",          1, 1,  c_delete,      "rm NAME" },
+    { "delete",      1, 1,  c_delete,      "delete NAME" },
+    { "write",       1, -1, c_write,       "write NAME DATA..." },
+    { "append",      2, -1, c_write,       "append NAME DATA..." },
+    { "read",        1, 3,  c_read,        "read NAME [OFFSET [SIZE]]" },
+    { "cat",         1, 1,  c_read,        "cat NAME" },
+    { "ls",          0, 0,  c_ls,          "ls" },
+    { "format",      0, 1,  c_format,      "format [dedup|inline|log]" },
+    { "rename",      2, 2,  c_rename,      "rename OLD NEW" },
+    { "cp",          2, 2,  c_copy,        "cp SRC DST" },
+    { "mv",          2, 2,  c_move,        "mv SRC DST" },
+    { "exists",      1, 1,  c_exists,      "exists NAME" },
+    { "size",        1, 1,  c_size,        "size NAME" },
+    { "truncate",    2, 2,  c_truncate,    "truncate NAME SIZE" },
+    { "punch",       3, 3,  c_punch,       "punch NAME OFFSET LEN" },
+    { "fallocate",   3, 4,  c_fallocate,   "fallocate NAME OFFSET LEN [keep]" },
+    { "defrag",      0, 0,  c_defrag,      "defrag" },
+    { "check",       0, 0,  c_check,       "check" },
+    { "sync",        0, 0,  c_sync,        "sync" },
+    { "backup",      1, 1,  c_backup,      "backup HOSTFILE" },
+    { "restore",     1, 1,  c_restore,     "restore HOSTFILE" },
+    { "diff",        2, 2,  c_diff,        "diff A B" },
+    { "import",      2, 2,  c_import,      "import HOSTFILE NAME" },
+    { "export",      2, 2,  c_export,      "export NAME HOSTFILE" },
+    { "import-dir",  1, 1,  c_bulk_dir,    "import-dir HOSTDIR" },
+    { "export-dir",  1, 1,  c_bulk_dir,    "export-dir HOSTDIR" },
+    { "import-tar",  1, 1,  c_bulk_tar,    "import-tar HOSTFILE|-" },
+    { "export-tar",  1, 1,  c_bulk_tar,    "export-tar HOSTFILE|-" },
+    { "dedup-stats", 0, 0,  c_dedup_stats, "dedup-stats" },
+    { "lfs-stats",   0, 0,  c_lfs_stats,   "lfs-stats" },
+    { "stats",       0, 2,  c_stats,       "stats [on|off|reset|json [FILE]]" },
+    { "trace",       1, 2,  c_trace,       "trace start FILE | trace stop" },
+    { "space",       0, 0,  c_space,       "space" },
+    { "alloc",       0, 1,  c_alloc,       "alloc [first-fit|best-fit|next-fit|size-class]" },
+    { "stripe",      0, 1,  c_stripe,      "stripe [BLOCKS]" },
+    { "tier",        0, 1,  c_tier,        "tier [KB]" },
+    { "resize",      1, 1,  c_resize,      "resize KB" },
+    { "trim",        0, 1,  c_trim,        "trim [on|off]" },
+    { "delalloc",    1, 1,  c_delalloc,    "delalloc on|off" },
+    { "direct",      1, 1,  c_direct,      "direct on|off" },
+    { "log",         0, 0,  c_log,         "log" },
+    { "help",        0, 0,  c_help,        "help" },
+};
+
+#define COMMAND_COUNT (sizeof(commands) / sizeof(commands[0]))
+
+void cmd_print_help(FILE *out) {
+    fprintf(out, "Commands:\n");
+    for (size_t i = 0; i < COMMAND_COUNT; ++i) {
+        fprintf(out, "  %s\n", commands[i].usage);
+    }
+}
+
+static int execute(int argc, char **argv) {
+    for (size_t i = 0; i < COMMAND_COUNT; ++i) {
+        const Command *c = &commands[i];
+        if (strcmp(c->name, argv[0]) != 0) continue;
+        int nargs = argc - 1;
+        if (nargs < c->min_args || (c->max_args >= 0 && nargs > c->max_args)) {
+            fprintf(stderr, "usage: %s\n", c->usage);
+            return -1;
+        }
+        return c->fn(argc, argv);
+    }
+    fprintf(stderr, "unknown command: '%s'\n", argv[0]);
+    return -1;
+}
+
+int cmd_run_line(const char *line, int flags) {
+    size_t len = strlen(line);
+    char *scratch = malloc(len + 1);
+    if (!scratch) {
+        perror("cmd_run_line: malloc");
+        return 1;
+    }
+
+    char *argv[CMD_MAX_ARGS + 1];
+    int argc = 0, failures = 0;
+    char *out = scratch;
+    const char *p = line;
+
+    for (;;) {
+        while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') p++;
+        int comment = (flags & CMD_COMMENTS) && *p == '#' && (p == line || p[-1] == ' ' || p[-1] == '\t');
+        if (*p == '\0' || *p == ';' || comment) {
+            if (argc > 0) {
+                argv[argc] = NULL;
+                if (execute(argc, argv) < 0) {
+                    failures++;
+                    if (flags & CMD_STOP_ON_ERROR) break;
+                }
+                argc = 0;
+                out = scratch;
+            }
+            if (*p == ';') { p++; continue; }
+            break;
+        }
+
+        // Bir argüman topla (tırnaklar ve \ kaçışları desteklenir)
+        char *arg = out;
+        char quote = 0;
+        while (*p && (quote || (*p != ' ' && *p != '\t' && *p != '\r' &&
+                                *p != '\n' && *p != ';'))) {
+            if (quote && *p == quote) { quote = 0; p++; continue; }
+            if (!quote && (*p == '"' || *p == '\'')) { quote = *p++; continue; }
+            if (*p == '\\' && quote != '\'' && p[1]) {
+                p++;
+                *out++ = (*p == 'n') ? '\n' : (*p == 't') ? '\t' : *p;
+                p++;
+                continue;
+            }
+            *out++ = *p++;
+        }
+        *out++ = '\0';
+        if (argc == CMD_MAX_ARGS) {
+            fprintf(stderr, "too many arguments\n");
+            failures++;
+            if (flags & CMD_STOP_ON_ERROR) break;
+            argc = 0;
+            out = scratch;
+            while (*p && *p != ';') p++;
+            continue;
+        }
+        argv[argc++] = arg;
+    }
+
+    free(scratch);
+    return failures;
+}
+
+int cmd_run_stream(FILE *in, int stop_on_error) {
+    char *line = NULL;
+    size_t cap = 0;
+    int failures = 0;
+    unsigned long lineno = 0;
+
+    while (getline(&line, &cap, in) != -1) {
+        lineno++;
+        int f = cmd_run_line(line, CMD_COMMENTS | (stop_on_error ? CMD_STOP_ON_ERROR : 0));
+        if (f) {
+            failures += f;
+            fprintf(stderr, "line %lu: command failed\n", lineno);
+            if (stop_on_error) break;
+        }
+    }
+    free(line);
+    return failures;
+}
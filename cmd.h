@@ -0,0 +1,25 @@
+#ifndef CMD_H
+#define CMD_H
+
+#include <stdio.h>      // FILE
+
+// Metin komut yorumlayıcısı (batch/script modu)
+// Bir satır ';' ile ayrılmış birden fazla komut içerebilir. Argümanlar boşlukla
+// ayrılır, "..." veya '...' ile tırnaklanabilir.
+
+// cmd_run_line bayrakları
+#define CMD_COMMENTS      1   // Betik satırı: satır başında ya da boşluktan sonra '#' yorumdur
+#define CMD_STOP_ON_ERROR 2   // İlk başarısız komuttan sonraki komutlar çalıştırılmaz
+
+// Tek bir satırı çalıştır; başarısız komut sayısını döner. -c argümanı
+// CMD_COMMENTS olmadan çalışır: '#' sıradan bir karakterdir.
+int cmd_run_line(const char *line, int flags);
+
+// Akıştaki tüm satırları çalıştır; stop_on_error ise ilk hatada durur.
+// Başarısız komut sayısını döner
+int cmd_run_stream(FILE *in, int stop_on_error);
+
+// Desteklenen komutların listesini yazdır
+void cmd_print_help(FILE *out);
+
+#endif // CMD_H
@@ -0,0 +1,289 @@
+// dedup.c — içerik adresli blok tekilleştirme
+//
+// Dosya sistemi mantıksal blok adresleriyle çalışmaya devam eder; bu katman
+// her mantıksal bloğu bir fiziksel bloğa eşler. Yazılan her blok hızlı bir
+// 64-bit özetle parmak izi alır; aynı içerik daha önce yazılmışsa mevcut
+// fiziksel blok referans sayacı artırılarak paylaşılır. Tamamen sıfır bloklar
+// hiç yer tutmaz (eşlenmemiş blok sıfır okunur).
+#include "dedup.h"
+#include "disk.h"
+#include "trim.h"
+#include "fserr.h"
+
+#include <stdlib.h>     // calloc, free
+#include <string.h>     // memcmp, memset
+
+#define PHYS_FIRST      DEDUP_MAP_BLOCKS          // İlk kullanılabilir veri bloğu
+#define INDEX_CAPACITY  4096                      // 2'nin kuvveti, >= 2 * DATA_BLOCKS
+
+typedef struct {
+    uint64_t hash;
+    uint32_t pblock;          // 0 = boş yuva
+} IndexSlot;
+
+static int        loaded = 0;
+static uint32_t  *map;                    // mantıksal -> fiziksel (diskteki tablo ile aynı düzen)
+static uint32_t  *refcnt;                 // fiziksel blok referans sayaçları
+static uint64_t  *phash;                  // fiziksel bloğun parmak izi
+static IndexSlot *index_tab;              // parmak izi -> fiziksel blok
+static uint32_t   index_count;
+static uint8_t    map_dirty[DEDUP_MAP_BLOCKS];
+static uint32_t   alloc_cursor = PHYS_FIRST;
+
+// 8 baytlık kelimeler üzerinde çalışan hızlı, çarpma tabanlı özet
+static uint64_t block_hash(const void *data) {
+    const uint8_t *p = data;
+    uint64_t h = 0x9E3779B97F4A7C15ull;
+    for (size_t i = 0; i < BLOCK_SIZE; i += 8) {
+        uint64_t w;
+        memcpy(&w, p + i, sizeof(w));
+        h ^= w * 0xC2B2AE3D27D4EB4Full;
+        h = (h << 31) | (h >> 33);
+        h *= 0x9E3779B185EBCA87ull;
+    }
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    return h;
+}
+
+static int block_is_zero(const void *data) {
+    const uint8_t *p = data;
+    for (size_t i = 0; i < BLOCK_SIZE; i += 8) {
+        uint64_t w;
+        memcpy(&w, p + i, sizeof(w));     // Tampon hizalı olmayabilir
+        if (w) return 0;
+    }
+    return 1;
+}
+
+static uint32_t slot_home(uint64_t hash) {
+    return (uint32_t)hash & (INDEX_CAPACITY - 1);
+}
+
+static void index_insert(uint64_t hash, uint32_t pblock) {
+    uint32_t i = slot_home(hash);
+    while (index_tab[i].pblock) i = (i + 1) & (INDEX_CAPACITY - 1);
+    index_tab[i].hash = hash;
+    index_tab[i].pblock = pblock;
+    index_count++;
+}
+
+// Doğrusal yoklamada mezar taşı bırakmadan silme (geri kaydırma)
+static void index_remove(uint32_t pblock) {
+    uint32_t i = slot_home(phash[pblock]);
+    while (index_tab[i].pblock && index_tab[i].pblock != pblock) {
+        i = (i + 1) & (INDEX_CAPACITY - 1);
+    }
+    if (!index_tab[i].pblock) return;
+
+    uint32_t j = i;
+    for (;;) {
+        j = (j + 1) & (INDEX_CAPACITY - 1);
+        if (!index_tab[j].pblock) break;
+        uint32_t k = slot_home(index_tab[j].hash);
+        int movable = (j > i) ? (k <= i || k > j) : (k <= i && k > j);
+        if (movable) {
+            index_tab[i] = index_tab[j];
+            i = j;
+        }
+    }
+    index_tab[i].pblock = 0;
+    index_count--;
+}
+
+// Aynı özete ve aynı içeriğe sahip fiziksel bloğu bul (çakışmaya karşı doğrulanır)
+static uint32_t index_find(uint64_t hash, const void *data) {
+    uint8_t cand[BLOCK_SIZE];
+    uint32_t i = slot_home(hash);
+    while (index_tab[i].pblock) {
+        if (index_tab[i].hash == hash) {
+            uint32_t pb = index_tab[i].pblock;
+            if (disk_phys_read(pb, 1, cand) == 0 && memcmp(cand, data, BLOCK_SIZE) == 0) {
+                return pb;
+            }
+        }
+        i = (i + 1) & (INDEX_CAPACITY - 1);
+    }
+    return 0;
+}
+
+static uint32_t alloc_pblock(void) {
+    for (uint32_t n = 0; n < DATA_BLOCKS - PHYS_FIRST; ++n) {
+        uint32_t pb = alloc_cursor;
+        alloc_cursor = (alloc_cursor + 1 < DATA_BLOCKS) ? alloc_cursor + 1 : PHYS_FIRST;
+        if (refcnt[pb] == 0) return pb;
+    }
+    return 0;
+}
+
+// Referansı kalmayan fiziksel blok imajda delinmeye bırakılır
+static void release_pblock(uint32_t pblock) {
+    if (!pblock) return;
+    if (--refcnt[pblock] == 0) {
+        index_remove(pblock);
+        trim_queue(pblock, 1);
+    }
+}
+
+static void set_map(uint32_t lba, uint32_t pblock) {
+    map[lba] = pblock;
+    map_dirty[lba / DEDUP_MAP_ENTRIES_PER_BLOCK] = 1;
+}
+
+int dedup_is_loaded(void) {
+    return loaded;
+}
+
+void dedup_unload(void) {
+    free(map);
+    free(refcnt);
+    free(phash);
+    free(index_tab);
+    map = NULL;
+    refcnt = NULL;
+    phash = NULL;
+    index_tab = NULL;
+    index_count = 0;
+    alloc_cursor = PHYS_FIRST;
+    memset(map_dirty, 0, sizeof(map_dirty));
+    loaded = 0;
+}
+
+int dedup_load(void) {
+    if (loaded) return 0;
+
+    map       = calloc(DEDUP_MAP_BLOCKS, BLOCK_SIZE);
+    refcnt    = calloc(DATA_BLOCKS, sizeof(*refcnt));
+    phash     = calloc(DATA_BLOCKS, sizeof(*phash));
+    index_tab = calloc(INDEX_CAPACITY, sizeof(*index_tab));
+    uint8_t *data = malloc((size_t)(DATA_BLOCKS - PHYS_FIRST) * BLOCK_SIZE);
+    if (!map || !refcnt || !phash || !index_tab || !data) {
+        free(data);
+        dedup_unload();
+        FS_FAIL(FS_ERR_NO_MEMORY, "dedup_load: calloc");
+    }
+
+    int rc;
+    if ((rc = disk_phys_read(0, DEDUP_MAP_BLOCKS, map)) < 0 ||
+        (rc = disk_phys_read(PHYS_FIRST, DATA_BLOCKS - PHYS_FIRST, data)) < 0) {
+        free(data);
+        dedup_unload();
+        FS_FAIL(rc, "dedup_load: block map read failed");
+    }
+
+    for (uint32_t lba = 0; lba < DATA_BLOCKS; ++lba) {
+        uint32_t pb = map[lba];
+        if (!pb) continue;
+        if (pb < PHYS_FIRST || pb >= DATA_BLOCKS) {
+            free(data);
+            dedup_unload();
+            FS_FAIL(FS_ERR_CORRUPT, "dedup_load: corrupt map entry %u -> %u", lba, pb);
+        }
+        if (refcnt[pb]++ == 0) {
+            phash[pb] = block_hash(data + (size_t)(pb - PHYS_FIRST) * BLOCK_SIZE);
+            index_insert(phash[pb], pb);
+        }
+    }
+    free(data);
+    loaded = 1;
+    return 0;
+}
+
+int dedup_read_block(uint32_t lba, void *buffer) {
+    if (lba >= DATA_BLOCKS) return FS_ERR_RANGE;
+    uint32_t pb = map[lba];
+    if (!pb) {
+        memset(buffer, 0, BLOCK_SIZE);
+        return 0;
+    }
+    return disk_phys_read(pb, 1, buffer);
+}
+
+int dedup_write_block(uint32_t lba, const void *buffer) {
+    if (lba >= DATA_BLOCKS) return FS_ERR_RANGE;
+    uint32_t old = map[lba];
+
+    if (block_is_zero(buffer)) {
+        if (old) {
+            release_pblock(old);
+            set_map(lba, 0);
+        }
+        return 0;
+    }
+
+    uint64_t h = block_hash(buffer);
+    uint32_t pb = index_find(h, buffer);
+    if (pb) {
+        if (pb == old) return 0;
+        refcnt[pb]++;
+    } else if (old && refcnt[old] == 1) {
+        // Blok yalnızca bize ait: yerinde üzerine yaz
+        index_remove(old);
+        int rc = disk_phys_write(old, 1, buffer);
+        if (rc < 0) return rc;
+        phash[old] = h;
+        index_insert(h, old);
+        return 0;
+    } else {
+        pb = alloc_pblock();
+        if (!pb) FS_FAIL(FS_ERR_NO_SPACE, "dedup_write_block: no free physical blocks");
+        int rc = disk_phys_write(pb, 1, buffer);
+        if (rc < 0) return rc;
+        refcnt[pb] = 1;
+        phash[pb] = h;
+        index_insert(h, pb);
+    }
+
+    release_pblock(old);
+    set_map(lba, pb);
+    return 0;
+}
+
+int dedup_discard(uint32_t lba, uint32_t count) {
+    for (uint32_t i = 0; i < count && lba + i < DATA_BLOCKS; ++i) {
+        if (map[lba + i]) {
+            release_pblock(map[lba + i]);
+            set_map(lba + i, 0);
+        }
+    }
+    return 0;
+}
+
+int dedup_is_mapped(uint32_t lba) {
+    return lba < DATA_BLOCKS && map[lba] != 0;
+}
+
+int dedup_flush(void) {
+    for (uint32_t b = 0; b < DEDUP_MAP_BLOCKS; ++b) {
+        if (!map_dirty[b]) continue;
+        int rc = disk_phys_write(b, 1, (uint8_t *)map + (size_t)b * BLOCK_SIZE);
+        if (rc < 0) FS_FAIL(rc, "dedup_flush: map block %u write failed", b);
+        map_dirty[b] = 0;
+    }
+    return 0;
+}
+
+void dedup_get_stats(DedupStats *out) {
+    memset(out, 0, sizeof(*out));
+    out->physical_total = DATA_BLOCKS - PHYS_FIRST;
+    out->index_capacity = INDEX_CAPACITY;
+    out->index_memory   = INDEX_CAPACITY * sizeof(IndexSlot) + DATA_BLOCKS * sizeof(*phash);
+    out->total_memory   = out->index_memory
+                        + (size_t)DEDUP_MAP_BLOCKS * BLOCK_SIZE
+                        + DATA_BLOCKS * sizeof(*refcnt);
+    if (!loaded) return;
+
+    for (uint32_t lba = 0; lba < DATA_BLOCKS; ++lba) {
+        if (map[lba]) out->logical_blocks++;
+    }
+    for (uint32_t pb = PHYS_FIRST; pb < DATA_BLOCKS; ++pb) {
+        if (refcnt[pb]) out->physical_blocks++;
+        if (refcnt[pb] > 1) out->shared_blocks++;
+    }
+    out->index_entries = index_count;
+    out->saved_bytes = (uint64_t)(out->logical_blocks - out->physical_blocks) * BLOCK_SIZE;
+    out->dedup_ratio = out->physical_blocks
+                     ? (double)out->logical_blocks / out->physical_blocks
+                     : 1.0;
+}
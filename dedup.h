@@ -0,0 +1,40 @@
+#ifndef DEDUP_H
+#define DEDUP_H
+
+#include <stdint.h>     // uint32_t, uint64_t
+#include <stddef.h>     // size_t
+#include "disk.h"       // BLOCK_SIZE, DATA_BLOCKS
+
+// Mantıksal -> fiziksel blok eşleme tablosu, veri bölgesinin ilk
+// DEDUP_MAP_BLOCKS fiziksel bloğunda tutulur. Girdi 0 = eşlenmemiş blok
+// (fiziksel 0. blok tablonun kendisine ait olduğu için hiçbir zaman veri değildir).
+#define DEDUP_MAP_ENTRIES_PER_BLOCK (BLOCK_SIZE / sizeof(uint32_t))
+#define DEDUP_MAP_BLOCKS \
+    ((DATA_BLOCKS + DEDUP_MAP_ENTRIES_PER_BLOCK - 1) / DEDUP_MAP_ENTRIES_PER_BLOCK)
+
+typedef struct {
+    uint32_t logical_blocks;    // Eşlenmiş mantıksal blok sayısı
+    uint32_t physical_blocks;   // Kullanılan fiziksel veri bloğu
+    uint32_t physical_total;    // Kullanılabilir fiziksel veri bloğu
+    uint32_t shared_blocks;     // Birden fazla mantıksal blokça paylaşılan fiziksel blok
+    uint64_t saved_bytes;       // Tekilleştirme ile kazanılan alan
+    double   dedup_ratio;       // mantıksal / fiziksel
+    uint32_t index_entries;     // Parmak izi indeksindeki kayıt sayısı
+    uint32_t index_capacity;    // İndeks tablosunun yuva sayısı
+    size_t   index_memory;      // Parmak izi indeksinin bellek maliyeti (byte)
+    size_t   total_memory;      // İndeks + eşleme + referans sayaçları (byte)
+} DedupStats;
+
+int  dedup_load(void);                                  // Eşleme tablosunu oku, indeksi kur
+void dedup_unload(void);                                // Bellekteki durumu bırak
+int  dedup_is_loaded(void);
+
+int  dedup_read_block(uint32_t lba, void *buffer);      // Eşlenmemiş blok sıfır okunur
+int  dedup_write_block(uint32_t lba, const void *buffer);
+int  dedup_discard(uint32_t lba, uint32_t count);       // Referansları bırak, boşalan blokları geri kazan
+int  dedup_is_mapped(uint32_t lba);                     // 0 = delik (sıfır okunur)
+int  dedup_flush(void);                                 // Kirli eşleme bloklarını diske yaz
+
+void dedup_get_stats(DedupStats *out);
+
+#endif // DEDUP_H
@@ -0,0 +1,217 @@
+// dio.c — doğrudan G/Ç için hizalı tampon havuzu ve istek biçimlendirme
+//
+// Havuz tek bir posix_memalign bölgesidir, ilk dio_buf_get'te ayrılır ve
+// program sonuna kadar tutulur (çıkışta memtier_flush hâlâ kullanabilir);
+// boş tamponlar bir yığında durur. Bir çağrı aynı anda en fazla bir tampon
+// tutar ve tamponu tutarken başka bir tampon beklemez, bu yüzden şeritleme
+// iş parçacıkları havuzdan fazla olsa da kilitlenme olmaz.
+//
+// Hizalı olmayan bir istek DIO_BUF_SIZE'lık parçalara bölünür: okumada parçayı
+// kapsayan hizalı aralık okunup istenen kısım kopyalanır; yazımda yarım kalan
+// baş ve son birimler önce okunur, sonra hizalı aralığın tamamı yazılır. Son
+// birim dosya sonunu aşıyorsa sonu sıfırla doldurulur ve dosya bir sonraki
+// hizalama sınırına kadar uzayabilir.
+#define _GNU_SOURCE             // preadv/pwritev
+
+#include "dio.h"
+#include "stats.h"
+
+#include <errno.h>
+#include <limits.h>     // IOV_MAX
+#include <pthread.h>
+#include <stdlib.h>     // posix_memalign
+#include <string.h>
+#include <unistd.h>     // pread, pwrite
+
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
+#define ADD(var, n) __atomic_fetch_add(&(var), (n), __ATOMIC_RELAXED)
+
+static int      enabled;
+static uint8_t *pool;                       // DIO_POOL_BUFS * DIO_BUF_SIZE bayt
+static uint8_t *free_bufs[DIO_POOL_BUFS];
+static int      nfree = -1;                 // -1: havuz henüz ayrılmadı
+static DioStats st;
+
+static pthread_mutex_t lock  = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  avail = PTHREAD_COND_INITIALIZER;
+
+int dio_enabled(void) {
+    return enabled;
+}
+
+void dio_set_enabled(int on) {
+    enabled = on ? 1 : 0;
+}
+
+void *dio_buf_get(void) {
+    pthread_mutex_lock(&lock);
+    if (nfree < 0) {
+        void *p = NULL;
+        if (posix_memalign(&p, DIO_ALIGN, (size_t)DIO_POOL_BUFS * DIO_BUF_SIZE) != 0) {
+            pthread_mutex_unlock(&lock);
+            return NULL;
+        }
+        pool = p;
+        for (int i = 0; i < DIO_POOL_BUFS; ++i) free_bufs[i] = pool + (size_t)i * DIO_BUF_SIZE;
+        nfree = DIO_POOL_BUFS;
+    }
+    if (nfree == 0) st.pool_waits++;
+    while (nfree == 0) pthread_cond_wait(&avail, &lock);
+    uint8_t *buf = free_bufs[--nfree];
+    pthread_mutex_unlock(&lock);
+    return buf;
+}
+
+void dio_buf_put(void *buf) {
+    if (!buf) return;
+    pthread_mutex_lock(&lock);
+    free_bufs[nfree++] = buf;
+    pthread_cond_signal(&avail);
+    pthread_mutex_unlock(&lock);
+}
+
+static int aligned(uint64_t v) {
+    return (v & (DIO_ALIGN - 1)) == 0;
+}
+
+static ssize_t xfer(int fd, void *buf, size_t len, off_t pos, int write) {
+    ssize_t r;
+    do {
+        r = write ? pwrite(fd, buf, len, pos) : pread(fd, buf, len, pos);
+        STATS_SYSCALL(1);
+    } while (r < 0 && errno == EINTR);
+    return r;
+}
+
+// Yazımdan önce bir hizalama birimini diskteki içerikle doldurur
+static int fill_unit(int fd, uint8_t *unit, off_t pos) {
+    ssize_t r = xfer(fd, unit, DIO_ALIGN, pos, 0);
+    if (r < 0) return -1;
+    memset(unit + r, 0, DIO_ALIGN - (size_t)r);     // dosya sonu
+    ADD(st.rmw_reads, 1);
+    return 0;
+}
+
+// iov'un skip baytından sonraki n baytı buf'a kopyalar (to_buf) ya da tersi
+static void iov_copy(const struct iovec *iov, int iovcnt, size_t skip, uint8_t *buf, size_t n, int to_buf) {
+    for (int i = 0; i < iovcnt && n; ++i) {
+        size_t len = iov[i].iov_len;
+        if (skip >= len) {
+            skip -= len;
+            continue;
+        }
+        size_t c = len - skip < n ? len - skip : n;
+        uint8_t *p = (uint8_t *)iov[i].iov_base + skip;
+        if (to_buf) memcpy(buf, p, c);
+        else        memcpy(p, buf, c);
+        buf += c;
+        n -= c;
+        skip = 0;
+    }
+}
+
+ssize_t dio_rwv(int fd, const struct iovec *iov, int iovcnt, off_t pos, int write) {
+    size_t total = 0;
+    int fast = aligned((uint64_t)pos) && iovcnt <= IOV_MAX;
+    for (int i = 0; i < iovcnt; ++i) {
+        total += iov[i].iov_len;
+        if (!aligned((uintptr_t)iov[i].iov_base) || !aligned(iov[i].iov_len)) fast = 0;
+    }
+    if (total == 0) return 0;
+    if (fast) {
+        ssize_t r;
+        do {
+            r = write ? pwritev(fd, iov, iovcnt, pos) : preadv(fd, iov, iovcnt, pos);
+            STATS_SYSCALL(1);
+        } while (r < 0 && errno == EINTR);
+        ADD(st.direct, 1);
+        return r;
+    }
+
+    uint8_t *buf = dio_buf_get();
+    if (!buf) {
+        errno = ENOMEM;
+        return -1;
+    }
+    ADD(st.bounced, 1);
+    size_t done = 0;
+    int failed = 0;
+    while (done < total) {
+        off_t  at   = pos + (off_t)done;
+        size_t head = (size_t)(at & (DIO_ALIGN - 1));
+        off_t  base = at - (off_t)head;
+        size_t n    = total - done;
+        if (n > DIO_BUF_SIZE - head) n = DIO_BUF_SIZE - head;
+        size_t span = (head + n + DIO_ALIGN - 1) & ~(size_t)(DIO_ALIGN - 1);
+
+        if (!write) {
+            ssize_t r = xfer(fd, buf, span, base, 0);
+            if (r < 0) {
+                failed = 1;
+                break;
+            }
+            size_t got = (size_t)r > head ? (size_t)r - head : 0;
+            if (got > n) got = n;
+            iov_copy(iov, iovcnt, done, buf + head, got, 0);
+            done += got;
+            if (got < n) break;         // dosya sonu
+            continue;
+        }
+
+        size_t last = span - DIO_ALIGN;
+        if (head && fill_unit(fd, buf, base) < 0) {
+            failed = 1;
+            break;
+        }
+        if (!aligned(head + n) && !(head && last == 0) && fill_unit(fd, buf + last, base + (off_t)last) < 0) {
+            failed = 1;
+            break;
+        }
+        iov_copy(iov, iovcnt, done, buf + head, n, 1);
+        ssize_t r = xfer(fd, buf, span, base, 1);
+        if (r < 0) {
+            failed = 1;
+            break;
+        }
+        if ((size_t)r < span) {         // kısa yazım: yalnızca tamamlanan kısım sayılır
+            if ((size_t)r > head) done += (size_t)r - head < n ? (size_t)r - head : n;
+            break;
+        }
+        done += n;
+    }
+    int err = errno;
+    dio_buf_put(buf);
+    if (failed && done == 0) {
+        errno = err;
+        return -1;
+    }
+    return (ssize_t)done;
+}
+
+ssize_t dio_pread(int fd, void *buf, size_t size, off_t pos) {
+    struct iovec v = { buf, size };
+    return dio_rwv(fd, &v, 1, pos, 0);
+}
+
+ssize_t dio_pwrite(int fd, const void *buf, size_t size, off_t pos) {
+    struct iovec v = { (void *)buf, size };
+    return dio_rwv(fd, &v, 1, pos, 1);
+}
+
+void dio_stats(DioStats *out) {
+    pthread_mutex_lock(&lock);
+    out->direct     = __atomic_load_n(&st.direct, __ATOMIC_RELAXED);
+    out->bounced    = __atomic_load_n(&st.bounced, __ATOMIC_RELAXED);
+    out->rmw_reads  = __atomic_load_n(&st.rmw_reads, __ATOMIC_RELAXED);
+    out->pool_waits = st.pool_waits;
+    pthread_mutex_unlock(&lock);
+}
+
+void dio_reset_stats(void) {
+    pthread_mutex_lock(&lock);
+    memset(&st, 0, sizeof(st));
+    pthread_mutex_unlock(&lock);
+}
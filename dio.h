@@ -0,0 +1,42 @@
+#ifndef DIO_H
+#define DIO_H
+
+#include <stdint.h>     // uint64_t
+#include <sys/types.h>  // off_t, ssize_t
+#include <sys/uio.h>    // struct iovec
+
+// Doğrudan G/Ç (O_DIRECT) yardımcıları: ana makinenin sayfa önbelleği
+// atlanır, bu yüzden her istek DIO_ALIGN'a hizalı konum, uzunluk ve bellek
+// adresiyle yapılmalıdır. dio_pread/dio_pwrite/dio_rwv isteği hizalı
+// aralıklara genişletir: hizalı bir tampon ve hizalı aralık olduğu gibi
+// geçirilir, diğerleri havuzdan alınan hizalı bir tampon üzerinden kopyalanır;
+// yazımda yarım kalan baş/son hizalama birimi önce okunur (oku-değiştir-yaz).
+// Havuzda DIO_POOL_BUFS adet DIO_BUF_SIZE'lık tampon vardır ve ilk kullanımda
+// bir kez ayrılır; doğrudan G/Ç'nin bellek kullanımı bununla sınırlıdır.
+// Tamponların hepsi kullanımdaysa istek birinin bırakılmasını bekler.
+// Fonksiyonlar pread/pwrite gibi hatada -1 döndürür ve errno'yu ayarlar.
+#define DIO_ALIGN      4096
+#define DIO_BUF_SIZE   (256 * 1024)
+#define DIO_POOL_BUFS  8
+
+typedef struct {
+    uint64_t direct;            // Kopyasız geçirilen (zaten hizalı) istekler
+    uint64_t bounced;           // Havuz tamponu üzerinden kopyalanan istekler
+    uint64_t rmw_reads;         // Yazım için önceden okunan hizalama birimleri
+    uint64_t pool_waits;        // Boş tampon beklenen durumlar
+} DioStats;
+
+int  dio_enabled(void);
+void dio_set_enabled(int on);   // Yalnızca bayrak; tanıtıcıları disk.c açar
+
+void *dio_buf_get(void);        // DIO_ALIGN hizalı, DIO_BUF_SIZE bayt (NULL: bellek yok)
+void  dio_buf_put(void *buf);
+
+ssize_t dio_pread(int fd, void *buf, size_t size, off_t pos);
+ssize_t dio_pwrite(int fd, const void *buf, size_t size, off_t pos);
+ssize_t dio_rwv(int fd, const struct iovec *iov, int iovcnt, off_t pos, int write);
+
+void dio_stats(DioStats *out);
+void dio_reset_stats(void);
+
+#endif // DIO_H
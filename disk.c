@@ -1,138 +1,1243 @@
-// disk.c
-#include "disk.h"
-#include <fcntl.h>
-#include <unistd.h>     // open, read, write, lseek, close
-#include <stdio.h>      // perror, fprintf
-#include <stdlib.h>     // malloc, calloc, free
-#include <string.h>     // memcpy
-#include <stdint.h>     // uint8_t
-
-#define META_BUF_SIZE METADATA_SIZE
-
-DiskMetadata metadata;
-static int disk_fd = -1;
-
-// Disk dosyasını açar (yoksa hata verir)
-int disk_open() {
-    if (disk_fd >= 0) return 0;
-
-    disk_fd = open(DISK_NAME, O_RDWR);
-    if (disk_fd < 0) {
-        perror("Failed to open disk file");
-        return -1;
-    }
-    return 0;
-}
-
-// Metadata’yı diskin başından belleğe okur
-int disk_read_metadata() {
-    if (disk_open() < 0) return -1;
-
-    if (lseek(disk_fd, 0, SEEK_SET) < 0) {
-        perror("lseek metadata read failed");
-        return -1;
-    }
-
-    uint8_t *buf = malloc(META_BUF_SIZE);
-    if (!buf) {
-        perror("malloc metadata buffer");
-        return -1;
-    }
-
-    ssize_t bytes = read(disk_fd, buf, META_BUF_SIZE);
-    if (bytes != META_BUF_SIZE) {
-        fprintf(stderr, "Incomplete metadata read: %zd bytes\n", bytes);
-        free(buf);
-        return -1;
-    }
-
-    memcpy(&metadata, buf, sizeof(DiskMetadata));
-    free(buf);
-    return 0;
-}
-
-// Metadata’yı bellekteki halinden diske yazar
-int disk_write_metadata() {
-    if (disk_open() < 0) return -1;
-
-    if (lseek(disk_fd, 0, SEEK_SET) < 0) {
-        perror("lseek metadata write failed");
-        return -1;
-    }
-
-    uint8_t *buf = calloc(1, META_BUF_SIZE);
-    if (!buf) {
-        perror("calloc metadata buffer");
-        return -1;
-    }
-
-    memcpy(buf, &metadata, sizeof(DiskMetadata));
-
-    ssize_t bytes = write(disk_fd, buf, META_BUF_SIZE);
-    if (bytes != META_BUF_SIZE) {
-        fprintf(stderr, "Incomplete metadata write: %zd bytes\n", bytes);
-        free(buf);
-        return -1;
-    }
-
-    free(buf);
-    return 0;
-}
-
-// Belirtilen bloktan veri okur (BLOCK_SIZE kadar)
-int disk_read_block(uint32_t block_index, void *buffer) {
-    if (disk_open() < 0) return -1;
-
-    off_t offset = METADATA_SIZE + (off_t)block_index * BLOCK_SIZE;
-    if (lseek(disk_fd, offset, SEEK_SET) < 0) {
-        perror("lseek block read failed");
-        return -1;
-    }
-
-    ssize_t bytes = read(disk_fd, buffer, BLOCK_SIZE);
-    if (bytes != BLOCK_SIZE) {
-        fprintf(stderr, "Incomplete block read: %zd bytes\n", bytes);
-        return -1;
-    }
-
-    return 0;
-}
-
-// Belirtilen bloğa veri yazar (BLOCK_SIZE kadar)
-int disk_write_block(uint32_t block_index, const void *buffer) {
-    if (disk_open() < 0) return -1;
-
-    off_t offset = METADATA_SIZE + (off_t)block_index * BLOCK_SIZE;
-    if (lseek(disk_fd, offset, SEEK_SET) < 0) {
-        perror("lseek block write failed");
-        return -1;
-    }
-
-    ssize_t bytes = write(disk_fd, buffer, BLOCK_SIZE);
-    if (bytes != BLOCK_SIZE) {
-        fprintf(stderr, "Incomplete block write: %zd bytes\n", bytes);
-        return -1;
-    }
-
-    return 0;
-}
-
-// Disk dosyasını kapatır
-static void disk_close() {
-    if (disk_fd >= 0) {
-        close(disk_fd);
-        disk_fd = -1;
-    }
-}
-
-// Program başladığında fd’yi başlat
-__attribute__((constructor))
-static void init_disk() {
-    disk_fd = -1;
-}
-
-// Program bittiğinde diski kapat
-__attribute__((destructor))
-static void cleanup_disk() {
-    disk_close();
-}
+// disk.c
+#define _GNU_SOURCE             // fallocate, O_DIRECT, SEEK_DATA / SEEK_HOLE
+
+#include "disk.h"
+#include "dedup.h"
+#include "lfs.h"
+#include "trim.h"
+#include "bcache.h"
+#include "stripe.h"
+#include "memtier.h"
+#include "dio.h"
+#include "bufpool.h"
+#include "share.h"
+#include "stats.h"
+#include "fserr.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>     // IOV_MAX
+#include <sys/mman.h>   // mmap, msync, munmap
+#include <sys/stat.h>   // fstat
+#include <unistd.h>     // open, read, write, lseek, close, pread, pwrite
+#include <string.h>     // memcpy, strerror
+#include <stdint.h>     // uint8_t
+
+#define META_BUF_SIZE METADATA_SIZE
+
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
+DiskMetadata metadata;
+uint8_t inline_area[MAX_FILES][INLINE_MAX];
+// Aygıt 0 metadata'yı tutar; tek imajda disk_fds[0] imajın kendisidir
+static int disk_fds[STRIPE_MAX_DEVICES];
+// Doğrudan G/Ç açıkken veri bölgesi aynı dosyaların O_DIRECT ile açılmış
+// ikinci tanıtıcılarından okunur/yazılır (kapalıyken -1). Metadata (ve
+// share.c'nin her çağrıda okuduğu nesil kelimesi) disk_fds üzerinden sayfa
+// önbelleğinde kalır; çekirdek, doğrudan yazılan aralığın önbellekteki
+// sayfalarını geçersiz kılar.
+static int disk_dfds[STRIPE_MAX_DEVICES];
+static int disk_ndev = 1;
+static char disk_image[1024] = DISK_NAME;
+static char disk_members[STRIPE_MAX_DEVICES][256] = { DISK_NAME };
+static uint32_t stripe_width = STRIPE_DEFAULT_BLOCKS;   // Sonraki format için
+static uint32_t stripe_blocks_active;                   // Bağlı kümenin parça boyutu
+static int disk_maps;                                   // Açık bellek eşlemeleri
+static uint32_t disk_image_blocks;                      // Tek imajın boyutuna sığan veri blokları
+
+static void disk_close(void);
+
+static void disk_close_direct(void) {
+    for (int i = 0; i < STRIPE_MAX_DEVICES; ++i) {
+        if (disk_dfds[i] >= 0) {
+            close(disk_dfds[i]);
+            STATS_SYSCALL(1);
+            disk_dfds[i] = -1;
+        }
+    }
+}
+
+static int disk_open_direct(void) {
+    for (int i = 0; i < disk_ndev; ++i) {
+        if (disk_dfds[i] >= 0) continue;
+        disk_dfds[i] = open(disk_members[i], O_RDWR | O_DIRECT);
+        STATS_SYSCALL(1);
+        if (disk_dfds[i] < 0) {
+            int err = errno;
+            disk_close_direct();
+            FS_FAIL(err == EINVAL ? FS_ERR_UNSUPPORTED : FS_ERR_IO,
+                    "disk: cannot open '%s' for direct I/O: %s", disk_members[i], strerror(err));
+        }
+    }
+    return 0;
+}
+
+// Veri bölgesi G/Ç'si için tanıtıcılar (şeritleme katmanına da bunlar verilir)
+static const int *disk_data_fds(void) {
+    return disk_dfds[0] >= 0 ? disk_dfds : disk_fds;
+}
+
+// Disk dosyalarını açar (yoksa hata verir). Doğrudan G/Ç'yi desteklemeyen bir
+// dosya sisteminde mod kapatılır ve imaj sayfa önbelleği üzerinden kullanılır.
+int disk_open() {
+    if (disk_fds[0] >= 0) return 0;
+
+    for (int i = 0; i < disk_ndev; ++i) {
+        disk_fds[i] = open(disk_members[i], O_RDWR);
+        STATS_SYSCALL(1);
+        if (disk_fds[i] < 0) {
+            int err = errno;
+            disk_close();
+            FS_FAIL(FS_ERR_IO, "Failed to open disk file '%s': %s", disk_members[i], strerror(err));
+        }
+    }
+    if (dio_enabled() && disk_open_direct() < 0) {
+        dio_set_enabled(0);
+        FS_ERROR("disk: direct I/O disabled for '%s'", disk_image);
+    }
+    // Tek imajın kapasitesi dosya boyutundan gelir (bkz. disk_resize)
+    struct stat st;
+    STATS_SYSCALL(1);
+    disk_image_blocks = DATA_BLOCKS;
+    if (disk_ndev == 1 && fstat(disk_fds[0], &st) == 0 && st.st_size < DISK_SIZE) {
+        disk_image_blocks = st.st_size > METADATA_SIZE
+                            ? (uint32_t)((st.st_size - METADATA_SIZE) / BLOCK_SIZE) : 0;
+    }
+    return 0;
+}
+
+// Kullanılacak disk imajını seçer (varsayılan DISK_NAME); açık disk kapatılır.
+// Virgülle ayrılmış liste şeritli bir kümenin aygıtlarıdır (ilki metadata'yı tutar).
+int disk_set_path(const char *path) {
+    char members[STRIPE_MAX_DEVICES][256];
+    int count = 0;
+    if (!path || !*path || strlen(path) >= sizeof(disk_image)) {
+        FS_FAIL(FS_ERR_INVALID, "disk_set_path: invalid path");
+    }
+    for (const char *p = path; ; ++p) {
+        size_t len = strcspn(p, ",");
+        if (len == 0 || len >= sizeof(members[0]) || count == STRIPE_MAX_DEVICES) {
+            FS_FAIL(FS_ERR_INVALID, "disk_set_path: invalid device list '%s' (at most %d devices)",
+                    path, STRIPE_MAX_DEVICES);
+        }
+        memcpy(members[count], p, len);
+        members[count++][len] = '\0';
+        p += len;
+        if (!*p) break;
+    }
+    // Bellek katmanındaki kirli veri ve günlük eşlemesi eski imaja aittir;
+    // kirayı bırakan izleyici önce durdurulur
+    share_shutdown();
+    int rc = disk_fds[0] >= 0 ? disk_flush() : 0;
+    if (rc < 0) FS_FAIL(rc, "disk_set_path: cannot flush pending state to '%s'", disk_image);
+    disk_reset();
+    share_close();              // Kilitler eski imaja aittir
+    strcpy(disk_image, path);
+    memcpy(disk_members, members, sizeof(members));
+    disk_ndev = count;
+    stripe_blocks_active = 0;
+    return 0;
+}
+
+const char *disk_path(void) {
+    return disk_image;
+}
+
+int disk_exists(void) {
+    return access(disk_members[0], F_OK) == 0;
+}
+
+int disk_devices(void) {
+    return disk_ndev;
+}
+
+const char *disk_device(int index) {
+    return index >= 0 && index < disk_ndev ? disk_members[index] : NULL;
+}
+
+int disk_set_stripe_width(uint32_t blocks) {
+    if (blocks == 0 || blocks > DATA_BLOCKS) {
+        FS_FAIL(FS_ERR_INVALID, "disk_set_stripe_width: %u blocks (1-%u)", blocks, (unsigned)DATA_BLOCKS);
+    }
+    stripe_width = blocks;
+    return 0;
+}
+
+uint32_t disk_stripe_blocks(void) {
+    return disk_ndev > 1 ? stripe_blocks_active : 0;
+}
+
+// Açık imajda O_DIRECT tanıtıcıları hemen açılır/kapatılır; şeritleme iş
+// parçacıkları tanıtıcıları tuttuğundan küme yenileriyle yeniden bağlanır.
+// Bellek eşlemeleri sayfa önbelleğine bağlı olduğundan açıkken geçilemez.
+int disk_set_direct(int on) {
+    on = on ? 1 : 0;
+    if (on == dio_enabled()) return 0;
+    if (on && disk_maps > 0) FS_FAIL(FS_ERR_UNSUPPORTED, "disk_set_direct: memory mappings are open");
+    dio_set_enabled(on);
+    if (disk_fds[0] < 0) return 0;          // sonraki disk_open uygular
+
+    int restripe = stripe_active();
+    lfs_shutdown();                         // Temizleyici eski tanıtıcıları kullanmasın
+    trim_flush();                           // Bekleyen delmeler de
+    stripe_detach();
+    disk_close_direct();
+    int rc = on ? disk_open_direct() : 0;
+    if (rc < 0) dio_set_enabled(0);
+    if (restripe) {
+        int src = stripe_attach(disk_data_fds(), disk_ndev, stripe_blocks_active);
+        if (rc == 0) rc = src;
+    }
+    return rc;
+}
+
+int disk_direct(void) {
+    return dio_enabled();
+}
+
+// Veri bölgesinde tek tamponlu G/Ç (tek imaj); doğrudan G/Ç açıkken istek
+// hizalanır (bkz. dio.h)
+static ssize_t disk_pio(void *buffer, size_t size, off_t pos, int write) {
+    if (disk_dfds[0] >= 0) {
+        return write ? dio_pwrite(disk_dfds[0], buffer, size, pos) : dio_pread(disk_dfds[0], buffer, size, pos);
+    }
+    STATS_SYSCALL(1);
+    return write ? pwrite(disk_fds[0], buffer, size, pos) : pread(disk_fds[0], buffer, size, pos);
+}
+
+// Yazılacak aralığın bekleyen delmelerini iptal eder (bkz. trim.h)
+static void disk_trim_cancel(uint64_t offset, uint64_t size) {
+    if (size == 0) return;
+    uint32_t first = (uint32_t)(offset / BLOCK_SIZE);
+    trim_cancel(first, (uint32_t)((offset + size - 1) / BLOCK_SIZE) - first + 1);
+}
+
+// Veri bölgesinde ham G/Ç (çeviri katmanı ve önbellek yok): tek imajda
+// pread/pwrite, şeritli kümede aygıtlara bölünür. Aktarılan bayt sayısı
+// (tek imajın sonunda kısa olabilir) veya FsError döner.
+static ssize_t disk_raw_io(uint64_t offset, void *buffer, size_t size, int write, const char *who) {
+    if (write) {
+        disk_trim_cancel(offset, size);
+        share_note_write();
+    }
+    if (stripe_active()) {
+        struct iovec v = { buffer, size };
+        return stripe_rw(offset, &v, 1, write);
+    }
+    ssize_t r = disk_pio(buffer, size, METADATA_SIZE + (off_t)offset, write);
+    if (r < 0) FS_FAIL(FS_ERR_IO, "%s: %s", who, strerror(errno));
+    return r;
+}
+
+// Metadata'daki şeritleme geometrisi verilen aygıt listesiyle eşleşmeli
+static int disk_attach_stripe(void) {
+    uint32_t devices = metadata.stripe_devices ? metadata.stripe_devices : 1;
+    if (devices != (uint32_t)disk_ndev) {
+        FS_FAIL(FS_ERR_CORRUPT, "disk: '%s' was formatted for %u device(s), %d given",
+                disk_members[0], devices, disk_ndev);
+    }
+    if (disk_ndev == 1 || (stripe_active() && stripe_blocks_active == metadata.stripe_blocks)) return 0;
+    int rc = stripe_attach(disk_data_fds(), disk_ndev, metadata.stripe_blocks);
+    if (rc == 0) stripe_blocks_active = metadata.stripe_blocks;
+    return rc;
+}
+
+// Format/restore diski değiştirdiğinde önbellekli durumu bırakır;
+// bir sonraki disk_read_metadata her şeyi yeniden yükler
+void disk_reset(void) {
+    share_note_write();         // İmaj yeniden yazıldı: diğer süreçler yeniden yükler
+    share_forget();
+    trim_drop();
+    memtier_clear();
+    bcache_clear();
+    dedup_unload();
+    lfs_unload();
+    disk_close();
+}
+
+// Başka bir süreç imajı değiştirdi (bkz. share.h): önbellekler ve çeviri
+// katmanlarının tabloları bırakılır, metadata yeniden okunur. Bellekte
+// bekleyen durum yoktur; kira tutulmadığı sürece her çağrı sonunda yazılır.
+int disk_reload(void) {
+    bcache_clear();
+    memtier_clear();
+    dedup_unload();
+    lfs_unload();
+    struct stat st;
+    STATS_SYSCALL(1);
+    if (disk_fds[0] >= 0 && disk_ndev == 1 && fstat(disk_fds[0], &st) == 0) {
+        disk_image_blocks = st.st_size >= DISK_SIZE ? DATA_BLOCKS
+                          : st.st_size > METADATA_SIZE ? (uint32_t)((st.st_size - METADATA_SIZE) / BLOCK_SIZE) : 0;
+    }
+    share_forget();
+    return disk_read_metadata();
+}
+
+// Çağrı yerinde yazımı başka sürecin gördüğü veri önbelleklerini bırakır
+void disk_drop_caches(void) {
+    bcache_clear();
+    memtier_clear();
+}
+
+// Bellekte imaja henüz yazılmamış durum var mı (bellek katmanının kirli
+// kısımları, günlük eşlemesi ve temizleyicisi, bekleyen delmeler)
+int disk_pending(void) {
+    return memtier_dirty() || lfs_pending() || trim_pending();
+}
+
+// Bekleyen durumu imaja yazar ve arka plan işlerini durdurur; sonrasında
+// imajı başka süreç değiştirebilir
+int disk_release_state(void) {
+    lfs_shutdown();
+    return disk_flush();
+}
+
+// Metadata bayraklarına göre çeviri katmanını hazırla
+static int disk_attach_layers(void) {
+    if (metadata.flags & DISK_FLAG_DEDUP) {
+        if (!dedup_is_loaded()) return dedup_load();
+    } else if (dedup_is_loaded()) {
+        dedup_unload();
+    }
+    if (metadata.flags & DISK_FLAG_LOG) {
+        if (!lfs_is_loaded()) return lfs_load();
+    } else if (lfs_is_loaded()) {
+        lfs_unload();
+    }
+    return 0;
+}
+
+static int dedup_active(void) {
+    return (metadata.flags & DISK_FLAG_DEDUP) && dedup_is_loaded();
+}
+
+static int lfs_active(void) {
+    return (metadata.flags & DISK_FLAG_LOG) && lfs_is_loaded();
+}
+
+// Mantıksal blok fiziksel bloğa denk gelmiyor (dedup ya da günlük yapılı)
+static int disk_translated(void) {
+    return dedup_active() || lfs_active();
+}
+
+// Düz tek imajda veri bölgesi dosya boyutunda biter; çeviri katmanları ve
+// şeritli küme bölgenin tamamını kullanır
+uint32_t disk_capacity(void) {
+    if (disk_open() < 0 || disk_translated()) return DATA_BLOCKS;
+    return disk_image_blocks;
+}
+
+static uint64_t disk_data_end(void) {
+    return (uint64_t)disk_capacity() * BLOCK_SIZE;
+}
+
+// Metadata’yı diskin başından belleğe okur. Çağrı başında nesli doğrulanmış
+// bellekteki kopya geçerliyse okuma yapılmaz (bkz. share.h).
+static int disk_read_metadata_impl(void) {
+    if (share_current()) return 0;
+    int rc = disk_open();
+    if (rc < 0) return rc;
+
+    if (lseek(disk_fds[0], 0, SEEK_SET) < 0) {
+        FS_FAIL(FS_ERR_IO, "lseek metadata read failed: %s", strerror(errno));
+    }
+
+    uint8_t *buf = buf_get(BUF_META);
+    if (!buf) FS_FAIL(FS_ERR_NO_MEMORY, "malloc metadata buffer");
+
+    // Önceki okuma satır içi alanı olan bir imaj gösterdiyse alan aynı çağrıda
+    // okunur (şeritli kümede alan aygıtlara dağıldığından ayrıca)
+    int with_inline = (metadata.flags & DISK_FLAG_INLINE) && disk_ndev == 1;
+    struct iovec iov[2] = {
+        { buf, META_BUF_SIZE }, { inline_area, sizeof(inline_area) }
+    };
+    ssize_t want = META_BUF_SIZE + (with_inline ? (ssize_t)sizeof(inline_area) : 0);
+    ssize_t bytes = readv(disk_fds[0], iov, with_inline ? 2 : 1);
+    STATS_SYSCALL(2);   // lseek + readv
+    if (bytes != want) {
+        buf_put(BUF_META, buf);
+        if (bytes < 0) FS_FAIL(FS_ERR_IO, "metadata read failed: %s", strerror(errno));
+        FS_FAIL(FS_ERR_CORRUPT, "Incomplete metadata read: %zd bytes", bytes);
+    }
+
+    memcpy(&metadata, buf, sizeof(DiskMetadata));
+    buf_put(BUF_META, buf);
+    if ((rc = disk_attach_stripe()) < 0) return rc;
+    if ((metadata.flags & DISK_FLAG_INLINE) && !with_inline) {
+        bytes = disk_raw_io(0, inline_area, sizeof(inline_area), 0, "inline area read failed");
+        if (bytes < 0) return (int)bytes;
+        if (bytes != (ssize_t)sizeof(inline_area)) FS_FAIL(FS_ERR_IO, "inline area read failed: short read");
+    }
+    if ((rc = disk_attach_layers()) < 0) return rc;
+    share_loaded(metadata.flags >> SHARE_GEN_SHIFT);
+    return 0;
+}
+
+// Metadata’yı bellekteki halinden diske yazar
+static int disk_write_metadata_impl(void) {
+    int rc = disk_open();
+    if (rc < 0) return rc;
+
+    if (lseek(disk_fds[0], 0, SEEK_SET) < 0) {
+        FS_FAIL(FS_ERR_IO, "lseek metadata write failed: %s", strerror(errno));
+    }
+
+    uint8_t *buf = buf_get(BUF_META);
+    if (!buf) FS_FAIL(FS_ERR_NO_MEMORY, "malloc metadata buffer");
+
+    // Her metadata yazımı imajın neslini de ilerletir
+    uint32_t gen = share_next_gen();
+    metadata.flags = (metadata.flags & ~SHARE_GEN_MASK) | (gen << SHARE_GEN_SHIFT);
+    memcpy(buf, &metadata, sizeof(DiskMetadata));
+    memset(buf + sizeof(DiskMetadata), 0, META_BUF_SIZE - sizeof(DiskMetadata));
+
+    ssize_t bytes = write(disk_fds[0], buf, META_BUF_SIZE);
+    STATS_SYSCALL(2);   // lseek + write
+    buf_put(BUF_META, buf);
+    if (bytes != META_BUF_SIZE) FS_FAIL(FS_ERR_IO, "Incomplete metadata write: %zd bytes", bytes);
+    share_gen_written(gen);
+    return 0;
+}
+
+// Satır içi yuvayı bellekteki halinden diske yazar (çeviri katmanından geçmez)
+int disk_write_inline(uint32_t slot) {
+    if (slot >= MAX_FILES) FS_FAIL(FS_ERR_INVALID, "disk_write_inline: bad slot %u", slot);
+    int rc = disk_open();
+    if (rc < 0) return rc;
+    ssize_t bytes = disk_raw_io((uint64_t)slot * INLINE_MAX, inline_area[slot], INLINE_MAX, 1,
+                                "inline slot write failed");
+    if (bytes < 0) return (int)bytes;
+    if (bytes != INLINE_MAX) FS_FAIL(FS_ERR_IO, "inline slot write failed: short write");
+    return 0;
+}
+
+// Fiziksel veri bloklarını okur (çeviri yapılmaz)
+static int disk_phys_read_impl(uint32_t pblock, uint32_t count, void *buffer) {
+    int rc = disk_open();
+    if (rc < 0) return rc;
+
+    size_t len = (size_t)count * BLOCK_SIZE;
+    ssize_t bytes = disk_raw_io((uint64_t)pblock * BLOCK_SIZE, buffer, len, 0, "block read");
+    if (bytes < 0) return (int)bytes;
+    if (bytes != (ssize_t)len) FS_FAIL(FS_ERR_IO, "Incomplete block read: %zd bytes", bytes);
+    return 0;
+}
+
+// Fiziksel veri bloklarına yazar (çeviri yapılmaz)
+static int disk_phys_write_impl(uint32_t pblock, uint32_t count, const void *buffer) {
+    int rc = disk_open();
+    if (rc < 0) return rc;
+
+    size_t len = (size_t)count * BLOCK_SIZE;
+    ssize_t bytes = disk_raw_io((uint64_t)pblock * BLOCK_SIZE, (void *)buffer, len, 1, "block write");
+    if (bytes < 0) return (int)bytes;
+    if (bytes != (ssize_t)len) FS_FAIL(FS_ERR_IO, "Incomplete block write: %zd bytes", bytes);
+    return 0;
+}
+
+// Fiziksel veri bloklarını imaj dosyasında deler (bkz. trim.h). Bırakılan
+// blokların sıfır okunması gerekmez: tek imajda delme desteklenmiyorsa hiçbir
+// şey yapılmaz (şeritli kümede stripe_punch sıfır yazar).
+int disk_phys_punch(uint32_t pblock, uint32_t count) {
+    if (disk_fds[0] < 0 || count == 0) return 0;
+    uint64_t offset = (uint64_t)pblock * BLOCK_SIZE, len = (uint64_t)count * BLOCK_SIZE;
+    if (stripe_active()) return stripe_punch(offset, len);
+#ifdef FALLOC_FL_PUNCH_HOLE
+    STATS_SYSCALL(1);
+    if (fallocate(disk_fds[0], FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+                  METADATA_SIZE + (off_t)offset, (off_t)len) < 0 &&
+        errno != EOPNOTSUPP && errno != ENOSYS) {
+        FS_FAIL(FS_ERR_IO, "disk_phys_punch: fallocate: %s", strerror(errno));
+    }
+#endif
+    return 0;
+}
+
+// Belirtilen bloktan veri okur (BLOCK_SIZE kadar)
+static int disk_read_block_impl(uint32_t block_index, void *buffer) {
+    if (block_index >= DATA_BLOCKS) return FS_ERR_RANGE;
+    if (dedup_active()) return dedup_read_block(block_index, buffer);
+    if (lfs_active()) return lfs_read((uint64_t)block_index * BLOCK_SIZE, buffer, BLOCK_SIZE);
+    if (memtier_read((uint64_t)block_index * BLOCK_SIZE, buffer, BLOCK_SIZE)) return 0;
+    return disk_phys_read(block_index, 1, buffer);
+}
+
+// Belirtilen bloğa veri yazar (BLOCK_SIZE kadar)
+static int disk_write_block_impl(uint32_t block_index, const void *buffer) {
+    if (block_index >= DATA_BLOCKS) return FS_ERR_RANGE;
+    int rc;
+    if (dedup_active()) {
+        if ((rc = dedup_write_block(block_index, buffer)) == 0) rc = dedup_flush();
+    } else if (lfs_active()) {
+        ssize_t w = lfs_write((uint64_t)block_index * BLOCK_SIZE, buffer, BLOCK_SIZE);
+        rc = w < 0 ? (int)w : w == BLOCK_SIZE ? 0 : FS_ERR_NO_SPACE;
+    } else if (memtier_write((uint64_t)block_index * BLOCK_SIZE, buffer, BLOCK_SIZE)) {
+        rc = 0;
+    } else {
+        rc = disk_phys_write(block_index, 1, buffer);
+    }
+    if (rc == 0) bcache_write((uint64_t)block_index * BLOCK_SIZE, buffer, BLOCK_SIZE);
+    else         bcache_invalidate(block_index, 1);
+    return rc;
+}
+
+// Ardışık blokları önbelleği atlayarak okur: düz modda tek pread, dedup modunda
+// blok blok, günlük yapılı modda fiziksel olarak ardışık parçalar halinde
+static int disk_fill_blocks(uint32_t lba, uint32_t count, uint8_t *buffer) {
+    if (lfs_active()) return lfs_read((uint64_t)lba * BLOCK_SIZE, buffer, (size_t)count * BLOCK_SIZE);
+    if (!dedup_active()) return disk_phys_read(lba, count, buffer);
+    for (uint32_t i = 0; i < count; ++i) {
+        int rc = dedup_read_block(lba + i, buffer + (size_t)i * BLOCK_SIZE);
+        if (rc < 0) return rc;
+    }
+    return 0;
+}
+
+// Önbellek üzerinden okuma: isabetler bellekten kopyalanır, ardışık ıskalar
+// tek seferde okunup önbelleğe eklenir
+static ssize_t disk_read_cached(uint64_t offset, uint8_t *out, size_t size) {
+    static uint8_t run[BCACHE_RA_MAX * BLOCK_SIZE];
+    uint32_t lba  = (uint32_t)(offset / BLOCK_SIZE);
+    uint32_t last = (uint32_t)((offset + size - 1) / BLOCK_SIZE);
+    while (lba <= last) {
+        uint32_t n = 1;
+        if (!bcache_lookup(lba, run)) {
+            while (lba + n <= last && n < BCACHE_RA_MAX && !bcache_contains(lba + n)) n++;
+            int rc = disk_fill_blocks(lba, n, run);
+            if (rc < 0) return rc;
+            for (uint32_t i = 0; i < n; ++i) bcache_insert(lba + i, run + (size_t)i * BLOCK_SIZE);
+        }
+        for (uint32_t i = 0; i < n; ++i, ++lba) {
+            uint64_t lo = (uint64_t)lba * BLOCK_SIZE, hi = lo + BLOCK_SIZE;
+            if (lo < offset) lo = offset;
+            if (hi > offset + size) hi = offset + size;
+            memcpy(out + (lo - offset), run + (size_t)i * BLOCK_SIZE + lo % BLOCK_SIZE,
+                   (size_t)(hi - lo));
+        }
+    }
+    return (ssize_t)size;
+}
+
+// Veri bölgesinden bayt aralığı okur; bölge sonunda kısa okuma döner
+static ssize_t disk_read_data_io(uint64_t offset, void *buffer, size_t size) {
+    if (offset >= DATA_SIZE) return 0;
+    if (size > DATA_SIZE - offset) size = DATA_SIZE - offset;
+    int rc = disk_open();
+    if (rc < 0) return rc;
+
+    // Küçük okumalar önbellekten; önbelleği dolduracak kadar büyük okumalar doğrudan
+    if (size > 0 && bcache_enabled() &&
+        (offset + size - 1) / BLOCK_SIZE - offset / BLOCK_SIZE < BCACHE_RA_MAX) {
+        return disk_read_cached(offset, buffer, size);
+    }
+
+    if (lfs_active()) {
+        rc = lfs_read(offset, buffer, size);
+        return rc < 0 ? rc : (ssize_t)size;
+    }
+    if (!dedup_active()) return disk_raw_io(offset, buffer, size, 0, "disk_read_data: pread");
+
+    uint8_t block[BLOCK_SIZE];
+    uint8_t *out = buffer;
+    size_t done = 0;
+    while (done < size) {
+        uint64_t pos = offset + done;
+        uint32_t lba = (uint32_t)(pos / BLOCK_SIZE);
+        size_t in_block = pos % BLOCK_SIZE;
+        size_t chunk = BLOCK_SIZE - in_block;
+        if (chunk > size - done) chunk = size - done;
+        if ((rc = dedup_read_block(lba, block)) < 0) return rc;
+        memcpy(out + done, block + in_block, chunk);
+        done += chunk;
+    }
+    return (ssize_t)done;
+}
+
+// Veri bölgesine bayt aralığı yazar; bölge dışına taşan yazım reddedilir
+static ssize_t disk_write_data_io(uint64_t offset, const void *buffer, size_t size) {
+    int rc = disk_open();
+    if (rc < 0) return rc;
+    uint64_t end = disk_data_end();
+    if (offset > end || size > end - offset) {
+        FS_FAIL(FS_ERR_NO_SPACE, "disk_write_data: disk full (offset %llu, %zu bytes)",
+                (unsigned long long)offset, size);
+    }
+
+    if (lfs_active()) {
+        ssize_t wr = lfs_write(offset, buffer, size);
+        if (wr < 0) bcache_invalidate((uint32_t)(offset / BLOCK_SIZE), (uint32_t)(size / BLOCK_SIZE + 2));
+        else        bcache_write(offset, buffer, (size_t)wr);
+        return wr;
+    }
+    if (!dedup_active()) {
+        ssize_t wr = disk_raw_io(offset, (void *)buffer, size, 1, "disk_write_data: pwrite");
+        if (wr < 0) {
+            bcache_invalidate((uint32_t)(offset / BLOCK_SIZE), (uint32_t)(size / BLOCK_SIZE + 2));
+            return wr;
+        }
+        bcache_write(offset, buffer, (size_t)wr);
+        return wr;
+    }
+
+    // Kısmi bloklar için oku-değiştir-yaz; her blok parmak izi alınarak yazılır
+    uint8_t block[BLOCK_SIZE];
+    const uint8_t *in = buffer;
+    size_t done = 0;
+    while (done < size) {
+        uint64_t pos = offset + done;
+        uint32_t lba = (uint32_t)(pos / BLOCK_SIZE);
+        size_t in_block = pos % BLOCK_SIZE;
+        size_t chunk = BLOCK_SIZE - in_block;
+        if (chunk > size - done) chunk = size - done;
+        if (chunk < BLOCK_SIZE && (rc = dedup_read_block(lba, block)) < 0) break;
+        memcpy(block + in_block, in + done, chunk);
+        if ((rc = dedup_write_block(lba, block)) < 0) break;
+        done += chunk;
+    }
+    int frc = dedup_flush();
+    bcache_write(offset, buffer, done);
+    if (done < size || frc < 0) {
+        bcache_invalidate((uint32_t)((offset + done) / BLOCK_SIZE),
+                          (uint32_t)((size - done) / BLOCK_SIZE + 2));
+    }
+    if (frc < 0) return frc;
+    return done ? (ssize_t)done : rc;
+}
+
+// Bellek katmanı (memtier.h): aralık tamamen bellekteki bir dosyadaysa disk
+// hiç görülmez; kısmen bellekteyse disk G/Ç'sinden sonra o kısım uzlaştırılır
+static ssize_t disk_read_data_impl(uint64_t offset, void *buffer, size_t size) {
+    if (memtier_read(offset, buffer, size)) return (ssize_t)size;
+    ssize_t r = disk_read_data_io(offset, buffer, size);
+    if (r > 0) memtier_overlay(offset, buffer, (size_t)r);
+    return r;
+}
+
+static ssize_t disk_write_data_impl(uint64_t offset, const void *buffer, size_t size) {
+    if (memtier_write(offset, buffer, size)) return (ssize_t)size;
+    ssize_t r = disk_write_data_io(offset, buffer, size);
+    if (r > 0) memtier_update(offset, buffer, (size_t)r);
+    return r;
+}
+
+// Diske yazılan ilk len baytı önbelleğe yansıtır
+static void disk_vec_to_cache(uint64_t at, const struct iovec *iov, int iovcnt, size_t len) {
+    for (int k = 0; k < iovcnt && len; ++k) {
+        size_t n = iov[k].iov_len < len ? iov[k].iov_len : len;
+        bcache_write(at, iov[k].iov_base, n);
+        at += n;
+        len -= n;
+    }
+}
+
+// Bitişik aralığı birden çok tampon üzerinden okur / yazar. Düz modda IOV_MAX
+// tampon başına tek sistem çağrısı yapılır ve yazımlar önbelleğe yansıtılır;
+// disk_read_data gibi küçük okumalar önbellekten karşılanır. Dedup ve günlük
+// yapılı modda tamponlar sırayla çeviri katmanından geçer; şeritli kümede aralık aygıt
+// başına tek çağrıya bölünür.
+static ssize_t disk_rw_vec_io(uint64_t offset, const struct iovec *iov, int iovcnt, int write) {
+    const char *who = write ? "disk_writev_data" : "disk_readv_data";
+    uint64_t total = 0;
+    for (int i = 0; i < iovcnt; ++i) total += iov[i].iov_len;
+    int rc = disk_open();
+    if (rc < 0) return rc;
+    uint64_t end = disk_data_end();
+    if (offset > end || total > end - offset) {
+        FS_FAIL(write ? FS_ERR_NO_SPACE : FS_ERR_RANGE, "%s: range outside data region (offset %llu, %llu bytes)",
+                who, (unsigned long long)offset, (unsigned long long)total);
+    }
+
+    size_t done = 0;
+    if (!write && total > 0 && bcache_enabled() &&
+        (offset + total - 1) / BLOCK_SIZE - offset / BLOCK_SIZE < BCACHE_RA_MAX) {
+        for (int i = 0; i < iovcnt; ++i) {
+            if (iov[i].iov_len == 0) continue;
+            ssize_t r = disk_read_cached(offset + done, iov[i].iov_base, iov[i].iov_len);
+            if (r < 0) return r;
+            done += (size_t)r;
+        }
+        return (ssize_t)done;
+    }
+    if (disk_translated()) {
+        for (int i = 0; i < iovcnt; ++i) {
+            ssize_t r = write ? disk_write_data_impl(offset + done, iov[i].iov_base, iov[i].iov_len)
+                              : disk_read_data_impl(offset + done, iov[i].iov_base, iov[i].iov_len);
+            if (r < 0) return r;
+            done += (size_t)r;
+            if ((size_t)r < iov[i].iov_len) break;
+        }
+        return (ssize_t)done;
+    }
+    if (write) {
+        disk_trim_cancel(offset, total);
+        share_note_write();
+    }
+    if (stripe_active()) {
+        ssize_t r = stripe_rw(offset, iov, iovcnt, write);
+        if (r < 0 && write) bcache_invalidate((uint32_t)(offset / BLOCK_SIZE), (uint32_t)(total / BLOCK_SIZE + 2));
+        if (r > 0 && write) disk_vec_to_cache(offset, iov, iovcnt, (size_t)r);
+        return r;
+    }
+
+    for (int i = 0; i < iovcnt; ) {
+        int cnt = iovcnt - i < IOV_MAX ? iovcnt - i : IOV_MAX;
+        size_t want = 0;
+        for (int k = 0; k < cnt; ++k) want += iov[i + k].iov_len;
+        off_t pos = METADATA_SIZE + (off_t)(offset + done);
+        ssize_t r;
+        if (disk_dfds[0] >= 0) {
+            r = dio_rwv(disk_dfds[0], &iov[i], cnt, pos, write);
+        } else {
+            r = write ? pwritev(disk_fds[0], &iov[i], cnt, pos) : preadv(disk_fds[0], &iov[i], cnt, pos);
+            STATS_SYSCALL(1);
+        }
+        if (r < 0) {
+            if (write) bcache_invalidate((uint32_t)(offset / BLOCK_SIZE), (uint32_t)(total / BLOCK_SIZE + 2));
+            FS_FAIL(FS_ERR_IO, "%s: %s", who, strerror(errno));
+        }
+        if (write) disk_vec_to_cache(offset + done, &iov[i], cnt, (size_t)r);
+        done += (size_t)r;
+        if ((size_t)r < want) {
+            if (write) FS_FAIL(FS_ERR_IO, "%s: short write (%zu of %llu bytes)",
+                               who, done, (unsigned long long)total);
+            break;      // imaj sonunda kısa okuma
+        }
+        i += cnt;
+    }
+    return (ssize_t)done;
+}
+
+// Vektörlü G/Ç'nin bellek katmanı karşılığı (bkz. disk_read_data_impl): len
+// bayt tamponlar sırasıyla bellekten okunur / belleğe yansıtılır
+static void disk_vec_tier(uint64_t at, const struct iovec *iov, int iovcnt, size_t len, int write) {
+    for (int k = 0; k < iovcnt && len; ++k) {
+        size_t n = iov[k].iov_len < len ? iov[k].iov_len : len;
+        if (write) memtier_update(at, iov[k].iov_base, n);
+        else       memtier_overlay(at, iov[k].iov_base, n);
+        at += n;
+        len -= n;
+    }
+}
+
+static ssize_t disk_rw_vec(uint64_t offset, const struct iovec *iov, int iovcnt, int write) {
+    size_t total = 0;
+    for (int i = 0; i < iovcnt; ++i) total += iov[i].iov_len;
+    if (total && memtier_extent_end(offset) >= offset + total) {
+        for (int i = 0; i < iovcnt; ++i) {
+            if (!iov[i].iov_len) continue;
+            if (write) memtier_write(offset, iov[i].iov_base, iov[i].iov_len);
+            else       memtier_read(offset, iov[i].iov_base, iov[i].iov_len);
+            offset += iov[i].iov_len;
+        }
+        return (ssize_t)total;
+    }
+    ssize_t r = disk_rw_vec_io(offset, iov, iovcnt, write);
+    if (r > 0) disk_vec_tier(offset, iov, iovcnt, (size_t)r, write);
+    return r;
+}
+
+// Aralığı sıfırlar; tam bloklar yer tutmayacak şekilde bırakılır (delik).
+// Düz modda imaj dosyasında fallocate ile delik açılır, desteklenmiyorsa
+// sıfır yazılır; dedup ve günlük yapılı modda bloklar eşlemeden çıkarılır.
+static int disk_zero_range_io(uint64_t offset, uint64_t len) {
+    if (len == 0) return 0;
+    int rc = disk_open();
+    if (rc < 0) return rc;
+    share_note_write();
+    uint64_t end = disk_data_end();
+    if (offset > end || len > end - offset) {
+        FS_FAIL(FS_ERR_NO_SPACE, "disk_zero_range: disk full (offset %llu, %llu bytes)",
+                (unsigned long long)offset, (unsigned long long)len);
+    }
+
+    if (lfs_active()) return lfs_zero(offset, len);
+    if (!dedup_active() && stripe_active()) return stripe_punch(offset, len);
+    if (!dedup_active()) {
+#ifdef FALLOC_FL_PUNCH_HOLE
+        STATS_SYSCALL(1);
+        if (fallocate(disk_fds[0], FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+                      METADATA_SIZE + (off_t)offset, (off_t)len) == 0) {
+            return 0;
+        }
+        if (errno != EOPNOTSUPP && errno != ENOSYS) {
+            FS_FAIL(FS_ERR_IO, "disk_zero_range: fallocate: %s", strerror(errno));
+        }
+#endif
+        static const uint8_t zeros[8 * BLOCK_SIZE];
+        while (len > 0) {
+            size_t n = len < sizeof(zeros) ? (size_t)len : sizeof(zeros);
+            ssize_t wr = disk_pio((void *)zeros, n, METADATA_SIZE + (off_t)offset, 1);
+            if (wr != (ssize_t)n) FS_FAIL(FS_ERR_IO, "disk_zero_range: pwrite: %s", strerror(errno));
+            offset += n;
+            len -= n;
+        }
+        return 0;
+    }
+
+    // Baştaki ve sondaki kısmi bloklar oku-değiştir-yaz, aradakiler eşlemeden çıkar
+    uint8_t block[BLOCK_SIZE];
+    while (len > 0 && rc == 0) {
+        uint32_t lba = (uint32_t)(offset / BLOCK_SIZE);
+        size_t in_block = offset % BLOCK_SIZE;
+        if (in_block == 0 && len >= BLOCK_SIZE) {
+            uint32_t count = (uint32_t)(len / BLOCK_SIZE);
+            rc = dedup_discard(lba, count);
+            offset += (uint64_t)count * BLOCK_SIZE;
+            len    -= (uint64_t)count * BLOCK_SIZE;
+            continue;
+        }
+        size_t chunk = BLOCK_SIZE - in_block;
+        if (chunk > len) chunk = (size_t)len;
+        if ((rc = dedup_read_block(lba, block)) < 0) break;
+        memset(block + in_block, 0, chunk);
+        rc = dedup_write_block(lba, block);
+        offset += chunk;
+        len    -= chunk;
+    }
+    int frc = dedup_flush();
+    return rc < 0 ? rc : frc;
+}
+
+// Önbellekteki kopyalar disk değiştikten sonra bırakılır; süren bir ileri okuma
+// eski içeriği getirmiş olabilir, bcache onu da bayat sayar
+static int disk_zero_range_impl(uint64_t offset, uint64_t len) {
+    int rc = disk_zero_range_io(offset, len);
+    if (rc == 0) memtier_update(offset, NULL, (size_t)len);
+    if (len) {
+        uint32_t first = (uint32_t)(offset / BLOCK_SIZE);
+        bcache_invalidate(first, (uint32_t)((offset + len - 1) / BLOCK_SIZE) - first + 1);
+    }
+    return rc;
+}
+
+// offset'ten itibaren ilk veri içeren (hole = 0) veya ilk delik olan (hole = 1)
+// konumu döner; bulunamazsa DATA_SIZE. Sorgu desteklenmiyorsa her yer veri sayılır.
+static int64_t disk_seek_io(uint64_t offset, int hole) {
+    if (offset >= DATA_SIZE) return DATA_SIZE;
+    int rc = disk_open();
+    if (rc < 0) return rc;
+
+    if (disk_translated()) {
+        for (uint32_t lba = (uint32_t)(offset / BLOCK_SIZE); lba < DATA_BLOCKS; ++lba) {
+            int mapped = dedup_active() ? dedup_is_mapped(lba) : lfs_is_mapped(lba);
+            if (mapped != hole) {
+                uint64_t pos = (uint64_t)lba * BLOCK_SIZE;
+                return (int64_t)(pos > offset ? pos : offset);
+            }
+        }
+        return DATA_SIZE;
+    }
+    if (stripe_active()) return stripe_seek(offset, hole);
+#if defined(SEEK_DATA) && defined(SEEK_HOLE)
+    off_t pos = lseek(disk_fds[0], METADATA_SIZE + (off_t)offset, hole ? SEEK_HOLE : SEEK_DATA);
+    STATS_SYSCALL(1);
+    if (pos < 0) {
+        if (errno == ENXIO) return DATA_SIZE;       // offset'ten sonra veri yok
+        return hole ? DATA_SIZE : (int64_t)offset;
+    }
+    pos -= METADATA_SIZE;
+    return pos > DATA_SIZE ? DATA_SIZE : (int64_t)pos;
+#else
+    return hole ? DATA_SIZE : (int64_t)offset;
+#endif
+}
+
+// Bellekteki aralıklar baştan sona veri sayılır: diskteki delikler onların
+// kirli içeriğini göstermeyebilir
+static int64_t disk_seek_extent(uint64_t offset, int hole) {
+    if (!hole) {
+        int64_t pos = disk_seek_io(offset, 0);
+        uint64_t mem = memtier_next_start(offset);
+        return pos >= 0 && mem < (uint64_t)pos ? (int64_t)mem : pos;
+    }
+    for (;;) {
+        uint64_t end = memtier_extent_end(offset);
+        if (end) {
+            offset = end;
+            continue;
+        }
+        int64_t pos = disk_seek_io(offset, 1);
+        if (pos < 0 || (end = memtier_extent_end((uint64_t)pos)) == 0) return pos;
+        offset = end;
+    }
+}
+
+int64_t disk_next_data(uint64_t offset) {
+    return disk_seek_extent(offset, 0);
+}
+
+int64_t disk_next_hole(uint64_t offset) {
+    return disk_seek_extent(offset, 1);
+}
+
+// Bellek katmanındaki kirli veriyi ve günlük yapılı modun eşlemesini
+// (checkpoint) imaja yazar, bekleyen delmeleri yapar; kalıcılık için disk_sync gerekir
+int disk_flush(void) {
+    int rc = memtier_flush();
+    if (rc == 0 && lfs_active()) rc = lfs_checkpoint();
+    int trc = trim_flush();
+    return rc < 0 ? rc : trc;
+}
+
+// Diske yazılmış verinin kalıcı belleğe aktarılmasını bekler
+int disk_sync(void) {
+    if (disk_fds[0] < 0) return 0;
+    int rc = disk_flush();
+    if (rc < 0) return rc;
+    if (stripe_active()) return stripe_sync();
+    STATS_SYSCALL(1);
+    if (fdatasync(disk_fds[0]) < 0) FS_FAIL(FS_ERR_IO, "disk_sync: fdatasync: %s", strerror(errno));
+    return 0;
+}
+
+// Artık hiçbir dosyanın kullanmadığı mantıksal blokları bırakır; düz modda
+// bloklar imajda delinir, çeviri katmanları kendi fiziksel bloklarını deler
+static int disk_discard_impl(uint32_t first_block, uint32_t count) {
+    if (!count || first_block >= DATA_BLOCKS) return 0;
+    memtier_discard(first_block, count);
+    if (lfs_active()) {
+        int rc = lfs_discard(first_block, count);
+        bcache_invalidate(first_block, count);
+        return rc;
+    }
+    if (!dedup_active()) {
+        bcache_invalidate(first_block, count);
+        return trim_queue(first_block, count);
+    }
+    int rc = dedup_discard(first_block, count);
+    bcache_invalidate(first_block, count);
+    if (rc < 0) return rc;
+    return dedup_flush();
+}
+
+// İleri okuma ipucu: aralığın blokları arka planda önbelleğe alınır. Dedup ve
+// günlük yapılı modda mantıksal bloklar dağınık fiziksel bloklara denk gelir
+// ve ileri okuma fiziksel blokları okuduğundan ipucu yok sayılır.
+void disk_readahead(uint64_t offset, uint64_t len) {
+    if (len == 0 || offset >= DATA_SIZE || !bcache_enabled() || disk_translated()) return;
+    if (len > DATA_SIZE - offset) len = DATA_SIZE - offset;
+    if (memtier_extent_end(offset) >= offset + len) return;    // zaten bellekte
+    if (disk_open() < 0) return;
+    uint32_t first = (uint32_t)(offset / BLOCK_SIZE);
+    bcache_prefetch(first, (uint32_t)((offset + len - 1) / BLOCK_SIZE) - first + 1);
+}
+
+// Eşleme sayfa sınırından başlamalı: aralığın öncesindeki kısım da eşlenir.
+// Eşlenen adres dosya konumuyla aynı sayfa içi kaymaya sahip olduğundan
+// sonraki çağrılar kaymayı adresten bulur.
+static off_t disk_map_delta(uint64_t pos) {
+    long page = sysconf(_SC_PAGESIZE);
+    if (page <= 0) page = 4096;
+    return (off_t)(pos % (uint64_t)page);
+}
+
+// Veri bölgesinin bir aralığını imaj dosyasından belleğe eşler. Mantıksal
+// blok == fiziksel blok olmayan dedup ve günlük yapılı modda desteklenmez; şeritli kümede
+// aralık tek bir parçada (tek aygıtta) kalmalıdır. Eşleme diske bağlı
+// olduğundan aralık bellek katmanından indirilir ve eşlemeler açıkken
+// hiçbir aralık belleğe alınmaz.
+int disk_map(uint64_t offset, size_t len, int writable, void **addr_out) {
+    if (dedup_active()) FS_FAIL(FS_ERR_UNSUPPORTED, "disk_map: not supported on dedup images");
+    if (lfs_active()) FS_FAIL(FS_ERR_UNSUPPORTED, "disk_map: not supported on log-structured images");
+    if (dio_enabled()) FS_FAIL(FS_ERR_UNSUPPORTED, "disk_map: not supported with direct I/O");
+    int rc = disk_open();
+    if (rc < 0) return rc;
+    uint64_t end = disk_data_end();
+    if (len == 0 || offset > end || len > end - offset) {
+        FS_FAIL(FS_ERR_RANGE, "disk_map: range outside data region");
+    }
+    if ((rc = memtier_evict(offset, len)) < 0) return rc;
+    if (writable) {
+        disk_trim_cancel(offset, len);
+        share_note_write();
+    }
+    off_t pos = METADATA_SIZE + (off_t)offset;
+    int fd = disk_fds[0];
+    if (stripe_active() && (fd = stripe_locate(offset, len, &pos)) < 0) {
+        FS_FAIL(FS_ERR_UNSUPPORTED, "disk_map: range crosses a stripe unit");
+    }
+    off_t delta = disk_map_delta((uint64_t)pos);
+    void *p = mmap(NULL, len + (size_t)delta, PROT_READ | (writable ? PROT_WRITE : 0),
+                   MAP_SHARED, fd, pos - delta);
+    STATS_SYSCALL(1);
+    if (p == MAP_FAILED) FS_FAIL(FS_ERR_IO, "disk_map: mmap: %s", strerror(errno));
+    *addr_out = (uint8_t *)p + delta;
+    disk_maps++;
+    return 0;
+}
+
+// Eşleme üzerinden yapılan yazımları imaja aktarır; önbellekteki kopyalar
+// artık eski olabileceğinden aralık önbellekten düşürülür
+int disk_map_sync(void *addr, uint64_t offset, size_t len) {
+    off_t delta = disk_map_delta((uintptr_t)addr);
+    share_note_write();
+    int rc = msync((uint8_t *)addr - delta, len + (size_t)delta, MS_SYNC);
+    STATS_SYSCALL(1);
+    uint32_t first = (uint32_t)(offset / BLOCK_SIZE);
+    bcache_invalidate(first, (uint32_t)((offset + len - 1) / BLOCK_SIZE) - first + 1);
+    if (rc < 0) FS_FAIL(FS_ERR_IO, "disk_map_sync: msync: %s", strerror(errno));
+    return 0;
+}
+
+int disk_unmap(void *addr, uint64_t offset, size_t len) {
+    (void)offset;               // kayma adresten bulunur
+    off_t delta = disk_map_delta((uintptr_t)addr);
+    STATS_SYSCALL(1);
+    if (munmap((uint8_t *)addr - delta, len + (size_t)delta) < 0) {
+        FS_FAIL(FS_ERR_IO, "disk_unmap: munmap: %s", strerror(errno));
+    }
+    disk_maps--;
+    return 0;
+}
+
+// Eşlemeyi aynı adreste sıfır sayfalarla değiştirir: imaj yeniden yazıldığında
+// (format/restore) veya bloklar başka dosyaya geçebileceğinde işaretçi geçerli
+// kalır ama artık diske bağlı değildir
+int disk_map_detach(void *addr, uint64_t offset, size_t len) {
+    (void)offset;               // kayma adresten bulunur
+    off_t delta = disk_map_delta((uintptr_t)addr);
+    void *p = mmap((uint8_t *)addr - delta, len + (size_t)delta, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+    STATS_SYSCALL(1);
+    if (p == MAP_FAILED) FS_FAIL(FS_ERR_IO, "disk_map_detach: mmap: %s", strerror(errno));
+    return 0;
+}
+
+// Disk imajını (şeritli kümede tüm aygıt dosyalarını) sıfırdan oluşturur:
+// dosyalar kesilip tam boyuta ayarlanır (içerik delik olarak kalır) ve md,
+// şeritleme geometrisi doldurularak aygıt 0'ın başına yazılır. Açık imaj
+// bırakılır; şeritli kümede yeni geometri hemen bağlanır (disk_image_write).
+int disk_create(DiskMetadata *md) {
+    int multi = disk_ndev > 1;
+    md->stripe_devices = multi ? (uint32_t)disk_ndev : 0;
+    md->stripe_blocks  = multi ? stripe_width : 0;
+    off_t size = multi ? (off_t)stripe_member_size(disk_ndev, stripe_width) : DISK_SIZE;
+    uint32_t gen = share_next_gen();
+    md->flags = (md->flags & ~SHARE_GEN_MASK) | (gen << SHARE_GEN_SHIFT);
+
+    disk_reset();
+    for (int i = 0; i < disk_ndev; ++i) {
+        int fd = open(disk_members[i], O_CREAT | O_TRUNC | O_RDWR, 0666);
+        STATS_SYSCALL(1);
+        if (fd < 0) FS_FAIL(FS_ERR_IO, "disk_create: open '%s': %s", disk_members[i], strerror(errno));
+        int ok = ftruncate(fd, size) == 0 &&
+                 (i > 0 || pwrite(fd, md, METADATA_SIZE, 0) == METADATA_SIZE);
+        int err = errno;
+        close(fd);
+        STATS_SYSCALL(i ? 2 : 3);   // ftruncate, (pwrite), close
+        if (!ok) FS_FAIL(FS_ERR_IO, "disk_create: '%s': %s", disk_members[i], strerror(err));
+    }
+    share_gen_written(gen);
+    share_forget();             // Bellekteki metadata md değil
+    if (!multi) return 0;
+    int rc = disk_open();
+    if (rc == 0 && (rc = stripe_attach(disk_data_fds(), disk_ndev, stripe_width)) == 0) {
+        stripe_blocks_active = stripe_width;
+    }
+    return rc;
+}
+
+// Her aygıt dosyası açılabilmeli ve geometrinin gerektirdiği boyutta olmalı.
+// Düz tek imaj küçültülmüş olabilir (bkz. disk_resize): metadata ve satır içi
+// alan sığmalı, dosyaların kapasiteye sığdığını fs_check_integrity denetler.
+int disk_check_devices(void) {
+    int rc = disk_open();
+    if (rc < 0) return 1;
+    off_t want = stripe_active() ? (off_t)stripe_member_size(disk_ndev, stripe_blocks_active) : DISK_SIZE;
+    if (disk_ndev == 1 && !disk_translated()) {
+        want = METADATA_SIZE + ((metadata.flags & DISK_FLAG_INLINE) ? (off_t)INLINE_BLOCKS * BLOCK_SIZE : 0);
+    }
+    int bad = 0;
+    for (int i = 0; i < disk_ndev; ++i) {
+        struct stat st;
+        STATS_SYSCALL(1);
+        if (fstat(disk_fds[i], &st) < 0 || st.st_size < want) {
+            FS_ERROR("disk: device '%s' is shorter than %lld bytes", disk_members[i], (long long)want);
+            bad++;
+        }
+    }
+    return bad;
+}
+
+// Düz tek imajın veri bölgesini blocks bloğa büyütür/küçültür (en fazla
+// DATA_BLOCKS). Kesilen kuyruktaki bloklar artık hiçbir dosyaya ait
+// olmamalıdır (fs_resize önce dosyaları taşır); önbellekteki kopyaları ve
+// bekleyen delmeleri bırakılır. Büyüyen kısım delik olarak eklenir.
+int disk_resize(uint32_t blocks) {
+    int rc = disk_open();
+    if (rc < 0) return rc;
+    if (disk_ndev > 1) FS_FAIL(FS_ERR_UNSUPPORTED, "disk_resize: striped sets cannot be resized");
+    if (disk_translated()) {
+        FS_FAIL(FS_ERR_UNSUPPORTED, "disk_resize: dedup and log-structured images use the whole data region");
+    }
+    if (blocks > DATA_BLOCKS) {
+        FS_FAIL(FS_ERR_INVALID, "disk_resize: %u blocks (at most %u)", blocks, (unsigned)DATA_BLOCKS);
+    }
+    if (blocks < disk_image_blocks) {
+        uint32_t tail = disk_image_blocks - blocks;
+        memtier_discard(blocks, tail);
+        bcache_invalidate(blocks, tail);
+        trim_cancel(blocks, tail);
+    }
+    STATS_SYSCALL(1);
+    if (ftruncate(disk_fds[0], METADATA_SIZE + (off_t)blocks * BLOCK_SIZE) < 0) {
+        FS_FAIL(FS_ERR_IO, "disk_resize: ftruncate: %s", strerror(errno));
+    }
+    share_note_write();
+    disk_image_blocks = blocks;
+    return 0;
+}
+
+// Aygıt dosyalarının toplam boyutu ve ana makinede gerçekten kapladığı yer
+int disk_usage(uint64_t *size_out, uint64_t *allocated_out) {
+    int rc = disk_open();
+    if (rc < 0) return rc;
+    uint64_t size = 0, allocated = 0;
+    for (int i = 0; i < disk_ndev; ++i) {
+        struct stat st;
+        STATS_SYSCALL(1);
+        if (fstat(disk_fds[i], &st) < 0) FS_FAIL(FS_ERR_IO, "disk_usage: fstat '%s': %s", disk_members[i], strerror(errno));
+        size += (uint64_t)st.st_size;
+        allocated += (uint64_t)st.st_blocks * 512;
+    }
+    *size_out = size;
+    *allocated_out = allocated;
+    return 0;
+}
+
+// İmaj dışarıdan yeniden yazılmadan önce (restore): arka plan işçileri
+// durdurulur, bekleyen delmeler unutulur
+void disk_quiesce(void) {
+    lfs_shutdown();
+    trim_drop();
+}
+
+static ssize_t disk_image_io(uint64_t offset, uint8_t *buffer, size_t size, int write) {
+    const char *who = write ? "disk_image_write" : "disk_image_read";
+    int rc = disk_open();
+    if (rc < 0) return rc;
+    if (offset >= DISK_SIZE) return 0;
+    if (size > DISK_SIZE - offset) size = DISK_SIZE - offset;
+
+    size_t done = 0;
+    if (offset < METADATA_SIZE) {
+        done = size < METADATA_SIZE - offset ? size : (size_t)(METADATA_SIZE - offset);
+        if (write) share_note_write();
+        ssize_t r = write ? pwrite(disk_fds[0], buffer, done, (off_t)offset)
+                          : pread(disk_fds[0], buffer, done, (off_t)offset);
+        STATS_SYSCALL(1);
+        if (r != (ssize_t)done) FS_FAIL(FS_ERR_IO, "%s: metadata: %s", who, r < 0 ? strerror(errno) : "short");
+    }
+    if (done < size) {
+        ssize_t r = disk_raw_io(offset + done - METADATA_SIZE, buffer + done, size - done, write, who);
+        if (r < 0) return r;
+        done += (size_t)r;
+    }
+    return (ssize_t)done;
+}
+
+ssize_t disk_image_read(uint64_t offset, void *buffer, size_t size) {
+    return disk_image_io(offset, buffer, size, 0);
+}
+
+ssize_t disk_image_write(uint64_t offset, const void *buffer, size_t size) {
+    return disk_image_io(offset, (uint8_t *)buffer, size, 1);
+}
+
+// Disk dosyalarını kapatır
+static void disk_close() {
+    stripe_detach();
+    disk_close_direct();
+    for (int i = 0; i < STRIPE_MAX_DEVICES; ++i) {
+        if (disk_fds[i] >= 0) {
+            close(disk_fds[i]);
+            STATS_SYSCALL(1);
+            disk_fds[i] = -1;
+        }
+    }
+}
+
+// Program başladığında fd’leri başlat
+__attribute__((constructor))
+static void init_disk() {
+    for (int i = 0; i < STRIPE_MAX_DEVICES; ++i) disk_fds[i] = disk_dfds[i] = -1;
+}
+
+// Program bittiğinde diski kapat; temizleyici tanıtıcılar kapanmadan durdurulur
+__attribute__((destructor))
+static void cleanup_disk() {
+    share_shutdown();
+    lfs_shutdown();
+    if (disk_fds[0] >= 0) disk_flush();
+    disk_close();
+}
+
+// Dosya katmanından erişim ipucu (bkz. memtier.h). Dedup ve günlük yapılı
+// modda mantıksal bloklar fiziksel bloklara denk gelmez, eşlemeler açıkken
+// imaj doğrudan değişebilir; bu durumlarda belleğe alma yapılmaz.
+int disk_tier_access(uint32_t first_block, uint32_t count) {
+    if (disk_translated() || disk_maps > 0) return 0;
+    return memtier_access(first_block, count);
+}
+
+// Ölçüm sarmalayıcıları (bkz. stats.h)
+int disk_read_metadata(void) {
+    STATS_CALL(STAT_DISK_READ_METADATA, int, disk_read_metadata_impl());
+}
+
+int disk_write_metadata(void) {
+    STATS_CALL(STAT_DISK_WRITE_METADATA, int, disk_write_metadata_impl());
+}
+
+int disk_phys_read(uint32_t pblock, uint32_t count, void *buffer) {
+    uint64_t t0 = STATS_BEGIN();
+    int r = disk_phys_read_impl(pblock, count, buffer);
+    STATS_END(STAT_DISK_PHYS_READ, t0, r == 0, r == 0 ? (uint64_t)count * BLOCK_SIZE : 0);
+    return r;
+}
+
+int disk_phys_write(uint32_t pblock, uint32_t count, const void *buffer) {
+    uint64_t t0 = STATS_BEGIN();
+    int r = disk_phys_write_impl(pblock, count, buffer);
+    STATS_END(STAT_DISK_PHYS_WRITE, t0, r == 0, r == 0 ? (uint64_t)count * BLOCK_SIZE : 0);
+    return r;
+}
+
+int disk_read_block(uint32_t block_index, void *buffer) {
+    uint64_t t0 = STATS_BEGIN();
+    int r = disk_read_block_impl(block_index, buffer);
+    STATS_END(STAT_DISK_READ_BLOCK, t0, r == 0, r == 0 ? BLOCK_SIZE : 0);
+    return r;
+}
+
+int disk_write_block(uint32_t block_index, const void *buffer) {
+    uint64_t t0 = STATS_BEGIN();
+    int r = disk_write_block_impl(block_index, buffer);
+    STATS_END(STAT_DISK_WRITE_BLOCK, t0, r == 0, r == 0 ? BLOCK_SIZE : 0);
+    return r;
+}
+
+ssize_t disk_read_data(uint64_t offset, void *buffer, size_t size) {
+    STATS_CALL_IO(STAT_DISK_READ_DATA, ssize_t, disk_read_data_impl(offset, buffer, size));
+}
+
+ssize_t disk_write_data(uint64_t offset, const void *buffer, size_t size) {
+    STATS_CALL_IO(STAT_DISK_WRITE_DATA, ssize_t, disk_write_data_impl(offset, buffer, size));
+}
+
+int disk_discard(uint32_t first_block, uint32_t count) {
+    STATS_CALL(STAT_DISK_DISCARD, int, disk_discard_impl(first_block, count));
+}
+
+ssize_t disk_readv_data(uint64_t offset, const struct iovec *iov, int iovcnt) {
+    STATS_CALL_IO(STAT_DISK_READV_DATA, ssize_t, disk_rw_vec(offset, iov, iovcnt, 0));
+}
+
+ssize_t disk_writev_data(uint64_t offset, const struct iovec *iov, int iovcnt) {
+    STATS_CALL_IO(STAT_DISK_WRITEV_DATA, ssize_t, disk_rw_vec(offset, iov, iovcnt, 1));
+}
+
+int disk_zero_range(uint64_t offset, uint64_t len) {
+    STATS_CALL(STAT_DISK_ZERO_RANGE, int, disk_zero_range_impl(offset, len));
+}
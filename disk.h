@@ -1,36 +1,140 @@
-#ifndef DISK_H
-#define DISK_H
-
-#include <stdint.h>   // uint32_t gibi sabit boyutlu tamsayılar
-#include <time.h>     // time_t zaman türü
-
-#define DISK_NAME       "disk.sim"            // Sanal disk dosya adı
-#define DISK_SIZE       (1024 * 1024)         // 1 MB = 1024 * 1024 byte
-#define METADATA_SIZE   (4 * 1024)            // 4 KB metadata alanı
-#define BLOCK_SIZE      512                   // Sabit blok boyutu (byte)
-
-typedef struct {
-    char     name[32];        // Dosya ismi (maks. 31 karakter + null)
-    uint32_t size;            // Dosya boyutu (byte)
-    uint32_t start_block;     // Veri bloğundaki başlangıç indeksi
-    time_t   created;         // Oluşturulma zamanı (Unix zaman damgası)
-} FileEntry;
-
-#define MAX_FILES ((METADATA_SIZE - sizeof(uint32_t)) / sizeof(FileEntry))
-// Dosya sayısı = metadata'dan kalan alan / bir dosya kaydının boyutu
-
-typedef struct {
-    uint32_t    file_count;               // Toplam dosya sayısı
-    FileEntry   entries[MAX_FILES];       // Dosya kayıtları
-} DiskMetadata;
-
-extern DiskMetadata metadata;  // Diğer .c dosyalarında kullanılacak global metadata
-
-// Fonksiyon prototipleri
-int  disk_open(void);                                      // disk.sim dosyasını aç
-int  disk_read_metadata(void);                             // metadata'yı oku
-int  disk_write_metadata(void);                            // metadata'yı diske yaz
-int  disk_read_block(uint32_t block_index, void *buffer);  // belirli bloktan veri oku
-int  disk_write_block(uint32_t block_index, const void *buffer); // belirli bloğa veri yaz
-
-#endif // DISK_H
+#ifndef DISK_H
+#define DISK_H
+
+#include <stdint.h>   // uint32_t gibi sabit boyutlu tamsayılar
+#include <stddef.h>   // size_t
+#include <sys/types.h> // ssize_t
+#include <sys/uio.h>   // struct iovec
+#include <time.h>     // time_t zaman türü
+
+#define DISK_NAME       "disk.sim"            // Sanal disk dosya adı
+#define DISK_SIZE       (1024 * 1024)         // 1 MB = 1024 * 1024 byte
+#define METADATA_SIZE   (4 * 1024)            // 4 KB metadata alanı
+#define BLOCK_SIZE      512                   // Sabit blok boyutu (byte)
+
+#define DATA_SIZE       (DISK_SIZE - METADATA_SIZE)   // Veri bölgesinin boyutu
+#define DATA_BLOCKS     (DATA_SIZE / BLOCK_SIZE)      // Veri bölgesindeki blok sayısı
+
+// Metadata bayrakları (format sırasında belirlenir)
+#define DISK_FLAG_DEDUP 0x1u                  // İçerik adresli blok tekilleştirme açık
+#define DISK_FLAG_INLINE 0x2u                 // Küçük dosyalar satır içi alanda tutulur
+#define DISK_FLAG_LOG   0x4u                  // Veri bölgesi günlük yapılı (bkz. lfs.h)
+
+typedef struct {
+    char     name[32];        // Dosya ismi (maks. 31 karakter + null)
+    uint32_t size;            // Dosya boyutu (byte)
+    uint32_t start_block;     // Veri bloğundaki başlangıç indeksi
+    time_t   created;         // Oluşturulma zamanı (Unix zaman damgası)
+} FileEntry;
+
+#define MAX_FILES ((METADATA_SIZE - 4 * sizeof(uint32_t)) / sizeof(FileEntry))
+// Dosya sayısı = metadata'dan kalan alan / bir dosya kaydının boyutu
+
+typedef struct {
+    uint32_t    file_count;               // Toplam dosya sayısı
+    uint32_t    flags;                    // DISK_FLAG_* (eski imajlarda hizalama boşluğu, yani 0)
+    FileEntry   entries[MAX_FILES];       // Dosya kayıtları
+    uint32_t    stripe_devices;           // Şeritli kümede aygıt sayısı (0 = tek imaj dosyası)
+    uint32_t    stripe_blocks;            // Şerit parçası (blok); eski imajlarda bu alan 0
+} DiskMetadata;
+
+extern DiskMetadata metadata;  // Diğer .c dosyalarında kullanılacak global metadata
+
+// Satır içi alan (DISK_FLAG_INLINE): her dosya kaydı için INLINE_MAX byte'lık
+// bir yuva, veri bölgesinin ilk INLINE_BLOCKS bloğunda, yani metadata'nın hemen
+// ardında durur ve metadata ile aynı okuma çağrısında belleğe alınır. Satır içi
+// bir dosyanın start_block alanı INLINE_SLOT | yuva numarasıdır; yuvada dosya
+// sonundan sonraki baytlar her zaman sıfırdır.
+#define INLINE_MAX      128
+#define INLINE_BLOCKS   ((uint32_t)((MAX_FILES * INLINE_MAX + BLOCK_SIZE - 1) / BLOCK_SIZE))
+#define INLINE_SLOT     0x80000000u
+
+extern uint8_t inline_area[MAX_FILES][INLINE_MAX];
+
+// Fonksiyon prototipleri
+int  disk_open(void);                                      // disk.sim dosyasını aç
+int  disk_set_path(const char *path);                      // farklı bir disk imajı seç ("a.sim,b.sim" = şeritli küme)
+const char *disk_path(void);                               // kullanılan disk imajının yolu
+int  disk_exists(void);                                    // imaj (kümenin ilk aygıtı) var mı
+int  disk_create(DiskMetadata *md);                        // imajı/aygıtları sıfırdan oluştur, md'yi yaz
+void disk_reset(void);                                     // fd'yi ve önbellekli katman durumunu bırak (format/restore sonrası)
+void disk_quiesce(void);                                   // arka plan işlerini durdur (imaj dışarıdan yazılacak)
+int  disk_reload(void);                                    // imaj başka süreçte değişti: önbellekleri bırak, metadata'yı oku
+void disk_drop_caches(void);                               // veri önbelleklerini bırak (başka süreç yerinde yazdı)
+int  disk_pending(void);                                   // bellekte imaja yazılmamış katman durumu var mı
+int  disk_release_state(void);                             // bekleyen durumu yaz, arka plan işlerini durdur
+int  disk_read_metadata(void);                             // metadata'yı oku
+int  disk_write_metadata(void);                            // metadata'yı diske yaz
+int  disk_write_inline(uint32_t slot);                     // satır içi yuvayı diske yaz
+int  disk_read_block(uint32_t block_index, void *buffer);  // belirli bloktan veri oku
+int  disk_write_block(uint32_t block_index, const void *buffer); // belirli bloğa veri yaz
+
+// Veri bölgesi üzerinde bayt aralığı G/Ç (offset veri bölgesinin başına göre)
+ssize_t disk_read_data(uint64_t offset, void *buffer, size_t size);
+ssize_t disk_write_data(uint64_t offset, const void *buffer, size_t size);
+int     disk_discard(uint32_t first_block, uint32_t count); // artık kullanılmayan blokları bırak
+int     disk_zero_range(uint64_t offset, uint64_t len);      // aralık sıfır okunur, tam bloklar delik olur
+void    disk_readahead(uint64_t offset, uint64_t len);       // aralığı arka planda önbelleğe al (ipucu)
+int     disk_flush(void);                                    // bellekte bekleyen katman durumunu imaja yaz
+int     disk_sync(void);                                     // imajı kalıcı belleğe aktar (fdatasync)
+
+// Kapasite: düz tek imajda veri bölgesi imaj dosyasının boyutunda biter ve
+// disk_resize ile çevrimiçi büyütülüp küçültülebilir (en fazla DATA_BLOCKS;
+// kesilen kuyrukta dosya kalmamalıdır). Dedup, günlük yapılı imajlar ve
+// şeritli kümeler bölgenin tamamını kullanır, boyutları değiştirilemez.
+uint32_t disk_capacity(void);                              // kullanılabilir veri bloğu
+int      disk_resize(uint32_t blocks);
+int      disk_usage(uint64_t *size_out, uint64_t *allocated_out); // imaj boyutu / ana makinede kaplanan
+
+// Vektörlü G/Ç: offset'ten başlayan bitişik aralık sırayla birden çok tampona
+// okunur / tampondan yazılır. Düz modda IOV_MAX tampon başına tek preadv/pwritev.
+ssize_t disk_readv_data(uint64_t offset, const struct iovec *iov, int iovcnt);
+ssize_t disk_writev_data(uint64_t offset, const struct iovec *iov, int iovcnt);
+
+// Bellek eşlemesi (yalnızca düz mod): offset/len veri bölgesine göre; adres
+// sayfa hizalı olmayabilir, sync/unmap/detach aynı offset ve len ile çağrılır
+int disk_map(uint64_t offset, size_t len, int writable, void **addr_out);
+int disk_map_sync(void *addr, uint64_t offset, size_t len);   // msync + önbellekten düşür
+int disk_unmap(void *addr, uint64_t offset, size_t len);
+int disk_map_detach(void *addr, uint64_t offset, size_t len); // diskten ayır (sıfır sayfalar)
+
+// Delik sorguları (SEEK_DATA / SEEK_HOLE benzeri): offset'ten itibaren ilk veri /
+// ilk delik konumu, yoksa DATA_SIZE. Blok ya da ana makine sayfası hassasiyetinde
+// olduğundan sıfır içeren bir alan veri olarak da görülebilir.
+int64_t disk_next_data(uint64_t offset);
+int64_t disk_next_hole(uint64_t offset);
+
+// Şeritleme (bkz. stripe.h): disk_set_path virgülle ayrılmış birden çok imaj
+// dosyası aldığında veri bölgesi bu dosyalara parça parça dağıtılır. Parça
+// boyutu format/restore sırasında disk_set_stripe_width ile seçilir ve
+// metadata'ya yazılır; açılışta verilen aygıt sayısı metadata ile eşleşmelidir.
+int      disk_set_stripe_width(uint32_t blocks);           // sonraki format için parça (blok)
+int      disk_devices(void);                               // aygıt (imaj dosyası) sayısı
+const char *disk_device(int index);                        // aygıt dosyasının yolu (0 = metadata'yı tutan)
+uint32_t disk_stripe_blocks(void);                         // etkin parça boyutu (tek aygıtta 0)
+int      disk_check_devices(void);                         // eksik/kısa aygıt sayısı (hatalar loglanır)
+
+// Doğrudan G/Ç (varsayılan kapalı; bkz. dio.h): veri bölgesi O_DIRECT ile
+// açılmış tanıtıcılardan okunur/yazılır ve ana makinenin sayfa önbelleğine
+// girmez; metadata önbellekli kalır. Dosya sistemi desteklemiyorsa
+// FS_ERR_UNSUPPORTED döner. Açıkken disk_map kullanılamaz.
+int      disk_set_direct(int on);
+int      disk_direct(void);
+
+// Düz imaj üzerinde ham G/Ç (yedekleme): offset metadata dahil imajın başına
+// göredir, çeviri katmanı ve önbellek atlanır; şeritli kümede aygıtlar
+// paralel okunur/yazılır. Yazımdan sonra çağıran disk_reset yapmalıdır.
+ssize_t disk_image_read(uint64_t offset, void *buffer, size_t size);
+ssize_t disk_image_write(uint64_t offset, const void *buffer, size_t size);
+
+// Bellek katmanı (bkz. memtier.h): dosya katmanı her erişimde dosyanın blok
+// aralığını bildirir; sık erişilen aralıklar belleğe alınır ve veri G/Ç'si
+// oradan karşılanır. Kirli veri disk_sync ile diske yazılır.
+int  disk_tier_access(uint32_t first_block, uint32_t count);
+
+// Fiziksel katman: çeviri katmanlarının (dedup) kullandığı ham blok G/Ç
+int  disk_phys_read(uint32_t pblock, uint32_t count, void *buffer);
+int  disk_phys_write(uint32_t pblock, uint32_t count, const void *buffer);
+int  disk_phys_punch(uint32_t pblock, uint32_t count);     // imajda delik aç (bkz. trim.h)
+
+#endif // DISK_H
@@ -1,809 +1,2984 @@
-#define _POSIX_C_SOURCE 200809L
-
-#include "fs.h"
-#include "disk.h"
-
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include <fcntl.h>
-#include <sys/stat.h>    // ← stat için
-#ifdef _WIN32
-    #include <io.h>
-    #define ftruncate _chsize
-#else
-    #include <unistd.h>  // Bu satır kesinlikle burada olmalı
-#endif
-
-
-#define LOG_FILENAME  "fs_operations.log"
-
-// Format (initialize) the disk
-int fs_format(void) {
-    int fd = open(DISK_NAME, O_CREAT | O_TRUNC | O_RDWR, 0666);
-    if (fd < 0) { perror("fs_format: open"); return -1; }
-    if (ftruncate(fd, DISK_SIZE) < 0) { perror("fs_format: ftruncate"); close(fd); return -1; }
-
-    void *zero = calloc(1, METADATA_SIZE);
-    if (!zero) { perror("fs_format: calloc"); close(fd); return -1; }
-    if (lseek(fd, 0, SEEK_SET) < 0 || write(fd, zero, METADATA_SIZE) != METADATA_SIZE) {
-        perror("fs_format: write metadata"); free(zero); close(fd); return -1;
-    }
-    free(zero);
-
-    if (lseek(fd, DISK_SIZE - 1, SEEK_SET) < 0 || write(fd, "\0", 1) != 1) {
-        perror("fs_format: allocate data"); close(fd); return -1;
-    }
-    close(fd);
-    return 0;
-}
-
-// Create a new file in metadata
-int fs_create(const char *filename) {
-    if (!filename || !*filename || strlen(filename) >= sizeof(metadata.entries[0].name)) {
-        fprintf(stderr, "fs_create: invalid name\n");
-        return -1;
-    }
-    if (disk_read_metadata() < 0) { fprintf(stderr, "fs_create: read_meta\n"); return -1; }
-
-    for (uint32_t i = 0; i < metadata.file_count; ++i) {
-        if (strcmp(metadata.entries[i].name, filename) == 0) {
-            fprintf(stderr, "fs_create: '%s' exists\n", filename);
-            return -1;
-        }
-    }
-    if (metadata.file_count >= MAX_FILES) {
-        fprintf(stderr, "fs_create: max files reached\n");
-        return -1;
-    }
-
-    FileEntry *e = &metadata.entries[metadata.file_count];
-    memset(e, 0, sizeof(*e));
-    strncpy(e->name, filename, sizeof(e->name)-1);
-    e->size = 0;
-    e->start_block = 0;
-    e->created = time(NULL);
-    metadata.file_count++;
-
-    if (disk_write_metadata() < 0) { fprintf(stderr, "fs_create: write_meta\n"); return -1; }
-    printf("fs_create: '%s' created\n", filename);
-    return 0;
-}
-
-// Delete a file from metadata
-int fs_delete(const char *filename) {
-    if (disk_read_metadata() < 0) {
-        fprintf(stderr, "fs_delete: read_meta\n");
-        return -1;
-    }
-    int idx = -1;
-    for (uint32_t i = 0; i < metadata.file_count; ++i) {
-        if (strcmp(metadata.entries[i].name, filename) == 0) {
-            idx = i;
-            break;
-        }
-    }
-    if (idx < 0) {
-        fprintf(stderr, "fs_delete: '%s' not found\n", filename);
-        return -1;
-    }
-    // shift entries
-    for (uint32_t i = idx; i + 1 < metadata.file_count; ++i) {
-        metadata.entries[i] = metadata.entries[i + 1];
-    }
-    metadata.file_count--;
-    memset(&metadata.entries[metadata.file_count], 0, sizeof(FileEntry));
-
-    if (disk_write_metadata() < 0) {
-        fprintf(stderr, "fs_delete: write_meta\n");
-        return -1;
-    }
-    printf("fs_delete: '%s' deleted\n", filename);
-    return 0;
-}
-
-// Overwrite data into a file
-ssize_t fs_write(const char *filename, const void *data, size_t size) {
-    if (size == 0) return 0;
-    if (disk_read_metadata() < 0) { fprintf(stderr, "fs_write: read_meta\n"); return -1; }
-
-    FileEntry *e = NULL;
-    for (uint32_t i = 0; i < metadata.file_count; ++i) {
-        if (strcmp(metadata.entries[i].name, filename) == 0) {
-            e = &metadata.entries[i];
-            break;
-        }
-    }
-    if (!e) {
-        fprintf(stderr, "fs_write: '%s' not found\n", filename);
-        return -1;
-    }
-
-    int fd = open(DISK_NAME, O_RDWR);
-    if (fd < 0) { perror("fs_write: open disk"); return -1; }
-
-    off_t abs_off = METADATA_SIZE + (off_t)e->start_block * BLOCK_SIZE;
-    if (lseek(fd, abs_off, SEEK_SET) < 0) { perror("fs_write: lseek"); close(fd); return -1; }
-    ssize_t written = write(fd, data, size);
-    if (written < 0) { perror("fs_write: write"); close(fd); return -1; }
-    close(fd);
-
-    if ((uint32_t)written > e->size) {
-        e->size = (uint32_t)written;
-        if (disk_write_metadata() < 0) {
-            fprintf(stderr, "fs_write: write_meta\n");
-            return -1;
-        }
-    }
-    printf("fs_write: '%s' -> %zd bytes\n", filename, written);
-    return written;
-}
-//************************************************************************************************ */
-// Read data from a file
-ssize_t fs_read(const char *filename, uint32_t offset, size_t size, void *buffer) {
-    if (size == 0) return 0;
-    if (disk_read_metadata() < 0) { fprintf(stderr, "fs_read: read_meta\n"); return -1; }
-
-    FileEntry *e = NULL;
-    for (uint32_t i = 0; i < metadata.file_count; ++i) {
-        if (strcmp(metadata.entries[i].name, filename) == 0) {
-            e = &metadata.entries[i];
-            break;
-        }
-    }
-    if (!e) {
-        fprintf(stderr, "fs_read: '%s' not found\n", filename);
-        return -1;
-    }
-    if (offset >= e->size) {
-        fprintf(stderr, "fs_read: offset beyond size\n");
-        return -1;
-    }
-
-    int fd = open(DISK_NAME, O_RDONLY);
-    if (fd < 0) { perror("fs_read: open disk"); return -1; }
-
-    off_t abs_off = METADATA_SIZE + (off_t)e->start_block * BLOCK_SIZE + offset;
-    if (lseek(fd, abs_off, SEEK_SET) < 0) { perror("fs_read: lseek"); close(fd); return -1; }
-    memset(buffer, 0, size);
-    ssize_t rd = read(fd, buffer, size);
-    if (rd < 0) { perror("fs_read: read"); close(fd); return -1; }
-    close(fd);
-
-    printf("fs_read: '%s' <- %zd bytes\n", filename, rd);
-    return rd;
-}
-// Tüm dosyayı okuyup buffer'a yazar
-ssize_t fs_read_all(const char *filename, void *buffer) {
-    if (disk_read_metadata() < 0) {
-        fprintf(stderr, "fs_read_all: read_meta\n");
-        return -1;
-    }
-
-    FileEntry *e = NULL;
-    for (uint32_t i = 0; i < metadata.file_count; ++i) {
-        if (strcmp(metadata.entries[i].name, filename) == 0) {
-            e = &metadata.entries[i];
-            break;
-        }
-    }
-    if (!e) {
-        fprintf(stderr, "fs_read_all: '%s' not found\n", filename);
-        return -1;
-    }
-
-    return fs_read(filename, 0, e->size, buffer);  // Offset = 0, size = tüm dosya
-}
-//***************************************************************************************** */
-// Copy stub
-// fs.c — implement fs_copy
-
-#define COPY_CHUNK_SIZE BLOCK_SIZE
-
-int fs_copy(const char *src_filename, const char *dest_filename) {
-    // 1) kaynak dosya var mı?
-    if (!fs_exists(src_filename)) {
-        fprintf(stderr, "fs_copy: source '%s' not found\n", src_filename);
-        return -1;
-    }
-    // 2) hedef zaten varsa hata
-    if (fs_exists(dest_filename)) {
-        fprintf(stderr, "fs_copy: destination '%s' already exists\n", dest_filename);
-        return -1;
-    }
-    // 3) yeni dosya oluştur
-    if (fs_create(dest_filename) < 0) {
-        return -1;
-    }
-    // 4) kaynak boyutunu al
-    uint32_t total_size;
-    if (fs_size(src_filename, &total_size) < 0) {
-        return -1;
-    }
-
-    // 5) blok blok kopyala
-    uint32_t offset = 0;
-    ssize_t n;
-    char *buffer = malloc(COPY_CHUNK_SIZE);
-    if (!buffer) {
-        perror("fs_copy: malloc");
-        return -1;
-    }
-
-    // İlk blokta fs_write, kalanlarda fs_append
-    int first = 1;
-    while (offset < total_size) {
-        size_t to_read = (total_size - offset > COPY_CHUNK_SIZE)
-                         ? COPY_CHUNK_SIZE
-                         : (total_size - offset);
-        n = fs_read(src_filename, offset, to_read, buffer);
-        if (n < 0) {
-            free(buffer);
-            return -1;
-        }
-        if (first) {
-            if (fs_write(dest_filename, buffer, (size_t)n) < 0) {
-                free(buffer);
-                return -1;
-            }
-            first = 0;
-        } else {
-            if (fs_append(dest_filename, buffer, (size_t)n) < 0) {
-                free(buffer);
-                return -1;
-            }
-        }
-        offset += (uint32_t)n;
-    }
-
-    free(buffer);
-    printf("fs_copy: '%s' -> '%s' complete (%u bytes)\n",
-           src_filename, dest_filename, total_size);
-    return 0;
-}
-
-
-// Move stub
-//  After your fs_copy implementation, add:
-
-int fs_mv(const char *old_path, const char *new_path) {
-    // 1) Kaynak dosya var mı?
-    if (!fs_exists(old_path)) {
-        fprintf(stderr, "fs_mv: source '%s' not found\n", old_path);
-        return -1;
-    }
-    // 2) Hedef zaten varsa hata
-    if (fs_exists(new_path)) {
-        fprintf(stderr, "fs_mv: destination '%s' already exists\n", new_path);
-        return -1;
-    }
-    // 3) Kopyalama
-    if (fs_copy(old_path, new_path) < 0) {
-        return -1;
-    }
-    // 4) Orijinali sil
-    if (fs_delete(old_path) < 0) {
-        fprintf(stderr, "fs_mv: copied but failed to delete '%s'\n", old_path);
-        return -1;
-    }
-    printf("fs_mv: '%s' moved to '%s'\n", old_path, new_path);
-    return 0;
-}
-
-// Remaining stubs...
-int fs_ls(void) {
-    if (disk_read_metadata() < 0) {
-        fprintf(stderr, "fs_ls: metadata okunamadı\n");
-        return -1;
-    }
-    printf("=== Files on disk ===\n");
-    for (uint32_t i = 0; i < metadata.file_count; ++i) {
-        FileEntry *e = &metadata.entries[i];
-        printf("%2u: %-32s  %10u bytes\n",
-               i+1, e->name, e->size);
-    }
-    if (metadata.file_count == 0) {
-        printf("(no files)\n");
-    }
-    return 0;
-}
-
-// 2) Rename a file in metadata
-int fs_rename(const char *old_name, const char *new_name) {
-    if (!old_name || !new_name || strlen(new_name) >= sizeof(metadata.entries[0].name)) {
-        fprintf(stderr, "fs_rename: geçersiz isim\n");
-        return -1;
-    }
-    if (disk_read_metadata() < 0) {
-        fprintf(stderr, "fs_rename: metadata okunamadı\n");
-        return -1;
-    }
-    // check new_name not already used
-    for (uint32_t i = 0; i < metadata.file_count; ++i) {
-        if (strcmp(metadata.entries[i].name, new_name) == 0) {
-            fprintf(stderr, "fs_rename: '%s' zaten mevcut\n", new_name);
-            return -1;
-        }
-    }
-    // find old_name
-    for (uint32_t i = 0; i < metadata.file_count; ++i) {
-        if (strcmp(metadata.entries[i].name, old_name) == 0) {
-            // rename
-            memset(metadata.entries[i].name, 0, sizeof(metadata.entries[i].name));
-            strncpy(metadata.entries[i].name, new_name, sizeof(metadata.entries[i].name)-1);
-            if (disk_write_metadata() < 0) {
-                fprintf(stderr, "fs_rename: metadata yazılamadı\n");
-                return -1;
-            }
-            printf("fs_rename: '%s' -> '%s'\n", old_name, new_name);
-            return 0;
-        }
-    }
-    fprintf(stderr, "fs_rename: '%s' bulunamadı\n", old_name);
-    return -1;
-}
-
-// 3) Check if a file exists
-int fs_exists(const char *filename) {
-    if (!filename) return 0;
-    if (disk_read_metadata() < 0) {
-        fprintf(stderr, "fs_exists: metadata okunamadı\n");
-        return 0;
-    }
-    for (uint32_t i = 0; i < metadata.file_count; ++i) {
-        if (strcmp(metadata.entries[i].name, filename) == 0) {
-            return 1;
-        }
-    }
-    return 0;
-}
-// fs.c içinde uygun yere ekleyin:
-
-// 4) Get file size from metadata
-int fs_size(const char *filename, uint32_t *size_out) {
-    if (!filename || !size_out) {
-        fprintf(stderr, "fs_size: invalid arguments\n");
-        return -1;
-    }
-    // Eğer log dosyası isteniyorsa host FS'ten oku
-    if (strcmp(filename, LOG_FILENAME) == 0) {
-        struct stat st;
-        if (stat(LOG_FILENAME, &st) < 0) {
-            perror("fs_size: stat log file");
-            return -1;
-        }
-        *size_out = (uint32_t)st.st_size;
-        return 0;
-    }
-    // Aksi halde virtual FS metadata’dan oku
-    if (disk_read_metadata() < 0) {
-        fprintf(stderr, "fs_size: metadata okunamadı\n");
-        return -1;
-    }
-    for (uint32_t i = 0; i < metadata.file_count; ++i) {
-        if (strcmp(metadata.entries[i].name, filename) == 0) {
-            *size_out = metadata.entries[i].size;
-            return 0;
-        }
-    }
-    fprintf(stderr, "fs_size: '%s' not found\n", filename);
-    return -1;
-}
-
-// 5) Append data to end of file (preserve existing content)
-ssize_t fs_append(const char *filename, const void *data, size_t size) {
-    if (!filename || !data || size == 0) {
-        fprintf(stderr, "fs_append: invalid arguments\n");
-        return -1;
-    }
-    if (disk_read_metadata() < 0) {
-        fprintf(stderr, "fs_append: metadata okunamadı\n");
-        return -1;
-    }
-    FileEntry *e = NULL;
-    for (uint32_t i = 0; i < metadata.file_count; ++i) {
-        if (strcmp(metadata.entries[i].name, filename) == 0) {
-            e = &metadata.entries[i];
-            break;
-        }
-    }
-    if (!e) {
-        fprintf(stderr, "fs_append: '%s' bulunamadı\n", filename);
-        return -1;
-    }
-
-    int fd = open(DISK_NAME, O_RDWR);
-    if (fd < 0) {
-        perror("fs_append: open disk");
-        return -1;
-    }
-    // Hesap: veri bölgesinin başı + mevcut boyut
-    off_t abs_off = METADATA_SIZE + (off_t)e->start_block * BLOCK_SIZE + e->size;
-    if (lseek(fd, abs_off, SEEK_SET) < 0) {
-        perror("fs_append: lseek");
-        close(fd);
-        return -1;
-    }
-    ssize_t written = write(fd, data, size);
-    if (written < 0) {
-        perror("fs_append: write");
-        close(fd);
-        return -1;
-    }
-    close(fd);
-
-    // Metadata boyut güncellemesi
-    e->size += (uint32_t)written;
-    if (disk_write_metadata() < 0) {
-        fprintf(stderr, "fs_append: metadata yazılamadı\n");
-        return -1;
-    }
-    printf("fs_append: '%s' dosyasına %zd byte eklendi\n", filename, written);
-    return written;
-}
-
-// 6) Truncate (or extend with zeros) a file
-int fs_truncate(const char *filename, uint32_t new_size) {
-    if (!filename) {
-        fprintf(stderr, "fs_truncate: invalid argument\n");
-        return -1;
-    }
-    if (disk_read_metadata() < 0) {
-        fprintf(stderr, "fs_truncate: metadata okunamadı\n");
-        return -1;
-    }
-    FileEntry *e = NULL;
-    for (uint32_t i = 0; i < metadata.file_count; ++i) {
-        if (strcmp(metadata.entries[i].name, filename) == 0) {
-            e = &metadata.entries[i];
-            break;
-        }
-    }
-    if (!e) {
-        fprintf(stderr, "fs_truncate: '%s' bulunamadı\n", filename);
-        return -1;
-    }
-
-    // Eğer küçültme ise sadece metadata boyutu değişir
-    if (new_size <= e->size) {
-        e->size = new_size;
-    } else {
-        // Uzatma: araya sıfır dolduralım
-        int fd = open(DISK_NAME, O_RDWR);
-        if (fd < 0) {
-            perror("fs_truncate: open disk");
-            return -1;
-        }
-        off_t abs_off = METADATA_SIZE + (off_t)e->start_block * BLOCK_SIZE + e->size;
-        if (lseek(fd, abs_off, SEEK_SET) < 0) {
-            perror("fs_truncate: lseek");
-            close(fd);
-            return -1;
-        }
-        // Yeni kısma sıfır yaz
-        size_t pad = new_size - e->size;
-        void *zeros = calloc(1, pad);
-        if (!zeros) {
-            perror("fs_truncate: calloc");
-            close(fd);
-            return -1;
-        }
-        if (write(fd, zeros, pad) != (ssize_t)pad) {
-            perror("fs_truncate: write zeros");
-            free(zeros);
-            close(fd);
-            return -1;
-        }
-        free(zeros);
-        close(fd);
-        e->size = new_size;
-    }
-
-    // Metadata kaydet
-    if (disk_write_metadata() < 0) {
-        fprintf(stderr, "fs_truncate: metadata yazılamadı\n");
-        return -1;
-    }
-    printf("fs_truncate: '%s' boyutu %u byte olarak ayarlandı\n", filename, new_size);
-    return 0;
-}
-
-int fs_defragment(void) {
-    if (disk_read_metadata() < 0) {
-        fprintf(stderr, "fs_defragment: metadata okunamadı\n");
-        return -1;
-    }
-
-    // Yeni blok indeksini takip et
-    uint32_t next_block = 0;
-    char *buffer = malloc(BLOCK_SIZE);
-    if (!buffer) { perror("fs_defragment: malloc"); return -1; }
-
-    // Geçici kopya metadata
-    DiskMetadata old_meta = metadata;
-
-    for (uint32_t i = 0; i < old_meta.file_count; ++i) {
-        FileEntry *e_old = &old_meta.entries[i];
-        FileEntry *e_new = &metadata.entries[i];
-
-        uint32_t remaining = e_old->size;
-        uint32_t read_offset = 0;
-        off_t write_base = METADATA_SIZE + (off_t)next_block * BLOCK_SIZE;
-
-        // Her dosya için start_block güncelle
-        e_new->start_block = next_block;
-
-        // Boş blok tanımlandı, bellekte data bölgesini silmemek için sparse skip
-        int fd = open(DISK_NAME, O_RDWR);
-        if (fd < 0) { perror("fs_defragment: open"); free(buffer); return -1; }
-
-        // Parça parça oku ve yeniden yaz
-        while (remaining > 0) {
-            uint32_t chunk = remaining < BLOCK_SIZE ? remaining : BLOCK_SIZE;
-            // Kaynaktan oku
-            if (lseek(fd, METADATA_SIZE + (off_t)e_old->start_block * BLOCK_SIZE + read_offset, SEEK_SET) < 0 ||
-                read(fd, buffer, chunk) != (ssize_t)chunk) {
-                perror("fs_defragment: read");
-                close(fd);
-                free(buffer);
-                return -1;
-            }
-            // Yeni konuma yaz
-            if (lseek(fd, write_base + read_offset, SEEK_SET) < 0 ||
-                write(fd, buffer, chunk) != (ssize_t)chunk) {
-                perror("fs_defragment: write");
-                close(fd);
-                free(buffer);
-                return -1;
-            }
-            read_offset += chunk;
-            remaining  -= chunk;
-        }
-        close(fd);
-
-        // Bir sonraki dosya için blokları atla
-        uint32_t blocks_used = (e_old->size + BLOCK_SIZE - 1) / BLOCK_SIZE;
-        next_block += blocks_used;
-    }
-
-    free(buffer);
-
-    // Yeni metadata’yı diske yaz
-    if (disk_write_metadata() < 0) {
-        fprintf(stderr, "fs_defragment: metadata yazılamadı\n");
-        return -1;
-    }
-    printf("fs_defragment: tamamlandı, %u blok kullanıldı\n", next_block);
-    return 0;
-}
-int fs_check_integrity(void) {
-    if (disk_read_metadata() < 0) {
-        fprintf(stderr, "fs_check_integrity: metadata okunamadı\n");
-        return -1;
-    }
-
-    int fd = open(DISK_NAME, O_RDONLY);
-    if (fd < 0) {
-        perror("fs_check_integrity: open disk");
-        return -1;
-    }
-
-    int errors = 0;
-    for (uint32_t i = 0; i < metadata.file_count; ++i) {
-        FileEntry *e = &metadata.entries[i];
-        off_t data_off = METADATA_SIZE + (off_t)e->start_block * BLOCK_SIZE;
-        // Try to lseek past end of file region
-        off_t end_off = data_off + e->size;
-        if (lseek(fd, end_off, SEEK_SET) < 0) {
-            fprintf(stderr, "fs_check_integrity: '%s' data region invalid (start_block %u, size %u)\n",
-                    e->name, e->start_block, e->size);
-            errors++;
-        }
-    }
-    close(fd);
-
-    if (errors) {
-        fprintf(stderr, "fs_check_integrity: %d bozuk dosya bulundu\n", errors);
-        return -1;
-    }
-    printf("fs_check_integrity: tüm dosyalar tutarlı\n");
-    return 0;
-}
-
-// 11) Backup: copy entire disk.sim into backup_filename
-int fs_backup(const char *backup_filename) {
-    if (!backup_filename) {
-        fprintf(stderr, "fs_backup: geçersiz hedef dosya adı\n");
-        return -1;
-    }
-
-    int src = open(DISK_NAME, O_RDONLY);
-    if (src < 0) {
-        perror("fs_backup: open disk");
-        return -1;
-    }
-    int dst = open(backup_filename, O_CREAT | O_TRUNC | O_WRONLY, 0666);
-    if (dst < 0) {
-        perror("fs_backup: open backup");
-        close(src);
-        return -1;
-    }
-
-    char *buf = malloc(BLOCK_SIZE);
-    if (!buf) {
-        perror("fs_backup: malloc");
-        close(src);
-        close(dst);
-        return -1;
-    }
-
-    ssize_t n;
-    while ((n = read(src, buf, BLOCK_SIZE)) > 0) {
-        if (write(dst, buf, n) != n) {
-            perror("fs_backup: write backup");
-            free(buf);
-            close(src);
-            close(dst);
-            return -1;
-        }
-    }
-    if (n < 0) perror("fs_backup: read disk");
-
-    free(buf);
-    close(src);
-    close(dst);
-    printf("fs_backup: disk '%s' dosyasına yedeklendi\n", backup_filename);
-    return (n < 0) ? -1 : 0;
-}
-
-// 12) Restore: overwrite disk.sim from backup_filename
-int fs_restore(const char *backup_filename) {
-    if (!backup_filename) {
-        fprintf(stderr, "fs_restore: geçersiz kaynak dosya adı\n");
-        return -1;
-    }
-
-    int src = open(backup_filename, O_RDONLY);
-    if (src < 0) {
-        perror("fs_restore: open backup");
-        return -1;
-    }
-    int dst = open(DISK_NAME, O_CREAT | O_TRUNC | O_WRONLY, 0666);
-    if (dst < 0) {
-        perror("fs_restore: open disk");
-        close(src);
-        return -1;
-    }
-
-    char *buf = malloc(BLOCK_SIZE);
-    if (!buf) {
-        perror("fs_restore: malloc");
-        close(src);
-        close(dst);
-        return -1;
-    }
-
-    ssize_t n;
-    while ((n = read(src, buf, BLOCK_SIZE)) > 0) {
-        if (write(dst, buf, n) != n) {
-            perror("fs_restore: write disk");
-            free(buf);
-            close(src);
-            close(dst);
-            return -1;
-        }
-    }
-    if (n < 0) perror("fs_restore: read backup");
-
-    free(buf);
-    close(src);
-    close(dst);
-    printf("fs_restore: '%s' geri yüklendi\n", backup_filename);
-    return (n < 0) ? -1 : 0;
-}
-// 13) Print file contents to stdout
-int fs_cat(const char *filename) {
-    if (!filename) {
-        fprintf(stderr, "fs_cat: invalid filename\n");
-        return -1;
-    }
-    // Eğer log dosyası isteniyorsa host FS'ten oku
-    if (strcmp(filename, LOG_FILENAME) == 0) {
-        FILE *f = fopen(LOG_FILENAME, "r");
-        if (!f) {
-            perror("fs_cat: fopen log file");
-            return -1;
-        }
-        printf("=== %s ===\n", LOG_FILENAME);
-        int c;
-        while ((c = fgetc(f)) != EOF) {
-            putchar(c);
-        }
-        fclose(f);
-        return 0;
-    }
-    // Aksi halde virtual FS içinde çalış
-    uint32_t size;
-    if (fs_size(filename, &size) < 0) {
-        fprintf(stderr, "fs_cat: cannot get size for '%s'\n", filename);
-        return -1;
-    }
-    char *buffer = malloc(size + 1);
-    if (!buffer) {
-        perror("fs_cat: malloc");
-        return -1;
-    }
-    ssize_t rd = fs_read(filename, 0, size, buffer);
-    if (rd < 0) {
-        free(buffer);
-        return -1;
-    }
-    buffer[rd] = '\0';
-    printf("=== %s contents ===\n%s\n", filename, buffer);
-    free(buffer);
-    return 0;
-}
-
-// 14) Compare two files and print diff-like output
-int fs_diff(const char *file1, const char *file2) {
-    if (!file1 || !file2) {
-        fprintf(stderr, "fs_diff: invalid arguments\n");
-        return -1;
-    }
-    uint32_t sz1, sz2;
-    if (fs_size(file1, &sz1) < 0 || fs_size(file2, &sz2) < 0) {
-        fprintf(stderr, "fs_diff: cannot get sizes\n");
-        return -1;
-    }
-    uint32_t maxsz = sz1 > sz2 ? sz1 : sz2;
-    char *buf1 = malloc(maxsz);
-    char *buf2 = malloc(maxsz);
-    if (!buf1 || !buf2) {
-        perror("fs_diff: malloc");
-        free(buf1); free(buf2);
-        return -1;
-    }
-    ssize_t r1 = fs_read(file1, 0, maxsz, buf1);
-    ssize_t r2 = fs_read(file2, 0, maxsz, buf2);
-    if (r1 < 0 || r2 < 0) {
-        free(buf1); free(buf2);
-        return -1;
-    }
-    int diffs = 0;
-    uint32_t limit = r1 < r2 ? r1 : r2;
-    for (uint32_t i = 0; i < limit; ++i) {
-        if (buf1[i] != buf2[i]) {
-            printf("Difference at byte %u: '%c' vs '%c'\n", i,
-                   buf1[i], buf2[i]);
-            diffs++;
-        }
-    }
-    if (r1 != r2) {
-        printf("Files have different lengths: %zd vs %zd bytes\n", r1, r2);
-        diffs++;
-    }
-    if (diffs == 0) {
-        printf("fs_diff: files are identical\n");
-    }
-    free(buf1); free(buf2);
-    return diffs == 0 ? 0 : 1;
-}
-
-// 15) Log operations to a persistent file
-int fs_log(const char *operation, const char *filename) {
-    FILE *f = fopen(LOG_FILENAME, "a");
-    if (!f) {
-        perror("fs_log: fopen");
-        return -1;
-    }
-    time_t now = time(NULL);
-    struct tm *tm = localtime(&now);
-    char timestr[64];
-    strftime(timestr, sizeof(timestr), "%Y-%m-%d %H:%M:%S", tm);
-    if (filename)
-        fprintf(f, "[%s] %s('%s')\n", timestr, operation, filename);
-    else
-        fprintf(f, "[%s] %s\n", timestr, operation);
-    fclose(f);
-    return 0;
-}
+#define _GNU_SOURCE             // SEEK_DATA / SEEK_HOLE
+
+#include "fs.h"
+#include "disk.h"
+#include "dedup.h"
+#include "alloc.h"
+#include "bulk.h"
+#include "bcache.h"
+#include "dio.h"
+#include "trim.h"
+#include "bufpool.h"
+#include "oplog.h"
+#include "stats.h"
+#include "trace.h"
+#include "share.h"
+#include "fserr.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/stat.h>    // ← stat için
+#include <unistd.h>
+
+
+// Bu dosya veri yolunu içerir ve stdio kullanmaz: hatalar FsError koduyla
+// döner, mesajlar yalnızca kullanıcı günlük geri çağırması kuruluysa üretilir
+// (bkz. fserr.h). Ekrana yazdıran yardımcılar fs_print.c içindedir.
+
+// Metadata'yı yeniden okuyup dosyanın kayıt indeksini bulur
+static int fs_lookup(const char *filename) {
+    int rc = disk_read_metadata();
+    if (rc < 0) return rc;
+    for (uint32_t i = 0; i < metadata.file_count; ++i) {
+        if (strcmp(metadata.entries[i].name, filename) == 0) return (int)i;
+    }
+    return FS_ERR_NOT_FOUND;
+}
+
+static int  fs_reserve(FileEntry *e, uint64_t new_size);
+static int  fs_delalloc_fits(uint32_t idx, uint64_t end);
+static void fs_reclaim_blocks(uint32_t first, uint32_t count);
+static void fs_tier_touch(const FileEntry *e, uint64_t end);
+
+// Satır içi dosyalar (DISK_FLAG_INLINE): INLINE_MAX byte'a kadar olan dosyaların
+// verisi metadata ile birlikte okunan inline_area yuvasında durur; okuma ek G/Ç
+// gerektirmez ve dosya blok harcamaz. Dosya yuvaya sığmayacak kadar büyüyünce
+// fs_reserve onu bloklara taşır, fs_truncate sığacak kadar küçültünce geri alır.
+static int fs_is_inline(const FileEntry *e) {
+    return (e->start_block & INLINE_SLOT) != 0;
+}
+
+static uint8_t *fs_inline_data(const FileEntry *e) {
+    return inline_area[e->start_block & ~INLINE_SLOT];
+}
+
+// Veri bölgesinin başında satır içi alana ayrılmış bloklar
+static uint32_t fs_reserved_blocks(void) {
+    return (metadata.flags & DISK_FLAG_INLINE) ? INLINE_BLOCKS : 0;
+}
+
+// Boş bir yuva bulup sıfırlar; yuva sayısı MAX_FILES olduğundan her kayda yer vardır
+static int fs_inline_slot(uint32_t *slot_out) {
+    uint8_t taken[MAX_FILES] = { 0 };
+    for (uint32_t i = 0; i < metadata.file_count; ++i) {
+        const FileEntry *e = &metadata.entries[i];
+        if (fs_is_inline(e)) taken[e->start_block & ~INLINE_SLOT] = 1;
+    }
+    uint32_t slot = 0;
+    while (slot < MAX_FILES && taken[slot]) slot++;
+    if (slot == MAX_FILES) return FS_ERR_CORRUPT;
+    // Yuvada bırakılmış eski baytlar varsa diskte de sıfırlanır
+    static const uint8_t zero[INLINE_MAX];
+    if (memcmp(inline_area[slot], zero, INLINE_MAX) != 0) {
+        memset(inline_area[slot], 0, INLINE_MAX);
+        int rc = disk_write_inline(slot);
+        if (rc < 0) return rc;
+    }
+    *slot_out = slot;
+    return 0;
+}
+
+// Satır içi dosyanın offset konumuna yazar (fs_reserve sığdığını doğrulamış olmalı)
+static ssize_t fs_inline_write(FileEntry *e, const void *data, size_t size, uint32_t offset) {
+    memcpy(fs_inline_data(e) + offset, data, size);
+    int rc = disk_write_inline(e->start_block & ~INLINE_SLOT);
+    if (rc < 0) return rc;
+    if (offset + size > e->size) {
+        e->size = offset + (uint32_t)size;
+        if ((rc = disk_write_metadata()) < 0) return rc;
+    }
+    return (ssize_t)size;
+}
+
+// Paylaşımlı kilitle çalışan çağrıda (bkz. share.h) dosyanın veri aralığını
+// diğer süreçlere karşı kilitler; diğer kiplerde bir şey yapmaz. Kilit
+// beklenirken başka süreç yerinde yazdıysa veri önbellekleri bırakılır.
+// Satır içi dosyalar yerinde yazılmaz, bellekteki yuvaları metadata ile gelir.
+static int fs_lock_data(const FileEntry *e, uint64_t offset, uint64_t len, int exclusive) {
+    if (fs_is_inline(e)) return 0;
+    int rc = share_lock_range((uint64_t)e->start_block * BLOCK_SIZE + offset, len, exclusive);
+    if (rc > 0) {
+        disk_drop_caches();
+        rc = 0;
+    }
+    return rc;
+}
+
+// Dosyanın offset konumuna yazar; dosya sonundan ötedeki boşluk delik olarak
+// bırakılır (sıfır okunur), boyut büyüdüyse metadata kaydedilir
+static ssize_t fs_write_at(FileEntry *e, const void *data, size_t size, uint32_t offset) {
+    if (size == 0) return 0;
+    if (size > DATA_SIZE) return FS_ERR_NO_SPACE;
+    int rc = fs_reserve(e, (uint64_t)offset + size);
+    if (rc < 0) return rc;
+    if (fs_is_inline(e)) return fs_inline_write(e, data, size, offset);
+    if ((rc = fs_lock_data(e, offset, size, 1)) < 0) return rc;
+    fs_tier_touch(e, (uint64_t)offset + size);
+    uint64_t base = (uint64_t)e->start_block * BLOCK_SIZE;
+    if (offset > e->size && (rc = disk_zero_range(base + e->size, offset - e->size)) < 0) {
+        return rc;
+    }
+    ssize_t written = disk_write_data(base + offset, data, size);
+    if (written < 0) return written;
+
+    if ((uint64_t)offset + (uint64_t)written > e->size) {
+        e->size = offset + (uint32_t)written;
+        if ((rc = disk_write_metadata()) < 0) return rc;
+    }
+    return written;
+}
+
+// Ekleme tamponu: küçük fs_append çağrıları dosya başına bellekte biriktirilir
+// ve blok sınırına kadar tek yazımla (ve tek metadata yazımıyla) diske aktarılır.
+// Tampondaki baytlar fs_size/fs_read/fs_list tarafından hemen görülür; metadata
+// kaydındaki boyut yalnızca diske yazılmış kısmı gösterir, bu yüzden başka bir
+// işlemin metadata yazması bekleyen veriyi kalıcı hale getirmez. Kayıt
+// indekslerini değiştiren ya da dosya verisine doğrudan dokunan işlemler önce
+// tüm tamponları boşaltır; dolu bir tamponun kayıt indeksi her zaman geçerlidir.
+// Boşta kalan tamponları arka plandaki boşaltıcı iş parçacığı FS_APPEND_MAX_AGE_MS
+// dolunca yazar: süreç bu pencere içinde öldürülürse son eklemeler kaybolur
+// (fs_sync ya da fs_append_buffer_enable(0) hemen yazar).
+#define FS_APPEND_BUF_SIZE   (8 * BLOCK_SIZE)   // Bu boyuttaki eklemeler doğrudan yazılır
+#define FS_APPEND_SLOTS      8                  // Aynı anda tamponlanan dosya sayısı
+#define FS_APPEND_MAX_AGE_MS 100                // Bekleyen bayt bu süreyi aşınca yazılır
+
+typedef struct {
+    int      in_use;
+    uint32_t entry;           // metadata.entries indeksi
+    uint32_t len;             // Bekleyen bayt sayısı (dosya sonuna eklenecek)
+    uint64_t since_ms;        // En eski bekleyen baytın zamanı
+    uint8_t  data[FS_APPEND_BUF_SIZE];
+} AppendBuf;
+
+static AppendBuf append_bufs[FS_APPEND_SLOTS];
+static int       append_pending;              // Kullanımdaki tampon sayısı
+static int       append_buffering = 1;
+static int       delayed_alloc;               // Tampondaki baytlara yer yazımda seçilir
+
+static void fs_append_timer_arm(void);
+static void fs_append_timer_stop(void);
+
+static uint64_t fs_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u;
+}
+
+static AppendBuf *fs_append_buf(uint32_t idx) {
+    if (!append_pending) return NULL;
+    for (int i = 0; i < FS_APPEND_SLOTS; ++i) {
+        if (append_bufs[i].in_use && append_bufs[i].entry == idx) return &append_bufs[i];
+    }
+    return NULL;
+}
+
+// Görünür boyut: diske yazılmış boyut + tamponda bekleyen baytlar
+static uint32_t fs_visible_size(const FileEntry *e) {
+    const AppendBuf *ab = fs_append_buf((uint32_t)(e - metadata.entries));
+    return e->size + (ab ? ab->len : 0);
+}
+
+// Bekleyen baytları dosya sonuna yazar; whole_blocks ise yalnızca son blok
+// sınırına kadarki kısım yazılır, kalan kısmi blok tamponda bekler
+static int fs_append_write(AppendBuf *ab, int whole_blocks) {
+    FileEntry *e = &metadata.entries[ab->entry];
+    uint32_t n = ab->len;
+    if (whole_blocks) {
+        uint64_t end = (uint64_t)e->start_block * BLOCK_SIZE + e->size + ab->len;
+        uint32_t tail = (uint32_t)(end % BLOCK_SIZE);
+        n = ab->len > tail ? ab->len - tail : 0;
+    }
+    if (n) {
+        // Ertelenmiş ayırmada bekleyen baytların tamamına tek seferde yer seçilir
+        int rc;
+        if (delayed_alloc && (rc = fs_reserve(e, (uint64_t)e->size + ab->len)) < 0) return rc;
+        ssize_t written = fs_write_at(e, ab->data, n, e->size);
+        if (written < 0) return (int)written;
+        ab->len -= (uint32_t)written;
+        memmove(ab->data, ab->data + written, ab->len);
+        ab->since_ms = fs_now_ms();
+    }
+    if (ab->len == 0) {
+        ab->in_use = 0;
+        append_pending--;
+    }
+    return 0;
+}
+
+static int fs_append_flush_all(void) {
+    int rc = 0;
+    for (int i = 0; append_pending && i < FS_APPEND_SLOTS; ++i) {
+        if (!append_bufs[i].in_use) continue;
+        int r = fs_append_write(&append_bufs[i], 0);
+        if (r < 0 && rc == 0) rc = r;
+    }
+    return rc;
+}
+
+static void fs_append_discard_all(void) {
+    for (int i = 0; i < FS_APPEND_SLOTS; ++i) append_bufs[i].in_use = 0;
+    append_pending = 0;
+}
+
+// Tamponu olan dosyanın kayıt indeksi; metadata bellekte güncel olduğundan
+// yeniden okunmaz (-1: tamponda yok)
+static int fs_append_find(const char *filename) {
+    for (int i = 0; append_pending && i < FS_APPEND_SLOTS; ++i) {
+        const AppendBuf *ab = &append_bufs[i];
+        if (ab->in_use && strcmp(metadata.entries[ab->entry].name, filename) == 0) {
+            return (int)ab->entry;
+        }
+    }
+    return -1;
+}
+
+// Süresi dolan tamponları yaz (her eklemede ve boşaltıcı iş parçacığında)
+static int fs_append_expire(uint64_t now) {
+    for (int i = 0; append_pending && i < FS_APPEND_SLOTS; ++i) {
+        AppendBuf *ab = &append_bufs[i];
+        if (ab->in_use && now - ab->since_ms >= FS_APPEND_MAX_AGE_MS) {
+            int rc = fs_append_write(ab, 0);
+            if (rc < 0) return rc;
+        }
+    }
+    return 0;
+}
+
+// Dosya sonuna ekler: küçük eklemeler tampona, büyükler (ve tampon kapalıyken
+// hepsi) bekleyenlerden sonra doğrudan diske
+static ssize_t fs_append_to(uint32_t idx, const void *data, size_t size) {
+    FileEntry *e = &metadata.entries[idx];
+    uint64_t now = fs_now_ms();
+    int rc;
+    if ((rc = fs_append_expire(now)) < 0) return rc;
+    // Tampondaki baytların blokları da şimdiden ayrılır; yazım sırasında yer
+    // kalmaması olmaz. Ertelenmiş ayırmada yalnızca yeterli boş blok olduğu
+    // denetlenir, yer tampon yazılırken son boyuta göre seçilir.
+    uint64_t end = (uint64_t)fs_visible_size(e) + size;
+    int defer = delayed_alloc && append_buffering && size < FS_APPEND_BUF_SIZE &&
+                fs_delalloc_fits(idx, end);
+    if (!defer && (rc = fs_reserve(e, end)) < 0) return rc;
+    AppendBuf *ab = fs_append_buf(idx);
+
+    if (!append_buffering || size >= FS_APPEND_BUF_SIZE) {
+        if (ab && (rc = fs_append_write(ab, 0)) < 0) return rc;
+        return fs_write_at(e, data, size, e->size);
+    }
+    if (ab && ab->len + size > FS_APPEND_BUF_SIZE) {
+        // Tam bloklar yazılır; kısmi blok ile yeni veri hâlâ sığmıyorsa hepsi
+        if ((rc = fs_append_write(ab, 1)) < 0) return rc;
+        if (ab->in_use && ab->len + size > FS_APPEND_BUF_SIZE &&
+            (rc = fs_append_write(ab, 0)) < 0) return rc;
+        ab = fs_append_buf(idx);
+    }
+    if (!ab) {
+        // Boş yuva yoksa en eski tampon yazılıp yeniden kullanılır
+        AppendBuf *oldest = NULL;
+        for (int i = 0; i < FS_APPEND_SLOTS && !ab; ++i) {
+            if (!append_bufs[i].in_use) ab = &append_bufs[i];
+            else if (!oldest || append_bufs[i].since_ms < oldest->since_ms) oldest = &append_bufs[i];
+        }
+        if (!ab) {
+            if ((rc = fs_append_write(oldest, 0)) < 0) return rc;
+            ab = oldest;
+        }
+        ab->in_use = 1;
+        ab->entry = idx;
+        ab->len = 0;
+        ab->since_ms = now;
+        append_pending++;
+    }
+    memcpy(ab->data + ab->len, data, size);
+    ab->len += (uint32_t)size;
+    return (ssize_t)size;
+}
+
+// Dosya başına sıralı okuma tespiti. Bir önceki okumanın bittiği yerden devam
+// eden okumalar ileri okuma penceresini BCACHE_RA_MIN'den BCACHE_RA_MAX bloğa
+// kadar ikiye katlar; okuyucu önceden okunan bölgenin yarısına gelince sonraki
+// pencere arka planda istenir. Sıralı olmayan bir okuma pencereyi sıfırlar.
+typedef struct {
+    uint32_t next;            // Sıralı devam sayılacak offset
+    uint32_t window;          // Güncel pencere (bayt, 0 = ileri okuma yok)
+    uint32_t ra_end;          // İleri okunması istenen bölgenin sonu
+} ReadAhead;
+
+static ReadAhead file_ra[MAX_FILES];
+
+static void fs_readahead(const FileEntry *e, uint32_t offset, size_t size) {
+    ReadAhead *ra = &file_ra[e - metadata.entries];
+    uint32_t end = offset + (uint32_t)size;
+    int sequential = offset == ra->next;
+    ra->next = end;
+    if (!sequential) {
+        ra->window = ra->ra_end = 0;
+        return;
+    }
+    if (ra->window && end + ra->window / 2 < ra->ra_end) return;
+
+    uint32_t window = ra->window ? ra->window * 2 : BCACHE_RA_MIN * BLOCK_SIZE;
+    if (window > BCACHE_RA_MAX * BLOCK_SIZE) window = BCACHE_RA_MAX * BLOCK_SIZE;
+    uint32_t from = ra->ra_end > end ? ra->ra_end : end;
+    ra->window = window;
+    if (from >= e->size) return;
+    uint32_t to = e->size - from < window ? e->size : from + window;
+    ra->ra_end = to;
+    disk_readahead((uint64_t)e->start_block * BLOCK_SIZE + from, to - from);
+}
+
+// fs_delete kayıtları kaydırdığında durumlar da kayar; format/restore hepsini sıfırlar
+static void fs_readahead_entry_removed(uint32_t idx) {
+    memmove(&file_ra[idx], &file_ra[idx + 1], (MAX_FILES - idx - 1) * sizeof(file_ra[0]));
+    memset(&file_ra[MAX_FILES - 1], 0, sizeof(file_ra[0]));
+}
+
+// Dosyanın offset konumundan okur; dosya sonunda kısa okuma, ötesinde 0 döner.
+// Diske henüz yazılmamış eklenen baytlar tampondan kopyalanır.
+static ssize_t fs_read_at(const FileEntry *e, void *buffer, size_t size, uint32_t offset) {
+    uint32_t visible = fs_visible_size(e);
+    if (offset >= visible) return 0;
+    if (size > visible - offset) size = visible - offset;
+    size_t on_disk = offset < e->size ? e->size - offset : 0;
+    if (on_disk > size) on_disk = size;
+    if (on_disk && fs_is_inline(e)) {
+        memcpy(buffer, fs_inline_data(e) + offset, on_disk);
+    } else if (on_disk) {
+        int rc = fs_lock_data(e, offset, on_disk, 0);
+        if (rc < 0) return rc;
+        fs_tier_touch(e, 0);
+        fs_readahead(e, offset, on_disk);
+        ssize_t rd = disk_read_data((uint64_t)e->start_block * BLOCK_SIZE + offset, buffer, on_disk);
+        if (rd < (ssize_t)on_disk) return rd;
+    }
+    if (size > on_disk) {
+        const AppendBuf *ab = fs_append_buf((uint32_t)(e - metadata.entries));
+        memcpy((uint8_t *)buffer + on_disk, ab->data + (offset + on_disk - e->size), size - on_disk);
+    }
+    return (ssize_t)size;
+}
+
+// Dosya içinde offset'ten itibaren ilk veri (hole = 0) veya ilk delik (hole = 1)
+// konumu; dosya sonu bir delik sayılır, sonuç dosya boyutuyla sınırlanır
+static int64_t fs_file_extent(const FileEntry *e, uint32_t offset, int hole) {
+    if (fs_is_inline(e)) return hole || offset >= e->size ? e->size : offset;
+    uint64_t base = (uint64_t)e->start_block * BLOCK_SIZE;
+    int64_t pos = hole ? disk_next_hole(base + offset) : disk_next_data(base + offset);
+    if (pos < 0) return pos;
+    pos -= (int64_t)base;
+    return pos > e->size ? e->size : pos;
+}
+
+// Açık dosya tablosu: tanıtıcı, kayıt indeksini ve imleci tutar; böylece
+// akış halinde okuma/yazma ad çözümlemesini ve metadata okumasını bir kez öder.
+// Kayıt indeksleri fs_delete (kaydırma) ve format/restore (geçersiz kılma)
+// sırasında burada güncellenir.
+#define FS_ENTRY_GONE UINT32_MAX
+
+typedef struct {
+    int      in_use;
+    int      flags;           // FS_O_*
+    uint32_t entry;           // metadata.entries indeksi (FS_ENTRY_GONE = dosya silindi)
+    uint32_t pos;             // fs_fread / fs_fwrite imleci
+} OpenFile;
+
+static OpenFile open_files[FS_MAX_OPEN];
+
+static void fs_handles_entry_removed(uint32_t idx) {
+    for (int fd = 0; fd < FS_MAX_OPEN; ++fd) {
+        OpenFile *of = &open_files[fd];
+        if (!of->in_use || of->entry == FS_ENTRY_GONE) continue;
+        if (of->entry == idx)     of->entry = FS_ENTRY_GONE;
+        else if (of->entry > idx) of->entry--;
+    }
+}
+
+static void fs_handles_invalidate(void) {
+    for (int fd = 0; fd < FS_MAX_OPEN; ++fd) {
+        if (open_files[fd].in_use) open_files[fd].entry = FS_ENTRY_GONE;
+    }
+}
+
+// Bellek eşlemeleri: fs_map'in döndürdüğü adres, dosyanın kaydı ve veri
+// bölgesindeki aralıkla tutulur. Dosyanın blokları başka bir dosyaya
+// geçebilecekse (delete, defragment, format, restore) eşleme diskten ayrılır:
+// adres fs_unmap'e kadar geçerli kalır ama artık sıfır sayfaları gösterir.
+typedef struct {
+    int      in_use;
+    int      writable;
+    uint32_t entry;           // metadata.entries indeksi (FS_ENTRY_GONE = diskten ayrıldı)
+    uint8_t *addr;
+    uint64_t offset;          // Veri bölgesindeki konum
+    size_t   len;
+} FsMapping;
+
+static FsMapping maps[FS_MAX_MAPS];
+static int       maps_active;
+
+static void fs_map_detach(FsMapping *m) {
+    disk_map_detach(m->addr, m->offset, m->len);
+    m->entry = FS_ENTRY_GONE;
+}
+
+static void fs_maps_entry_removed(uint32_t idx) {
+    for (int i = 0; maps_active && i < FS_MAX_MAPS; ++i) {
+        FsMapping *m = &maps[i];
+        if (!m->in_use || m->entry == FS_ENTRY_GONE) continue;
+        if (m->entry == idx)     fs_map_detach(m);
+        else if (m->entry > idx) m->entry--;
+    }
+}
+
+// Yazılabilir eşlemelerdeki değişiklikleri imaja aktarır (önbellekten düşürür)
+static int fs_maps_flush_all(void) {
+    int rc = 0;
+    for (int i = 0; maps_active && i < FS_MAX_MAPS; ++i) {
+        FsMapping *m = &maps[i];
+        if (!m->in_use || !m->writable || m->entry == FS_ENTRY_GONE) continue;
+        int r = disk_map_sync(m->addr, m->offset, m->len);
+        if (r < 0 && rc == 0) rc = r;
+    }
+    return rc;
+}
+
+static void fs_maps_detach_all(void) {
+    for (int i = 0; maps_active && i < FS_MAX_MAPS; ++i) {
+        if (maps[i].in_use && maps[i].entry != FS_ENTRY_GONE) fs_map_detach(&maps[i]);
+    }
+}
+
+// Eşlemelerdeki yazımlar önce imaja aktarılır; dosya yer değiştireceği için
+// ona ait eşlemeler eski yeri gösterir ve ayrılır
+static int fs_maps_release(uint32_t idx) {
+    int rc = fs_maps_flush_all();
+    if (rc < 0) return rc;
+    for (int i = 0; maps_active && i < FS_MAX_MAPS; ++i) {
+        if (maps[i].in_use && maps[i].entry == idx) fs_map_detach(&maps[i]);
+    }
+    return 0;
+}
+
+// Yer ayırma: dosya [start_block, start_block + blok sayısı) aralığını kullanır;
+// blok sayısı görünür boyuttan (tampondaki eklemeler dahil; ertelenmiş ayırmada
+// yalnızca yazılmış kısım) ya da daha büyükse fs_fallocate ön ayırmasından gelir.
+static uint32_t fs_blocks(uint64_t size) {
+    return (uint32_t)((size + BLOCK_SIZE - 1) / BLOCK_SIZE);
+}
+
+// FS_FALLOC_KEEP_SIZE ile ayrılan blok sayısı (start_block'tan itibaren, 0 = yok).
+// Metadata'da yeri olmadığından yalnızca bellekte tutulur; kayıt indeksiyle kayar.
+static uint32_t file_prealloc[MAX_FILES];
+
+static uint32_t fs_alloc_blocks(const FileEntry *e) {
+    if (fs_is_inline(e)) return 0;
+    uint32_t n   = fs_blocks(delayed_alloc ? e->size : fs_visible_size(e));
+    uint32_t pre = file_prealloc[e - metadata.entries];
+    return pre > n ? pre : n;
+}
+
+static void fs_prealloc_entry_removed(uint32_t idx) {
+    memmove(&file_prealloc[idx], &file_prealloc[idx + 1], (MAX_FILES - idx - 1) * sizeof(file_prealloc[0]));
+    file_prealloc[MAX_FILES - 1] = 0;
+}
+
+// Dosya sonundan ötedeki ön ayırmayı bırakır
+static void fs_prealloc_drop(FileEntry *e) {
+    uint32_t idx = (uint32_t)(e - metadata.entries);
+    uint32_t have = fs_is_inline(e) ? 0 : fs_blocks(e->size);
+    if (file_prealloc[idx] > have) fs_reclaim_blocks(e->start_block + have, file_prealloc[idx] - have);
+    file_prealloc[idx] = 0;
+}
+
+// Bellek katmanına erişim ipucu: dosyanın bloklarına (en az end bayta kadar)
+// erişilecek. Yalnızca bir ipucudur; aralık belleğe alınamazsa G/Ç diskten devam eder.
+static void fs_tier_touch(const FileEntry *e, uint64_t end) {
+    if (fs_is_inline(e)) return;
+    uint32_t count = fs_alloc_blocks(e);
+    if (count < fs_blocks(end)) count = fs_blocks(end);
+    disk_tier_access(e->start_block, count);
+}
+
+// Tüm dosyaların kullandığı blokların haritası (0 = boş); imajın kapasitesi
+// dışında kalan bloklar da dolu sayılır
+static void fs_block_map(uint8_t *used) {
+    uint32_t cap = disk_capacity();
+    memset(used, 0, DATA_BLOCKS);
+    memset(used, 1, fs_reserved_blocks());
+    memset(used + cap, 1, DATA_BLOCKS - cap);
+    for (uint32_t i = 0; i < metadata.file_count; ++i) {
+        const FileEntry *e = &metadata.entries[i];
+        if (fs_is_inline(e)) continue;
+        uint32_t end = e->start_block + fs_alloc_blocks(e);
+        for (uint32_t b = e->start_block; b < end && b < DATA_BLOCKS; ++b) used[b] = 1;
+    }
+}
+
+// Ertelenmiş ayırma: dosyanın end bayta kadarki tampon baytları için henüz
+// ayrılmamış blok sayısı
+static uint32_t fs_delalloc_need(const FileEntry *e, uint64_t end) {
+    if (fs_is_inline(e) && end <= INLINE_MAX) return 0;
+    uint32_t need = fs_blocks(end), have = fs_alloc_blocks(e);
+    return need > have ? need - have : 0;
+}
+
+// Tampona girecek baytlara diskte yer kalıyor mu: boş bloklar, diğer
+// tamponlara verilmiş sözlerden sonra da yetmeli. Yer yine de parçalıysa
+// tampon yazılırken FS_ERR_NO_SPACE alınabilir; baytlar tamponda kalır.
+static int fs_delalloc_fits(uint32_t idx, uint64_t end) {
+    const FileEntry *e = &metadata.entries[idx];
+    // Aynı bloğa düşen eklemeler için yeniden sayılmaz
+    uint32_t need = fs_delalloc_need(e, end);
+    if (need <= fs_delalloc_need(e, fs_visible_size(e))) return 1;
+    for (int i = 0; append_pending && i < FS_APPEND_SLOTS; ++i) {
+        const AppendBuf *ab = &append_bufs[i];
+        if (!ab->in_use || ab->entry == idx) continue;
+        const FileEntry *o = &metadata.entries[ab->entry];
+        need += fs_delalloc_need(o, (uint64_t)o->size + ab->len);
+    }
+    // Dosyalar çakışmadığından boş blok sayısı haritasız hesaplanır
+    uint32_t used = fs_reserved_blocks();
+    for (uint32_t i = 0; i < metadata.file_count; ++i) used += fs_alloc_blocks(&metadata.entries[i]);
+    return used + need <= disk_capacity();
+}
+
+// Satır içi dosyanın verisini yeni ayrılan nblk bloğa taşır; yuva boşalır
+static int fs_inline_evict(FileEntry *e, uint32_t nblk) {
+    uint8_t used[DATA_BLOCKS];
+    fs_block_map(used);
+    int64_t start = alloc_find(used, nblk);
+    if (start < 0) return (int)start;
+    uint8_t *data = fs_inline_data(e);
+    ssize_t w = e->size ? disk_write_data((uint64_t)start * BLOCK_SIZE, data, e->size) : 0;
+    if (w != (ssize_t)e->size) return w < 0 ? (int)w : FS_ERR_IO;
+    memset(data, 0, INLINE_MAX);
+    e->start_block = (uint32_t)start;
+    return disk_write_metadata();
+}
+
+// Dosyanın verisini start bloğundan başlayan alana kopyalar (delikler
+// korunur); kayıt değişmez, eski bloklar çağıran tarafından bırakılır
+static int fs_move_data(FileEntry *e, uint32_t start) {
+    int rc = fs_maps_release((uint32_t)(e - metadata.entries));
+    if (rc < 0) return rc;
+    // Yeni alan önceki sahiplerinden veri taşımasın diye önce delik yapılır
+    uint64_t from = (uint64_t)e->start_block * BLOCK_SIZE, to = (uint64_t)start * BLOCK_SIZE;
+    if (e->size && (rc = disk_zero_range(to, e->size)) < 0) return rc;
+    uint8_t buf[8 * BLOCK_SIZE];
+    for (uint32_t off = 0; off < e->size; ) {
+        int64_t data = fs_file_extent(e, off, 0);
+        int64_t hole = data < 0 ? data : fs_file_extent(e, (uint32_t)data, 1);
+        if (hole < 0) return (int)hole;
+        for (uint32_t pos = (uint32_t)data; pos < (uint32_t)hole; ) {
+            size_t n = (uint32_t)hole - pos < sizeof(buf) ? (uint32_t)hole - pos : sizeof(buf);
+            ssize_t r = disk_read_data(from + pos, buf, n);
+            if (r == (ssize_t)n) r = disk_write_data(to + pos, buf, n);
+            if (r != (ssize_t)n) return r < 0 ? (int)r : FS_ERR_IO;
+            pos += (uint32_t)n;
+        }
+        off = (uint32_t)hole;
+    }
+    return 0;
+}
+
+// Dosyanın new_size bayta büyüyebilmesi için blok ayırır: ardındaki bloklar boşsa
+// yerinde uzar, değilse seçili politikanın bulduğu alana taşınır (delikler
+// korunur). Boş dosya ilk büyümesinde yer alır; start_block değişirse kaydedilir.
+static int fs_reserve(FileEntry *e, uint64_t new_size) {
+    uint32_t have = fs_alloc_blocks(e), need = fs_blocks(new_size);
+    if (fs_is_inline(e)) {
+        if (new_size <= INLINE_MAX) return 0;
+        // Yuvaya sığmıyor
+        return need > DATA_BLOCKS ? FS_ERR_NO_SPACE : fs_inline_evict(e, need);
+    }
+    if (need <= have) return 0;
+    if (need > DATA_BLOCKS) return FS_ERR_NO_SPACE;
+
+    uint8_t used[DATA_BLOCKS];
+    fs_block_map(used);
+    if (have && e->start_block + need <= DATA_BLOCKS) {
+        uint32_t b = e->start_block + have;
+        while (b < e->start_block + need && !used[b]) b++;
+        if (b == e->start_block + need) return 0;
+    }
+    int64_t start = alloc_find(used, need);
+    if (start < 0) return (int)start;
+
+    uint32_t idx = (uint32_t)(e - metadata.entries);
+    uint32_t old_start = e->start_block;
+    int rc;
+    if (have && (rc = fs_move_data(e, (uint32_t)start)) < 0) return rc;
+    e->start_block = (uint32_t)start;
+    file_prealloc[idx] = 0;       // Yeni alan ön ayırmayı da kapsıyor
+    if ((rc = disk_write_metadata()) < 0) return rc;
+    if (have) fs_reclaim_blocks(old_start, have);
+    return 0;
+}
+
+// Tanıtıcıyı doğrular; access FS_O_READ / FS_O_WRITE izni gerektirir
+static OpenFile *fs_handle(int fd, int access, FileEntry **entry_out, int *err) {
+    if (fd < 0 || fd >= FS_MAX_OPEN || !open_files[fd].in_use ||
+        (open_files[fd].flags & access) != access) {
+        *err = FS_ERR_BADF;
+        return NULL;
+    }
+    OpenFile *of = &open_files[fd];
+    if (of->entry == FS_ENTRY_GONE || of->entry >= metadata.file_count) {
+        *err = FS_ERR_NOT_FOUND;
+        return NULL;
+    }
+    *entry_out = &metadata.entries[of->entry];
+    return of;
+}
+
+// Mevcut imajı aç; metadata bayraklarına göre çeviri katmanları yüklenir
+static int fs_mount_impl(void) {
+    int rc = disk_read_metadata();
+    if (rc < 0) FS_FAIL(rc, "fs_mount: cannot load '%s'", disk_path());
+    return 0;
+}
+
+// Format (initialize) the disk
+int fs_format(void) {
+    return fs_format_mode(0);
+}
+
+// Format with optional features (FS_FORMAT_DEDUP, FS_FORMAT_INLINE, FS_FORMAT_LOG)
+static int fs_format_mode_impl(uint32_t flags) {
+    if (flags & ~(uint32_t)(FS_FORMAT_DEDUP | FS_FORMAT_INLINE | FS_FORMAT_LOG)) {
+        FS_FAIL(FS_ERR_INVALID, "fs_format: unknown flags 0x%x", flags);
+    }
+    // Tekilleştirme tablosu da veri bölgesinin başındaki fiziksel blokları kullanır
+    if ((flags & FS_FORMAT_DEDUP) && (flags & FS_FORMAT_INLINE)) {
+        FS_FAIL(FS_ERR_UNSUPPORTED, "fs_format: dedup and inline cannot be combined");
+    }
+    // Günlük yapılı mod veri bölgesinin tamamını kendi düzeniyle kullanır
+    if ((flags & FS_FORMAT_LOG) && (flags & (FS_FORMAT_DEDUP | FS_FORMAT_INLINE))) {
+        FS_FAIL(FS_ERR_UNSUPPORTED, "fs_format: log mode cannot be combined with dedup or inline");
+    }
+    fs_maps_detach_all();       // İmaj kesilmeden önce (erişim SIGBUS olurdu)
+    DiskMetadata *zero = buf_get(BUF_META);
+    if (!zero) FS_FAIL(FS_ERR_NO_MEMORY, "fs_format: malloc");
+    memset(zero, 0, METADATA_SIZE);
+    zero->flags = flags;
+    int rc = disk_create(zero);
+    buf_put(BUF_META, zero);
+    if (rc < 0) FS_FAIL(rc, "fs_format: cannot create '%s'", disk_path());
+    disk_reset();
+    fs_handles_invalidate();
+    fs_append_discard_all();
+    memset(file_ra, 0, sizeof(file_ra));
+    memset(file_prealloc, 0, sizeof(file_prealloc));
+    alloc_reset();
+    return 0;
+}
+
+// Verilen blok aralığında artık hiçbir dosyanın kullanmadığı blokları bırakır
+// (dedup modunda fiziksel bloklar referans sayacıyla geri kazanılır)
+static void fs_reclaim_blocks(uint32_t first, uint32_t count) {
+    uint32_t run_start = 0, run_len = 0;
+    for (uint32_t b = first; b < first + count && b < DATA_BLOCKS; ++b) {
+        int used = 0;
+        for (uint32_t i = 0; i < metadata.file_count && !used; ++i) {
+            const FileEntry *e = &metadata.entries[i];
+            uint32_t nblk = (e->size + BLOCK_SIZE - 1) / BLOCK_SIZE;
+            used = b >= e->start_block && b < e->start_block + nblk;
+        }
+        if (!used) {
+            if (!run_len) run_start = b;
+            run_len++;
+        } else if (run_len) {
+            disk_discard(run_start, run_len);
+            run_len = 0;
+        }
+    }
+    if (run_len) disk_discard(run_start, run_len);
+}
+
+// Create a new file in metadata
+static int fs_create_impl(const char *filename) {
+    if (!filename || !*filename || strlen(filename) >= sizeof(metadata.entries[0].name)) {
+        FS_FAIL(FS_ERR_INVALID, "fs_create: invalid name");
+    }
+    int rc = disk_read_metadata();
+    if (rc < 0) FS_FAIL(rc, "fs_create: read_meta");
+
+    for (uint32_t i = 0; i < metadata.file_count; ++i) {
+        if (strcmp(metadata.entries[i].name, filename) == 0) {
+            FS_FAIL(FS_ERR_EXISTS, "fs_create: '%s' exists", filename);
+        }
+    }
+    if (metadata.file_count >= MAX_FILES) {
+        FS_FAIL(FS_ERR_TOO_MANY_FILES, "fs_create: max files reached");
+    }
+
+    uint32_t slot = 0;
+    if ((metadata.flags & DISK_FLAG_INLINE) && (rc = fs_inline_slot(&slot)) < 0) {
+        FS_FAIL(rc, "fs_create: inline slot");
+    }
+    FileEntry *e = &metadata.entries[metadata.file_count];
+    memset(e, 0, sizeof(*e));
+    strncpy(e->name, filename, sizeof(e->name)-1);
+    e->size = 0;
+    e->start_block = (metadata.flags & DISK_FLAG_INLINE) ? INLINE_SLOT | slot : 0;
+    e->created = time(NULL);
+    metadata.file_count++;
+
+    if ((rc = disk_write_metadata()) < 0) FS_FAIL(rc, "fs_create: write_meta");
+    FS_INFO("fs_create: '%s' created", filename);
+    return 0;
+}
+
+// Delete a file from metadata
+static int fs_delete_impl(const char *filename) {
+    if (!filename) FS_FAIL(FS_ERR_INVALID, "fs_delete: invalid name");
+    int rc = fs_append_flush_all();
+    if (rc < 0) FS_FAIL(rc, "fs_delete: pending appends");
+    rc = disk_read_metadata();
+    if (rc < 0) FS_FAIL(rc, "fs_delete: read_meta");
+    int idx = -1;
+    for (uint32_t i = 0; i < metadata.file_count; ++i) {
+        if (strcmp(metadata.entries[i].name, filename) == 0) {
+            idx = i;
+            break;
+        }
+    }
+    if (idx < 0) FS_FAIL(FS_ERR_NOT_FOUND, "fs_delete: '%s' not found", filename);
+    uint32_t freed_start = metadata.entries[idx].start_block;
+    uint32_t freed_blocks = fs_alloc_blocks(&metadata.entries[idx]);
+
+    // shift entries
+    for (uint32_t i = idx; i + 1 < metadata.file_count; ++i) {
+        metadata.entries[i] = metadata.entries[i + 1];
+    }
+    metadata.file_count--;
+    memset(&metadata.entries[metadata.file_count], 0, sizeof(FileEntry));
+    fs_handles_entry_removed((uint32_t)idx);
+    fs_maps_entry_removed((uint32_t)idx);
+    fs_readahead_entry_removed((uint32_t)idx);
+    fs_prealloc_entry_removed((uint32_t)idx);
+
+    if ((rc = disk_write_metadata()) < 0) FS_FAIL(rc, "fs_delete: write_meta");
+    fs_reclaim_blocks(freed_start, freed_blocks);
+    FS_INFO("fs_delete: '%s' deleted", filename);
+    return 0;
+}
+
+// Overwrite data into a file
+static ssize_t fs_write_impl(const char *filename, const void *data, size_t size) {
+    if (!filename || (!data && size)) FS_FAIL(FS_ERR_INVALID, "fs_write: invalid arguments");
+    if (size == 0) return 0;
+    int idx = fs_append_flush_all();
+    if (idx < 0) FS_FAIL(idx, "fs_write: pending appends");
+    idx = fs_lookup(filename);
+    if (idx == FS_ERR_NOT_FOUND) FS_FAIL(idx, "fs_write: '%s' not found", filename);
+    if (idx < 0) FS_FAIL(idx, "fs_write: read_meta");
+
+    ssize_t written = fs_write_at(&metadata.entries[idx], data, size, 0);
+    if (written < 0) FS_FAIL((int)written, "fs_write: write");
+    FS_INFO("fs_write: '%s' -> %zd bytes", filename, written);
+    return written;
+}
+//************************************************************************************************ */
+// Read data from a file
+static ssize_t fs_read_impl(const char *filename, uint32_t offset, size_t size, void *buffer) {
+    if (!filename || (!buffer && size)) FS_FAIL(FS_ERR_INVALID, "fs_read: invalid arguments");
+    if (size == 0) return 0;
+    int idx = fs_lookup(filename);
+    if (idx == FS_ERR_NOT_FOUND) FS_FAIL(idx, "fs_read: '%s' not found", filename);
+    if (idx < 0) FS_FAIL(idx, "fs_read: read_meta");
+    if (offset >= fs_visible_size(&metadata.entries[idx])) {
+        FS_FAIL(FS_ERR_RANGE, "fs_read: offset beyond size");
+    }
+
+    memset(buffer, 0, size);
+    ssize_t rd = fs_read_at(&metadata.entries[idx], buffer, size, offset);
+    if (rd < 0) FS_FAIL((int)rd, "fs_read: read");
+
+    FS_INFO("fs_read: '%s' <- %zd bytes", filename, rd);
+    return rd;
+}
+// Tüm dosyayı okuyup buffer'a yazar
+static ssize_t fs_read_all_impl(const char *filename, void *buffer) {
+    if (!filename || !buffer) FS_FAIL(FS_ERR_INVALID, "fs_read_all: invalid arguments");
+    int idx = fs_lookup(filename);
+    if (idx == FS_ERR_NOT_FOUND) FS_FAIL(idx, "fs_read_all: '%s' not found", filename);
+    if (idx < 0) FS_FAIL(idx, "fs_read_all: read_meta");
+
+    return fs_read(filename, 0, fs_visible_size(&metadata.entries[idx]), buffer);  // Offset = 0, size = tüm dosya
+}
+//***************************************************************************************** */
+// Copy stub
+// fs.c — implement fs_copy
+
+#define COPY_CHUNK_SIZE BLOCK_SIZE
+
+static int fs_copy_impl(const char *src_filename, const char *dest_filename) {
+    int rc = fs_append_flush_all();
+    if (rc < 0) FS_FAIL(rc, "fs_copy: pending appends");
+    // 1) kaynak dosya var mı?
+    if (!fs_exists(src_filename)) {
+        FS_FAIL(FS_ERR_NOT_FOUND, "fs_copy: source '%s' not found", src_filename);
+    }
+    // 2) hedef zaten varsa hata
+    if (fs_exists(dest_filename)) {
+        FS_FAIL(FS_ERR_EXISTS, "fs_copy: destination '%s' already exists", dest_filename);
+    }
+    // 3) yeni dosya oluştur
+    rc = fs_create(dest_filename);
+    if (rc < 0) return rc;
+    // 4) kaynak boyutunu al
+    uint32_t total_size;
+    if ((rc = fs_size(src_filename, &total_size)) < 0) return rc;
+
+    // 5) yalnızca veri içeren aralıkları blok blok kopyala; delikler atlanır
+    int si = fs_lookup(src_filename), di = fs_lookup(dest_filename);
+    if (si < 0) return si;
+    if (di < 0) return di;
+    const FileEntry *src = &metadata.entries[si];
+    FileEntry *dst = &metadata.entries[di];
+    // Hedefin tüm alanı baştan ayrılır ve delik yapılır; boyut hemen son haline
+    // gelir, böylece kopya sırasında dosya taşınmaz ve kaynaktaki deliklere denk
+    // gelen yerler (sondaki delik dahil) eski veri göstermez
+    if ((rc = fs_reserve(dst, total_size)) < 0) FS_FAIL(rc, "fs_copy: allocate");
+    if (total_size && !fs_is_inline(dst) &&
+        (rc = disk_zero_range((uint64_t)dst->start_block * BLOCK_SIZE, total_size)) < 0) {
+        FS_FAIL(rc, "fs_copy: clear destination");
+    }
+    dst->size = total_size;
+    if ((rc = disk_write_metadata()) < 0) FS_FAIL(rc, "fs_copy: write_meta");
+    char *buffer = buf_get(BUF_BLOCK);
+    if (!buffer) FS_FAIL(FS_ERR_NO_MEMORY, "fs_copy: malloc");
+
+    uint32_t offset = 0;
+    while (offset < total_size) {
+        int64_t data = fs_file_extent(src, offset, 0);
+        int64_t hole = data < 0 ? data : fs_file_extent(src, (uint32_t)data, 1);
+        if (hole < 0) {
+            buf_put(BUF_BLOCK, buffer);
+            return (int)hole;
+        }
+        for (uint32_t pos = (uint32_t)data; pos < (uint32_t)hole; ) {
+            size_t to_read = (uint32_t)hole - pos > COPY_CHUNK_SIZE
+                             ? COPY_CHUNK_SIZE
+                             : (uint32_t)hole - pos;
+            ssize_t n = fs_read_at(src, buffer, to_read, pos);
+            ssize_t w = n <= 0 ? (n < 0 ? n : FS_ERR_IO) : fs_write_at(dst, buffer, (size_t)n, pos);
+            if (w < 0) {
+                buf_put(BUF_BLOCK, buffer);
+                return (int)w;
+            }
+            pos += (uint32_t)n;
+        }
+        offset = (uint32_t)hole;
+    }
+
+    buf_put(BUF_BLOCK, buffer);
+    FS_INFO("fs_copy: '%s' -> '%s' complete (%u bytes)",
+           src_filename, dest_filename, total_size);
+    return 0;
+}
+
+
+// Move stub
+//  After your fs_copy implementation, add:
+
+static int fs_mv_impl(const char *old_path, const char *new_path) {
+    // 1) Kaynak dosya var mı?
+    if (!fs_exists(old_path)) {
+        FS_FAIL(FS_ERR_NOT_FOUND, "fs_mv: source '%s' not found", old_path);
+    }
+    // 2) Hedef zaten varsa hata
+    if (fs_exists(new_path)) {
+        FS_FAIL(FS_ERR_EXISTS, "fs_mv: destination '%s' already exists", new_path);
+    }
+    // 3) Kopyalama
+    int rc = fs_copy(old_path, new_path);
+    if (rc < 0) return rc;
+    // 4) Orijinali sil
+    if ((rc = fs_delete(old_path)) < 0) {
+        FS_FAIL(rc, "fs_mv: copied but failed to delete '%s'", old_path);
+    }
+    FS_INFO("fs_mv: '%s' moved to '%s'", old_path, new_path);
+    return 0;
+}
+
+// Dosya kayıtlarını çağıranın dizisine kopyalar (listeleme stdio gerektirmez)
+static int fs_list_impl(FileEntry *out, uint32_t max) {
+    if (!out && max) FS_FAIL(FS_ERR_INVALID, "fs_list: invalid arguments");
+    int rc = disk_read_metadata();
+    if (rc < 0) FS_FAIL(rc, "fs_list: metadata okunamadı");
+    uint32_t n = metadata.file_count < max ? metadata.file_count : max;
+    memcpy(out, metadata.entries, n * sizeof(FileEntry));
+    for (uint32_t i = 0; append_pending && i < n; ++i) out[i].size = fs_visible_size(&metadata.entries[i]);
+    return (int)metadata.file_count;
+}
+
+// 2) Rename a file in metadata
+static int fs_rename_impl(const char *old_name, const char *new_name) {
+    if (!old_name || !new_name || !*new_name ||
+        strlen(new_name) >= sizeof(metadata.entries[0].name)) {
+        FS_FAIL(FS_ERR_INVALID, "fs_rename: geçersiz isim");
+    }
+    int rc = disk_read_metadata();
+    if (rc < 0) FS_FAIL(rc, "fs_rename: metadata okunamadı");
+    // check new_name not already used
+    for (uint32_t i = 0; i < metadata.file_count; ++i) {
+        if (strcmp(metadata.entries[i].name, new_name) == 0) {
+            FS_FAIL(FS_ERR_EXISTS, "fs_rename: '%s' zaten mevcut", new_name);
+        }
+    }
+    // find old_name
+    for (uint32_t i = 0; i < metadata.file_count; ++i) {
+        if (strcmp(metadata.entries[i].name, old_name) == 0) {
+            // rename
+            memset(metadata.entries[i].name, 0, sizeof(metadata.entries[i].name));
+            strncpy(metadata.entries[i].name, new_name, sizeof(metadata.entries[i].name)-1);
+            if ((rc = disk_write_metadata()) < 0) FS_FAIL(rc, "fs_rename: metadata yazılamadı");
+            FS_INFO("fs_rename: '%s' -> '%s'", old_name, new_name);
+            return 0;
+        }
+    }
+    FS_FAIL(FS_ERR_NOT_FOUND, "fs_rename: '%s' bulunamadı", old_name);
+}
+
+// 3) Check if a file exists
+static int fs_exists_impl(const char *filename) {
+    if (!filename) return 0;
+    if (disk_read_metadata() < 0) {
+        FS_ERROR("fs_exists: metadata okunamadı");
+        return 0;
+    }
+    for (uint32_t i = 0; i < metadata.file_count; ++i) {
+        if (strcmp(metadata.entries[i].name, filename) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+// fs.c içinde uygun yere ekleyin:
+
+// 4) Get file size from metadata
+static int fs_size_impl(const char *filename, uint32_t *size_out) {
+    if (!filename || !size_out) FS_FAIL(FS_ERR_INVALID, "fs_size: invalid arguments");
+    // Eğer log dosyası isteniyorsa host FS'teki ikili logun boyutunu ver
+    if (strcmp(filename, OPLOG_TEXT_NAME) == 0) {
+        struct stat st;
+        fs_log_flush();
+        if (stat(OPLOG_FILENAME, &st) < 0) {
+            FS_FAIL(FS_ERR_IO, "fs_size: stat log file: %s", strerror(errno));
+        }
+        *size_out = (uint32_t)st.st_size;
+        return 0;
+    }
+    // Aksi halde virtual FS metadata’dan oku
+    int rc = disk_read_metadata();
+    if (rc < 0) FS_FAIL(rc, "fs_size: metadata okunamadı");
+    for (uint32_t i = 0; i < metadata.file_count; ++i) {
+        if (strcmp(metadata.entries[i].name, filename) == 0) {
+            *size_out = fs_visible_size(&metadata.entries[i]);
+            return 0;
+        }
+    }
+    FS_FAIL(FS_ERR_NOT_FOUND, "fs_size: '%s' not found", filename);
+}
+
+// 5) Append data to end of file (preserve existing content)
+static ssize_t fs_append_impl(const char *filename, const void *data, size_t size) {
+    if (!filename || !data || size == 0) FS_FAIL(FS_ERR_INVALID, "fs_append: invalid arguments");
+    int idx = fs_append_find(filename);
+    if (idx < 0) idx = fs_lookup(filename);
+    if (idx == FS_ERR_NOT_FOUND) FS_FAIL(idx, "fs_append: '%s' bulunamadı", filename);
+    if (idx < 0) FS_FAIL(idx, "fs_append: metadata okunamadı");
+
+    // Yeni veri görünür boyutun hemen ardına eklenir (küçükse önce tampona)
+    ssize_t written = fs_append_to((uint32_t)idx, data, size);
+    if (written < 0) FS_FAIL((int)written, "fs_append: write");
+    FS_INFO("fs_append: '%s' dosyasına %zd byte eklendi", filename, written);
+    return written;
+}
+
+// 6) Truncate (or extend with zeros) a file
+static int fs_truncate_impl(const char *filename, uint32_t new_size) {
+    if (!filename) FS_FAIL(FS_ERR_INVALID, "fs_truncate: invalid argument");
+    int rc = fs_append_flush_all();
+    if (rc < 0) FS_FAIL(rc, "fs_truncate: pending appends");
+    rc = disk_read_metadata();
+    if (rc < 0) FS_FAIL(rc, "fs_truncate: metadata okunamadı");
+    FileEntry *e = NULL;
+    for (uint32_t i = 0; i < metadata.file_count; ++i) {
+        if (strcmp(metadata.entries[i].name, filename) == 0) {
+            e = &metadata.entries[i];
+            break;
+        }
+    }
+    if (!e) FS_FAIL(FS_ERR_NOT_FOUND, "fs_truncate: '%s' bulunamadı", filename);
+
+    // Eğer küçültme ise sadece metadata boyutu değişir; ön ayırma bırakılır
+    uint32_t old_size = e->size;
+    if (new_size < old_size) fs_prealloc_drop(e);
+    if (fs_is_inline(e) && new_size <= INLINE_MAX) {
+        // Yuvada kalır; kesilen kısım sıfırlanır (uzatılan kısım zaten sıfır)
+        if (new_size < old_size) {
+            memset(fs_inline_data(e) + new_size, 0, old_size - new_size);
+            if ((rc = disk_write_inline(e->start_block & ~INLINE_SLOT)) < 0) {
+                FS_FAIL(rc, "fs_truncate: inline slot");
+            }
+        }
+        e->size = new_size;
+    } else if (new_size <= e->size && (metadata.flags & DISK_FLAG_INLINE) && new_size <= INLINE_MAX) {
+        // Yuvaya sığacak kadar küçüldü: kalan veri yuvaya alınır, bloklar bırakılır
+        uint32_t slot, old_start = e->start_block;
+        if ((rc = fs_maps_release((uint32_t)(e - metadata.entries))) < 0 ||
+            (rc = fs_inline_slot(&slot)) < 0) {
+            FS_FAIL(rc, "fs_truncate: inline slot");
+        }
+        ssize_t rd = new_size ? disk_read_data((uint64_t)old_start * BLOCK_SIZE, inline_area[slot], new_size) : 0;
+        if (rd != (ssize_t)new_size) {
+            memset(inline_area[slot], 0, INLINE_MAX);
+            FS_FAIL(rd < 0 ? (int)rd : FS_ERR_IO, "fs_truncate: read");
+        }
+        if ((rc = disk_write_inline(slot)) < 0) FS_FAIL(rc, "fs_truncate: inline slot");
+        e->start_block = INLINE_SLOT | slot;
+        e->size = new_size;
+        if ((rc = disk_write_metadata()) < 0) FS_FAIL(rc, "fs_truncate: metadata yazılamadı");
+        fs_reclaim_blocks(old_start, fs_blocks(old_size));
+        FS_INFO("fs_truncate: '%s' boyutu %u byte olarak ayarlandı", filename, new_size);
+        return 0;
+    } else if (new_size <= e->size) {
+        e->size = new_size;
+    } else {
+        // Uzatma: yeni alan delik olarak bırakılır (yazım yapılmaz, sıfır okunur)
+        if ((rc = fs_reserve(e, new_size)) < 0) FS_FAIL(rc, "fs_truncate: allocate");
+        uint64_t data_off = (uint64_t)e->start_block * BLOCK_SIZE + e->size;
+        if (!fs_is_inline(e) && (rc = disk_zero_range(data_off, new_size - e->size)) < 0) {
+            FS_FAIL(rc, "fs_truncate: extend");
+        }
+        e->size = new_size;
+    }
+
+    // Metadata kaydet
+    if ((rc = disk_write_metadata()) < 0) FS_FAIL(rc, "fs_truncate: metadata yazılamadı");
+    if (new_size < old_size && !fs_is_inline(e)) {
+        uint32_t keep = (new_size + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        uint32_t had  = (old_size + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        fs_reclaim_blocks(e->start_block + keep, had - keep);
+    }
+    FS_INFO("fs_truncate: '%s' boyutu %u byte olarak ayarlandı", filename, new_size);
+    return 0;
+}
+
+// 7) Punch hole: dosyanın ortasındaki bir aralığı serbest bırakır; boyut değişmez,
+// aralık sıfır okunur ve tam bloklar yer tutmaz
+static int fs_punch_hole_impl(const char *filename, uint32_t offset, uint32_t len) {
+    if (!filename) FS_FAIL(FS_ERR_INVALID, "fs_punch_hole: invalid argument");
+    int idx = fs_append_flush_all();
+    if (idx < 0) FS_FAIL(idx, "fs_punch_hole: pending appends");
+    idx = fs_lookup(filename);
+    if (idx == FS_ERR_NOT_FOUND) FS_FAIL(idx, "fs_punch_hole: '%s' not found", filename);
+    if (idx < 0) FS_FAIL(idx, "fs_punch_hole: read_meta");
+
+    const FileEntry *e = &metadata.entries[idx];
+    if (offset >= e->size || len == 0) return 0;
+    if (len > e->size - offset) len = e->size - offset;
+    int rc;
+    if (fs_is_inline(e)) {
+        memset(fs_inline_data(e) + offset, 0, len);
+        rc = disk_write_inline(e->start_block & ~INLINE_SLOT);
+    } else {
+        rc = disk_zero_range((uint64_t)e->start_block * BLOCK_SIZE + offset, len);
+    }
+    if (rc < 0) FS_FAIL(rc, "fs_punch_hole: '%s'", filename);
+    FS_INFO("fs_punch_hole: '%s' [%u, %u) serbest bırakıldı", filename, offset, offset + len);
+    return 0;
+}
+
+// 8) Fallocate: [offset, offset+len) aralığı için dosyaya bitişik blok ayırır,
+// veri yazmaz. Boyut gerekirse büyür (uzatılan kısım fs_truncate'teki gibi
+// delik kalır); FS_FALLOC_KEEP_SIZE ile boyut değişmez ve bloklar sonraki
+// eklemeler için dosyanın ardında ayrılmış kalır.
+static int fs_fallocate_impl(const char *filename, uint32_t offset, uint32_t len, int flags) {
+    if (!filename || len == 0 || (flags & ~FS_FALLOC_KEEP_SIZE)) {
+        FS_FAIL(FS_ERR_INVALID, "fs_fallocate: invalid arguments");
+    }
+    uint64_t end = (uint64_t)offset + len;
+    if (end > DATA_SIZE) FS_FAIL(FS_ERR_NO_SPACE, "fs_fallocate: %llu bytes do not fit", (unsigned long long)end);
+    int idx = fs_append_flush_all();
+    if (idx < 0) FS_FAIL(idx, "fs_fallocate: pending appends");
+    idx = fs_lookup(filename);
+    if (idx == FS_ERR_NOT_FOUND) FS_FAIL(idx, "fs_fallocate: '%s' not found", filename);
+    if (idx < 0) FS_FAIL(idx, "fs_fallocate: read_meta");
+
+    FileEntry *e = &metadata.entries[idx];
+    if (!(flags & FS_FALLOC_KEEP_SIZE)) {
+        return end > e->size ? fs_truncate_impl(filename, (uint32_t)end) : 0;
+    }
+    if (fs_is_inline(e) && end <= INLINE_MAX) return 0;      // Yuva zaten ayrılmış
+    uint32_t need = fs_blocks(end);
+    if (need <= fs_alloc_blocks(e)) return 0;
+    int rc = fs_reserve(e, end);
+    if (rc < 0) FS_FAIL(rc, "fs_fallocate: '%s' needs %u contiguous blocks", filename, need);
+    file_prealloc[idx] = need;
+    FS_INFO("fs_fallocate: '%s' için %u blok ayrıldı", filename, need);
+    return 0;
+}
+
+// Kapasite dışına taşan ilk (en büyük) dosya; yoksa -1
+static int fs_resize_victim(uint32_t blocks) {
+    int best = -1;
+    for (uint32_t i = 0; i < metadata.file_count; ++i) {
+        const FileEntry *e = &metadata.entries[i];
+        uint32_t n = fs_alloc_blocks(e);
+        if (!n || e->start_block + n <= blocks) continue;
+        if (best < 0 || n > fs_alloc_blocks(&metadata.entries[best])) best = (int)i;
+    }
+    return best;
+}
+
+// 9) Resize: düz tek imajın toplam boyutunu (metadata dahil) size bayta
+// getirir, blok sınırına yukarı yuvarlanır. Küçültürken yeni sonun ötesine
+// taşan dosyalar ön ayırmalarıyla birlikte kalan boş alana taşınır (büyükler
+// önce, delikler korunur); yer yoksa imaj kesilmez ve FS_ERR_NO_SPACE döner,
+// o ana kadar taşınan dosyalar yeni yerlerinde kalır.
+static int fs_resize_impl(uint32_t size) {
+    if (size < METADATA_SIZE || size > DISK_SIZE) {
+        FS_FAIL(FS_ERR_INVALID, "fs_resize: %u bytes (%d-%d)", size, METADATA_SIZE, DISK_SIZE);
+    }
+    int rc = fs_append_flush_all();
+    if (rc < 0) FS_FAIL(rc, "fs_resize: pending appends");
+    if ((rc = disk_read_metadata()) < 0) FS_FAIL(rc, "fs_resize: read_meta");
+    if ((metadata.flags & (DISK_FLAG_DEDUP | DISK_FLAG_LOG)) || disk_devices() > 1) {
+        FS_FAIL(FS_ERR_UNSUPPORTED, "fs_resize: only plain single-file images can be resized");
+    }
+    uint32_t blocks = (size - METADATA_SIZE + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    if (blocks < fs_reserved_blocks()) {
+        FS_FAIL(FS_ERR_INVALID, "fs_resize: the inline area needs %u blocks", fs_reserved_blocks());
+    }
+
+    uint8_t used[DATA_BLOCKS];
+    for (int idx; (idx = fs_resize_victim(blocks)) >= 0; ) {
+        FileEntry *e = &metadata.entries[idx];
+        uint32_t n = fs_alloc_blocks(e), old_start = e->start_block;
+        fs_block_map(used);
+        memset(used + blocks, 1, DATA_BLOCKS - blocks);
+        int64_t start = alloc_find(used, n);
+        if (start < 0) {
+            FS_FAIL(FS_ERR_NO_SPACE, "fs_resize: no room below block %u for '%s' (%u blocks)",
+                    blocks, e->name, n);
+        }
+        if ((rc = fs_move_data(e, (uint32_t)start)) < 0) FS_FAIL(rc, "fs_resize: moving '%s'", e->name);
+        e->start_block = (uint32_t)start;
+        if ((rc = disk_write_metadata()) < 0) FS_FAIL(rc, "fs_resize: metadata yazılamadı");
+        fs_reclaim_blocks(old_start, n);
+    }
+    if ((rc = disk_resize(blocks)) < 0) FS_FAIL(rc, "fs_resize: cannot resize '%s'", disk_path());
+    FS_INFO("fs_resize: imaj %u bayt, %u veri bloğu", METADATA_SIZE + blocks * BLOCK_SIZE, blocks);
+    return 0;
+}
+
+static int fs_delayed_alloc_enable_impl(int on) {
+    int rc = fs_append_flush_all();
+    if (rc < 0) FS_FAIL(rc, "fs_delayed_alloc_enable: pending appends");
+    delayed_alloc = on ? 1 : 0;
+    return 0;
+}
+
+static int fs_defragment_impl(void) {
+    int rc = fs_append_flush_all();
+    if (rc < 0) FS_FAIL(rc, "fs_defragment: pending appends");
+    // Dosyalar yer değiştirir: eşlemelerdeki yazımlar aktarılır, eşlemeler ayrılır
+    if ((rc = fs_maps_flush_all()) < 0) FS_FAIL(rc, "fs_defragment: mapped writes");
+    fs_maps_detach_all();
+    rc = disk_read_metadata();
+    if (rc < 0) FS_FAIL(rc, "fs_defragment: metadata okunamadı");
+
+    // Yeni blok indeksini takip et (satır içi alanın ardından başlar)
+    uint32_t next_block = fs_reserved_blocks();
+    // Dosyalar DIO_BUF_SIZE'lık parçalarla taşınır; doğrudan G/Ç'de tampon
+    // hizalı havuzdan gelir ve hizalı istekler kopyasız geçer
+    int direct = dio_enabled();
+    char *buffer = direct ? dio_buf_get() : buf_get(BUF_CHUNK);
+    if (!buffer) FS_FAIL(FS_ERR_NO_MEMORY, "fs_defragment: malloc");
+
+    // Geçici kopya metadata
+    DiskMetadata old_meta = metadata;
+
+    // Dosyalar eski konum sırasıyla öne kaydırılır: hedef hiçbir zaman henüz
+    // taşınmamış bir dosyanın üzerine düşmez, aynı dosya içinde de ileri kopya güvenli
+    uint32_t order[MAX_FILES];
+    for (uint32_t i = 0; i < old_meta.file_count; ++i) {
+        uint32_t j = i;
+        while (j > 0 && old_meta.entries[order[j - 1]].start_block > old_meta.entries[i].start_block) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+    }
+
+    for (uint32_t k = 0; k < old_meta.file_count; ++k) {
+        uint32_t i = order[k];
+        FileEntry *e_old = &old_meta.entries[i];
+        FileEntry *e_new = &metadata.entries[i];
+        if (fs_is_inline(e_old)) continue;      // Blok kullanmaz
+
+        uint64_t read_base  = (uint64_t)e_old->start_block * BLOCK_SIZE;
+        uint64_t write_base = (uint64_t)next_block * BLOCK_SIZE;
+
+        // Her dosya için start_block güncelle; yerinde kalan dosya yazılmaz
+        e_new->start_block = next_block;
+        const char *failed = NULL;
+
+        // Yalnızca veri aralıkları parça parça kopyalanır, hedefteki delik
+        // aralıkları sıfırlanır (tam bloklar delik olur). Aralıklar sırayla
+        // işlendiğinden hedef, kaynağın yalnızca işlenmiş kısmıyla çakışır;
+        // parça yazılmadan önce okunmuş olur.
+        for (uint32_t off = 0; e_old->start_block != next_block && off < e_old->size && !failed; ) {
+            int64_t data = fs_file_extent(e_old, off, 0);
+            int64_t hole = data < 0 ? data : fs_file_extent(e_old, (uint32_t)data, 1);
+            if (hole < 0) {
+                rc = (int)hole;
+                failed = "extent";
+                break;
+            }
+            if ((uint32_t)data > off && (rc = disk_zero_range(write_base + off, (uint32_t)data - off)) < 0) {
+                failed = "clear hole";
+                break;
+            }
+            for (uint32_t pos = (uint32_t)data; pos < (uint32_t)hole; ) {
+                uint32_t chunk = (uint32_t)hole - pos < DIO_BUF_SIZE ? (uint32_t)hole - pos : DIO_BUF_SIZE;
+                rc = FS_ERR_IO;
+                if (disk_read_data(read_base + pos, buffer, chunk) != (ssize_t)chunk) {
+                    failed = "read";
+                    break;
+                }
+                if (disk_write_data(write_base + pos, buffer, chunk) != (ssize_t)chunk) {
+                    failed = "write";
+                    break;
+                }
+                pos += chunk;
+            }
+            off = (uint32_t)hole;
+        }
+        if (failed) {
+            if (direct) dio_buf_put(buffer);
+            else        buf_put(BUF_CHUNK, buffer);
+            FS_FAIL(rc, "fs_defragment: %s", failed);
+        }
+
+        // Bir sonraki dosya için blokları atla (ön ayırma dosyanın ardında korunur)
+        uint32_t blocks_used = (e_old->size + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        if (blocks_used < file_prealloc[i]) blocks_used = file_prealloc[i];
+        next_block += blocks_used;
+    }
+
+    if (direct) dio_buf_put(buffer);
+    else        buf_put(BUF_CHUNK, buffer);
+
+    // Yeni metadata’yı diske yaz
+    if ((rc = disk_write_metadata()) < 0) FS_FAIL(rc, "fs_defragment: metadata yazılamadı");
+    alloc_reset();
+    // Sıkıştırılan alanın gerisinde kalan eski kopyaları bırak
+    if (next_block < disk_capacity()) fs_reclaim_blocks(next_block, disk_capacity() - next_block);
+    FS_INFO("fs_defragment: tamamlandı, %u blok kullanıldı", next_block);
+    return 0;
+}
+static int fs_check_integrity_impl(void) {
+    int rc = fs_append_flush_all();
+    if (rc < 0) FS_FAIL(rc, "fs_check_integrity: pending appends");
+    rc = disk_read_metadata();
+    if (rc < 0) FS_FAIL(rc, "fs_check_integrity: metadata okunamadı");
+
+    // Şeritli kümede eksik ya da kısalmış aygıt dosyaları
+    int errors = disk_check_devices();
+    uint8_t slot_owner[MAX_FILES] = { 0 };
+    for (uint32_t i = 0; i < metadata.file_count; ++i) {
+        FileEntry *e = &metadata.entries[i];
+        if (fs_is_inline(e)) {
+            // Satır içi dosya: geçerli, başka kayıtla paylaşılmayan bir yuva ve sığan boyut
+            uint32_t slot = e->start_block & ~INLINE_SLOT;
+            if (!(metadata.flags & DISK_FLAG_INLINE) || slot >= MAX_FILES ||
+                slot_owner[slot] || e->size > INLINE_MAX) {
+                FS_ERROR("fs_check_integrity: '%s' has an invalid inline slot (%u, size %u)",
+                         e->name, slot, e->size);
+                errors++;
+            } else {
+                slot_owner[slot] = 1;
+            }
+            continue;
+        }
+        // Her dosya kendi bitişik blok aralığını kullanmalı
+        uint32_t nblk = fs_blocks(e->size);
+        if ((uint64_t)e->start_block + nblk > disk_capacity()) {
+            FS_ERROR("fs_check_integrity: '%s' extends past the data region", e->name);
+            errors++;
+        }
+        if (nblk && e->start_block < fs_reserved_blocks()) {
+            FS_ERROR("fs_check_integrity: '%s' overlaps the inline area", e->name);
+            errors++;
+        }
+        for (uint32_t j = 0; j < i && nblk; ++j) {
+            const FileEntry *o = &metadata.entries[j];
+            if (fs_is_inline(o)) continue;
+            uint32_t oblk = fs_blocks(o->size);
+            if (oblk && e->start_block < o->start_block + oblk && o->start_block < e->start_block + nblk) {
+                FS_ERROR("fs_check_integrity: '%s' overlaps '%s' (blocks %u-%u)",
+                         e->name, o->name, e->start_block, e->start_block + nblk - 1);
+                errors++;
+            }
+        }
+    }
+
+    if (errors) FS_FAIL(FS_ERR_CORRUPT, "fs_check_integrity: %d bozuk dosya bulundu", errors);
+    FS_INFO("fs_check_integrity: tüm dosyalar tutarlı");
+    return 0;
+}
+
+// İlk bayt sıfırsa tampon kendisinin bir bayt kaydırılmışıyla aynı olmalı;
+// libc memcmp'i bayt döngüsünden çok daha hızlıdır
+static int is_zero_block(const char *buf, size_t len) {
+    return len == 0 || (buf[0] == 0 && memcmp(buf, buf + 1, len - 1) == 0);
+}
+
+#define IMAGE_CHUNK DIO_BUF_SIZE  // Şeritli kümede / doğrudan G/Ç'de yedekleme adımı
+// Yedekleme ve birleştirme tamponu doğrudan G/Ç'de dio havuzundan, değilse
+// BUF_CHUNK sınıfından gelir; adım ikisinde de aynıdır
+_Static_assert(BUF_CHUNK_SIZE == DIO_BUF_SIZE, "BUF_CHUNK_SIZE must match DIO_BUF_SIZE");
+
+// buf[*pos, len) içindeki bir sonraki tamamen sıfır olmayan blok dizisinin
+// uzunluğu (dizi *pos'ta biter); kalmadıysa 0
+static size_t next_data_run(const char *buf, size_t len, size_t *pos) {
+    size_t at = *pos;
+    while (at < len && is_zero_block(buf + at, len - at < BLOCK_SIZE ? len - at : BLOCK_SIZE)) at += BLOCK_SIZE;
+    if (at > len) at = len;
+    size_t start = at;
+    while (at < len && !is_zero_block(buf + at, len - at < BLOCK_SIZE ? len - at : BLOCK_SIZE)) at += BLOCK_SIZE;
+    if (at > len) at = len;
+    *pos = at;
+    return at - start;
+}
+
+// Yedek ve geri yükleme dosyaları: doğrudan G/Ç açıksa bunlar da sayfa
+// önbelleğini atlar (O_DIRECT, oku-değiştir-yaz için yazımda da okuma izni);
+// dosya sistemi desteklemiyorsa normal açılır. G/Ç dio.h üzerinden hizalanır.
+static int fs_image_open(const char *path, int flags, int direct) {
+#ifdef O_DIRECT
+    if (direct) {
+        int dflags = (flags & O_ACCMODE) == O_WRONLY ? (flags & ~O_ACCMODE) | O_RDWR : flags;
+        int fd = open(path, dflags | O_DIRECT, 0666);
+        if (fd >= 0 || errno != EINVAL) return fd;
+    }
+#else
+    (void)direct;
+#endif
+    return open(path, flags, 0666);
+}
+
+static ssize_t fs_image_pio(int fd, void *buf, size_t size, off_t off, int write, int direct) {
+    if (direct) return write ? dio_pwrite(fd, buf, size, off) : dio_pread(fd, buf, size, off);
+    STATS_SYSCALL(1);
+    return write ? pwrite(fd, buf, size, off) : pread(fd, buf, size, off);
+}
+
+static char *fs_image_buf(int direct, BufClass cls) {
+    return direct ? dio_buf_get() : buf_get(cls);
+}
+
+static void fs_image_buf_free(char *buf, int direct, BufClass cls) {
+    if (direct) dio_buf_put(buf);
+    else        buf_put(cls, buf);
+}
+
+// İmaj dosyasını src'den dst'ye kopyalar. Kaynaktaki delikler (SEEK_DATA /
+// SEEK_HOLE) okunmaz, tamamen sıfır bloklar yazılmaz: hedef önce tam boyuta
+// ayarlandığından bu alanlar hedefte de delik olarak kalır. Doğrudan G/Ç'de
+// blok yerine IMAGE_CHUNK'lık adımlarla okunur.
+static int fs_copy_image(int src, int dst, const char *who) {
+    struct stat st;
+    if (fstat(src, &st) < 0 || ftruncate(dst, st.st_size) < 0) {
+        FS_FAIL(FS_ERR_IO, "%s: size image: %s", who, strerror(errno));
+    }
+    STATS_SYSCALL(2);
+
+    int direct = dio_enabled();
+    size_t step = direct ? IMAGE_CHUNK : BLOCK_SIZE;
+    char *buf = fs_image_buf(direct, BUF_BLOCK);
+    if (!buf) FS_FAIL(FS_ERR_NO_MEMORY, "%s: malloc", who);
+
+    int rc = 0;
+    off_t off = 0;
+    while (off < st.st_size && rc == 0) {
+        off_t hole = st.st_size;
+#if defined(SEEK_DATA) && defined(SEEK_HOLE)
+        off_t data = lseek(src, off, SEEK_DATA);
+        STATS_SYSCALL(1);
+        if (data < 0 && errno == ENXIO) break;     // geri kalan tamamen delik
+        if (data >= 0) {
+            off = data;
+            hole = lseek(src, data, SEEK_HOLE);
+            STATS_SYSCALL(1);
+            if (hole < 0) hole = st.st_size;
+        }
+#endif
+        while (off < hole) {
+            size_t want = direct && (uint64_t)(hole - off) < step ? (size_t)(hole - off) : step;
+            ssize_t n = fs_image_pio(src, buf, want, off, 0, direct);
+            if (n < 0) {
+                FS_ERROR("%s: read: %s", who, strerror(errno));
+                rc = FS_ERR_IO;
+                break;
+            }
+            if (n == 0) {                         // kaynak beklenenden kısa
+                off = st.st_size;
+                break;
+            }
+            for (size_t at = 0, run; rc == 0 && (run = next_data_run(buf, (size_t)n, &at)) > 0; ) {
+                if (fs_image_pio(dst, buf + at - run, run, off + (off_t)(at - run), 1, direct) != (ssize_t)run) {
+                    FS_ERROR("%s: write: %s", who, strerror(errno));
+                    rc = FS_ERR_IO;
+                }
+            }
+            off += n;
+        }
+    }
+    fs_image_buf_free(buf, direct, BUF_BLOCK);
+    return rc;
+}
+
+// Şeritli kümeyi tek aygıtla açılabilen düz bir imaj olarak dst'ye yazar.
+// Her IMAGE_CHUNK tüm aygıtlardan paralel okunur; sıfır bloklar yazılmaz.
+static int fs_export_striped(int dst) {
+    STATS_SYSCALL(1);
+    if (ftruncate(dst, DISK_SIZE) < 0) FS_FAIL(FS_ERR_IO, "fs_backup: size image: %s", strerror(errno));
+    int direct = dio_enabled();
+    char *buf = fs_image_buf(direct, BUF_CHUNK);
+    if (!buf) FS_FAIL(FS_ERR_NO_MEMORY, "fs_backup: malloc");
+
+    int rc = 0;
+    for (uint64_t off = 0; off < DISK_SIZE && rc == 0; off += IMAGE_CHUNK) {
+        size_t n = DISK_SIZE - off < IMAGE_CHUNK ? (size_t)(DISK_SIZE - off) : IMAGE_CHUNK;
+        ssize_t r = disk_image_read(off, buf, n);
+        if (r != (ssize_t)n) {
+            rc = r < 0 ? (int)r : FS_ERR_IO;
+            FS_ERROR("fs_backup: read at %llu failed", (unsigned long long)off);
+            break;
+        }
+        if (off == 0) {
+            DiskMetadata *md = (DiskMetadata *)buf;
+            md->stripe_devices = md->stripe_blocks = 0;
+        }
+        for (size_t at = 0, run; rc == 0 && (run = next_data_run(buf, n, &at)) > 0; ) {
+            if (fs_image_pio(dst, buf + at - run, run, (off_t)(off + at - run), 1, direct) != (ssize_t)run) {
+                FS_ERROR("fs_backup: write: %s", strerror(errno));
+                rc = FS_ERR_IO;
+            }
+        }
+    }
+    fs_image_buf_free(buf, direct, BUF_CHUNK);
+    return rc;
+}
+
+// Düz bir yedeği şeritli kümeye yazar: aygıt dosyaları yeniden oluşturulur,
+// metadata kümenin geometrisiyle yazılır ve veri aygıtlara paralel dağıtılır
+static int fs_import_striped(int src) {
+    int direct = dio_enabled();
+    char *buf = fs_image_buf(direct, BUF_CHUNK);
+    if (!buf) FS_FAIL(FS_ERR_NO_MEMORY, "fs_restore: malloc");
+
+    int rc = 0;
+    ssize_t r = fs_image_pio(src, buf, METADATA_SIZE, 0, 0, direct);
+    if (r != METADATA_SIZE) {
+        FS_ERROR("fs_restore: read metadata: %s", r < 0 ? strerror(errno) : "short backup");
+        rc = FS_ERR_IO;
+    } else {
+        rc = disk_create((DiskMetadata *)buf);
+    }
+    for (uint64_t off = METADATA_SIZE; off < DISK_SIZE && rc == 0; off += IMAGE_CHUNK) {
+        size_t n = DISK_SIZE - off < IMAGE_CHUNK ? (size_t)(DISK_SIZE - off) : IMAGE_CHUNK;
+        r = fs_image_pio(src, buf, n, (off_t)off, 0, direct);
+        if (r < 0) {
+            FS_ERROR("fs_restore: read: %s", strerror(errno));
+            rc = FS_ERR_IO;
+            break;
+        }
+        if (r == 0) break;                          // yedek beklenenden kısa: gerisi delik
+        for (size_t at = 0, run; rc == 0 && (run = next_data_run(buf, (size_t)r, &at)) > 0; ) {
+            ssize_t w = disk_image_write(off + at - run, buf + at - run, run);
+            if (w != (ssize_t)run) rc = w < 0 ? (int)w : FS_ERR_IO;
+        }
+    }
+    fs_image_buf_free(buf, direct, BUF_CHUNK);
+    return rc;
+}
+
+// 11) Backup: copy entire disk.sim into backup_filename (seyrek kopya)
+static int fs_backup_impl(const char *backup_filename) {
+    if (!backup_filename) FS_FAIL(FS_ERR_INVALID, "fs_backup: geçersiz hedef dosya adı");
+    int rc = fs_append_flush_all();
+    if (rc < 0) FS_FAIL(rc, "fs_backup: pending appends");
+    // Yedek imajdan okunur: bellek katmanındaki yazımlar ve günlük eşlemesi önce diske
+    if ((rc = disk_flush()) < 0) FS_FAIL(rc, "fs_backup: pending layer state");
+    // Yedek imaj dosyasından okunur: yerinde yazan süreçler bitene kadar beklenir
+    if ((rc = share_lock_range(0, DATA_SIZE, 0)) < 0) FS_FAIL(rc, "fs_backup: lock");
+
+    if (disk_devices() > 1) {
+        int dst = fs_image_open(backup_filename, O_CREAT | O_TRUNC | O_WRONLY, dio_enabled());
+        if (dst < 0) FS_FAIL(FS_ERR_IO, "fs_backup: open backup: %s", strerror(errno));
+        rc = fs_export_striped(dst);
+        close(dst);
+        STATS_SYSCALL(2);   // open, close
+        if (rc < 0) return rc;
+        FS_INFO("fs_backup: %d aygıtlı küme '%s' dosyasına yedeklendi", disk_devices(), backup_filename);
+        return 0;
+    }
+
+    int src = fs_image_open(disk_path(), O_RDONLY, dio_enabled());
+    if (src < 0) FS_FAIL(FS_ERR_IO, "fs_backup: open disk: %s", strerror(errno));
+    int dst = fs_image_open(backup_filename, O_CREAT | O_TRUNC | O_WRONLY, dio_enabled());
+    if (dst < 0) {
+        FS_ERROR("fs_backup: open backup: %s", strerror(errno));
+        close(src);
+        return FS_ERR_IO;
+    }
+
+    rc = fs_copy_image(src, dst, "fs_backup");
+    close(src);
+    close(dst);
+    STATS_SYSCALL(4);   // 2x open, 2x close
+    if (rc < 0) return rc;
+    FS_INFO("fs_backup: disk '%s' dosyasına yedeklendi", backup_filename);
+    return 0;
+}
+
+// 12) Restore: overwrite disk.sim from backup_filename (seyrek kopya)
+static int fs_restore_impl(const char *backup_filename) {
+    if (!backup_filename) FS_FAIL(FS_ERR_INVALID, "fs_restore: geçersiz kaynak dosya adı");
+
+    int src = fs_image_open(backup_filename, O_RDONLY, dio_enabled());
+    if (src < 0) FS_FAIL(FS_ERR_IO, "fs_restore: open backup: %s", strerror(errno));
+    fs_maps_detach_all();
+    disk_quiesce();             // Temizleyici ve bekleyen delmeler kopyalanan imaja dokunmasın
+    int rc;
+    if (disk_devices() > 1) {
+        rc = fs_import_striped(src);
+        close(src);
+        STATS_SYSCALL(2);   // open, close
+    } else {
+        int dst = fs_image_open(disk_path(), O_CREAT | O_TRUNC | O_WRONLY, dio_enabled());
+        if (dst < 0) {
+            FS_ERROR("fs_restore: open disk: %s", strerror(errno));
+            close(src);
+            return FS_ERR_IO;
+        }
+        rc = fs_copy_image(src, dst, "fs_restore");
+        close(src);
+        close(dst);
+        STATS_SYSCALL(4);   // 2x open, 2x close
+    }
+    disk_reset();
+    fs_handles_invalidate();
+    fs_append_discard_all();
+    memset(file_ra, 0, sizeof(file_ra));
+    memset(file_prealloc, 0, sizeof(file_prealloc));
+    alloc_reset();
+    if (rc < 0) return rc;
+    FS_INFO("fs_restore: '%s' geri yüklendi", backup_filename);
+    return 0;
+}
+
+// 13) Toplu içe/dışa aktarma: ana makine tarafı bulk.c'deki iş parçacığında
+// okunur/yazılır. İçe aktarmada yer ayırma bellekteki blok haritası üzerinden
+// yapılır, dosyalar IMPORT_BATCH'lik gruplar halinde konumlarına göre
+// sıralanıp bitişik olanlar tek disk_writev_data ile yazılır ve metadata en
+// sonda bir kez kaydedilir; hata olursa hiçbir kayıt eklenmez.
+#define IMPORT_BATCH       64
+#define IMPORT_BATCH_BYTES (256 * 1024)
+
+typedef struct {
+    uint32_t start;
+    BulkItem item;
+} ImportSlot;
+
+static int fs_import_cmp(const void *a, const void *b) {
+    uint32_t x = ((const ImportSlot *)a)->start, y = ((const ImportSlot *)b)->start;
+    return (x > y) - (x < y);
+}
+
+// Son bloğun kalanı sıfırla doldurulur: bloklar önceki sahiplerinden veri taşımaz
+static int fs_import_flush(ImportSlot *batch, int n) {
+    static const uint8_t pad[BLOCK_SIZE];
+    struct iovec iov[2 * IMPORT_BATCH];
+    int rc = 0;
+    qsort(batch, (size_t)n, sizeof(*batch), fs_import_cmp);
+    for (int i = 0; i < n && rc == 0; ) {
+        int    k     = 0, j = i;
+        size_t total = 0;
+        for (;; j++) {
+            uint32_t nblk = fs_blocks(batch[j].item.size);
+            size_t   tail = (size_t)nblk * BLOCK_SIZE - batch[j].item.size;
+            iov[k++] = (struct iovec){ batch[j].item.data, batch[j].item.size };
+            if (tail) iov[k++] = (struct iovec){ (void *)pad, tail };
+            total += (size_t)nblk * BLOCK_SIZE;
+            if (j + 1 == n || batch[j + 1].start != batch[j].start + nblk) break;
+        }
+        ssize_t w = disk_writev_data((uint64_t)batch[i].start * BLOCK_SIZE, iov, k);
+        if (w != (ssize_t)total) rc = w < 0 ? (int)w : FS_ERR_IO;
+        i = j + 1;
+    }
+    for (int i = 0; i < n; ++i) free(batch[i].item.data);
+    return rc;
+}
+
+// Öğeye kayıt açar; veri ya satır içi yuvaya kopyalanır ya da gruba eklenir
+static int fs_import_place(BulkItem *it, uint8_t *used, uint8_t *slots, uint8_t *dirty,
+                           ImportSlot *batch, int *n, time_t now) {
+    for (uint32_t i = 0; i < metadata.file_count; ++i) {
+        if (strcmp(metadata.entries[i].name, it->name) == 0) return FS_ERR_EXISTS;
+    }
+    if (metadata.file_count >= MAX_FILES) return FS_ERR_TOO_MANY_FILES;
+
+    FileEntry *e = &metadata.entries[metadata.file_count];
+    memset(e, 0, sizeof(*e));
+    strncpy(e->name, it->name, sizeof(e->name) - 1);
+    e->size    = it->size;
+    e->created = now;
+    if ((metadata.flags & DISK_FLAG_INLINE) && it->size <= INLINE_MAX) {
+        uint32_t slot = 0;
+        while (slot < MAX_FILES && slots[slot]) slot++;
+        if (slot == MAX_FILES) return FS_ERR_CORRUPT;
+        slots[slot] = dirty[slot] = 1;
+        memset(inline_area[slot], 0, INLINE_MAX);
+        if (it->size) memcpy(inline_area[slot], it->data, it->size);
+        e->start_block = INLINE_SLOT | slot;
+        free(it->data);
+    } else if (it->size == 0) {
+        free(it->data);
+    } else {
+        uint32_t nblk  = fs_blocks(it->size);
+        int64_t  start = alloc_find(used, nblk);
+        if (start < 0) return (int)start;
+        memset(used + start, 1, nblk);
+        e->start_block = (uint32_t)start;
+        batch[(*n)++] = (ImportSlot){ (uint32_t)start, *it };
+    }
+    it->data = NULL;
+    metadata.file_count++;
+    return 0;
+}
+
+static int fs_import_impl(BulkPipe *src, const char *who) {
+    int rc = fs_append_flush_all();
+    if (rc < 0) FS_FAIL(rc, "%s: pending appends", who);
+    if ((rc = disk_read_metadata()) < 0) FS_FAIL(rc, "%s: read_meta", who);
+
+    ScratchMark   mark  = scratch_mark();
+    DiskMetadata *saved = scratch_alloc(sizeof(*saved));
+    ImportSlot   *batch = scratch_alloc(IMPORT_BATCH * sizeof(*batch));
+    if (!saved || !batch) {
+        scratch_release(mark);
+        FS_FAIL(FS_ERR_NO_MEMORY, "%s: out of memory", who);
+    }
+    memcpy(saved, &metadata, sizeof(*saved));
+
+    uint8_t used[DATA_BLOCKS];
+    uint8_t slots[MAX_FILES] = { 0 }, dirty[MAX_FILES] = { 0 };
+    fs_block_map(used);
+    for (uint32_t i = 0; i < metadata.file_count; ++i) {
+        const FileEntry *e = &metadata.entries[i];
+        if (fs_is_inline(e)) slots[e->start_block & ~INLINE_SLOT] = 1;
+    }
+
+    time_t   now   = time(NULL);
+    int      n     = 0, count = 0;
+    size_t   bytes = 0;
+    BulkItem it;
+    while ((rc = bulk_next(src, &it)) > 0) {
+        int before = n;
+        if ((rc = fs_import_place(&it, used, slots, dirty, batch, &n, now)) < 0) {
+            FS_ERROR("%s: '%s': %s", who, it.name, fs_strerror(rc));
+            free(it.data);
+            break;
+        }
+        count++;
+        if (n > before) bytes += it.size;
+        if (n == IMPORT_BATCH || bytes >= IMPORT_BATCH_BYTES) {
+            rc    = fs_import_flush(batch, n);
+            n     = 0;
+            bytes = 0;
+            if (rc < 0) break;
+        }
+    }
+    if (rc == 0 && n) rc = fs_import_flush(batch, n);
+    else for (int i = 0; i < n; ++i) free(batch[i].item.data);
+
+    for (uint32_t s = 0; rc == 0 && s < MAX_FILES; ++s) {
+        if (dirty[s]) rc = disk_write_inline(s);
+    }
+    if (rc == 0) rc = disk_write_metadata();
+    if (rc < 0) {
+        // Yazılan bloklar hiçbir kayda ait olmadığından boş sayılır
+        memcpy(&metadata, saved, sizeof(metadata));
+        scratch_release(mark);
+        FS_FAIL(rc, "%s: import failed, no files added", who);
+    }
+    scratch_release(mark);
+    return count;
+}
+
+static int fs_export_cmp(const void *a, const void *b) {
+    const FileEntry *x = &metadata.entries[*(const uint32_t *)a];
+    const FileEntry *y = &metadata.entries[*(const uint32_t *)b];
+    uint32_t sx = fs_is_inline(x) ? 0 : x->start_block, sy = fs_is_inline(y) ? 0 : y->start_block;
+    return (sx > sy) - (sx < sy);
+}
+
+// Dosyalar imajdaki konumlarına göre okunur: ardışık okumalar bitişik kalır
+static int fs_export_impl(BulkPipe *dst, const char *who) {
+    int rc = fs_append_flush_all();
+    if (rc < 0) FS_FAIL(rc, "%s: pending appends", who);
+    if ((rc = disk_read_metadata()) < 0) FS_FAIL(rc, "%s: read_meta", who);
+
+    uint32_t order[MAX_FILES];
+    for (uint32_t i = 0; i < metadata.file_count; ++i) order[i] = i;
+    qsort(order, metadata.file_count, sizeof(order[0]), fs_export_cmp);
+
+    int count = 0;
+    for (uint32_t i = 0; i < metadata.file_count; ++i) {
+        const FileEntry *e = &metadata.entries[order[i]];
+        BulkItem it;
+        memset(&it, 0, sizeof(it));
+        memcpy(it.name, e->name, sizeof(it.name));
+        it.name[sizeof(it.name) - 1] = '\0';
+        it.size  = e->size;
+        it.mtime = e->created;
+        if (!(it.data = malloc(e->size ? e->size : 1))) FS_FAIL(FS_ERR_NO_MEMORY, "%s: out of memory", who);
+        if (fs_is_inline(e)) {
+            memcpy(it.data, fs_inline_data(e), e->size);
+        } else if (e->size) {
+            if ((rc = fs_lock_data(e, 0, e->size, 0)) < 0) {
+                free(it.data);
+                FS_FAIL(rc, "%s: lock '%s'", who, e->name);
+            }
+            ssize_t r = disk_read_data((uint64_t)e->start_block * BLOCK_SIZE, it.data, e->size);
+            if (r != (ssize_t)e->size) {
+                free(it.data);
+                FS_FAIL(r < 0 ? (int)r : FS_ERR_IO, "%s: read '%s'", who, e->name);
+            }
+        }
+        if ((rc = bulk_put(dst, &it)) < 0) FS_FAIL(rc, "%s: '%s' could not be written", who, e->name);
+        count++;
+    }
+    return count;
+}
+
+static int fs_import_dir_impl(const char *host_dir) {
+    BulkPipe *p;
+    int rc = bulk_open_dir_reader(host_dir, &p);
+    if (rc < 0) return rc;
+    int n = fs_import_impl(p, "fs_import_dir");
+    bulk_close(p);
+    if (n >= 0) FS_INFO("fs_import_dir: %d files imported from '%s'", n, host_dir);
+    return n;
+}
+
+static int fs_import_tar_impl(int fd) {
+    BulkPipe *p;
+    int rc = bulk_open_tar_reader(fd, &p);
+    if (rc < 0) return rc;
+    int n = fs_import_impl(p, "fs_import_tar");
+    bulk_close(p);
+    if (n >= 0) FS_INFO("fs_import_tar: %d files imported", n);
+    return n;
+}
+
+// Yazıcının hatası bulk_put'ta ya da en geç bulk_close'da görülür
+static int fs_export_dir_impl(const char *host_dir) {
+    BulkPipe *p;
+    int rc = bulk_open_dir_writer(host_dir, &p);
+    if (rc < 0) return rc;
+    int n = fs_export_impl(p, "fs_export_dir");
+    rc = bulk_close(p);
+    if (n >= 0 && rc < 0) FS_FAIL(rc, "fs_export_dir: write to '%s' failed", host_dir);
+    if (n >= 0) FS_INFO("fs_export_dir: %d files exported to '%s'", n, host_dir);
+    return n;
+}
+
+static int fs_export_tar_impl(int fd) {
+    BulkPipe *p;
+    int rc = bulk_open_tar_writer(fd, &p);
+    if (rc < 0) return rc;
+    int n = fs_export_impl(p, "fs_export_tar");
+    rc = bulk_close(p);
+    if (n >= 0 && rc < 0) FS_FAIL(rc, "fs_export_tar: write failed");
+    if (n >= 0) FS_INFO("fs_export_tar: %d files exported", n);
+    return n;
+}
+
+// 15) Log operations to a persistent file (buffered; see oplog.c)
+static int fs_log_impl(const char *operation, const char *filename) {
+    return oplog_append(operation, filename);
+}
+
+int fs_log_configure(const OpLogConfig *cfg) {
+    return oplog_configure(cfg);
+}
+
+int fs_log_flush(void) {
+    return oplog_flush();
+}
+
+// 16) Dedup statistics (only meaningful on images formatted with FS_FORMAT_DEDUP)
+static int fs_dedup_stats_impl(DedupStats *out) {
+    if (!out) FS_FAIL(FS_ERR_INVALID, "fs_dedup_stats: invalid arguments");
+    int rc = disk_read_metadata();
+    if (rc < 0) FS_FAIL(rc, "fs_dedup_stats: metadata okunamadı");
+    if (!(metadata.flags & DISK_FLAG_DEDUP)) {
+        FS_FAIL(FS_ERR_UNSUPPORTED, "fs_dedup_stats: dedup mode is not enabled on this disk");
+    }
+    dedup_get_stats(out);
+    return 0;
+}
+
+// Günlük yapılı mod istatistikleri (FS_FORMAT_LOG ile formatlanmış disk)
+static int fs_lfs_stats_impl(LfsStats *out) {
+    if (!out) FS_FAIL(FS_ERR_INVALID, "fs_lfs_stats: invalid arguments");
+    int rc = disk_read_metadata();
+    if (rc < 0) FS_FAIL(rc, "fs_lfs_stats: metadata okunamadı");
+    if (!(metadata.flags & DISK_FLAG_LOG)) {
+        FS_FAIL(FS_ERR_UNSUPPORTED, "fs_lfs_stats: log mode is not enabled on this disk");
+    }
+    lfs_get_stats(out);
+    return 0;
+}
+
+// 17) Statistics: counters and latency histograms for fs.h / disk.c entry points
+void fs_stats_enable(int on) {
+    stats_set_enabled(on);
+}
+
+void fs_stats_reset(void) {
+    stats_reset();
+    bcache_reset_stats();
+    memtier_reset_stats();
+    dio_reset_stats();
+    bufpool_reset_stats();
+    lfs_reset_stats();
+    trim_reset_stats();
+    share_reset_stats();
+}
+
+int fs_stats(StatOp op, StatSummary *out) {
+    if (!out || op < 0 || op >= STAT_OP_COUNT) FS_FAIL(FS_ERR_INVALID, "fs_stats: invalid arguments");
+    stats_summary(op, out);
+    return 0;
+}
+
+// Ayrıntılı iz: önce mevcut durum (format kipi, dosyalar ve görünen boyutları)
+// anlık görüntü kayıtları olarak yazılır, ardından kayıt açılır
+static int fs_trace_start_impl(const char *trace_filename) {
+    int rc = trace_open(trace_filename);
+    if (rc < 0) return rc;
+    if ((rc = disk_read_metadata()) < 0) {
+        trace_close();
+        FS_FAIL(rc, "fs_trace_start: read_meta");
+    }
+    uint64_t now = trace_now_ns();
+    trace_record(TRACE_FORMAT, TRACE_F_SNAPSHOT, now, 0, NULL, NULL, 0, 0,
+                 metadata.flags & (FS_FORMAT_DEDUP | FS_FORMAT_INLINE | FS_FORMAT_LOG));
+    if (disk_capacity() < DATA_BLOCKS) {
+        trace_record(TRACE_RESIZE, TRACE_F_SNAPSHOT, now, 0, NULL, NULL, 0,
+                     METADATA_SIZE + (uint64_t)disk_capacity() * BLOCK_SIZE, 0);
+    }
+    for (uint32_t i = 0; i < metadata.file_count; ++i) {
+        const FileEntry *e = &metadata.entries[i];
+        trace_record(TRACE_CREATE, TRACE_F_SNAPSHOT, now, 0, e->name, NULL, 0,
+                     fs_visible_size(e), 0);
+    }
+    trace_set_enabled(1);
+    FS_INFO("fs_trace_start: recording to '%s'", trace_filename);
+    return 0;
+}
+
+int fs_trace_stop(void) {
+    int rc = trace_close();
+    if (rc < 0) FS_FAIL(rc, "fs_trace_stop: flush trace");
+    return 0;
+}
+
+int fs_trace_active(void) {
+    return trace_enabled;
+}
+
+// Blok önbelleği ve ileri okuma (varsayılan açık); kapatmak önbelleği boşaltır
+void fs_cache_enable(int on) {
+    bcache_set_enabled(on);
+}
+
+int fs_cache_stats(BCacheStats *out) {
+    if (!out) FS_FAIL(FS_ERR_INVALID, "fs_cache_stats: invalid arguments");
+    bcache_stats(out);
+    return 0;
+}
+
+// Serbest kalan blokları toplu delme (varsayılan kapalı: hemen delinir)
+void fs_trim_batch_enable(int on) {
+    trim_set_batching(on);
+}
+
+int fs_share_stats(ShareStats *out) {
+    if (!out) FS_FAIL(FS_ERR_INVALID, "fs_share_stats: invalid arguments");
+    share_stats(out);
+    return 0;
+}
+
+int fs_trim_stats(TrimStats *out) {
+    if (!out) FS_FAIL(FS_ERR_INVALID, "fs_trim_stats: invalid arguments");
+    trim_stats(out);
+    return 0;
+}
+
+static int fs_direct_io_enable_impl(int on) {
+    int rc = disk_set_direct(on);
+    if (rc < 0) FS_FAIL(rc, "fs_direct_io_enable: cannot switch direct I/O %s", on ? "on" : "off");
+    return 0;
+}
+
+int fs_direct_io_stats(DioStats *out) {
+    if (!out) FS_FAIL(FS_ERR_INVALID, "fs_direct_io_stats: invalid arguments");
+    dio_stats(out);
+    return 0;
+}
+
+int fs_buffer_stats(BufPoolStats *out) {
+    if (!out) FS_FAIL(FS_ERR_INVALID, "fs_buffer_stats: invalid arguments");
+    bufpool_stats(out);
+    return 0;
+}
+
+static int fs_tier_set_limit_impl(uint64_t limit_bytes) {
+    int rc = memtier_set_limit(limit_bytes);
+    if (rc < 0) FS_FAIL(rc, "fs_tier_set_limit: cannot write back memory tier");
+    return 0;
+}
+
+int fs_tier_stats(MemTierStats *out) {
+    if (!out) FS_FAIL(FS_ERR_INVALID, "fs_tier_stats: invalid arguments");
+    memtier_stats(out);
+    return 0;
+}
+
+int fs_set_alloc_policy(AllocPolicy policy) {
+    if ((unsigned)policy >= ALLOC_POLICY_COUNT) {
+        FS_FAIL(FS_ERR_INVALID, "fs_set_alloc_policy: unknown policy %d", (int)policy);
+    }
+    alloc_set_policy(policy);
+    return 0;
+}
+
+AllocPolicy fs_alloc_policy(void) {
+    return alloc_get_policy();
+}
+
+static int fs_space_stats_impl(FsSpaceReport *out) {
+    if (!out) FS_FAIL(FS_ERR_INVALID, "fs_space_stats: invalid arguments");
+    int rc = fs_append_flush_all();
+    if (rc < 0) FS_FAIL(rc, "fs_space_stats: pending appends");
+    if ((rc = disk_read_metadata()) < 0) FS_FAIL(rc, "fs_space_stats: read_meta");
+
+    uint8_t used[DATA_BLOCKS];
+    fs_block_map(used);
+    memset(out, 0, sizeof(*out));
+    alloc_space_stats(used, &out->space);
+    // Kapasite dışındaki bloklar haritada dolu görünür ama bölgeye ait değildir
+    uint32_t cut = DATA_BLOCKS - disk_capacity();
+    out->space.total_blocks -= cut;
+    out->space.used_blocks  -= cut;
+    if ((rc = disk_usage(&out->image_bytes, &out->host_bytes)) < 0) FS_FAIL(rc, "fs_space_stats: image size");
+    out->devices = (uint32_t)disk_devices();
+    out->stripe_blocks = disk_stripe_blocks();
+    out->file_count = metadata.file_count;
+    for (uint32_t i = 0; i < metadata.file_count; ++i) {
+        const FileEntry *e = &metadata.entries[i];
+        FsFileLayout *f = &out->files[i];
+        memcpy(f->name, e->name, sizeof(f->name));
+        f->start_block = e->start_block;
+        if (fs_is_inline(e)) {
+            out->inline_files++;
+            out->inline_bytes += e->size;
+            f->extents = e->size ? 1 : 0;
+            continue;
+        }
+        f->blocks = fs_blocks(e->size);
+        for (uint32_t off = 0; off < e->size; ) {
+            int64_t data = fs_file_extent(e, off, 0);
+            if (data < 0) FS_FAIL((int)data, "fs_space_stats: extent query");
+            if (data >= e->size) break;
+            int64_t hole = fs_file_extent(e, (uint32_t)data, 1);
+            if (hole < 0) FS_FAIL((int)hole, "fs_space_stats: extent query");
+            f->extents++;
+            off = (uint32_t)hole;
+        }
+    }
+    return 0;
+}
+
+// Bekleyen eklemeleri yaz ve imajı kalıcı belleğe aktar
+static int fs_sync_impl(void) {
+    int rc = fs_append_flush_all();
+    if (rc < 0) FS_FAIL(rc, "fs_sync: pending appends");
+    if ((rc = fs_maps_flush_all()) < 0) FS_FAIL(rc, "fs_sync: mapped writes");
+    if ((rc = disk_sync()) < 0) FS_FAIL(rc, "fs_sync: flush disk image");
+    return 0;
+}
+
+// Kapatmak bekleyen eklemeleri hemen yazar; sonraki fs_append'ler doğrudan diske gider
+static int fs_append_buffer_enable_impl(int on) {
+    int rc = on ? 0 : fs_append_flush_all();
+    if (rc < 0) FS_FAIL(rc, "fs_append_buffer_enable: pending appends");
+    append_buffering = on ? 1 : 0;
+    return 0;
+}
+
+// Program bittiğinde bekleyen eklemeleri yaz; disk.c'nin çıkış işlevi daha
+// önce çalışmış olabileceğinden bellek katmanına ve günlüğe düşenler de
+// diske aktarılır
+__attribute__((destructor))
+static void fs_append_at_exit(void) {
+    fs_append_timer_stop();
+    share_shutdown();
+    fs_append_flush_all();
+    disk_flush();
+}
+
+// 18) Open file handles: ad bir kez çözülür, sonraki G/Ç bellekteki kayıt üzerinden
+static int fs_open_impl(const char *filename, int flags) {
+    if (!filename || !(flags & FS_O_RDWR) ||
+        (flags & ~(FS_O_RDWR | FS_O_CREATE | FS_O_TRUNC | FS_O_APPEND))) {
+        FS_FAIL(FS_ERR_INVALID, "fs_open: invalid arguments");
+    }
+    int fd = 0;
+    while (fd < FS_MAX_OPEN && open_files[fd].in_use) fd++;
+    if (fd == FS_MAX_OPEN) FS_FAIL(FS_ERR_TOO_MANY_OPEN, "fs_open: open file table full");
+
+    int idx = fs_lookup(filename);
+    if (idx == FS_ERR_NOT_FOUND && (flags & FS_O_CREATE)) {
+        int rc = fs_create_impl(filename);
+        if (rc < 0) return rc;
+        idx = (int)metadata.file_count - 1;
+    }
+    if (idx == FS_ERR_NOT_FOUND) FS_FAIL(idx, "fs_open: '%s' not found", filename);
+    if (idx < 0) FS_FAIL(idx, "fs_open: read_meta");
+
+    if ((flags & FS_O_TRUNC) && (flags & FS_O_WRITE) && metadata.entries[idx].size) {
+        int rc = fs_truncate_impl(filename, 0);
+        if (rc < 0) return rc;
+    }
+
+    OpenFile *of = &open_files[fd];
+    of->in_use = 1;
+    of->flags  = flags;
+    of->entry  = (uint32_t)idx;
+    of->pos    = (flags & FS_O_APPEND) ? fs_visible_size(&metadata.entries[idx]) : 0;
+    return fd;
+}
+
+static int fs_close_impl(int fd) {
+    if (fd < 0 || fd >= FS_MAX_OPEN || !open_files[fd].in_use) {
+        FS_FAIL(FS_ERR_BADF, "fs_close: bad handle %d", fd);
+    }
+    // Dosyanın bekleyen eklemeleri kapanışta yazılır
+    OpenFile *of = &open_files[fd];
+    AppendBuf *ab = of->entry == FS_ENTRY_GONE ? NULL : fs_append_buf(of->entry);
+    int rc = ab ? fs_append_write(ab, 0) : 0;
+    memset(of, 0, sizeof(*of));
+    if (rc < 0) FS_FAIL(rc, "fs_close: pending appends");
+    return 0;
+}
+
+static ssize_t fs_pread_impl(int fd, void *buffer, size_t size, uint32_t offset) {
+    FileEntry *e;
+    int err;
+    if (!fs_handle(fd, FS_O_READ, &e, &err)) FS_FAIL(err, "fs_pread: bad handle %d", fd);
+    if (!buffer && size) FS_FAIL(FS_ERR_INVALID, "fs_pread: invalid arguments");
+    ssize_t rd = fs_read_at(e, buffer, size, offset);
+    if (rd < 0) FS_FAIL((int)rd, "fs_pread: read");
+    return rd;
+}
+
+static ssize_t fs_pwrite_impl(int fd, const void *data, size_t size, uint32_t offset) {
+    FileEntry *e;
+    int err;
+    if (!fs_handle(fd, FS_O_WRITE, &e, &err)) FS_FAIL(err, "fs_pwrite: bad handle %d", fd);
+    if (!data && size) FS_FAIL(FS_ERR_INVALID, "fs_pwrite: invalid arguments");
+    int rc = fs_append_flush_all();
+    if (rc < 0) FS_FAIL(rc, "fs_pwrite: pending appends");
+    ssize_t written = fs_write_at(e, data, size, offset);
+    if (written < 0) FS_FAIL((int)written, "fs_pwrite: write");
+    return written;
+}
+
+static ssize_t fs_fread_impl(int fd, void *buffer, size_t size) {
+    FileEntry *e;
+    int err;
+    OpenFile *of = fs_handle(fd, FS_O_READ, &e, &err);
+    if (!of) FS_FAIL(err, "fs_fread: bad handle %d", fd);
+    if (!buffer && size) FS_FAIL(FS_ERR_INVALID, "fs_fread: invalid arguments");
+    ssize_t rd = fs_read_at(e, buffer, size, of->pos);
+    if (rd < 0) FS_FAIL((int)rd, "fs_fread: read");
+    of->pos += (uint32_t)rd;
+    return rd;
+}
+
+static ssize_t fs_fwrite_impl(int fd, const void *data, size_t size) {
+    FileEntry *e;
+    int err;
+    OpenFile *of = fs_handle(fd, FS_O_WRITE, &e, &err);
+    if (!of) FS_FAIL(err, "fs_fwrite: bad handle %d", fd);
+    if (!data && size) FS_FAIL(FS_ERR_INVALID, "fs_fwrite: invalid arguments");
+    ssize_t written;
+    if (of->flags & FS_O_APPEND) {
+        written = size ? fs_append_to(of->entry, data, size) : 0;
+        if (written < 0) FS_FAIL((int)written, "fs_fwrite: append");
+        of->pos = fs_visible_size(e);
+        return written;
+    }
+    int rc = fs_append_flush_all();
+    if (rc < 0) FS_FAIL(rc, "fs_fwrite: pending appends");
+    written = fs_write_at(e, data, size, of->pos);
+    if (written < 0) FS_FAIL((int)written, "fs_fwrite: write");
+    of->pos += (uint32_t)written;
+    return written;
+}
+
+static int64_t fs_seek_impl(int fd, int64_t offset, int whence) {
+    FileEntry *e;
+    int err;
+    OpenFile *of = fs_handle(fd, 0, &e, &err);
+    if (!of) FS_FAIL(err, "fs_seek: bad handle %d", fd);
+    int64_t base;
+    switch (whence) {
+        case FS_SEEK_SET: base = 0;       break;
+        case FS_SEEK_CUR: base = of->pos; break;
+        case FS_SEEK_END: base = fs_visible_size(e); break;
+        case FS_SEEK_DATA:
+        case FS_SEEK_HOLE:
+            if ((err = fs_append_flush_all()) < 0) FS_FAIL(err, "fs_seek: pending appends");
+            // offset mutlaktır; veri kalmadıysa (ya da offset sonun ötesindeyse) hata
+            if (offset < 0 || offset > e->size || (whence == FS_SEEK_DATA && offset == e->size)) {
+                FS_FAIL(FS_ERR_RANGE, "fs_seek: no %s at offset %lld",
+                        whence == FS_SEEK_DATA ? "data" : "hole", (long long)offset);
+            }
+            base = fs_file_extent(e, (uint32_t)offset, whence == FS_SEEK_HOLE);
+            if (base < 0) FS_FAIL((int)base, "fs_seek: extent query");
+            if (whence == FS_SEEK_DATA && base >= e->size) {
+                FS_FAIL(FS_ERR_RANGE, "fs_seek: no data at offset %lld", (long long)offset);
+            }
+            offset = 0;
+            break;
+        default: FS_FAIL(FS_ERR_INVALID, "fs_seek: invalid whence %d", whence);
+    }
+    int64_t pos = base + offset;
+    if (pos < 0 || pos > UINT32_MAX) FS_FAIL(FS_ERR_RANGE, "fs_seek: position out of range");
+    of->pos = (uint32_t)pos;
+    return pos;
+}
+
+// 19) Vectored I/O: elemanlar veri bölgesindeki konumlarına göre sıralanır ve
+// uç uca gelen aralıklar tek disk_readv_data / disk_writev_data çağrısında
+// birleştirilir; metadata tüm çağrı için bir kez okunur
+#define FS_IOV_STACK 16       // Bu kadar elemana kadar yığın üzerinde çalışılır
+
+typedef struct {
+    uint64_t pos;             // Veri bölgesindeki konum
+    uint32_t entry;           // metadata.entries indeksi
+    uint32_t offset;          // Dosya içindeki konum
+    uint8_t *base;
+    size_t   len;
+    int      index;           // Çağıranın verdiği sıra
+} FsIoSeg;
+
+static int fs_iov_cmp_pos(const void *a, const void *b) {
+    const FsIoSeg *x = a, *y = b;
+    if (x->pos != y->pos) return x->pos < y->pos ? -1 : 1;
+    return x->index - y->index;
+}
+
+static int fs_iov_cmp_index(const void *a, const void *b) {
+    return ((const FsIoSeg *)a)->index - ((const FsIoSeg *)b)->index;
+}
+
+// Bellekteki metadata'da adı arar (çağıran metadata'yı önceden okumuş olmalı)
+static int fs_iov_resolve(const FsIoVec *iov, int i, int prev) {
+    if (i > 0 && prev >= 0 && strcmp(iov[i].filename, iov[i - 1].filename) == 0) return prev;
+    for (uint32_t k = 0; k < metadata.file_count; ++k) {
+        if (strcmp(metadata.entries[k].name, iov[i].filename) == 0) return (int)k;
+    }
+    return FS_ERR_NOT_FOUND;
+}
+
+// Sıradaki parçalardan uç uca gelenleri tek vektörlü çağrıyla aktarır
+static ssize_t fs_iov_submit(const FsIoSeg *seg, int n, int write) {
+    struct iovec vec_stack[FS_IOV_STACK];
+    ScratchMark mark = scratch_mark();
+    struct iovec *vec = n <= FS_IOV_STACK ? vec_stack : scratch_alloc((size_t)n * sizeof(*vec));
+    if (!vec) return FS_ERR_NO_MEMORY;
+    ssize_t total = 0;
+    for (int i = 0; i < n; ++i) {
+        if (i == 0 || seg[i].entry != seg[i - 1].entry) {
+            fs_tier_touch(&metadata.entries[seg[i].entry], 0);
+        }
+    }
+    for (int i = 0; i < n; ) {
+        int k = 0;
+        uint64_t end = seg[i].pos;
+        while (i + k < n && seg[i + k].pos == end) {
+            vec[k].iov_base = seg[i + k].base;
+            vec[k].iov_len  = seg[i + k].len;
+            end += seg[i + k].len;
+            k++;
+        }
+        ssize_t r = write ? disk_writev_data(seg[i].pos, vec, k) : disk_readv_data(seg[i].pos, vec, k);
+        if (r < 0) {
+            total = r;
+            break;
+        }
+        total += r;
+        i += k;
+    }
+    scratch_release(mark);
+    return total;
+}
+
+static ssize_t fs_readv_impl(const FsIoVec *iov, int iovcnt) {
+    if (!iov || iovcnt < 0) FS_FAIL(FS_ERR_INVALID, "fs_readv: invalid arguments");
+    if (iovcnt == 0) return 0;
+    for (int i = 0; i < iovcnt; ++i) {
+        if (!iov[i].filename || (!iov[i].base && iov[i].len)) {
+            FS_FAIL(FS_ERR_INVALID, "fs_readv: invalid element %d", i);
+        }
+    }
+    int rc = disk_read_metadata();
+    if (rc < 0) FS_FAIL(rc, "fs_readv: read_meta");
+
+    FsIoSeg seg_stack[FS_IOV_STACK];
+    ScratchMark mark = scratch_mark();
+    FsIoSeg *seg = iovcnt <= FS_IOV_STACK ? seg_stack : scratch_alloc((size_t)iovcnt * sizeof(*seg));
+    if (!seg) FS_FAIL(FS_ERR_NO_MEMORY, "fs_readv: malloc");
+
+    // Önce tüm adlar çözülür; eksik dosya varsa hiçbir tampona dokunulmaz
+    int n = 0, idx = -1;
+    for (int i = 0; i < iovcnt; ++i) {
+        idx = fs_iov_resolve(iov, i, idx);
+        if (idx < 0) {
+            scratch_release(mark);
+            FS_FAIL(idx, "fs_readv: '%s' not found", iov[i].filename);
+        }
+        seg[i].entry = (uint32_t)idx;
+    }
+
+    ssize_t from_buf = 0;         // Bellekten (tampon, satır içi yuva) kopyalanan bayt
+    for (int i = 0; i < iovcnt; ++i) {
+        const FsIoVec *v = &iov[i];
+        const FileEntry *e = &metadata.entries[seg[i].entry];
+        uint32_t visible = fs_visible_size(e);
+        size_t len = v->offset < visible ? visible - v->offset : 0;
+        if (len > v->len) len = v->len;
+        size_t on_disk = v->offset < e->size ? e->size - v->offset : 0;
+        if (on_disk > len) on_disk = len;
+        uint8_t *out = v->base;
+        if (len < v->len) memset(out + len, 0, v->len - len);
+        if (len > on_disk) {
+            // Diske henüz yazılmamış eklenen baytlar
+            const AppendBuf *ab = fs_append_buf(seg[i].entry);
+            memcpy(out + on_disk, ab->data + (v->offset + on_disk - e->size), len - on_disk);
+            from_buf += (ssize_t)(len - on_disk);
+        }
+        if (on_disk && fs_is_inline(e)) {
+            memcpy(out, fs_inline_data(e) + v->offset, on_disk);
+            from_buf += (ssize_t)on_disk;
+        } else if (on_disk) {
+            if ((rc = fs_lock_data(e, v->offset, on_disk, 0)) < 0) {
+                scratch_release(mark);
+                FS_FAIL(rc, "fs_readv: lock");
+            }
+            seg[n] = (FsIoSeg){ (uint64_t)e->start_block * BLOCK_SIZE + v->offset,
+                                seg[i].entry, v->offset, out, on_disk, i };
+            n++;
+        }
+    }
+
+    qsort(seg, (size_t)n, sizeof(*seg), fs_iov_cmp_pos);
+    ssize_t rd = fs_iov_submit(seg, n, 0);
+    scratch_release(mark);
+    if (rd < 0) FS_FAIL((int)rd, "fs_readv: read");
+    FS_INFO("fs_readv: %d ranges <- %zd bytes", iovcnt, rd + from_buf);
+    return rd + from_buf;
+}
+
+static ssize_t fs_writev_impl(const FsIoVec *iov, int iovcnt) {
+    if (!iov || iovcnt < 0) FS_FAIL(FS_ERR_INVALID, "fs_writev: invalid arguments");
+    if (iovcnt == 0) return 0;
+    for (int i = 0; i < iovcnt; ++i) {
+        if (!iov[i].filename || (!iov[i].base && iov[i].len)) {
+            FS_FAIL(FS_ERR_INVALID, "fs_writev: invalid element %d", i);
+        }
+    }
+    int rc = fs_append_flush_all();
+    if (rc < 0) FS_FAIL(rc, "fs_writev: pending appends");
+    if ((rc = disk_read_metadata()) < 0) FS_FAIL(rc, "fs_writev: read_meta");
+
+    FsIoSeg seg_stack[FS_IOV_STACK];
+    ScratchMark mark = scratch_mark();
+    FsIoSeg *seg = iovcnt <= FS_IOV_STACK ? seg_stack : scratch_alloc((size_t)iovcnt * sizeof(*seg));
+    if (!seg) FS_FAIL(FS_ERR_NO_MEMORY, "fs_writev: malloc");
+
+    int n = 0, idx = -1;
+    uint64_t old[MAX_FILES], reach[MAX_FILES];
+    for (uint32_t k = 0; k < metadata.file_count; ++k) old[k] = reach[k] = metadata.entries[k].size;
+    for (int i = 0; i < iovcnt; ++i) {
+        const FsIoVec *v = &iov[i];
+        idx = fs_iov_resolve(iov, i, idx);
+        if (idx < 0) {
+            scratch_release(mark);
+            FS_FAIL(idx, "fs_writev: '%s' not found", v->filename);
+        }
+        if (v->len == 0) continue;
+        seg[n++] = (FsIoSeg){ 0, (uint32_t)idx, v->offset, v->base, v->len, i };
+        if (v->offset + (uint64_t)v->len > reach[idx]) reach[idx] = v->offset + (uint64_t)v->len;
+    }
+
+    // Büyüyen dosyalara yer ayrılır; sonraki ayırmalar bunu görsün diye boyut
+    // bellekte hemen güncellenir (hata olursa eski boyutlar geri yazılır)
+    for (uint32_t k = 0; k < metadata.file_count && rc == 0; ++k) {
+        if (reach[k] <= old[k]) continue;
+        if ((rc = fs_reserve(&metadata.entries[k], reach[k])) == 0) {
+            metadata.entries[k].size = (uint32_t)reach[k];
+        }
+    }
+    // Satır içi kalan dosyalara yazımlar çağıranın sırasıyla yuvaya yapılır
+    ssize_t in_slots = 0;
+    uint8_t dirty[MAX_FILES] = { 0 };
+    int m = 0;
+    for (int i = 0; i < n && rc == 0; ++i) {
+        const FileEntry *e = &metadata.entries[seg[i].entry];
+        if (fs_is_inline(e)) {
+            memcpy(fs_inline_data(e) + seg[i].offset, seg[i].base, seg[i].len);
+            dirty[seg[i].entry] = 1;
+            in_slots += (ssize_t)seg[i].len;
+            continue;
+        }
+        seg[i].pos = (uint64_t)e->start_block * BLOCK_SIZE + seg[i].offset;
+        seg[m++] = seg[i];
+    }
+    n = m;
+    for (uint32_t k = 0; k < metadata.file_count && rc == 0; ++k) {
+        if (dirty[k]) rc = disk_write_inline(metadata.entries[k].start_block & ~INLINE_SLOT);
+    }
+
+    // Eski dosya sonunun ötesinde hiçbir elemanın kapsamadığı boşluklar delik olur
+    qsort(seg, (size_t)n, sizeof(*seg), fs_iov_cmp_pos);
+    uint64_t gap[MAX_FILES];
+    memcpy(gap, old, sizeof(gap));
+    int overlap = 0;
+    uint64_t prev_end = 0;
+    for (int i = 0; i < n && rc == 0; ++i) {
+        const FileEntry *e = &metadata.entries[seg[i].entry];
+        uint64_t *r = &gap[seg[i].entry];
+        if (seg[i].offset > *r) {
+            rc = disk_zero_range((uint64_t)e->start_block * BLOCK_SIZE + *r, seg[i].offset - *r);
+        }
+        if (seg[i].offset + seg[i].len > *r) *r = seg[i].offset + seg[i].len;
+        if (i > 0 && seg[i].pos < prev_end) overlap = 1;
+        if (seg[i].pos + seg[i].len > prev_end) prev_end = seg[i].pos + seg[i].len;
+    }
+    // Çakışan aralıklarda sonraki elemanın kazanması için çağıranın sırası korunur
+    if (overlap) qsort(seg, (size_t)n, sizeof(*seg), fs_iov_cmp_index);
+    ssize_t written = rc < 0 ? rc : fs_iov_submit(seg, n, 1);
+    scratch_release(mark);
+    if (written >= 0) written += in_slots;
+
+    int grew = 0;
+    for (uint32_t k = 0; k < metadata.file_count; ++k) {
+        if (written < 0) metadata.entries[k].size = (uint32_t)old[k];
+        else grew |= metadata.entries[k].size != old[k];
+    }
+    if (written < 0) {
+        disk_write_metadata();
+        FS_FAIL((int)written, "fs_writev: write");
+    }
+    if (grew && (rc = disk_write_metadata()) < 0) FS_FAIL(rc, "fs_writev: write_meta");
+    FS_INFO("fs_writev: %d ranges -> %zd bytes", iovcnt, written);
+    return written;
+}
+
+static ssize_t fs_appendv_impl(const char *filename, const struct iovec *iov, int iovcnt) {
+    if (!filename || !iov || iovcnt < 0) FS_FAIL(FS_ERR_INVALID, "fs_appendv: invalid arguments");
+    uint64_t total = 0;
+    for (int i = 0; i < iovcnt; ++i) {
+        if (!iov[i].iov_base && iov[i].iov_len) FS_FAIL(FS_ERR_INVALID, "fs_appendv: invalid element %d", i);
+        total += iov[i].iov_len;
+    }
+    if (total == 0) return 0;
+    int idx = fs_append_find(filename);
+    if (idx < 0) idx = fs_lookup(filename);
+    if (idx == FS_ERR_NOT_FOUND) FS_FAIL(idx, "fs_appendv: '%s' not found", filename);
+    if (idx < 0) FS_FAIL(idx, "fs_appendv: read_meta");
+
+    FileEntry *e = &metadata.entries[idx];
+    int buffered = append_buffering && total < FS_APPEND_BUF_SIZE;
+    // Ertelenmiş ayırmada tampona giden baytların yerini fs_append_to ayarlar
+    int rc = buffered && delayed_alloc ? 0 : fs_reserve(e, (uint64_t)fs_visible_size(e) + total);
+    if (rc < 0) FS_FAIL(rc, "fs_appendv: allocate");
+
+    // Küçük toplamlar ekleme tamponunda birleşir; büyükler tek pwritev ile yazılır
+    if (buffered) {
+        for (int i = 0; i < iovcnt; ++i) {
+            if (iov[i].iov_len == 0) continue;
+            ssize_t w = fs_append_to((uint32_t)idx, iov[i].iov_base, iov[i].iov_len);
+            if (w < 0) FS_FAIL((int)w, "fs_appendv: append");
+        }
+        return (ssize_t)total;
+    }
+    AppendBuf *ab = fs_append_buf((uint32_t)idx);
+    if (ab && (rc = fs_append_write(ab, 0)) < 0) FS_FAIL(rc, "fs_appendv: pending appends");
+    ssize_t written = 0;
+    if (fs_is_inline(e)) {
+        for (int i = 0; i < iovcnt; ++i) {
+            memcpy(fs_inline_data(e) + e->size + written, iov[i].iov_base, iov[i].iov_len);
+            written += (ssize_t)iov[i].iov_len;
+        }
+        if ((rc = disk_write_inline(e->start_block & ~INLINE_SLOT)) < 0) FS_FAIL(rc, "fs_appendv: write");
+    } else {
+        fs_tier_touch(e, (uint64_t)e->size + total);
+        written = disk_writev_data((uint64_t)e->start_block * BLOCK_SIZE + e->size, iov, iovcnt);
+    }
+    if (written < 0) FS_FAIL((int)written, "fs_appendv: write");
+    e->size += (uint32_t)written;
+    if ((rc = disk_write_metadata()) < 0) FS_FAIL(rc, "fs_appendv: write_meta");
+    FS_INFO("fs_appendv: '%s' dosyasına %zd byte eklendi", filename, written);
+    return written;
+}
+
+// 20) Memory mapping: dosyanın bitişik veri aralığı disk imajından doğrudan
+// belleğe eşlenir; kayıtlar fs_read'in kopyası olmadan yerinde okunur
+static int fs_map_impl(const char *filename, uint32_t offset, size_t len, int flags, void **addr_out) {
+    if (!filename || !addr_out || !(flags & FS_MAP_READ) || (flags & ~FS_MAP_RDWR)) {
+        FS_FAIL(FS_ERR_INVALID, "fs_map: invalid arguments");
+    }
+    int slot = 0;
+    while (slot < FS_MAX_MAPS && maps[slot].in_use) slot++;
+    if (slot == FS_MAX_MAPS) FS_FAIL(FS_ERR_TOO_MANY_OPEN, "fs_map: mapping table full");
+
+    int rc = fs_append_flush_all();
+    if (rc < 0) FS_FAIL(rc, "fs_map: pending appends");
+    int idx = fs_lookup(filename);
+    if (idx == FS_ERR_NOT_FOUND) FS_FAIL(idx, "fs_map: '%s' not found", filename);
+    if (idx < 0) FS_FAIL(idx, "fs_map: read_meta");
+    FileEntry *e = &metadata.entries[idx];
+    if (offset >= e->size) FS_FAIL(FS_ERR_RANGE, "fs_map: offset beyond size");
+    if (len == 0) len = e->size - offset;
+    if (len > e->size - offset) FS_FAIL(FS_ERR_RANGE, "fs_map: range beyond end of file");
+    // Eşleme imajdaki bitişik bir aralık ister: satır içi dosya bloklara taşınır
+    if (fs_is_inline(e) && (rc = fs_inline_evict(e, fs_blocks(e->size))) < 0) {
+        FS_FAIL(rc, "fs_map: move inline file to blocks");
+    }
+
+    uint64_t pos = (uint64_t)e->start_block * BLOCK_SIZE + offset;
+    void *addr;
+    if ((rc = disk_map(pos, len, flags & FS_MAP_WRITE, &addr)) < 0) FS_FAIL(rc, "fs_map: map");
+    maps[slot] = (FsMapping){ 1, (flags & FS_MAP_WRITE) != 0, (uint32_t)idx, addr, pos, len };
+    maps_active++;
+    *addr_out = addr;
+    FS_INFO("fs_map: '%s' [%u, +%zu) mapped", filename, offset, len);
+    return 0;
+}
+
+static FsMapping *fs_mapping(const void *addr) {
+    for (int i = 0; addr && maps_active && i < FS_MAX_MAPS; ++i) {
+        if (maps[i].in_use && maps[i].addr == addr) return &maps[i];
+    }
+    return NULL;
+}
+
+static int fs_map_flush_impl(void *addr) {
+    FsMapping *m = fs_mapping(addr);
+    if (!m) FS_FAIL(FS_ERR_INVALID, "fs_map_flush: unknown mapping");
+    if (!m->writable || m->entry == FS_ENTRY_GONE) return 0;
+    int rc = disk_map_sync(m->addr, m->offset, m->len);
+    if (rc < 0) FS_FAIL(rc, "fs_map_flush: sync");
+    return 0;
+}
+
+static int fs_unmap_impl(void *addr) {
+    FsMapping *m = fs_mapping(addr);
+    if (!m) FS_FAIL(FS_ERR_INVALID, "fs_unmap: unknown mapping");
+    int rc = 0;
+    if (m->writable && m->entry != FS_ENTRY_GONE) rc = disk_map_sync(m->addr, m->offset, m->len);
+    int r = disk_unmap(m->addr, m->offset, m->len);
+    memset(m, 0, sizeof(*m));
+    maps_active--;
+    if (rc < 0) FS_FAIL(rc, "fs_unmap: sync");
+    if (r < 0) FS_FAIL(r, "fs_unmap: unmap");
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// Çoklu süreç erişimi (bkz. share.h): her giriş noktası bir çağrı olarak
+// imaj kilidini alır; iç içe çağrılar (fs_copy -> fs_create) dıştakinin
+// kilidiyle çalışır. Çağrı sonunda bellekte bekleyen durum yalnızca imaj
+// başka süreçte açık değilse kalır.
+// ---------------------------------------------------------------------------
+#define FS_SHARED    0
+#define FS_EXCLUSIVE 1
+
+// Çağrı derinliği iş parçacığına özeldir: ekleme boşaltıcısı da kendi
+// çağrısını açar, diğer iş parçacıklarıyla share.c'nin kilidinde sıralanır
+static _Thread_local int fs_op_depth;
+static _Thread_local int fs_op_rc;
+
+// prev'deki idx kaydının yeniden okunan metadata'daki yeri: ad ve
+// oluşturulma zamanı, yeniden adlandırılmışsa oluşturulma zamanı ve ilk blok
+static uint32_t fs_rebind(const DiskMetadata *prev, uint32_t idx) {
+    if (idx >= prev->file_count) return FS_ENTRY_GONE;
+    const FileEntry *old = &prev->entries[idx];
+    for (uint32_t i = 0; i < metadata.file_count; ++i) {
+        const FileEntry *e = &metadata.entries[i];
+        if (e->created == old->created && strcmp(e->name, old->name) == 0) return i;
+    }
+    for (uint32_t i = 0; i < metadata.file_count; ++i) {
+        const FileEntry *e = &metadata.entries[i];
+        if (e->created == old->created && e->start_block == old->start_block) return i;
+    }
+    return FS_ENTRY_GONE;
+}
+
+// İmaj başka süreçte değişti: metadata yeniden okunur, açık tanıtıcılar
+// dosyalarına yeniden bağlanır; yeri değişen dosyaların eşlemeleri diskten
+// ayrılır. Bekleyen durum yoktur (kira tutulmuyordu).
+static int fs_image_changed(void) {
+    DiskMetadata *prev = buf_get(BUF_META);
+    if (!prev) FS_FAIL(FS_ERR_NO_MEMORY, "fs: malloc");
+    memcpy(prev, &metadata, sizeof(*prev));
+    int rc = disk_reload();
+    if (rc < 0) {
+        buf_put(BUF_META, prev);
+        FS_FAIL(rc, "fs: cannot reload '%s' after a change by another process", disk_path());
+    }
+    for (int fd = 0; fd < FS_MAX_OPEN; ++fd) {
+        OpenFile *of = &open_files[fd];
+        if (of->in_use && of->entry != FS_ENTRY_GONE) of->entry = fs_rebind(prev, of->entry);
+    }
+    for (int i = 0; maps_active && i < FS_MAX_MAPS; ++i) {
+        FsMapping *m = &maps[i];
+        if (!m->in_use || m->entry == FS_ENTRY_GONE) continue;
+        uint32_t idx = fs_rebind(prev, m->entry);
+        if (idx == FS_ENTRY_GONE || metadata.entries[idx].start_block != prev->entries[m->entry].start_block) {
+            fs_map_detach(m);
+        } else {
+            m->entry = idx;
+        }
+    }
+    memset(file_ra, 0, sizeof(file_ra));
+    buf_put(BUF_META, prev);
+    return 0;
+}
+
+static int fs_op_begin(int exclusive) {
+    if (fs_op_depth++) return 0;
+    int rc = share_begin(exclusive);
+    // SHARE_RELOAD: çağrının disk_read_metadata'sı imajdan okur
+    if (rc == SHARE_CHANGED) rc = fs_image_changed();
+    if (rc < 0) {
+        share_end(1);
+        fs_op_depth--;
+        return rc;
+    }
+    return 0;
+}
+
+// Bellekte imaja yazılmamış durum: tampondaki eklemeler, ön ayırmalar ve
+// disk katmanlarının bekleyenleri
+static int fs_pending(void) {
+    if (append_pending || disk_pending()) return 1;
+    for (uint32_t i = 0; i < MAX_FILES; ++i) {
+        if (file_prealloc[i]) return 1;
+    }
+    return 0;
+}
+
+// Başka süreç imajı açtı: bekleyen durum yazılır (ön ayırmalar bırakılır).
+// share.c'nin izleyicisinden çağrı dışında da çalışabilir; yalnızca iç
+// işlevleri kullanır.
+static int fs_release_state(void) {
+    int rc = fs_append_flush_all();
+    for (uint32_t i = 0; i < metadata.file_count; ++i) {
+        if (file_prealloc[i]) fs_prealloc_drop(&metadata.entries[i]);
+    }
+    int drc = disk_release_state();
+    if (rc == 0) rc = drc;
+    if (rc < 0) FS_ERROR("fs: cannot write pending state of '%s' (%s)", disk_path(), fs_strerror(rc));
+    return rc;
+}
+
+static int64_t fs_op_end(int64_t r) {
+    if (--fs_op_depth) return r;
+    int pending = fs_pending();
+    if (!share_hold(pending) && pending) {
+        int rc = fs_release_state();
+        if (rc < 0 && r >= 0) r = rc;
+    }
+    if (append_pending) fs_append_timer_arm();
+    share_end(r < 0);
+    return r;
+}
+
+// Kira bırakılırken (share.c'nin izleyicisi ya da sıradaki çağrı) bekleyen
+// durum aynı işlevle yazılır
+__attribute__((constructor))
+static void fs_share_init(void) {
+    share_set_release(fs_release_state);
+}
+
+// Dosyayı büyütmeyen fs_pwrite / fs_fwrite düz imajda yerinde yazar:
+// metadata değişmediğinden paylaşımlı kilit ve yazılan aralığın özel kilidi
+// (fs_write_at) yeter. Diğer durumlarda çağrı özel kilitle yeniden başlar.
+static int fs_op_begin_write(int fd, uint32_t offset, size_t size, int at_pos) {
+    int rc = fs_op_begin(FS_SHARED);
+    if (rc < 0 || fs_op_depth > 1) return rc;
+    FileEntry *e;
+    OpenFile *of = fs_handle(fd, FS_O_WRITE, &e, &rc);
+    if (!of) return 0;                  // Hatayı çağrının kendisi raporlar
+    if (at_pos) offset = of->pos;
+    if (!(metadata.flags & (DISK_FLAG_DEDUP | DISK_FLAG_LOG)) && !fs_is_inline(e) && !append_pending &&
+        !(at_pos && (of->flags & FS_O_APPEND)) && (uint64_t)offset + size <= e->size) {
+        return 0;
+    }
+    fs_op_end(0);
+    return fs_op_begin(FS_EXCLUSIVE);
+}
+
+#define FS_LOCKED_(begin, type, call) \
+    ((fs_op_rc = (begin)) < 0 ? (type)fs_op_rc : (type)fs_op_end((int64_t)(call)))
+#define FS_LOCKED(exclusive, type, call) FS_LOCKED_(fs_op_begin(exclusive), type, call)
+
+// Ekleme boşaltıcısı: tampon kalan her çağrının sonunda kurulur, en eski
+// tamponun yaşı dolunca süresi dolanları ayrı bir çağrı olarak yazar. Yazım
+// başarısızsa (ör. imaj başka süreçte meşgul) bir sonraki turda yeniden dener.
+static pthread_mutex_t append_timer_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  append_timer_wake = PTHREAD_COND_INITIALIZER;
+static pthread_t       append_timer;
+static int             append_timer_started, append_timer_stopping, append_timer_armed;
+
+static int fs_append_expire_idle(void) {
+    return fs_append_expire(fs_now_ms());
+}
+
+static void *fs_append_timer_main(void *arg) {
+    (void)arg;
+    pthread_mutex_lock(&append_timer_lock);
+    while (!append_timer_stopping) {
+        if (!append_timer_armed) {
+            pthread_cond_wait(&append_timer_wake, &append_timer_lock);
+            continue;
+        }
+        append_timer_armed = 0;
+        struct timespec until;
+        clock_gettime(CLOCK_REALTIME, &until);
+        until.tv_nsec += (long)FS_APPEND_MAX_AGE_MS * 1000000L;
+        if (until.tv_nsec >= 1000000000L) { until.tv_sec++; until.tv_nsec -= 1000000000L; }
+        while (!append_timer_stopping &&
+               pthread_cond_timedwait(&append_timer_wake, &append_timer_lock, &until) != ETIMEDOUT) {
+        }
+        if (append_timer_stopping) break;
+        pthread_mutex_unlock(&append_timer_lock);
+        // Yaşı dolmamış tampon kalırsa çağrının sonu zamanlayıcıyı yeniden kurar
+        int rc = FS_LOCKED(FS_EXCLUSIVE, int, fs_append_expire_idle());
+        pthread_mutex_lock(&append_timer_lock);
+        if (rc < 0) append_timer_armed = 1;
+    }
+    pthread_mutex_unlock(&append_timer_lock);
+    return NULL;
+}
+
+// Çağrı sonunda, tampon kaldıysa. İş parçacığı başlatılamazsa tamponlar
+// yalnızca sonraki eklemede ve fs_sync'te yazılır. Durdurma atexit ile de
+// kaydedilir: çalışma anında kaydedilen işlevler disk.c'nin çıkış işlevinden
+// önce çalışır, boşaltıcı imaj kapanırken yazmaz.
+static void fs_append_timer_arm(void) {
+    pthread_mutex_lock(&append_timer_lock);
+    if (!append_timer_started && !append_timer_stopping &&
+        pthread_create(&append_timer, NULL, fs_append_timer_main, NULL) == 0) {
+        append_timer_started = 1;
+        atexit(fs_append_timer_stop);
+    }
+    if (append_timer_started && !append_timer_armed && !append_timer_stopping) {
+        append_timer_armed = 1;
+        pthread_cond_signal(&append_timer_wake);
+    }
+    pthread_mutex_unlock(&append_timer_lock);
+}
+
+static void fs_append_timer_stop(void) {
+    pthread_mutex_lock(&append_timer_lock);
+    int was = append_timer_started;
+    append_timer_stopping = 1;
+    pthread_cond_broadcast(&append_timer_wake);
+    pthread_mutex_unlock(&append_timer_lock);
+    if (was) pthread_join(append_timer, NULL);
+    pthread_mutex_lock(&append_timer_lock);
+    append_timer_started = 0;
+    pthread_mutex_unlock(&append_timer_lock);
+}
+
+// ---------------------------------------------------------------------------
+// Ölçüm sarmalayıcıları: her fs.h giriş noktası çağrı sayısı, hata, bayt ve
+// gecikme histogramına işlenir (stats_enabled kapalıyken tek bir dal); iz
+// açıksa veriyi değiştiren ve okuyan çağrılar argümanlarıyla kaydedilir
+// ---------------------------------------------------------------------------
+
+int fs_format_mode(uint32_t flags) {
+    TRACE_CALL(STAT_FS_FORMAT, int, FS_LOCKED(FS_EXCLUSIVE, int, fs_format_mode_impl(flags)),
+               TRACE_FORMAT, NULL, NULL, 0, 0, flags);
+}
+
+int fs_create(const char *filename) {
+    TRACE_CALL(STAT_FS_CREATE, int, FS_LOCKED(FS_EXCLUSIVE, int, fs_create_impl(filename)),
+               TRACE_CREATE, filename, NULL, 0, 0, 0);
+}
+
+int fs_delete(const char *filename) {
+    TRACE_CALL(STAT_FS_DELETE, int, FS_LOCKED(FS_EXCLUSIVE, int, fs_delete_impl(filename)),
+               TRACE_DELETE, filename, NULL, 0, 0, 0);
+}
+
+ssize_t fs_write(const char *filename, const void *data, size_t size) {
+    TRACE_CALL_IO(STAT_FS_WRITE, ssize_t, FS_LOCKED(FS_EXCLUSIVE, ssize_t, fs_write_impl(filename, data, size)),
+                  TRACE_WRITE, filename, NULL, 0, size, 0);
+}
+
+ssize_t fs_read(const char *filename, uint32_t offset, size_t size, void *buffer) {
+    TRACE_CALL_IO(STAT_FS_READ, ssize_t, FS_LOCKED(FS_SHARED, ssize_t, fs_read_impl(filename, offset, size, buffer)),
+                  TRACE_READ, filename, NULL, offset, size, 0);
+}
+
+ssize_t fs_read_all(const char *filename, void *buffer) {
+    TRACE_CALL_IO(STAT_FS_READ_ALL, ssize_t, FS_LOCKED(FS_SHARED, ssize_t, fs_read_all_impl(filename, buffer)),
+                  TRACE_READ_ALL, filename, NULL, 0, 0, 0);
+}
+
+int fs_copy(const char *src_filename, const char *dest_filename) {
+    TRACE_CALL(STAT_FS_COPY, int, FS_LOCKED(FS_EXCLUSIVE, int, fs_copy_impl(src_filename, dest_filename)),
+               TRACE_COPY, src_filename, dest_filename, 0, 0, 0);
+}
+
+int fs_mv(const char *old_path, const char *new_path) {
+    TRACE_CALL(STAT_FS_MV, int, FS_LOCKED(FS_EXCLUSIVE, int, fs_mv_impl(old_path, new_path)),
+               TRACE_MV, old_path, new_path, 0, 0, 0);
+}
+
+int fs_list(FileEntry *out, uint32_t max) {
+    STATS_CALL(STAT_FS_LIST, int, FS_LOCKED(FS_SHARED, int, fs_list_impl(out, max)));
+}
+
+int fs_rename(const char *old_name, const char *new_name) {
+    TRACE_CALL(STAT_FS_RENAME, int, FS_LOCKED(FS_EXCLUSIVE, int, fs_rename_impl(old_name, new_name)),
+               TRACE_RENAME, old_name, new_name, 0, 0, 0);
+}
+
+int fs_exists(const char *filename) {
+    TRACE_CALL(STAT_FS_EXISTS, int, FS_LOCKED(FS_SHARED, int, fs_exists_impl(filename)),
+               TRACE_EXISTS, filename, NULL, 0, 0, 0);
+}
+
+int fs_size(const char *filename, uint32_t *size_out) {
+    TRACE_CALL(STAT_FS_SIZE, int, FS_LOCKED(FS_SHARED, int, fs_size_impl(filename, size_out)),
+               TRACE_SIZE, filename, NULL, 0, 0, 0);
+}
+
+ssize_t fs_append(const char *filename, const void *data, size_t size) {
+    TRACE_CALL_IO(STAT_FS_APPEND, ssize_t, FS_LOCKED(FS_EXCLUSIVE, ssize_t, fs_append_impl(filename, data, size)),
+                  TRACE_APPEND, filename, NULL, 0, size, 0);
+}
+
+int fs_truncate(const char *filename, uint32_t new_size) {
+    TRACE_CALL(STAT_FS_TRUNCATE, int, FS_LOCKED(FS_EXCLUSIVE, int, fs_truncate_impl(filename, new_size)),
+               TRACE_TRUNCATE, filename, NULL, 0, new_size, 0);
+}
+
+int fs_punch_hole(const char *filename, uint32_t offset, uint32_t len) {
+    TRACE_CALL(STAT_FS_PUNCH_HOLE, int, FS_LOCKED(FS_EXCLUSIVE, int, fs_punch_hole_impl(filename, offset, len)),
+               TRACE_PUNCH_HOLE, filename, NULL, offset, len, 0);
+}
+
+int fs_fallocate(const char *filename, uint32_t offset, uint32_t len, int flags) {
+    TRACE_CALL(STAT_FS_FALLOCATE, int, FS_LOCKED(FS_EXCLUSIVE, int, fs_fallocate_impl(filename, offset, len, flags)),
+               TRACE_FALLOCATE, filename, NULL, offset, len, (uint32_t)flags);
+}
+
+int fs_sync(void) {
+    TRACE_CALL(STAT_FS_SYNC, int, FS_LOCKED(FS_EXCLUSIVE, int, fs_sync_impl()),
+               TRACE_SYNC, NULL, NULL, 0, 0, 0);
+}
+
+int fs_defragment(void) {
+    TRACE_CALL(STAT_FS_DEFRAGMENT, int, FS_LOCKED(FS_EXCLUSIVE, int, fs_defragment_impl()),
+               TRACE_DEFRAGMENT, NULL, NULL, 0, 0, 0);
+}
+
+int fs_resize(uint32_t size) {
+    TRACE_CALL(STAT_FS_RESIZE, int, FS_LOCKED(FS_EXCLUSIVE, int, fs_resize_impl(size)),
+               TRACE_RESIZE, NULL, NULL, 0, size, 0);
+}
+
+int fs_check_integrity(void) {
+    STATS_CALL(STAT_FS_CHECK_INTEGRITY, int, FS_LOCKED(FS_SHARED, int, fs_check_integrity_impl()));
+}
+
+int fs_backup(const char *backup_filename) {
+    STATS_CALL(STAT_FS_BACKUP, int, FS_LOCKED(FS_SHARED, int, fs_backup_impl(backup_filename)));
+}
+
+int fs_restore(const char *backup_filename) {
+    STATS_CALL(STAT_FS_RESTORE, int, FS_LOCKED(FS_EXCLUSIVE, int, fs_restore_impl(backup_filename)));
+}
+
+int fs_import_dir(const char *host_dir) {
+    STATS_CALL(STAT_FS_IMPORT, int, FS_LOCKED(FS_EXCLUSIVE, int, fs_import_dir_impl(host_dir)));
+}
+
+int fs_import_tar(int fd) {
+    STATS_CALL(STAT_FS_IMPORT, int, FS_LOCKED(FS_EXCLUSIVE, int, fs_import_tar_impl(fd)));
+}
+
+int fs_export_dir(const char *host_dir) {
+    STATS_CALL(STAT_FS_EXPORT, int, FS_LOCKED(FS_SHARED, int, fs_export_dir_impl(host_dir)));
+}
+
+int fs_export_tar(int fd) {
+    STATS_CALL(STAT_FS_EXPORT, int, FS_LOCKED(FS_SHARED, int, fs_export_tar_impl(fd)));
+}
+
+int fs_log(const char *operation, const char *filename) {
+    STATS_CALL(STAT_FS_LOG, int, fs_log_impl(operation, filename));
+}
+
+int fs_open(const char *filename, int flags) {
+    int mode = (flags & (FS_O_CREATE | FS_O_TRUNC)) ? FS_EXCLUSIVE : FS_SHARED;
+    TRACE_CALL(STAT_FS_OPEN, int, FS_LOCKED(mode, int, fs_open_impl(filename, flags)),
+               TRACE_OPEN, filename, NULL, 0, 0, (uint32_t)flags);
+}
+
+int fs_close(int fd) {
+    TRACE_CALL(STAT_FS_CLOSE, int, FS_LOCKED(FS_SHARED, int, fs_close_impl(fd)),
+               TRACE_CLOSE, NULL, NULL, 0, 0, (uint32_t)fd);
+}
+
+ssize_t fs_pread(int fd, void *buffer, size_t size, uint32_t offset) {
+    TRACE_CALL_IO(STAT_FS_PREAD, ssize_t, FS_LOCKED(FS_SHARED, ssize_t, fs_pread_impl(fd, buffer, size, offset)),
+                  TRACE_PREAD, NULL, NULL, offset, size, (uint32_t)fd);
+}
+
+ssize_t fs_pwrite(int fd, const void *data, size_t size, uint32_t offset) {
+    TRACE_CALL_IO(STAT_FS_PWRITE, ssize_t,
+                  FS_LOCKED_(fs_op_begin_write(fd, offset, size, 0), ssize_t, fs_pwrite_impl(fd, data, size, offset)),
+                  TRACE_PWRITE, NULL, NULL, offset, size, (uint32_t)fd);
+}
+
+ssize_t fs_fread(int fd, void *buffer, size_t size) {
+    TRACE_CALL_IO(STAT_FS_FREAD, ssize_t, FS_LOCKED(FS_SHARED, ssize_t, fs_fread_impl(fd, buffer, size)),
+                  TRACE_FREAD, NULL, NULL, 0, size, (uint32_t)fd);
+}
+
+ssize_t fs_fwrite(int fd, const void *data, size_t size) {
+    TRACE_CALL_IO(STAT_FS_FWRITE, ssize_t,
+                  FS_LOCKED_(fs_op_begin_write(fd, 0, size, 1), ssize_t, fs_fwrite_impl(fd, data, size)),
+                  TRACE_FWRITE, NULL, NULL, 0, size, (uint32_t)fd);
+}
+
+int64_t fs_seek(int fd, int64_t offset, int whence) {
+    TRACE_CALL(STAT_FS_SEEK, int64_t, FS_LOCKED(FS_SHARED, int64_t, fs_seek_impl(fd, offset, whence)),
+               TRACE_SEEK, NULL, NULL, (uint64_t)offset, (uint64_t)whence, (uint32_t)fd);
+}
+
+// Vektörlü çağrı izde eleman başına bir kayıt olur; gecikme ilk kayıttadır
+static ssize_t fs_iov_traced(TraceOp op, const FsIoVec *iov, int iovcnt) {
+    uint64_t t0 = STATS_BEGIN(), tt = trace_now_ns();
+    trace_nest++;
+    ssize_t r = op == TRACE_READV ? FS_LOCKED(FS_SHARED, ssize_t, fs_readv_impl(iov, iovcnt))
+                                  : FS_LOCKED(FS_EXCLUSIVE, ssize_t, fs_writev_impl(iov, iovcnt));
+    trace_nest--;
+    STATS_END(op == TRACE_READV ? STAT_FS_READV : STAT_FS_WRITEV, t0, r >= 0, r > 0 ? (uint64_t)r : 0);
+    for (int i = 0; iov && i < iovcnt; ++i) {
+        trace_record(op, i ? TRACE_F_CONT : 0, tt, r, iov[i].filename, NULL,
+                     iov[i].offset, iov[i].len, (uint32_t)i);
+    }
+    return r;
+}
+
+ssize_t fs_readv(const FsIoVec *iov, int iovcnt) {
+    if (trace_enabled && !trace_nest) return fs_iov_traced(TRACE_READV, iov, iovcnt);
+    STATS_CALL_IO(STAT_FS_READV, ssize_t, FS_LOCKED(FS_SHARED, ssize_t, fs_readv_impl(iov, iovcnt)));
+}
+
+ssize_t fs_writev(const FsIoVec *iov, int iovcnt) {
+    if (trace_enabled && !trace_nest) return fs_iov_traced(TRACE_WRITEV, iov, iovcnt);
+    STATS_CALL_IO(STAT_FS_WRITEV, ssize_t, FS_LOCKED(FS_EXCLUSIVE, ssize_t, fs_writev_impl(iov, iovcnt)));
+}
+
+ssize_t fs_appendv(const char *filename, const struct iovec *iov, int iovcnt) {
+    size_t total = 0;
+    for (int i = 0; trace_enabled && iov && i < iovcnt; ++i) total += iov[i].iov_len;
+    TRACE_CALL_IO(STAT_FS_APPENDV, ssize_t, FS_LOCKED(FS_EXCLUSIVE, ssize_t, fs_appendv_impl(filename, iov, iovcnt)),
+                  TRACE_APPENDV, filename, NULL, 0, total, (uint32_t)iovcnt);
+}
+
+int fs_map(const char *filename, uint32_t offset, size_t len, int flags, void **addr_out) {
+    STATS_CALL(STAT_FS_MAP, int, FS_LOCKED(FS_EXCLUSIVE, int, fs_map_impl(filename, offset, len, flags, addr_out)));
+}
+
+int fs_map_flush(void *addr) {
+    STATS_CALL(STAT_FS_MAP_FLUSH, int, FS_LOCKED(FS_EXCLUSIVE, int, fs_map_flush_impl(addr)));
+}
+
+int fs_unmap(void *addr) {
+    STATS_CALL(STAT_FS_UNMAP, int, FS_LOCKED(FS_EXCLUSIVE, int, fs_unmap_impl(addr)));
+}
+
+// Metadata'ya bakan diğer giriş noktaları da paylaşımlı kilitle çalışır
+int fs_mount(void) {
+    return FS_LOCKED(FS_SHARED, int, fs_mount_impl());
+}
+
+int fs_dedup_stats(DedupStats *out) {
+    return FS_LOCKED(FS_SHARED, int, fs_dedup_stats_impl(out));
+}
+
+int fs_lfs_stats(LfsStats *out) {
+    return FS_LOCKED(FS_SHARED, int, fs_lfs_stats_impl(out));
+}
+
+int fs_trace_start(const char *trace_filename) {
+    return FS_LOCKED(FS_SHARED, int, fs_trace_start_impl(trace_filename));
+}
+
+int fs_space_stats(FsSpaceReport *out) {
+    return FS_LOCKED(FS_SHARED, int, fs_space_stats_impl(out));
+}
+
+// Bekleyen durumu yazan ya da disk tanıtıcılarını değiştiren ayarlar da bir
+// çağrıdır: kirayı bırakan izleyiciyle aynı anda çalışmamalıdır
+int fs_delayed_alloc_enable(int on) {
+    return FS_LOCKED(FS_EXCLUSIVE, int, fs_delayed_alloc_enable_impl(on));
+}
+
+int fs_append_buffer_enable(int on) {
+    return FS_LOCKED(FS_EXCLUSIVE, int, fs_append_buffer_enable_impl(on));
+}
+
+int fs_direct_io_enable(int on) {
+    return FS_LOCKED(FS_EXCLUSIVE, int, fs_direct_io_enable_impl(on));
+}
+
+int fs_tier_set_limit(uint64_t limit_bytes) {
+    return FS_LOCKED(FS_EXCLUSIVE, int, fs_tier_set_limit_impl(limit_bytes));
+}
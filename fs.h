@@ -1,73 +1,337 @@
-#ifndef FS_H
-#define FS_H
-
-#include <stdint.h>     // uint32_t gibi sabit boyutlu tamsayılar
-#include <time.h>       // time_t türü
-#include <sys/types.h>  // ssize_t türü
-#include "disk.h"       // Disk yapısı ve metadata
-
-// Disk formatla (boş metadata ve veri alanı oluştur)
-int fs_format(void);
-
-// Yeni bir dosya oluştur
-int fs_create(const char *filename);
-
-// Dosyayı sil
-int fs_delete(const char *filename);
-
-// Dosyaya veri yaz (üzerine yazar)
-ssize_t fs_write(const char *filename, const void *data, size_t size);
-
-// Dosyadan veri oku (belirli offset’ten)
-ssize_t fs_read(const char *filename, uint32_t offset, size_t size, void *buffer);
-
-// fs.h
-void handle_read_file();
-ssize_t fs_read_all(const char *filename, void *buffer);
-
-// Dosya listesini ve boyutlarını yazdır
-int fs_ls(void);
-
-// Dosya adını değiştir
-int fs_rename(const char *old_name, const char *new_name);
-
-// Dosya var mı kontrolü (1: var, 0: yok)
-int fs_exists(const char *filename);
-
-// Dosya boyutunu al
-int fs_size(const char *filename, uint32_t *size_out);
-
-// Dosya sonuna veri ekle
-ssize_t fs_append(const char *filename, const void *data, size_t size);
-
-// Dosyanın boyutunu kes veya uzat (truncate gibi)
-int fs_truncate(const char *filename, uint32_t new_size);
-
-// Dosyayı başka adla kopyala
-int fs_copy(const char *src_filename, const char *dest_filename);
-
-// Dosyayı taşı (yeniden adlandırma ile benzer)
-int fs_mv(const char *old_path, const char *new_path);
-
-// Diskteki parçalı blokları birleştir (defragmentation)
-int fs_defragment(void);
-
-// Dosya sistemi bütünlüğünü kontrol et (metadata + veri blokları)
-int fs_check_integrity(void);
-
-// Disk dosyasının yedeğini al
-int fs_backup(const char *backup_filename);
-
-// Yedekten disk dosyasını geri yükle
-int fs_restore(const char *backup_filename);
-
-// Dosyanın içeriğini stdout’a yaz
-int fs_cat(const char *filename);
-
-// İki dosyayı karşılaştır (byte düzeyinde)
-int fs_diff(const char *file1, const char *file2);
-
-// İşlem günlüğüne log yaz (örn. "create", "delete" vs.)
-int fs_log(const char *operation, const char *filename);
-
-#endif // FS_H
+#ifndef FS_H
+#define FS_H
+
+#include <stdint.h>     // uint32_t gibi sabit boyutlu tamsayılar
+#include <time.h>       // time_t türü
+#include <sys/types.h>  // ssize_t türü
+#include <sys/uio.h>    // struct iovec
+#include "disk.h"       // Disk yapısı ve metadata
+#include "dedup.h"      // DedupStats
+#include "alloc.h"      // AllocPolicy, SpaceStats
+#include "bcache.h"     // BCacheStats
+#include "memtier.h"    // MemTierStats
+#include "dio.h"        // DioStats
+#include "bufpool.h"    // BufPoolStats
+#include "lfs.h"        // LfsStats
+#include "trim.h"       // TrimStats
+#include "share.h"      // ShareStats
+#include "oplog.h"      // OpLogConfig
+#include "stats.h"      // StatOp, StatSummary
+#include "fserr.h"      // FsError, FsLogCallback
+
+// libsimplefs: tüm fonksiyonlar başarıda >= 0, hatada FsError (< 0) döndürür.
+// Kütüphane kendiliğinden hiçbir şey yazdırmaz; hata ve ilerleme mesajları
+// fs_set_log_callback ile kurulan fonksiyona iletilir. Ekrana yazan yardımcılar
+// (fs_ls, fs_cat, fs_diff, *_report) açıkça çağrılmadıkça stdio kullanılmaz.
+
+// fs_format_mode bayrakları
+#define FS_FORMAT_DEDUP  DISK_FLAG_DEDUP   // İçerik adresli blok tekilleştirme
+#define FS_FORMAT_INLINE DISK_FLAG_INLINE  // INLINE_MAX byte'a kadar dosyalar metadata yanında (dedup ile birlikte olmaz)
+#define FS_FORMAT_LOG    DISK_FLAG_LOG     // Günlük yapılı veri bölgesi (tek başına kullanılır)
+
+// Disk imajını aç ve metadata'yı yükle (mevcut imajı kullanmaya başlamadan önce)
+int fs_mount(void);
+
+// Disk formatla (boş metadata ve veri alanı oluştur)
+int fs_format(void);
+
+// Disk formatla, isteğe bağlı özelliklerle (FS_FORMAT_* bayrakları)
+int fs_format_mode(uint32_t flags);
+
+// Yeni bir dosya oluştur
+int fs_create(const char *filename);
+
+// Dosyayı sil
+int fs_delete(const char *filename);
+
+// Dosyaya veri yaz (üzerine yazar)
+ssize_t fs_write(const char *filename, const void *data, size_t size);
+
+// Dosyadan veri oku (belirli offset’ten; dosya sonunda kısa okuma)
+ssize_t fs_read(const char *filename, uint32_t offset, size_t size, void *buffer);
+
+// Tüm dosyayı buffer'a oku (buffer en az dosya boyutu kadar olmalı)
+ssize_t fs_read_all(const char *filename, void *buffer);
+
+// Dosya kayıtlarını out'a kopyala (en fazla max adet); toplam dosya sayısını döner
+int fs_list(FileEntry *out, uint32_t max);
+
+// Dosya listesini ve boyutlarını yazdır
+int fs_ls(void);
+
+// Dosya adını değiştir
+int fs_rename(const char *old_name, const char *new_name);
+
+// Dosya var mı kontrolü (1: var, 0: yok)
+int fs_exists(const char *filename);
+
+// Dosya boyutunu al
+int fs_size(const char *filename, uint32_t *size_out);
+
+// Dosya sonuna veri ekle. Küçük eklemeler dosya başına bellekte biriktirilir ve
+// tam bloklar halinde yazılır; fs_size/fs_read hemen görür. Tampon; dolunca,
+// bekleyen veri 100 ms'yi aşınca (arka plan iş parçacığı), fs_sync, fs_close ve
+// dosyaya dokunan diğer işlemlerde (write, truncate, copy, ...) diske yazılır.
+// Süreç bu 100 ms içinde öldürülürse son eklemeler kaybolabilir.
+ssize_t fs_append(const char *filename, const void *data, size_t size);
+
+// Bekleyen eklemeleri yaz ve disk imajını kalıcı belleğe aktar (fdatasync)
+int fs_sync(void);
+
+// Ekleme tamponunu aç/kapat (varsayılan açık); kapatmak bekleyenleri yazar
+int fs_append_buffer_enable(int on);
+
+// Ertelenmiş ayırma (varsayılan kapalı): tampondaki eklemelere blok hemen
+// ayrılmaz, yalnızca yeterli boş blok olduğu denetlenir; yer tampon diske
+// yazılırken bekleyen baytların tamamına göre tek seferde seçilir. Boş alan
+// parçalıysa bu yazım FS_ERR_NO_SPACE ile başarısız olabilir.
+int fs_delayed_alloc_enable(int on);
+
+// Dosyanın boyutunu kes veya uzat (truncate gibi; uzatılan alan delik olur)
+int fs_truncate(const char *filename, uint32_t new_size);
+
+// Aralığı serbest bırak (delik aç): boyut değişmez, aralık sıfır okunur
+int fs_punch_hole(const char *filename, uint32_t offset, uint32_t len);
+
+// [offset, offset+len) için dosyaya bitişik blok ayır; veri (sıfır) yazılmaz.
+// Varsayılan: boyut gerekirse offset+len'e büyür (uzatılan kısım delik olur).
+// FS_FALLOC_KEEP_SIZE: boyut değişmez, bloklar dosyanın ardında sonraki
+// eklemeler için ayrılmış kalır; böylece büyüyen dosya taşınmaz. Bu ön
+// ayırma metadata'ya yazılmaz: dosya küçültülünce, silinince ya da program
+// kapanınca bırakılır.
+#define FS_FALLOC_KEEP_SIZE 0x1
+int fs_fallocate(const char *filename, uint32_t offset, uint32_t len, int flags);
+
+// Dosyayı başka adla kopyala (delikler kopyalanmaz)
+int fs_copy(const char *src_filename, const char *dest_filename);
+
+// Dosyayı taşı (yeniden adlandırma ile benzer)
+int fs_mv(const char *old_path, const char *new_path);
+
+// Diskteki parçalı blokları birleştir (defragmentation)
+int fs_defragment(void);
+
+// İmajı çevrimiçi büyüt/küçült: size metadata dahil toplam bayt (en fazla
+// DISK_SIZE, blok sınırına yukarı yuvarlanır). Küçültürken yeni sonun
+// ötesindeki dosyalar boş alana taşınır; sığmazlarsa FS_ERR_NO_SPACE döner
+// (önce fs_defragment denenebilir). Yalnızca düz tek imajda; dedup, günlük
+// yapılı imaj ve şeritli kümede FS_ERR_UNSUPPORTED.
+int fs_resize(uint32_t size);
+
+// Dosya sistemi bütünlüğünü kontrol et (metadata + veri blokları)
+int fs_check_integrity(void);
+
+// --- Açık dosya tanıtıcıları ---
+// fs_open adı bir kez çözer; tanıtıcı üzerinden yapılan G/Ç metadata'yı yeniden
+// okumaz. fs_delete ile silinen dosyanın tanıtıcısı FS_ERR_NOT_FOUND döner,
+// format/restore tüm tanıtıcıları geçersiz kılar (fs_close yine çağrılmalı).
+#define FS_MAX_OPEN   64
+
+#define FS_O_READ     0x01
+#define FS_O_WRITE    0x02
+#define FS_O_RDWR     (FS_O_READ | FS_O_WRITE)
+#define FS_O_CREATE   0x04    // Yoksa oluştur
+#define FS_O_TRUNC    0x08    // Yazma için açılırken boyutu sıfırla
+#define FS_O_APPEND   0x10    // fs_fwrite her zaman dosya sonuna yazar
+
+#define FS_SEEK_SET   0
+#define FS_SEEK_CUR   1
+#define FS_SEEK_END   2
+#define FS_SEEK_DATA  3       // offset'ten itibaren ilk veri (yoksa FS_ERR_RANGE)
+#define FS_SEEK_HOLE  4       // offset'ten itibaren ilk delik (dosya sonu da delik)
+
+// Dosyayı aç; tanıtıcı (>= 0) döner
+int fs_open(const char *filename, int flags);
+int fs_close(int fd);
+
+// Konum belirterek oku/yaz (imleç değişmez). Okuma dosya sonunda kısa döner,
+// sonun ötesinde 0; yazım sonun ötesindeyse aradaki boşluk sıfırla dolar
+ssize_t fs_pread(int fd, void *buffer, size_t size, uint32_t offset);
+ssize_t fs_pwrite(int fd, const void *data, size_t size, uint32_t offset);
+
+// İmleçten oku/yaz ve imleci ilerlet
+ssize_t fs_fread(int fd, void *buffer, size_t size);
+ssize_t fs_fwrite(int fd, const void *data, size_t size);
+
+// İmleci taşı (FS_SEEK_*); yeni konumu döner
+int64_t fs_seek(int fd, int64_t offset, int whence);
+
+// --- Vektörlü G/Ç ---
+// Her eleman bir dosyanın bir aralığını bir tampona bağlar; elemanlar farklı
+// dosyalara ve offset'lere işaret edebilir. Aralıklar disk konumuna göre
+// sıralanır, bitişik olanlar birleştirilip her parça tek preadv/pwritev ile
+// aktarılır; metadata yalnızca bir kez okunur (ve yazılır).
+typedef struct {
+    const char *filename;
+    uint32_t    offset;
+    void       *base;
+    size_t      len;
+} FsIoVec;
+
+// Okuma: her eleman dosya sonunda kısa kalır (tamponun kalanı sıfırlanır);
+// okunan toplam bayt sayısını döner. Dosyalardan biri yoksa hiçbir şey okunmaz.
+ssize_t fs_readv(const FsIoVec *iov, int iovcnt);
+
+// Yazım: fs_pwrite gibi; sonun ötesindeki boşluk delik olur. Aynı bölgeye
+// yazan elemanlardan sonraki kazanır. Yazılan toplam bayt sayısını döner.
+ssize_t fs_writev(const FsIoVec *iov, int iovcnt);
+
+// Tamponları sırayla dosya sonuna ekle (tek yazım ve tek metadata güncellemesi)
+ssize_t fs_appendv(const char *filename, const struct iovec *iov, int iovcnt);
+
+// --- Bellek eşlemesi ---
+// Dosyanın [offset, offset+len) aralığını disk imajından doğrudan belleğe eşler
+// (len 0 = dosya sonuna kadar); kayıtlar kopyalanmadan yerinde okunabilir.
+// Aralık dosya boyutunu aşamaz, dedup ve günlük yapılı modda FS_ERR_UNSUPPORTED döner.
+// FS_MAP_WRITE ile yapılan yazımlar fs_map_flush, fs_sync veya fs_unmap'ten
+// sonra fs_read ve diğer işlemlerce görülür. Dosya silinir, diske defragment
+// uygulanır ya da format/restore yapılırsa eşleme diskten ayrılır: adres
+// fs_unmap'e kadar geçerlidir ama sıfır okunur.
+#define FS_MAX_MAPS   16
+#define FS_MAP_READ   0x01
+#define FS_MAP_WRITE  0x02
+#define FS_MAP_RDWR   (FS_MAP_READ | FS_MAP_WRITE)
+
+int fs_map(const char *filename, uint32_t offset, size_t len, int flags, void **addr_out);
+int fs_map_flush(void *addr);
+int fs_unmap(void *addr);
+
+// Disk dosyasının yedeğini al (seyrek: delikler ve sıfır bloklar yazılmaz)
+int fs_backup(const char *backup_filename);
+
+// Yedekten disk dosyasını geri yükle
+int fs_restore(const char *backup_filename);
+
+// Toplu içe/dışa aktarma (bkz. bulk.h): ana makinedeki bir dizin ağacı ya da
+// tar akışı imaja tek seferde alınır / imajdaki tüm dosyalar dışarı yazılır.
+// Alt dizinlerdeki dosyalar "dizin/dosya" adını alır. İçe aktarma ya tamamen
+// olur ya hiç olmaz; aktarılan dosya sayısını ya da FsError döndürür. fd
+// kapatılmaz.
+int fs_import_dir(const char *host_dir);
+int fs_import_tar(int fd);
+int fs_export_dir(const char *host_dir);
+int fs_export_tar(int fd);
+
+// Dosyanın içeriğini stdout’a yaz
+int fs_cat(const char *filename);
+
+// İki dosyayı karşılaştır (byte düzeyinde; 0: aynı, 1: farklı)
+int fs_diff(const char *file1, const char *file2);
+
+// Tekilleştirme istatistiklerini al / yazdır (dedup modunda formatlanmış disk)
+int fs_dedup_stats(DedupStats *out);
+int fs_dedup_report(void);
+
+// Günlük yapılı mod (FS_FORMAT_LOG): yazımlar segmentlere sırayla eklenir,
+// eşleme tablosu checkpoint ile kalıcı olur (fs_sync, fs_backup, program
+// çıkışı ya da birkaç segmentte bir). Son checkpoint'ten sonraki yazımlar
+// çökmede kaybolur. fs_map ve bellek katmanı bu modda kullanılamaz.
+int fs_lfs_stats(LfsStats *out);
+int fs_lfs_report(void);
+
+// İstatistik toplamayı aç/kapat (varsayılan kapalı) ve sıfırla
+void fs_stats_enable(int on);
+void fs_stats_reset(void);
+
+// Blok önbelleği ve sıralı ileri okuma (varsayılan açık); isabet/ıska sayaçları
+// fs_stats_reset ile sıfırlanır
+void fs_cache_enable(int on);
+int  fs_cache_stats(BCacheStats *out);
+
+// Silinen, kısaltılan ya da taşınan dosyaların bıraktığı bloklar imaj
+// dosyasında delinir, imaj ana makinede yalnızca kullanılan kadar yer tutar
+// (bkz. trim.h). Toplu mod (varsayılan kapalı) delmeleri biriktirip arka
+// planda birleştirir; bekleyenler fs_sync, fs_backup ve çıkışta yapılır.
+void fs_trim_batch_enable(int on);
+int  fs_trim_stats(TrimStats *out);
+
+// Çoklu süreç erişimi (bkz. share.h): aynı imajı açan süreçler her çağrıda
+// imaj dosyası üzerinde danışma kilidi alır; okuyan çağrılar ve dosyayı
+// büyütmeyen fs_pwrite/fs_fwrite birlikte, diğerleri tek başına çalışır.
+// Bellekteki metadata çağrı başında imajın nesliyle doğrulanır. İmajı tek
+// başına açmış süreç kira tutar, kilitsiz çalışır ve tampondaki eklemeleri,
+// ön ayırmaları, bellek katmanının kirli verisini çağrılar arasında tutar;
+// başka süreç açınca durum arka planda yazılıp kira bırakılır (bırakılmazsa
+// yeni süreç FS_ERR_BUSY alır). fs_map eşlemeleri korunmaz.
+int  fs_share_stats(ShareStats *out);
+
+// Bellek katmanı (varsayılan kapalı; bkz. memtier.h): sık okunan/yazılan
+// dosyalar en fazla limit_bytes bayt anonim bellekte tutulur, soğuyanlar
+// diske indirilir. Bellekteki dosyalara yazımlar fs_sync, fs_backup veya
+// program çıkışına kadar yalnızca bellektedir. 0 katmanı kapatır (kirli
+// veri önce diske yazılır).
+int fs_tier_set_limit(uint64_t limit_bytes);
+int fs_tier_stats(MemTierStats *out);
+
+// Doğrudan G/Ç (varsayılan kapalı; bkz. dio.h): imajın veri bölgesi ile
+// fs_backup/fs_restore dosyaları O_DIRECT ile kullanılır, ana makinenin sayfa
+// önbelleğine girmez; hizalanmamış istekler sabit boyutlu hizalı tampon
+// havuzundan geçer. Açıkken fs_map kullanılamaz, açık eşleme varken
+// açılamaz. Dosya sistemi desteklemiyorsa FS_ERR_UNSUPPORTED döner.
+int fs_direct_io_enable(int on);
+int fs_direct_io_stats(DioStats *out);
+
+// İşlem başına geçici tamponlar iş parçacığı başına havuzlardan gelir (bkz.
+// bufpool.h); ısınmadan sonra okuma/yazma yolunda heap_allocs artmamalıdır.
+// Sayaçlar fs_stats_reset ile sıfırlanır
+int fs_buffer_stats(BufPoolStats *out);
+
+// Yer ayırma politikası (varsayılan first-fit; bkz. alloc.h). Dosyalar bitişik
+// blok aralıklarında durur: büyüyen dosyanın ardındaki bloklar doluysa dosya
+// politikanın bulduğu yeni alana taşınır, yer yoksa FS_ERR_NO_SPACE döner.
+int         fs_set_alloc_policy(AllocPolicy policy);
+AllocPolicy fs_alloc_policy(void);
+
+// Boş alan ve yerleşim raporu: kullanılan/boş bloklar, en büyük boş alan,
+// boş alan boy histogramı ve dosya başına yerleşim
+typedef struct {
+    char     name[32];
+    uint32_t start_block;
+    uint32_t blocks;            // Ayrılmış blok sayısı
+    uint32_t extents;           // Veri içeren bitişik parça sayısı (delikler böler)
+} FsFileLayout;
+
+typedef struct {
+    SpaceStats   space;
+    uint32_t     file_count;
+    uint32_t     inline_files;  // Satır içi tutulan dosyalar (blok kullanmaz)
+    uint64_t     inline_bytes;
+    uint32_t     devices;       // Aygıt (imaj dosyası) sayısı
+    uint32_t     stripe_blocks; // Şerit parçası (blok), tek aygıtta 0
+    uint64_t     image_bytes;   // İmaj dosyalarının boyutu
+    uint64_t     host_bytes;    // Ana makinede gerçekten kapladıkları yer
+    FsFileLayout files[MAX_FILES];  // Satır içi dosyada start_block = INLINE_SLOT | yuva
+} FsSpaceReport;
+
+int fs_space_stats(FsSpaceReport *out);
+int fs_space_report(void);      // Raporu yazdır
+
+// Ayrıntılı iş yükü izi (bkz. trace.h): veriyi okuyan/değiştiren her çağrı
+// işlem, dosya, offset, uzunluk, zaman ve gecikmesiyle dosyaya kaydedilir;
+// fsreplay izi taze bir imaj üzerinde yeniden oynatır. İz başlarken mevcut
+// dosyalar ve boyutları da yazılır. Başka bir iz açıkken FS_ERR_EXISTS döner.
+int fs_trace_start(const char *trace_filename);
+int fs_trace_stop(void);
+int fs_trace_active(void);
+
+// Bir giriş noktasının çağrı/hata/bayt sayaçları ve gecikme yüzdelikleri
+int fs_stats(StatOp op, StatSummary *out);
+
+// Tüm istatistikleri tablo olarak yazdır / JSON olarak dök (NULL = stdout)
+int fs_stats_report(void);
+int fs_stats_dump_json(const char *json_filename);
+
+// İşlem günlüğüne log yaz (örn. "create", "delete" vs.)
+// Kayıt bellekte tamponlanır, arka plandaki yazıcı toplu halde diske ekler
+int fs_log(const char *operation, const char *filename);
+
+// Günlük ayarları: kalıcılık modu (periyodik / her işlemde), toplu yazım, döndürme
+int fs_log_configure(const OpLogConfig *cfg);
+
+// Bekleyen tüm günlük kayıtları dosyaya yazılana kadar bekle
+int fs_log_flush(void);
+
+// İkili günlüğü okunabilir metin olarak dosyaya dök
+int fs_log_export(const char *text_filename);
+
+#endif // FS_H
@@ -0,0 +1,295 @@
+// fs_print.c — ekrana yazdıran yardımcılar (ls, cat, diff, raporlar)
+//
+// Veri yolunun (fs.c) dışında tutulur: bu fonksiyonlar fs.h API'si üzerine
+// kurulmuş kolaylık katmanıdır ve çıktıyı stdout'a veya verilen dosyaya yazar.
+#define _POSIX_C_SOURCE 200809L
+
+#include "fs.h"
+#include "fserr.h"
+#include "stats.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Dosya listesini ve boyutlarını yazdır
+static int fs_ls_impl(void) {
+    ScratchMark mark = scratch_mark();
+    FileEntry *entries = scratch_alloc(MAX_FILES * sizeof(*entries));
+    if (!entries) FS_FAIL(FS_ERR_NO_MEMORY, "fs_ls: malloc");
+    int n = fs_list(entries, MAX_FILES);
+    if (n < 0) {
+        scratch_release(mark);
+        return n;
+    }
+    printf("=== Files on disk ===\n");
+    for (int i = 0; i < n; ++i) {
+        printf("%2d: %-32s  %10u bytes\n", i + 1, entries[i].name, entries[i].size);
+    }
+    if (n == 0) {
+        printf("(no files)\n");
+    }
+    scratch_release(mark);
+    return 0;
+}
+
+// Print file contents to stdout
+static int fs_cat_impl(const char *filename) {
+    if (!filename) FS_FAIL(FS_ERR_INVALID, "fs_cat: invalid filename");
+    // Eğer log dosyası isteniyorsa ikili logu metne çevirerek göster
+    if (strcmp(filename, OPLOG_TEXT_NAME) == 0) {
+        printf("=== %s ===\n", OPLOG_TEXT_NAME);
+        return oplog_export(stdout);
+    }
+    // Aksi halde virtual FS içinde çalış
+    uint32_t size;
+    int rc = fs_size(filename, &size);
+    if (rc < 0) FS_FAIL(rc, "fs_cat: cannot get size for '%s'", filename);
+    // Dosya BUF_CHUNK parçalarıyla akıtılır; çıktı ilk NUL baytında biter
+    char *buffer = buf_get(BUF_CHUNK);
+    if (!buffer) FS_FAIL(FS_ERR_NO_MEMORY, "fs_cat: malloc");
+    printf("=== %s contents ===\n", filename);
+    for (uint32_t off = 0; off < size;) {
+        uint32_t want = size - off < BUF_CHUNK_SIZE ? size - off : BUF_CHUNK_SIZE;
+        ssize_t rd = fs_read(filename, off, want, buffer);
+        if (rd < 0) {
+            buf_put(BUF_CHUNK, buffer);
+            return (int)rd;
+        }
+        size_t len = strnlen(buffer, (size_t)rd);
+        fwrite(buffer, 1, len, stdout);
+        if (len < (size_t)rd || (uint32_t)rd < want) break;
+        off += (uint32_t)rd;
+    }
+    printf("\n");
+    buf_put(BUF_CHUNK, buffer);
+    return 0;
+}
+
+// Compare two files and print diff-like output (0: aynı, 1: farklı)
+static int fs_diff_impl(const char *file1, const char *file2) {
+    if (!file1 || !file2) FS_FAIL(FS_ERR_INVALID, "fs_diff: invalid arguments");
+    uint32_t sz1, sz2;
+    int rc;
+    if ((rc = fs_size(file1, &sz1)) < 0 || (rc = fs_size(file2, &sz2)) < 0) {
+        FS_FAIL(rc, "fs_diff: cannot get sizes");
+    }
+    char *buf1 = buf_get(BUF_CHUNK);
+    char *buf2 = buf_get(BUF_CHUNK);
+    if (!buf1 || !buf2) {
+        buf_put(BUF_CHUNK, buf1); buf_put(BUF_CHUNK, buf2);
+        FS_FAIL(FS_ERR_NO_MEMORY, "fs_diff: malloc");
+    }
+    // İki dosya aynı konumdan BUF_CHUNK parçalarıyla okunur; kısa okuma o
+    // dosyanın sonudur
+    int diffs = 0;
+    ssize_t r1 = 0, r2 = 0;
+    int more1 = sz1 > 0, more2 = sz2 > 0;
+    for (uint32_t off = 0; more1 || more2; off += BUF_CHUNK_SIZE) {
+        ssize_t n1 = 0, n2 = 0;
+        if (more1) {
+            uint32_t want = sz1 - off < BUF_CHUNK_SIZE ? sz1 - off : BUF_CHUNK_SIZE;
+            if ((n1 = fs_read(file1, off, want, buf1)) >= 0) {
+                r1 += n1;
+                more1 = (uint32_t)n1 == want && off + want < sz1;
+            }
+        }
+        if (more2 && n1 >= 0) {
+            uint32_t want = sz2 - off < BUF_CHUNK_SIZE ? sz2 - off : BUF_CHUNK_SIZE;
+            if ((n2 = fs_read(file2, off, want, buf2)) >= 0) {
+                r2 += n2;
+                more2 = (uint32_t)n2 == want && off + want < sz2;
+            }
+        }
+        if (n1 < 0 || n2 < 0) {
+            buf_put(BUF_CHUNK, buf1); buf_put(BUF_CHUNK, buf2);
+            return (int)(n1 < 0 ? n1 : n2);
+        }
+        ssize_t limit = n1 < n2 ? n1 : n2;
+        for (ssize_t i = 0; i < limit; ++i) {
+            if (buf1[i] != buf2[i]) {
+                printf("Difference at byte %u: '%c' vs '%c'\n", off + (uint32_t)i,
+                       buf1[i], buf2[i]);
+                diffs++;
+            }
+        }
+    }
+    if (r1 != r2) {
+        printf("Files have different lengths: %zd vs %zd bytes\n", r1, r2);
+        diffs++;
+    }
+    if (diffs == 0) {
+        printf("fs_diff: files are identical\n");
+    }
+    buf_put(BUF_CHUNK, buf1); buf_put(BUF_CHUNK, buf2);
+    return diffs == 0 ? 0 : 1;
+}
+
+// İkili günlüğü okunabilir metin olarak dosyaya döker
+int fs_log_export(const char *text_filename) {
+    if (!text_filename) FS_FAIL(FS_ERR_INVALID, "fs_log_export: invalid filename");
+    FILE *f = fopen(text_filename, "w");
+    if (!f) FS_FAIL(FS_ERR_IO, "fs_log_export: fopen: %s", strerror(errno));
+    int rc = oplog_export(f);
+    if (fclose(f) != 0 && rc == 0) rc = FS_ERR_IO;
+    return rc;
+}
+
+int fs_dedup_report(void) {
+    DedupStats st;
+    int rc = fs_dedup_stats(&st);
+    if (rc < 0) return rc;
+    printf("=== Dedup stats ===\n");
+    printf("Logical blocks   : %u (%u bytes)\n", st.logical_blocks,
+           st.logical_blocks * BLOCK_SIZE);
+    printf("Physical blocks  : %u / %u\n", st.physical_blocks, st.physical_total);
+    printf("Shared blocks    : %u\n", st.shared_blocks);
+    printf("Dedup ratio      : %.2fx\n", st.dedup_ratio);
+    printf("Space saved      : %llu bytes\n", (unsigned long long)st.saved_bytes);
+    printf("Index entries    : %u / %u slots\n", st.index_entries, st.index_capacity);
+    printf("Index memory     : %zu bytes\n", st.index_memory);
+    printf("Total memory     : %zu bytes (index + block map + refcounts)\n", st.total_memory);
+    return 0;
+}
+
+int fs_lfs_report(void) {
+    LfsStats st;
+    int rc = fs_lfs_stats(&st);
+    if (rc < 0) return rc;
+    printf("=== Log-structured stats ===\n");
+    printf("Segments         : %u clean / %u (%d blocks each)\n", st.clean_segments, st.segments,
+           LFS_SEG_BLOCKS);
+    printf("Live blocks      : %u / %u\n", st.live_blocks, st.capacity_blocks);
+    printf("User blocks      : %llu\n", (unsigned long long)st.user_blocks);
+    printf("Log blocks       : %llu (moved %llu)\n", (unsigned long long)st.log_blocks,
+           (unsigned long long)st.moved_blocks);
+    printf("Write amp.       : %.2fx\n", st.write_amp);
+    printf("Cleaned segments : %llu (%llu in write path)\n", (unsigned long long)st.cleaned_segments,
+           (unsigned long long)st.cleaner_waits);
+    printf("Checkpoints      : %llu\n", (unsigned long long)st.checkpoints);
+    return 0;
+}
+
+int fs_space_report(void) {
+    ScratchMark mark = scratch_mark();
+    FsSpaceReport *r = scratch_alloc(sizeof(*r));
+    if (!r) FS_FAIL(FS_ERR_NO_MEMORY, "fs_space_report: malloc");
+    int rc = fs_space_stats(r);
+    if (rc < 0) {
+        scratch_release(mark);
+        return rc;
+    }
+    const SpaceStats *s = &r->space;
+    printf("=== Space report (policy %s) ===\n", alloc_policy_name(fs_alloc_policy()));
+    if (r->devices > 1) {
+        printf("Devices          : %u, striped in %u-block units\n", r->devices, r->stripe_blocks);
+    }
+    printf("Blocks           : %u used / %u total, %u free\n",
+           s->used_blocks, s->total_blocks, s->free_blocks);
+    printf("Image            : %llu KB, %llu KB allocated on host\n",
+           (unsigned long long)(r->image_bytes / 1024), (unsigned long long)(r->host_bytes / 1024));
+    printf("Free extents     : %u, largest %u blocks\n", s->free_extents, s->largest_free);
+    printf("Fragmentation    : %.1f%% (1 - largest / free)\n", 100.0 * s->fragmentation);
+    printf("Free extent sizes:\n");
+    for (int k = 0; k < ALLOC_HIST_BUCKETS; ++k) {
+        if (!s->free_hist[k]) continue;
+        uint32_t lo = 1u << k, hi = (2u << k) - 1;
+        if (k == ALLOC_HIST_BUCKETS - 1) printf("  %5u+      : %u\n", lo, s->free_hist[k]);
+        else if (lo == hi)               printf("  %5u       : %u\n", lo, s->free_hist[k]);
+        else                             printf("  %5u-%-5u : %u\n", lo, hi, s->free_hist[k]);
+    }
+    if (r->inline_files) {
+        printf("Inline files     : %u (%llu bytes, %u blocks reserved)\n", r->inline_files,
+               (unsigned long long)r->inline_bytes, INLINE_BLOCKS);
+    }
+    printf("%-32s %8s %8s %8s\n", "File", "Start", "Blocks", "Extents");
+    for (uint32_t i = 0; i < r->file_count; ++i) {
+        const FsFileLayout *f = &r->files[i];
+        if (f->start_block & INLINE_SLOT) {
+            printf("%-32s %8s %8u %8u\n", f->name, "inline", f->blocks, f->extents);
+        } else {
+            printf("%-32s %8u %8u %8u\n", f->name, f->start_block, f->blocks, f->extents);
+        }
+    }
+    scratch_release(mark);
+    return 0;
+}
+
+int fs_stats_report(void) {
+    int rc = stats_report(stdout);
+    if (rc < 0) return rc;
+    BCacheStats cs;
+    fs_cache_stats(&cs);
+    uint64_t lookups = cs.hits + cs.misses;
+    printf("block cache: %s, hits %llu / %llu (%.1f%%), read-ahead %llu blocks "
+           "(%llu used, %llu waits)\n",
+           bcache_enabled() ? "on" : "off",
+           (unsigned long long)cs.hits, (unsigned long long)lookups,
+           lookups ? 100.0 * cs.hits / lookups : 0.0,
+           (unsigned long long)cs.readahead_blocks, (unsigned long long)cs.readahead_hits,
+           (unsigned long long)cs.readahead_waits);
+    MemTierStats ts;
+    fs_tier_stats(&ts);
+    if (ts.limit) {
+        printf("memory tier: %u files, %llu / %llu KB, hits %llu read %llu write, "
+               "%llu promoted, %llu demoted, %llu KB written back\n",
+               ts.resident, (unsigned long long)(ts.resident_bytes / 1024),
+               (unsigned long long)(ts.limit / 1024), (unsigned long long)ts.read_hits,
+               (unsigned long long)ts.write_hits, (unsigned long long)ts.promotions,
+               (unsigned long long)ts.demotions, (unsigned long long)(ts.writeback_bytes / 1024));
+    }
+    if (disk_direct()) {
+        DioStats ds;
+        fs_direct_io_stats(&ds);
+        printf("direct I/O: %llu aligned, %llu bounced, %llu read-modify-write units, "
+               "%llu pool waits (pool %d x %d KB)\n",
+               (unsigned long long)ds.direct, (unsigned long long)ds.bounced,
+               (unsigned long long)ds.rmw_reads, (unsigned long long)ds.pool_waits,
+               DIO_POOL_BUFS, DIO_BUF_SIZE / 1024);
+    }
+    TrimStats tr;
+    fs_trim_stats(&tr);
+    printf("trim: %s, %llu blocks punched in %llu calls, %llu cancelled, %u pending\n",
+           trim_batching() ? "batched" : "immediate", (unsigned long long)tr.punched,
+           (unsigned long long)tr.punch_calls, (unsigned long long)tr.cancelled, tr.pending);
+    ShareStats ss;
+    fs_share_stats(&ss);
+    printf("share: %llu locks (%llu waited), %llu range locks, %llu validations, "
+           "%llu reloads, %llu generation writes, %llu state flushes, %llu lease yields%s\n",
+           (unsigned long long)ss.locks, (unsigned long long)ss.lock_waits,
+           (unsigned long long)ss.range_locks, (unsigned long long)ss.validations,
+           (unsigned long long)ss.reloads, (unsigned long long)ss.publishes,
+           (unsigned long long)ss.state_flushes, (unsigned long long)ss.yields,
+           ss.lease ? ", lease held" : "");
+    BufPoolStats bs;
+    fs_buffer_stats(&bs);
+    printf("buffers: %llu pooled, %llu heap allocs, %llu heap frees, "
+           "%llu scratch (%llu overflowed)\n",
+           (unsigned long long)bs.pool_hits, (unsigned long long)bs.heap_allocs,
+           (unsigned long long)bs.heap_frees, (unsigned long long)bs.scratch_allocs,
+           (unsigned long long)bs.scratch_overflows);
+    return 0;
+}
+
+int fs_stats_dump_json(const char *json_filename) {
+    if (!json_filename) return stats_dump_json(stdout);
+    FILE *f = fopen(json_filename, "w");
+    if (!f) FS_FAIL(FS_ERR_IO, "fs_stats_dump_json: fopen: %s", strerror(errno));
+    int rc = stats_dump_json(f);
+    if (fclose(f) != 0 && rc == 0) rc = FS_ERR_IO;
+    return rc;
+}
+
+// Ölçüm sarmalayıcıları (bkz. stats.h)
+int fs_ls(void) {
+    STATS_CALL(STAT_FS_LS, int, fs_ls_impl());
+}
+
+int fs_cat(const char *filename) {
+    STATS_CALL(STAT_FS_CAT, int, fs_cat_impl(filename));
+}
+
+int fs_diff(const char *file1, const char *file2) {
+    STATS_CALL(STAT_FS_DIFF, int, fs_diff_impl(file1, file2));
+}
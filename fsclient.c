@@ -0,0 +1,333 @@
+// fsclient.c — simplefs sunucusu için istemci kütüphanesi
+//
+// İstekler proto.h çerçevelerine kodlanıp tek sendmsg ile gönderilir.
+// Gönderilen istekler bir halka dizide tutulur; sunucu yanıtları aynı sırayla
+// döndürdüğünden her yanıt en eski bekleyen istekle eşleşir.
+#define _POSIX_C_SOURCE 200809L
+
+#include "fsclient.h"
+#include "proto.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+struct FsClient {
+    int          fd;
+    int          broken;              // Bağlantı koptu; her çağrı FS_ERR_IO
+    uint32_t     next_id;
+    FsClientReq *inflight[FSC_MAX_INFLIGHT];
+    uint32_t     ids[FSC_MAX_INFLIGHT];
+    unsigned     head, count;
+};
+
+static void put_le(uint8_t *out, uint64_t v, int n) {
+    for (int i = 0; i < n; ++i) out[i] = (uint8_t)(v >> (8 * i));
+}
+
+static uint64_t get_le(const uint8_t *in, int n) {
+    uint64_t v = 0;
+    for (int i = 0; i < n; ++i) v |= (uint64_t)in[i] << (8 * i);
+    return v;
+}
+
+int fsc_connect(const char *socket_path, FsClient **out) {
+    if (!socket_path || !out) FS_FAIL(FS_ERR_INVALID, "fsc_connect: invalid arguments");
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(socket_path) >= sizeof(addr.sun_path)) {
+        FS_FAIL(FS_ERR_INVALID, "fsc_connect: socket path too long");
+    }
+    strcpy(addr.sun_path, socket_path);
+
+    FsClient *c = calloc(1, sizeof(*c));
+    if (!c) FS_FAIL(FS_ERR_NO_MEMORY, "fsc_connect: calloc");
+    c->fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (c->fd < 0 || connect(c->fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        FS_ERROR("fsc_connect: '%s': %s", socket_path, strerror(errno));
+        if (c->fd >= 0) close(c->fd);
+        free(c);
+        return FS_ERR_IO;
+    }
+    *out = c;
+    return 0;
+}
+
+static int io_all(FsClient *c, void *buf, size_t len, int sending) {
+    uint8_t *p = buf;
+    while (len > 0) {
+        ssize_t n = sending ? send(c->fd, p, len, MSG_NOSIGNAL) : recv(c->fd, p, len, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            c->broken = 1;
+            FS_FAIL(FS_ERR_IO, "fsclient: connection lost");
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+// En eski bekleyen isteğin yanıtını al
+static int complete_one(FsClient *c) {
+    FsClientReq *req = c->inflight[c->head];
+    uint32_t id = c->ids[c->head];
+    c->head = (c->head + 1) % FSC_MAX_INFLIGHT;
+    c->count--;
+    req->result = FS_ERR_IO;
+    if (c->broken) return FS_ERR_IO;
+
+    uint8_t hdr[FSP_RESP_HDR];
+    if (io_all(c, hdr, sizeof(hdr), 0) < 0) return FS_ERR_IO;
+    size_t len = (size_t)get_le(hdr, 4) + 4 - FSP_RESP_HDR;
+    if (get_le(hdr, 4) < FSP_RESP_HDR - 4 || (uint32_t)get_le(hdr + 4, 4) != id) {
+        c->broken = 1;
+        FS_FAIL(FS_ERR_CORRUPT, "fsclient: unexpected response");
+    }
+    int64_t result = (int64_t)get_le(hdr + 8, 8);
+
+    // Yanıt verisini isteğin hedefine çöz; fazlası atılır
+    uint8_t scratch[FSP_ENTRY_SIZE];
+    size_t want = 0;
+    if (req->op == FSP_READ || req->op == FSP_PREAD || req->op == FSP_FREAD) {
+        want = len < req->size ? len : req->size;
+        if (want && io_all(c, req->out, want, 0) < 0) return FS_ERR_IO;
+    } else if (req->op == FSP_SIZE && len >= 4) {
+        if (io_all(c, scratch, 4, 0) < 0) return FS_ERR_IO;
+        if (req->out) *(uint32_t *)req->out = (uint32_t)get_le(scratch, 4);
+        want = 4;
+    } else if (req->op == FSP_LIST) {
+        FileEntry *entries = req->out;
+        for (uint32_t i = 0; (size_t)(i + 1) * FSP_ENTRY_SIZE <= len && i < req->size; ++i) {
+            if (io_all(c, scratch, FSP_ENTRY_SIZE, 0) < 0) return FS_ERR_IO;
+            memset(&entries[i], 0, sizeof(entries[i]));
+            memcpy(entries[i].name, scratch, sizeof(entries[i].name) - 1);
+            entries[i].size = (uint32_t)get_le(scratch + 32, 4);
+            entries[i].start_block = (uint32_t)get_le(scratch + 36, 4);
+            entries[i].created = (time_t)(int64_t)get_le(scratch + 40, 8);
+            want += FSP_ENTRY_SIZE;
+        }
+    }
+    while (want < len) {
+        size_t n = len - want < sizeof(scratch) ? len - want : sizeof(scratch);
+        if (io_all(c, scratch, n, 0) < 0) return FS_ERR_IO;
+        want += n;
+    }
+    req->result = result;
+    return 0;
+}
+
+int fsc_submit(FsClient *c, FsClientReq *req) {
+    if (!c || !req) FS_FAIL(FS_ERR_INVALID, "fsc_submit: invalid arguments");
+    size_t n1 = req->name ? strlen(req->name) : 0, n2 = req->name2 ? strlen(req->name2) : 0;
+    if (n1 > 255 || n2 > 255 || req->data_len > FSP_MAX_DATA || (req->data_len && !req->data)) {
+        FS_FAIL(FS_ERR_INVALID, "fsc_submit: request too large");
+    }
+    if (c->broken) return FS_ERR_IO;
+    if (c->count == FSC_MAX_INFLIGHT && complete_one(c) < 0 && c->broken) return FS_ERR_IO;
+
+    uint32_t id = c->next_id++;
+    uint8_t hdr[FSP_REQ_HDR];
+    memset(hdr, 0, sizeof(hdr));
+    put_le(hdr, FSP_REQ_HDR - 4 + n1 + n2 + req->data_len, 4);
+    put_le(hdr + 4, id, 4);
+    hdr[8] = (uint8_t)req->op;
+    hdr[9] = (uint8_t)n1;
+    hdr[10] = (uint8_t)n2;
+    put_le(hdr + 12, (uint64_t)req->offset, 8);
+    put_le(hdr + 20, req->size, 4);
+    put_le(hdr + 24, req->arg, 4);
+
+    struct iovec iov[4] = {
+        { hdr, sizeof(hdr) }, { (void *)req->name, n1 }, { (void *)req->name2, n2 },
+        { (void *)req->data, req->data_len }
+    };
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = 4;
+    ssize_t sent = sendmsg(c->fd, &msg, MSG_NOSIGNAL);
+    if (sent < 0 && errno != EINTR) {
+        c->broken = 1;
+        FS_FAIL(FS_ERR_IO, "fsc_submit: connection lost");
+    }
+    // Kısa gönderimde kalanını parça parça yolla
+    size_t skip = sent > 0 ? (size_t)sent : 0;
+    for (int i = 0; i < 4; ++i) {
+        if (skip >= iov[i].iov_len) {
+            skip -= iov[i].iov_len;
+            continue;
+        }
+        if (io_all(c, (uint8_t *)iov[i].iov_base + skip, iov[i].iov_len - skip, 1) < 0) {
+            return FS_ERR_IO;
+        }
+        skip = 0;
+    }
+
+    unsigned slot = (c->head + c->count) % FSC_MAX_INFLIGHT;
+    c->inflight[slot] = req;
+    c->ids[slot] = id;
+    c->count++;
+    req->result = FS_ERR_IO;
+    return 0;
+}
+
+int fsc_wait(FsClient *c) {
+    if (!c) return FS_ERR_INVALID;
+    int rc = 0;
+    while (c->count) {
+        int r = complete_one(c);
+        if (r < 0) rc = r;
+    }
+    return rc;
+}
+
+void fsc_disconnect(FsClient *c) {
+    if (!c) return;
+    fsc_wait(c);
+    close(c->fd);
+    free(c);
+}
+
+// Tek isteği gönderip yanıtını bekler (önceden gönderilmiş istekler de tamamlanır)
+static int64_t call(FsClient *c, FsClientReq *req) {
+    int rc = fsc_submit(c, req);
+    if (rc < 0) return rc;
+    fsc_wait(c);
+    return req->result;
+}
+
+#define REQ(...) (FsClientReq){ __VA_ARGS__ }
+
+int fsc_format_mode(FsClient *c, uint32_t flags) {
+    FsClientReq r = REQ(.op = FSP_FORMAT, .arg = flags);
+    return (int)call(c, &r);
+}
+
+int fsc_create(FsClient *c, const char *filename) {
+    FsClientReq r = REQ(.op = FSP_CREATE, .name = filename);
+    return (int)call(c, &r);
+}
+
+int fsc_delete(FsClient *c, const char *filename) {
+    FsClientReq r = REQ(.op = FSP_DELETE, .name = filename);
+    return (int)call(c, &r);
+}
+
+ssize_t fsc_write(FsClient *c, const char *filename, const void *data, size_t size) {
+    FsClientReq r = REQ(.op = FSP_WRITE, .name = filename, .data = data, .data_len = size);
+    return (ssize_t)call(c, &r);
+}
+
+ssize_t fsc_read(FsClient *c, const char *filename, uint32_t offset, size_t size, void *buffer) {
+    if (size > FSP_MAX_DATA) size = FSP_MAX_DATA;
+    FsClientReq r = REQ(.op = FSP_READ, .name = filename, .offset = offset,
+                        .size = (uint32_t)size, .out = buffer);
+    return (ssize_t)call(c, &r);
+}
+
+ssize_t fsc_append(FsClient *c, const char *filename, const void *data, size_t size) {
+    FsClientReq r = REQ(.op = FSP_APPEND, .name = filename, .data = data, .data_len = size);
+    return (ssize_t)call(c, &r);
+}
+
+int fsc_size(FsClient *c, const char *filename, uint32_t *size_out) {
+    FsClientReq r = REQ(.op = FSP_SIZE, .name = filename, .out = size_out);
+    return (int)call(c, &r);
+}
+
+int fsc_exists(FsClient *c, const char *filename) {
+    FsClientReq r = REQ(.op = FSP_EXISTS, .name = filename);
+    return (int)call(c, &r);
+}
+
+int fsc_rename(FsClient *c, const char *old_name, const char *new_name) {
+    FsClientReq r = REQ(.op = FSP_RENAME, .name = old_name, .name2 = new_name);
+    return (int)call(c, &r);
+}
+
+int fsc_truncate(FsClient *c, const char *filename, uint32_t new_size) {
+    FsClientReq r = REQ(.op = FSP_TRUNCATE, .name = filename, .size = new_size);
+    return (int)call(c, &r);
+}
+
+int fsc_punch_hole(FsClient *c, const char *filename, uint32_t offset, uint32_t len) {
+    FsClientReq r = REQ(.op = FSP_PUNCH_HOLE, .name = filename, .offset = offset, .size = len);
+    return (int)call(c, &r);
+}
+
+int fsc_copy(FsClient *c, const char *src_filename, const char *dest_filename) {
+    FsClientReq r = REQ(.op = FSP_COPY, .name = src_filename, .name2 = dest_filename);
+    return (int)call(c, &r);
+}
+
+int fsc_mv(FsClient *c, const char *old_path, const char *new_path) {
+    FsClientReq r = REQ(.op = FSP_MV, .name = old_path, .name2 = new_path);
+    return (int)call(c, &r);
+}
+
+int fsc_list(FsClient *c, FileEntry *out, uint32_t max) {
+    if (!out && max) FS_FAIL(FS_ERR_INVALID, "fsc_list: invalid arguments");
+    FsClientReq r = REQ(.op = FSP_LIST, .size = max, .out = out);
+    return (int)call(c, &r);
+}
+
+int fsc_sync(FsClient *c) {
+    FsClientReq r = REQ(.op = FSP_SYNC);
+    return (int)call(c, &r);
+}
+
+int fsc_defragment(FsClient *c) {
+    FsClientReq r = REQ(.op = FSP_DEFRAGMENT);
+    return (int)call(c, &r);
+}
+
+int fsc_check_integrity(FsClient *c) {
+    FsClientReq r = REQ(.op = FSP_CHECK_INTEGRITY);
+    return (int)call(c, &r);
+}
+
+int fsc_open(FsClient *c, const char *filename, int flags) {
+    FsClientReq r = REQ(.op = FSP_OPEN, .name = filename, .arg = (uint32_t)flags);
+    return (int)call(c, &r);
+}
+
+int fsc_close(FsClient *c, int fd) {
+    FsClientReq r = REQ(.op = FSP_CLOSE, .arg = (uint32_t)fd);
+    return (int)call(c, &r);
+}
+
+ssize_t fsc_pread(FsClient *c, int fd, void *buffer, size_t size, uint32_t offset) {
+    if (size > FSP_MAX_DATA) size = FSP_MAX_DATA;
+    FsClientReq r = REQ(.op = FSP_PREAD, .arg = (uint32_t)fd, .offset = offset,
+                        .size = (uint32_t)size, .out = buffer);
+    return (ssize_t)call(c, &r);
+}
+
+ssize_t fsc_pwrite(FsClient *c, int fd, const void *data, size_t size, uint32_t offset) {
+    FsClientReq r = REQ(.op = FSP_PWRITE, .arg = (uint32_t)fd, .offset = offset,
+                        .data = data, .data_len = size);
+    return (ssize_t)call(c, &r);
+}
+
+ssize_t fsc_fread(FsClient *c, int fd, void *buffer, size_t size) {
+    if (size > FSP_MAX_DATA) size = FSP_MAX_DATA;
+    FsClientReq r = REQ(.op = FSP_FREAD, .arg = (uint32_t)fd, .size = (uint32_t)size, .out = buffer);
+    return (ssize_t)call(c, &r);
+}
+
+ssize_t fsc_fwrite(FsClient *c, int fd, const void *data, size_t size) {
+    FsClientReq r = REQ(.op = FSP_FWRITE, .arg = (uint32_t)fd, .data = data, .data_len = size);
+    return (ssize_t)call(c, &r);
+}
+
+int64_t fsc_seek(FsClient *c, int fd, int64_t offset, int whence) {
+    FsClientReq r = REQ(.op = FSP_SEEK, .arg = (uint32_t)fd, .offset = offset,
+                        .size = (uint32_t)whence);
+    return call(c, &r);
+}
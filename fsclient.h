@@ -0,0 +1,70 @@
+#ifndef FSCLIENT_H
+#define FSCLIENT_H
+
+#include <stdint.h>     // uint32_t
+#include <sys/types.h>  // ssize_t
+#include "disk.h"       // FileEntry
+#include "fserr.h"      // FsError
+
+// libsimplefsclient: simplefs sunucusuna (simplefs -S SOCKET) Unix soketiyle
+// bağlanan istemci. Fonksiyonlar fs.h'dekilerin aynısıdır, yalnızca ilk
+// argüman bağlantıdır; dönüş değerleri ve hata kodları sunucudaki çağrının
+// sonucudur. Bağlantı koptuysa FS_ERR_IO döner. Bir FsClient aynı anda tek
+// iş parçacığından kullanılmalıdır.
+typedef struct FsClient FsClient;
+
+#define FSC_MAX_INFLIGHT 64     // Yanıtı beklenmeden gönderilebilecek istek sayısı
+
+int  fsc_connect(const char *socket_path, FsClient **out);
+void fsc_disconnect(FsClient *c);
+
+int     fsc_format_mode(FsClient *c, uint32_t flags);
+int     fsc_create(FsClient *c, const char *filename);
+int     fsc_delete(FsClient *c, const char *filename);
+ssize_t fsc_write(FsClient *c, const char *filename, const void *data, size_t size);
+ssize_t fsc_read(FsClient *c, const char *filename, uint32_t offset, size_t size, void *buffer);
+ssize_t fsc_append(FsClient *c, const char *filename, const void *data, size_t size);
+int     fsc_size(FsClient *c, const char *filename, uint32_t *size_out);
+int     fsc_exists(FsClient *c, const char *filename);
+int     fsc_rename(FsClient *c, const char *old_name, const char *new_name);
+int     fsc_truncate(FsClient *c, const char *filename, uint32_t new_size);
+int     fsc_punch_hole(FsClient *c, const char *filename, uint32_t offset, uint32_t len);
+int     fsc_copy(FsClient *c, const char *src_filename, const char *dest_filename);
+int     fsc_mv(FsClient *c, const char *old_path, const char *new_path);
+int     fsc_list(FsClient *c, FileEntry *out, uint32_t max);
+int     fsc_sync(FsClient *c);
+int     fsc_defragment(FsClient *c);
+int     fsc_check_integrity(FsClient *c);
+
+// Tanıtıcılar sunucuda bağlantıya aittir ve bağlantı kapanınca kapatılır
+int     fsc_open(FsClient *c, const char *filename, int flags);
+int     fsc_close(FsClient *c, int fd);
+ssize_t fsc_pread(FsClient *c, int fd, void *buffer, size_t size, uint32_t offset);
+ssize_t fsc_pwrite(FsClient *c, int fd, const void *data, size_t size, uint32_t offset);
+ssize_t fsc_fread(FsClient *c, int fd, void *buffer, size_t size);
+ssize_t fsc_fwrite(FsClient *c, int fd, const void *data, size_t size);
+int64_t fsc_seek(FsClient *c, int fd, int64_t offset, int whence);
+
+// --- Ardışık (pipelined) istekler ---
+// fsc_submit isteği gönderir ve yanıtı beklemeden döner; istekler sunucuda
+// gönderildikleri sırayla çalışır. fsc_wait tüm bekleyen yanıtları alıp
+// her isteğin result (ve okuma için out) alanını doldurur. İstek yapısı ve
+// tamponları fsc_wait dönene kadar geçerli kalmalıdır. FSC_MAX_INFLIGHT
+// bekleyen istek varken fsc_submit önce en eskisinin yanıtını alır.
+typedef struct {
+    int         op;           // FSP_* (proto.h)
+    const char *name;
+    const char *name2;
+    int64_t     offset;
+    uint32_t    size;         // Okunacak bayt / yeni boyut / en fazla kayıt
+    uint32_t    arg;          // Tanıtıcı veya bayraklar
+    const void *data;         // Yazılacak veri (data_len bayt)
+    size_t      data_len;
+    void       *out;          // Okuma hedefi (size bayt), SIZE için uint32_t, LIST için FileEntry[]
+    int64_t     result;       // fsc_wait sonrasında
+} FsClientReq;
+
+int fsc_submit(FsClient *c, FsClientReq *req);
+int fsc_wait(FsClient *c);
+
+#endif // FSCLIENT_H
@@ -0,0 +1,46 @@
+// fserr.c — hata kodları ve kullanıcı günlük geri çağırması
+#include "fserr.h"
+
+#include <stdarg.h>
+#include <stdio.h>      // vsnprintf (yalnızca bellek içi biçimlendirme)
+
+#define FS_MSG_MAX 256
+
+FsLogCallback fs_log_callback = NULL;
+static void *fs_log_user = NULL;
+
+void fs_set_log_callback(FsLogCallback callback, void *user_data) {
+    fs_log_user = user_data;
+    fs_log_callback = callback;
+}
+
+void fs_emit(FsLogLevel level, const char *fmt, ...) {
+    FsLogCallback cb = fs_log_callback;
+    if (!cb) return;
+    char msg[FS_MSG_MAX];
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(msg, sizeof(msg), fmt, ap);
+    va_end(ap);
+    cb(level, msg, fs_log_user);
+}
+
+const char *fs_strerror(int code) {
+    switch (code) {
+        case FS_OK:                 return "success";
+        case FS_ERR_IO:             return "I/O error";
+        case FS_ERR_INVALID:        return "invalid argument";
+        case FS_ERR_NOT_FOUND:      return "file not found";
+        case FS_ERR_EXISTS:         return "file already exists";
+        case FS_ERR_NO_SPACE:       return "no space left on disk";
+        case FS_ERR_TOO_MANY_FILES: return "maximum number of files reached";
+        case FS_ERR_RANGE:          return "offset out of range";
+        case FS_ERR_NO_MEMORY:      return "out of memory";
+        case FS_ERR_CORRUPT:        return "corrupt file system";
+        case FS_ERR_UNSUPPORTED:    return "operation not supported";
+        case FS_ERR_BADF:           return "bad file handle";
+        case FS_ERR_TOO_MANY_OPEN:  return "too many open files";
+        case FS_ERR_BUSY:           return "image busy in another process";
+        default:                    return code >= 0 ? "success" : "unknown error";
+    }
+}
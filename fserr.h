@@ -0,0 +1,54 @@
+#ifndef FSERR_H
+#define FSERR_H
+
+// Hata kodları: fonksiyonlar başarıda >= 0, hatada aşağıdaki negatif
+// değerlerden birini döndürür (eski "-1 = hata" kontrolleri geçerliliğini korur)
+typedef enum {
+    FS_OK                  =   0,
+    FS_ERR_IO              =  -1,   // Disk imajı / ana makine dosyası G/Ç hatası
+    FS_ERR_INVALID         =  -2,   // Geçersiz argüman veya dosya adı
+    FS_ERR_NOT_FOUND       =  -3,   // Dosya yok
+    FS_ERR_EXISTS          =  -4,   // Hedef dosya zaten var
+    FS_ERR_NO_SPACE        =  -5,   // Veri bölgesi dolu
+    FS_ERR_TOO_MANY_FILES  =  -6,   // MAX_FILES sınırına ulaşıldı
+    FS_ERR_RANGE           =  -7,   // Offset dosya boyutunun dışında
+    FS_ERR_NO_MEMORY       =  -8,   // Bellek ayrılamadı
+    FS_ERR_CORRUPT         =  -9,   // Metadata veya çeviri tablosu tutarsız
+    FS_ERR_UNSUPPORTED     = -10,   // Özellik bu disk/modda kullanılamaz
+    FS_ERR_BADF            = -11,   // Geçersiz veya izinsiz dosya tanıtıcısı
+    FS_ERR_TOO_MANY_OPEN   = -12,   // Açık dosya tablosu dolu
+    FS_ERR_BUSY            = -13    // İmajın kirası başka süreçte bırakılmadı (bkz. share.h)
+} FsError;
+
+typedef enum {
+    FS_LOG_ERROR = 0,    // Başarısız işlemin nedeni
+    FS_LOG_INFO  = 1     // Başarılı işlem için ilerleme satırı
+} FsLogLevel;
+
+// Kullanıcının tanımladığı günlük fonksiyonu; mesajın sonunda satır sonu yoktur.
+// Arka plan iş parçacıklarından da çağrılabilir.
+typedef void (*FsLogCallback)(FsLogLevel level, const char *message, void *user_data);
+
+// Geri çağırma kurulmazsa kütüphane hiçbir şey yazdırmaz (NULL = kapat)
+void fs_set_log_callback(FsLogCallback callback, void *user_data);
+
+// Hata kodunun kısa açıklaması
+const char *fs_strerror(int code);
+
+// --- Kütüphane içi kullanım -------------------------------------------------
+// Mesajlar yalnızca bir geri çağırma kuruluysa biçimlendirilir; aksi halde
+// her çağrının maliyeti tek bir dal.
+extern FsLogCallback fs_log_callback;
+
+void fs_emit(FsLogLevel level, const char *fmt, ...)
+    __attribute__((format(printf, 2, 3)));
+
+#define FS_ERROR(...) \
+    do { if (fs_log_callback) fs_emit(FS_LOG_ERROR, __VA_ARGS__); } while (0)
+#define FS_INFO(...) \
+    do { if (fs_log_callback) fs_emit(FS_LOG_INFO, __VA_ARGS__); } while (0)
+
+// Hata mesajını bildir ve kodu döndür
+#define FS_FAIL(code, ...) do { FS_ERROR(__VA_ARGS__); return (code); } while (0)
+
+#endif // FSERR_H
@@ -0,0 +1,615 @@
+// lfs.c — günlük yapılı veri bölgesi, checkpoint'ler ve segment temizleyici
+//
+// Tüm durum (eşleme, ters eşleme, segment sayaçları) bellektedir ve tek bir
+// kilitle korunur; temizleyici iş parçacığı da aynı kilidi alır. Ters eşleme
+// (rev) her fiziksel bloğun sahibini tutar: veri bloğu için lba + 1, tablo
+// bloğu için REV_MAP | blok numarası, ölü ya da hiç yazılmamış blok için 0.
+// Temizleyici bir segmentin canlı bloklarını buradan bulur; diskte ayrıca
+// segment özeti tutulmaz.
+#define _POSIX_C_SOURCE 200809L
+
+#include "lfs.h"
+#include "trim.h"
+#include "fserr.h"
+
+#include <pthread.h>
+#include <stddef.h>     // offsetof
+#include <string.h>
+
+#define LOG_FIRST   LFS_CP_BLOCKS                 // İlk segmentin ilk bloğu
+#define LOG_END     (LOG_FIRST + LFS_SEGMENTS * LFS_SEG_BLOCKS)
+#define CP_MAGIC    0x3153464Cu                   // "LFS1"
+#define REV_MAP     0x80000000u
+#define NO_SEGMENT  UINT32_MAX
+#define MIN_DEAD    (LFS_SEG_BLOCKS / 8)          // Daha az ölü bloğu olan segment temizlenmez
+
+typedef struct {
+    uint32_t magic;
+    uint32_t head_seg;          // Günlük başı: segment ve içindeki sıradaki blok
+    uint64_t seq;               // Kayıt seq % 2 numaralı bloğa yazılır
+    uint32_t head_off;
+    uint32_t map_loc[LFS_MAP_BLOCKS];  // Tablo bloklarının yeri (0 = hiç yazılmadı, boş)
+    uint32_t sum;               // Önceki alanların FNV-1a özeti
+} Checkpoint;
+
+_Static_assert(sizeof(Checkpoint) <= BLOCK_SIZE, "checkpoint record must fit in one block");
+_Static_assert(LFS_MAP_BLOCKS * LFS_MAP_ENTRIES_PER_BLOCK >= DATA_BLOCKS, "map must cover the data region");
+
+static int      loaded;
+static uint32_t map[LFS_MAP_BLOCKS * LFS_MAP_ENTRIES_PER_BLOCK];  // mantıksal -> fiziksel (0 = eşlenmemiş)
+static uint32_t rev[DATA_BLOCKS];
+static uint32_t map_loc[LFS_MAP_BLOCKS];
+static uint8_t  map_dirty[LFS_MAP_BLOCKS];
+static uint16_t seg_live[LFS_SEGMENTS];
+static uint8_t  seg_used[LFS_SEGMENTS];           // 0 = temiz (yeniden yazılabilir)
+static uint32_t nclean;
+static uint32_t head_seg, head_off;
+static uint64_t cp_seq;
+static uint32_t segs_since_cp;
+static int      cp_dirty;                         // Son checkpoint'ten sonra değişiklik var
+static LfsStats st;
+
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  work = PTHREAD_COND_INITIALIZER;
+static pthread_t       cleaner;
+static int             started, stopping, wake;
+
+static int clean_locked(uint32_t target);
+
+static uint32_t seg_first(uint32_t seg) {
+    return LOG_FIRST + seg * LFS_SEG_BLOCKS;
+}
+
+static uint32_t seg_of(uint32_t pblock) {
+    return (pblock - LOG_FIRST) / LFS_SEG_BLOCKS;
+}
+
+static uint32_t cp_sum(const Checkpoint *cp) {
+    const uint8_t *p = (const uint8_t *)cp;
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < offsetof(Checkpoint, sum); ++i) {
+        h ^= p[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static void kill_block(uint32_t pblock) {
+    if (!pblock) return;
+    rev[pblock] = 0;
+    seg_live[seg_of(pblock)]--;
+}
+
+// pblock artık owner'ın (rev[] biçiminde) güncel kopyası; eskisi ölür
+static void assign(uint32_t owner, uint32_t pblock) {
+    if (owner & REV_MAP) {
+        uint32_t b = owner & ~REV_MAP;
+        kill_block(map_loc[b]);
+        map_loc[b] = pblock;
+    } else {
+        uint32_t lba = owner - 1;
+        kill_block(map[lba]);
+        map[lba] = pblock;
+        map_dirty[lba / LFS_MAP_ENTRIES_PER_BLOCK] = 1;
+    }
+    rev[pblock] = owner;
+    seg_live[seg_of(pblock)]++;
+}
+
+static void *cleaner_main(void *arg);
+
+// Günlük başını sıradaki temiz segmente taşır (yazımlar diskte ileriye doğru
+// ilerlesin diye arama mevcut segmentten sonra başlar). reserve değilse son
+// LFS_RESERVE_SEGS temiz segment kullanılmaz. Temizleyiciyi yalnızca yazım
+// yolu uyandırır; temizleyici kendi yazımlarıyla kendini yeniden uyandırmaz.
+static int next_segment(int reserve) {
+    if (nclean <= (reserve ? 0u : LFS_RESERVE_SEGS)) return FS_ERR_NO_SPACE;
+    for (uint32_t i = 1; i <= LFS_SEGMENTS; ++i) {
+        uint32_t s = (head_seg + i) % LFS_SEGMENTS;
+        if (seg_used[s]) continue;
+        seg_used[s] = 1;
+        nclean--;
+        head_seg = s;
+        head_off = 0;
+        segs_since_cp++;
+        if (!reserve && nclean < LFS_CLEAN_LOW) {
+            if (!started && pthread_create(&cleaner, NULL, cleaner_main, NULL) == 0) started = 1;
+            wake = 1;
+            pthread_cond_signal(&work);
+        }
+        return 0;
+    }
+    return FS_ERR_NO_SPACE;
+}
+
+// Günlük başında yazım yeri hazırlar. Yazım yolu (reserve = 0) ayrılmış
+// segmentlere dokunmaz; temizleyici onları kullanmaya başladıysa mevcut
+// segmentin kalanı da checkpoint'e bırakılır.
+static int log_room(int reserve) {
+    if (head_off < LFS_SEG_BLOCKS) {
+        return reserve || nclean >= LFS_RESERVE_SEGS ? 0 : FS_ERR_NO_SPACE;
+    }
+    return next_segment(reserve);
+}
+
+// n bloğu günlük başına yazar; i. bloğun sahibi owner0 + i. Yazılabilen blok
+// sayısını döner, hiç yazılamadıysa hata. Yazım yolu yer bulamazsa önce
+// kendisi temizlik yapar.
+static int log_append(uint32_t owner0, uint32_t n, const uint8_t *buf, int reserve) {
+    uint32_t done = 0;
+    while (done < n) {
+        int rc = log_room(reserve);
+        if (rc < 0 && !reserve) {
+            if ((rc = clean_locked(LFS_RESERVE_SEGS + 1)) == 0) rc = log_room(0);
+            if (rc == 0) st.cleaner_waits++;
+        }
+        if (rc < 0) {
+            if (done) return (int)done;
+            if (rc == FS_ERR_NO_SPACE) FS_FAIL(rc, "lfs: log is full (%u clean segments)", nclean);
+            return rc;
+        }
+        uint32_t k = n - done;
+        if (k > LFS_SEG_BLOCKS - head_off) k = LFS_SEG_BLOCKS - head_off;
+        uint32_t pb = seg_first(head_seg) + head_off;
+        rc = disk_phys_write(pb, k, buf + (size_t)done * BLOCK_SIZE);
+        if (rc < 0) return done ? (int)done : rc;
+        for (uint32_t i = 0; i < k; ++i) assign(owner0 + done + i, pb + i);
+        head_off += k;
+        done += k;
+        st.log_blocks += k;
+        cp_dirty = 1;
+    }
+    return (int)done;
+}
+
+// Günlük başı dışında, canlı bloğu kalmamış ama henüz temiz sayılmayan segmentler
+static uint32_t freed_segments(void) {
+    uint32_t n = 0;
+    for (uint32_t s = 0; s < LFS_SEGMENTS; ++s) {
+        if (seg_used[s] && s != head_seg && seg_live[s] == 0) n++;
+    }
+    return n;
+}
+
+// Son checkpoint'ten sonra boşalmış segmentleri temiz işaretler ve imajda
+// delinmeye bırakır; diskteki hiçbir checkpoint artık onlara işaret etmez
+static void recycle_locked(void) {
+    for (uint32_t s = 0; s < LFS_SEGMENTS; ++s) {
+        if (seg_used[s] && s != head_seg && seg_live[s] == 0) {
+            seg_used[s] = 0;
+            nclean++;
+            trim_queue(LOG_FIRST + s * LFS_SEG_BLOCKS, LFS_SEG_BLOCKS);
+        }
+    }
+}
+
+// Değişen tablo bloklarını günlüğe, ardından kaydı sıradaki checkpoint
+// bloğuna yazar; kayıt yazıldıktan sonra boşalmış segmentler geri kazanılır
+static int checkpoint_locked(void) {
+    if (!cp_dirty) {
+        recycle_locked();       // Diskteki kayıt bellekteki durumla aynı
+        return 0;
+    }
+    for (uint32_t b = 0; b < LFS_MAP_BLOCKS; ) {
+        if (!map_dirty[b]) {
+            b++;
+            continue;
+        }
+        uint32_t n = 1;
+        while (b + n < LFS_MAP_BLOCKS && map_dirty[b + n]) n++;
+        int w = log_append(REV_MAP | b, n, (const uint8_t *)map + (size_t)b * BLOCK_SIZE, 1);
+        if (w < 0) FS_FAIL(w, "lfs_checkpoint: map block %u write failed", b);
+        memset(&map_dirty[b], 0, (size_t)w);
+        b += (uint32_t)w;
+    }
+
+    uint8_t block[BLOCK_SIZE] = { 0 };
+    Checkpoint *cp = (Checkpoint *)block;
+    cp->magic    = CP_MAGIC;
+    cp->seq      = cp_seq + 1;
+    cp->head_seg = head_seg;
+    cp->head_off = head_off;
+    memcpy(cp->map_loc, map_loc, sizeof(map_loc));
+    cp->sum      = cp_sum(cp);
+    int rc = disk_phys_write((uint32_t)(cp->seq % 2), 1, block);
+    if (rc < 0) FS_FAIL(rc, "lfs_checkpoint: record write failed");
+
+    cp_seq++;
+    segs_since_cp = 0;
+    cp_dirty = 0;
+    st.checkpoints++;
+    recycle_locked();
+    return 0;
+}
+
+// En az canlı bloğu olan dolu segmentin canlı bloklarını günlük başına taşır.
+// Tablo blokları bellekteki güncel halleriyle yeniden yazılır; eski kopya bir
+// sonraki checkpoint'e kadar yerinde kalır. Ölü bloğu MIN_DEAD'den az segment
+// seçilmez. Taşıyacak segment ya da yer yoksa 0, taşındıysa 1 döner.
+static int clean_step(void) {
+    static uint8_t seg_buf[LFS_SEG_BLOCKS * BLOCK_SIZE];
+    uint32_t victim = NO_SEGMENT;
+    for (uint32_t s = 0; s < LFS_SEGMENTS; ++s) {
+        if (!seg_used[s] || s == head_seg || seg_live[s] == 0) continue;
+        if (victim == NO_SEGMENT || seg_live[s] < seg_live[victim]) victim = s;
+    }
+    if (victim == NO_SEGMENT || seg_live[victim] > LFS_SEG_BLOCKS - MIN_DEAD) return 0;
+    uint64_t room = (uint64_t)(LFS_SEG_BLOCKS - head_off) + (uint64_t)nclean * LFS_SEG_BLOCKS;
+    if (room < (uint64_t)seg_live[victim] + LFS_MAP_BLOCKS) return 0;
+
+    uint32_t first = seg_first(victim);
+    int rc = disk_phys_read(first, LFS_SEG_BLOCKS, seg_buf);
+    if (rc < 0) FS_FAIL(rc, "lfs: cleaner cannot read segment %u", victim);
+    for (uint32_t j = 0; j < LFS_SEG_BLOCKS; ) {
+        uint32_t owner = rev[first + j];
+        if (!owner) {
+            j++;
+            continue;
+        }
+        const uint8_t *src = seg_buf + (size_t)j * BLOCK_SIZE;
+        uint32_t n = 1;
+        if (owner & REV_MAP) {
+            uint32_t b = owner & ~REV_MAP;
+            src = (const uint8_t *)map + (size_t)b * BLOCK_SIZE;
+            map_dirty[b] = 0;
+        } else {
+            while (j + n < LFS_SEG_BLOCKS && rev[first + j + n] == owner + n) n++;
+        }
+        int w = log_append(owner, n, src, 1);
+        if (w < 0) return w;
+        st.moved_blocks += (uint32_t)w;
+        j += (uint32_t)w;
+    }
+    cp_dirty = 1;
+    st.cleaned_segments++;
+    return 1;
+}
+
+// Günlüğün yazılabilir kısmı: temiz segmentler ve mevcut segmentin kalanı
+static uint32_t log_free(void) {
+    return nclean * LFS_SEG_BLOCKS + (LFS_SEG_BLOCKS - head_off);
+}
+
+// Temiz segment sayısını target'a doğru bir adım ilerletir: bir segment
+// temizlenir, taşıma yeri kalmadıysa boşalmış segmentler checkpoint ile geri
+// kazanılır. Checkpoint'ler böylece seyrek kalır ve taşınan blokların kirlettiği
+// tablo blokları birkaç segment için bir kez yazılır. Taşınanlar ve tablo
+// boşalandan fazla yer tuttuysa (ölü bloklar segmentlere çok dağınık) temizlik
+// durur; *mark önceki checkpoint'teki log_free değeridir. İlerleme olduysa 1,
+// hedefe ulaşıldıysa ya da yapılacak bir şey kalmadıysa 0 döner.
+static int clean_once(uint32_t target, uint32_t *mark) {
+    uint32_t freed = freed_segments();
+    if (nclean + freed >= target) return 0;
+    int rc = clean_step();
+    if (rc == 0 && freed) {
+        if ((rc = checkpoint_locked()) < 0) return rc;
+        uint32_t now = log_free();
+        rc = now > *mark;
+        *mark = now;
+    }
+    return rc;
+}
+
+// Temiz segment sayısı target'a ulaşana kadar temizler, ardından checkpoint alır
+static int clean_locked(uint32_t target) {
+    uint32_t mark = log_free();
+    for (uint32_t round = 0; round < 2 * LFS_SEGMENTS; ++round) {
+        int rc = clean_once(target, &mark);
+        if (rc < 0) return rc;
+        if (rc == 0) break;
+    }
+    return checkpoint_locked();
+}
+
+// Arka plan temizleyicisi: günlük başı yeni bir segmente geçtiğinde temiz
+// segment LFS_CLEAN_LOW'un altındaysa uyandırılır. Segmentler arasında kilit
+// bırakılır, böylece yazımlar uzun süre beklemez.
+static void *cleaner_main(void *arg) {
+    (void)arg;
+    pthread_mutex_lock(&lock);
+    for (;;) {
+        while (!stopping && !wake) pthread_cond_wait(&work, &lock);
+        if (stopping) break;
+        wake = 0;
+        int rc = 0;
+        uint32_t mark = log_free();
+        for (uint32_t round = 0; loaded && !stopping && round < 2 * LFS_SEGMENTS; ++round) {
+            if ((rc = clean_once(LFS_CLEAN_HIGH, &mark)) <= 0) break;
+            pthread_mutex_unlock(&lock);
+            pthread_mutex_lock(&lock);
+        }
+        if (loaded && rc >= 0) rc = checkpoint_locked();
+        if (rc < 0) FS_ERROR("lfs: background cleaner failed (%s)", fs_strerror(rc));
+    }
+    pthread_mutex_unlock(&lock);
+    return NULL;
+}
+
+void lfs_shutdown(void) {
+    pthread_mutex_lock(&lock);
+    if (!started) {
+        pthread_mutex_unlock(&lock);
+        return;
+    }
+    stopping = 1;
+    pthread_cond_signal(&work);
+    pthread_mutex_unlock(&lock);
+    pthread_join(cleaner, NULL);
+    pthread_mutex_lock(&lock);
+    started = stopping = wake = 0;
+    pthread_mutex_unlock(&lock);
+}
+
+int lfs_is_loaded(void) {
+    return loaded;
+}
+
+int lfs_pending(void) {
+    pthread_mutex_lock(&lock);
+    int pending = loaded && (cp_dirty || started);
+    pthread_mutex_unlock(&lock);
+    return pending;
+}
+
+static void reset_locked(void) {
+    memset(map, 0, sizeof(map));
+    memset(rev, 0, sizeof(rev));
+    memset(map_loc, 0, sizeof(map_loc));
+    memset(map_dirty, 0, sizeof(map_dirty));
+    memset(seg_live, 0, sizeof(seg_live));
+    memset(seg_used, 0, sizeof(seg_used));
+    nclean = head_seg = head_off = segs_since_cp = 0;
+    cp_seq = 0;
+    cp_dirty = 0;
+    loaded = 0;
+}
+
+void lfs_unload(void) {
+    lfs_shutdown();
+    pthread_mutex_lock(&lock);
+    reset_locked();
+    pthread_mutex_unlock(&lock);
+}
+
+// Fiziksel bloğu sahibine bağlar; yükleme sırasında bozuk kayıtları yakalar
+static int load_claim(uint32_t owner, uint32_t pblock) {
+    if (pblock < LOG_FIRST || pblock >= LOG_END || rev[pblock]) return -1;
+    rev[pblock] = owner;
+    seg_live[seg_of(pblock)]++;
+    return 0;
+}
+
+static int load_locked(void) {
+    uint8_t slots[2][BLOCK_SIZE];
+    int rc = disk_phys_read(0, 2, slots);
+    if (rc < 0) FS_FAIL(rc, "lfs_load: checkpoint read failed");
+
+    // Geçerli kayıtlardan yenisi; hiç yoksa imaj yeni formatlanmıştır
+    const Checkpoint *cp = NULL;
+    for (int i = 0; i < 2; ++i) {
+        const Checkpoint *c = (const Checkpoint *)slots[i];
+        if (c->magic != CP_MAGIC || c->sum != cp_sum(c) || c->seq % 2 != (uint64_t)i) continue;
+        if (c->head_seg >= LFS_SEGMENTS || c->head_off > LFS_SEG_BLOCKS) continue;
+        if (!cp || c->seq > cp->seq) cp = c;
+    }
+    reset_locked();
+    if (cp) {
+        cp_seq   = cp->seq;
+        head_seg = cp->head_seg;
+        head_off = cp->head_off;
+        for (uint32_t b = 0; b < LFS_MAP_BLOCKS; ++b) {
+            uint32_t pb = cp->map_loc[b];
+            if (!pb) continue;
+            if (load_claim(REV_MAP | b, pb) < 0) {
+                reset_locked();
+                FS_FAIL(FS_ERR_CORRUPT, "lfs_load: corrupt map block location %u -> %u", b, pb);
+            }
+            map_loc[b] = pb;
+            if ((rc = disk_phys_read(pb, 1, (uint8_t *)map + (size_t)b * BLOCK_SIZE)) < 0) {
+                reset_locked();
+                FS_FAIL(rc, "lfs_load: map block %u read failed", b);
+            }
+        }
+    }
+    for (uint32_t lba = 0; lba < DATA_BLOCKS; ++lba) {
+        if (map[lba] && load_claim(lba + 1, map[lba]) < 0) {
+            uint32_t pb = map[lba];
+            reset_locked();
+            FS_FAIL(FS_ERR_CORRUPT, "lfs_load: corrupt map entry %u -> %u", lba, pb);
+        }
+    }
+    memset(map + DATA_BLOCKS, 0, sizeof(map) - DATA_BLOCKS * sizeof(map[0]));
+    for (uint32_t s = 0; s < LFS_SEGMENTS; ++s) {
+        seg_used[s] = seg_live[s] > 0 || s == head_seg;
+        if (!seg_used[s]) nclean++;
+    }
+    loaded = 1;
+    return 0;
+}
+
+int lfs_load(void) {
+    pthread_mutex_lock(&lock);
+    int rc = loaded ? 0 : load_locked();
+    pthread_mutex_unlock(&lock);
+    return rc;
+}
+
+// count bloğu eşlemeye göre okur; fiziksel olarak ardışık bloklar tek okuma
+static int read_locked(uint32_t lba, uint32_t count, uint8_t *out) {
+    for (uint32_t i = 0; i < count; ) {
+        uint32_t pb = map[lba + i], n = 1;
+        if (!pb) {
+            while (i + n < count && !map[lba + i + n]) n++;
+            memset(out + (size_t)i * BLOCK_SIZE, 0, (size_t)n * BLOCK_SIZE);
+        } else {
+            while (i + n < count && map[lba + i + n] == pb + n) n++;
+            int rc = disk_phys_read(pb, n, out + (size_t)i * BLOCK_SIZE);
+            if (rc < 0) return rc;
+        }
+        i += n;
+    }
+    return 0;
+}
+
+static int check_range(uint64_t offset, uint64_t len) {
+    return offset <= DATA_SIZE && len <= DATA_SIZE - offset;
+}
+
+int lfs_read(uint64_t offset, void *buffer, size_t size) {
+    if (!check_range(offset, size)) return FS_ERR_RANGE;
+    uint8_t block[BLOCK_SIZE];
+    uint8_t *out = buffer;
+    int rc = 0;
+    pthread_mutex_lock(&lock);
+    while (size > 0 && rc == 0) {
+        uint32_t lba = (uint32_t)(offset / BLOCK_SIZE);
+        size_t in_block = offset % BLOCK_SIZE;
+        size_t chunk;
+        if (in_block == 0 && size >= BLOCK_SIZE) {
+            chunk = size - size % BLOCK_SIZE;
+            rc = read_locked(lba, (uint32_t)(chunk / BLOCK_SIZE), out);
+        } else {
+            chunk = BLOCK_SIZE - in_block < size ? BLOCK_SIZE - in_block : size;
+            if ((rc = read_locked(lba, 1, block)) == 0) memcpy(out, block + in_block, chunk);
+        }
+        offset += chunk;
+        out += chunk;
+        size -= chunk;
+    }
+    pthread_mutex_unlock(&lock);
+    return rc;
+}
+
+// Belirli aralıkta checkpoint (bkz. lfs.h); kilit tutulurken
+static int after_write_locked(int rc) {
+    if (segs_since_cp >= LFS_CP_INTERVAL) {
+        int crc = checkpoint_locked();
+        if (rc >= 0 && crc < 0) rc = crc;
+    }
+    return rc;
+}
+
+ssize_t lfs_write(uint64_t offset, const void *buffer, size_t size) {
+    if (!check_range(offset, size)) return FS_ERR_NO_SPACE;
+    uint8_t block[BLOCK_SIZE];
+    const uint8_t *in = buffer;
+    size_t done = 0;
+    int rc = 0;
+    pthread_mutex_lock(&lock);
+    while (done < size) {
+        uint64_t pos = offset + done;
+        uint32_t lba = (uint32_t)(pos / BLOCK_SIZE);
+        size_t in_block = pos % BLOCK_SIZE;
+        if (in_block == 0 && size - done >= BLOCK_SIZE) {
+            uint32_t n = (uint32_t)((size - done) / BLOCK_SIZE);
+            int w = log_append(lba + 1, n, in + done, 0);
+            if (w < 0) {
+                rc = w;
+                break;
+            }
+            st.user_blocks += (uint32_t)w;
+            done += (size_t)w * BLOCK_SIZE;
+            if ((uint32_t)w < n) break;
+            continue;
+        }
+        // Kısmi blok: oku-değiştir-yaz
+        size_t chunk = BLOCK_SIZE - in_block < size - done ? BLOCK_SIZE - in_block : size - done;
+        if ((rc = read_locked(lba, 1, block)) < 0) break;
+        memcpy(block + in_block, in + done, chunk);
+        if ((rc = log_append(lba + 1, 1, block, 0)) < 0) break;
+        st.user_blocks++;
+        done += chunk;
+    }
+    rc = after_write_locked(rc);
+    pthread_mutex_unlock(&lock);
+    if (done) return (ssize_t)done;
+    return rc < 0 ? rc : 0;
+}
+
+static void discard_locked(uint32_t lba, uint32_t count) {
+    for (uint32_t i = 0; i < count && lba + i < DATA_BLOCKS; ++i) {
+        uint32_t pb = map[lba + i];
+        if (!pb) continue;
+        kill_block(pb);
+        map[lba + i] = 0;
+        map_dirty[(lba + i) / LFS_MAP_ENTRIES_PER_BLOCK] = 1;
+        cp_dirty = 1;
+    }
+}
+
+int lfs_discard(uint32_t lba, uint32_t count) {
+    pthread_mutex_lock(&lock);
+    discard_locked(lba, count);
+    pthread_mutex_unlock(&lock);
+    return 0;
+}
+
+// Kısmi bloklar eşlenmişse sıfırlanıp yeniden yazılır; eşlenmemiş blok zaten sıfırdır
+int lfs_zero(uint64_t offset, uint64_t len) {
+    if (!check_range(offset, len)) return FS_ERR_NO_SPACE;
+    uint8_t block[BLOCK_SIZE];
+    int rc = 0;
+    pthread_mutex_lock(&lock);
+    while (len > 0 && rc == 0) {
+        uint32_t lba = (uint32_t)(offset / BLOCK_SIZE);
+        size_t in_block = offset % BLOCK_SIZE;
+        uint64_t chunk;
+        if (in_block == 0 && len >= BLOCK_SIZE) {
+            chunk = len - len % BLOCK_SIZE;
+            discard_locked(lba, (uint32_t)(chunk / BLOCK_SIZE));
+        } else {
+            chunk = BLOCK_SIZE - in_block < len ? BLOCK_SIZE - in_block : len;
+            if (map[lba] && (rc = read_locked(lba, 1, block)) == 0) {
+                memset(block + in_block, 0, (size_t)chunk);
+                int w = log_append(lba + 1, 1, block, 0);
+                if (w < 0) rc = w;
+            }
+        }
+        offset += chunk;
+        len -= chunk;
+    }
+    rc = after_write_locked(rc);
+    pthread_mutex_unlock(&lock);
+    return rc;
+}
+
+int lfs_is_mapped(uint32_t lba) {
+    pthread_mutex_lock(&lock);
+    int mapped = lba < DATA_BLOCKS && map[lba] != 0;
+    pthread_mutex_unlock(&lock);
+    return mapped;
+}
+
+int lfs_checkpoint(void) {
+    pthread_mutex_lock(&lock);
+    int rc = loaded ? checkpoint_locked() : 0;
+    pthread_mutex_unlock(&lock);
+    return rc;
+}
+
+void lfs_get_stats(LfsStats *out) {
+    pthread_mutex_lock(&lock);
+    *out = st;
+    out->segments        = LFS_SEGMENTS;
+    out->capacity_blocks = (LFS_SEGMENTS - LFS_RESERVE_SEGS) * LFS_SEG_BLOCKS - LFS_MAP_BLOCKS;
+    if (loaded) {
+        out->clean_segments = nclean;
+        for (uint32_t lba = 0; lba < DATA_BLOCKS; ++lba) {
+            if (map[lba]) out->live_blocks++;
+        }
+    }
+    out->write_amp = st.user_blocks ? (double)st.log_blocks / st.user_blocks : 1.0;
+    pthread_mutex_unlock(&lock);
+}
+
+void lfs_reset_stats(void) {
+    pthread_mutex_lock(&lock);
+    memset(&st, 0, sizeof(st));
+    pthread_mutex_unlock(&lock);
+}
+
+// Program bittiğinde temizleyiciyi durdur (checkpoint disk.c'nin çıkışında alınır)
+__attribute__((destructor))
+static void cleanup_lfs(void) {
+    lfs_shutdown();
+}
@@ -0,0 +1,77 @@
+#ifndef LFS_H
+#define LFS_H
+
+#include <stdint.h>     // uint32_t, uint64_t
+#include <stddef.h>     // size_t
+#include <sys/types.h>  // ssize_t
+#include "disk.h"       // BLOCK_SIZE, DATA_BLOCKS
+
+// Günlük yapılı (log-structured) veri bölgesi: dosya sistemi mantıksal blok
+// adresleriyle çalışmaya devam eder, her yazım ise günlüğün başına (head)
+// eklenir ve mantıksal -> fiziksel eşleme bellekte güncellenir. Bir bloğun
+// üzerine yazmak eski fiziksel kopyasını ölü bırakır; veri bölgesine giden
+// yazımlar böylece sıralı olur.
+//
+// Fiziksel düzen: ilk LFS_CP_BLOCKS blok iki checkpoint kaydına ayrılır
+// (0. ve 1. blok, sırayla yazılır; kalanı günlüğü 4 KB sınırından başlatır),
+// ardından LFS_SEG_BLOCKS bloklu LFS_SEGMENTS segment gelir. Eşleme tablosu
+// LFS_MAP_BLOCKS bloktur ve checkpoint'te yalnızca değişen blokları
+// günlüğe yazılır; kayıt tablonun bloklarının yerini ve günlük başını tutar.
+// Checkpoint her LFS_CP_INTERVAL segmentte, lfs_checkpoint çağrısında ve
+// temizlikten sonra alınır; son checkpoint'ten sonraki yazımlar çökme
+// durumunda kaybolur (eski içerik okunur).
+//
+// Boşalan segment ancak bir sonraki checkpoint'ten sonra yeniden kullanılır,
+// böylece diskteki checkpoint'in gösterdiği bloklar hiçbir zaman üzerine
+// yazılmaz. Temiz segment sayısı LFS_CLEAN_LOW'un altına düşünce arka plan
+// temizleyicisi en az canlı bloğu olan segmentlerin canlı bloklarını günlük
+// başına taşır ve LFS_CLEAN_HIGH'a ulaşana kadar segment geri kazanır.
+// LFS_RESERVE_SEGS segment yalnızca temizleyiciye ve checkpoint'e ayrılır;
+// yazım yeri bulamazsa temizlik yazım yolunda yapılır, yine yer yoksa
+// FS_ERR_NO_SPACE döner. Ölü bloklar segmentlere çok dağınıksa (imaj
+// neredeyse dolu) taşıma yer kazandırmaz ve temizlik durur.
+#define LFS_CP_BLOCKS      8
+#define LFS_SEG_BLOCKS     32
+#define LFS_SEGMENTS       ((DATA_BLOCKS - LFS_CP_BLOCKS) / LFS_SEG_BLOCKS)
+#define LFS_MAP_ENTRIES_PER_BLOCK (BLOCK_SIZE / sizeof(uint32_t))
+#define LFS_MAP_BLOCKS \
+    ((DATA_BLOCKS + LFS_MAP_ENTRIES_PER_BLOCK - 1) / LFS_MAP_ENTRIES_PER_BLOCK)
+#define LFS_CP_INTERVAL    8
+#define LFS_RESERVE_SEGS   2
+#define LFS_CLEAN_LOW      6
+#define LFS_CLEAN_HIGH     12
+
+typedef struct {
+    uint32_t segments;          // Toplam segment
+    uint32_t clean_segments;    // Yeniden yazılabilir segment
+    uint32_t live_blocks;       // Canlı veri blokları
+    uint32_t capacity_blocks;   // Veri için kullanılabilir blok (ayrılmış segmentler ve tablo hariç)
+    uint64_t user_blocks;       // Çağıranların yazdığı bloklar
+    uint64_t log_blocks;        // Günlüğe yazılan tüm bloklar (veri + taşınan + tablo)
+    uint64_t moved_blocks;      // Temizleyicinin taşıdığı canlı bloklar
+    uint64_t cleaned_segments;  // Temizlenerek geri kazanılan segmentler
+    uint64_t cleaner_waits;     // Yazım yolunda yapılmak zorunda kalan temizlikler
+    uint64_t checkpoints;
+    double   write_amp;         // log_blocks / user_blocks
+} LfsStats;
+
+int  lfs_load(void);                // Son geçerli checkpoint'ten eşlemeyi kur
+void lfs_unload(void);              // Bellekteki durumu bırak (checkpoint yazmadan)
+int  lfs_is_loaded(void);
+int  lfs_pending(void);             // Checkpoint'e yazılmamış değişiklik ya da çalışan temizleyici var
+void lfs_shutdown(void);            // Temizleyiciyi durdur (durum yüklü kalır, gerekince yeniden başlar)
+
+// Veri bölgesine göre bayt aralığı G/Ç; eşlenmemiş bloklar sıfır okunur.
+// lfs_write kısmi blokları oku-değiştir-yaz ile tamamlar, yazılan bayt
+// sayısını döner (yer biterse kısa kalabilir).
+int     lfs_read(uint64_t offset, void *buffer, size_t size);
+ssize_t lfs_write(uint64_t offset, const void *buffer, size_t size);
+int     lfs_zero(uint64_t offset, uint64_t len);        // Tam bloklar eşlemeden çıkar
+int     lfs_discard(uint32_t lba, uint32_t count);
+int     lfs_is_mapped(uint32_t lba);
+int     lfs_checkpoint(void);                            // Değişen tabloyu ve kaydı yaz
+
+void lfs_get_stats(LfsStats *out);
+void lfs_reset_stats(void);
+
+#endif // LFS_H
@@ -1,252 +1,440 @@
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include <locale.h>
-#include <unistd.h>   // access() için
-#ifdef _WIN32
-#include <windows.h>
-#endif
-#include "fs.h"
-
-#define MAX_DATA_SIZE 1024
-#define LOG_FILE      "fs_operations.log"
-
-void print_menu() {
-    printf("\n=== SimpleFS Menu ===\n");
-    printf(" 1. Create file\n");
-    printf(" 2. Delete file\n");
-    printf(" 3. Write to file\n");
-    printf(" 4. Read from file\n");
-    printf(" 5. List files\n");
-    printf(" 6. Format disk\n");
-    printf(" 7. Rename file\n");
-    printf(" 8. Check file exists\n");
-    printf(" 9. Get file size\n");
-    printf("10. Append to file\n");
-    printf("11. Truncate file\n");
-    printf("12. Copy file\n");
-    printf("13. Move file\n");
-    printf("14. Defragment disk\n");
-    printf("15. Check integrity\n");
-    printf("16. Backup disk\n");
-    printf("17. Restore backup\n");
-    printf("18. Show file contents (cat)\n");
-    printf("19. Compare two files (diff)\n");
-    printf("20. Show operation log\n");
-    printf("21. Exit\n");
-    printf("Choice: ");
-}
-
-void handle_read_file() {
-    char filename[256];
-    printf("Enter filename to read: ");
-    scanf("%255s", filename);
-
-    int choice;
-    printf("Read mode:\n");
-    printf("1. Read full file\n");
-    printf("2. Read partial (offset + size)\n");
-    printf("Choose option: ");
-    scanf("%d", &choice);
-
-    char *buffer = malloc(BLOCK_SIZE * 10); // Gerekirse arttırılabilir
-    if (!buffer) {
-        fprintf(stderr, "Memory allocation failed\n");
-        return;
-    }
-
-    ssize_t result = -1;
-
-    if (choice == 1) {
-        result = fs_read_all(filename, buffer);
-        if (result > 0) {
-            printf("=== File Content ===\n");
-            fwrite(buffer, 1, result, stdout);
-            printf("\n====================\n");
-        }
-    } else if (choice == 2) {
-        uint32_t offset;
-        size_t size;
-        printf("Enter offset: ");
-        scanf("%u", &offset);
-        printf("Enter number of bytes to read: ");
-        scanf("%zu", &size);
-
-        result = fs_read(filename, offset, size, buffer);
-        if (result > 0) {
-            printf("Read data: ");
-            fwrite(buffer, 1, result, stdout);
-            printf("\n");
-        }
-    } else {
-        printf("Invalid option.\n");
-    }
-    /****************************** */
-    if (result > 0) {
-        fs_log("read", filename);
-    }
-/*********************************** */
-    free(buffer);
-}
-
-int main() {
-    int choice;
-    char filename[256], newname[256], src[256], dst[256], backup[256];
-    char data[MAX_DATA_SIZE];
-    //uint32_t offset, size, filesize;
-    ssize_t res;
-    uint32_t size, filesize;
-
-
-
-
-    // ✅ disk.sim varsa sadece metadata yükle, yoksa formatla
-    if (access(DISK_NAME, F_OK) != 0) {
-        if (fs_format() != 0) {
-            fprintf(stderr, "Disk format failed. Exiting.\n");
-            return EXIT_FAILURE;
-        }
-        fs_log("format", NULL);
-        printf("disk.sim created and formatted successfully.\n");
-    } else {
-        if (disk_read_metadata() != 0) {
-            fprintf(stderr, "Failed to read existing disk metadata.\n");
-            return EXIT_FAILURE;
-        }
-        printf("disk.sim found. Loaded existing disk.\n");
-    }
-
-    while (1) {
-        print_menu();
-        if (scanf("%d", &choice) != 1) {
-            fprintf(stderr, "Invalid input!\n");
-            int c; while ((c = getchar()) != '\n' && c != EOF);
-            continue;
-        }
-        switch (choice) {
-            case 1:
-                printf("Enter file name to create: ");
-                scanf("%s", filename);
-                if (fs_create(filename) == 0) fs_log("create", filename);
-                break;
-            case 2:
-                printf("Enter file name to delete: ");
-                scanf("%s", filename);
-                if (fs_delete(filename) == 0) fs_log("delete", filename);
-                break;
-            case 3:
-                printf("Enter file name: ");
-                scanf("%s", filename);
-                printf("Enter data to write (max %d chars): ", MAX_DATA_SIZE-1);
-                getchar();
-                fgets(data, MAX_DATA_SIZE, stdin);
-                data[strcspn(data, "\n")] = '\0';
-                size = (uint32_t)strlen(data);
-                if ((res = fs_write(filename, data, size)) >= 0) {
-                    fs_log("write", filename);
-                }
-                break;
-            case 4:
-                handle_read_file(); 
-                break;
-            case 5:
-                if (fs_ls() == 0) fs_log("ls", NULL);
-                break;
-            case 6:
-                if (fs_format() == 0) fs_log("format", NULL);
-                break;
-            case 7:
-                printf("Enter old file name: ");
-                scanf("%s", filename);
-                printf("Enter new file name: ");
-                scanf("%s", newname);
-                if (fs_rename(filename, newname) == 0) fs_log("rename", filename);
-                break;
-            case 8:
-                printf("Enter file name to check: ");
-                scanf("%s", filename);
-                printf(fs_exists(filename) ? "File exists.\n" : "File does not exist.\n");
-                fs_log("exists", filename);
-                break;
-            case 9:
-                printf("Enter file name to get size: ");
-                scanf("%s", filename);
-                if (fs_size(filename, &filesize) == 0) {
-                    printf("%s size: %u bytes\n", filename, filesize);
-                    fs_log("size", filename);
-                }
-                break;
-            case 10:
-                printf("Enter file name: ");
-                scanf("%s", filename);
-                printf("Enter data to append (max %d chars): ", MAX_DATA_SIZE-1);
-                getchar();
-                fgets(data, MAX_DATA_SIZE, stdin);
-                data[strcspn(data, "\n")] = '\0';
-                size = (uint32_t)strlen(data);
-                if ((res = fs_append(filename, data, size)) >= 0) fs_log("append", filename);
-                break;
-            case 11:
-                printf("Enter file name to truncate: ");
-                scanf("%s", filename);
-                printf("Enter new size (bytes): ");
-                scanf("%u", &size);
-                if (fs_truncate(filename, size) == 0) fs_log("truncate", filename);
-                break;
-            case 12:
-                printf("Source file: ");
-                scanf("%s", src);
-                printf("Destination file: ");
-                scanf("%s", dst);
-                if (fs_copy(src, dst) == 0) fs_log("copy", src);
-                break;
-            case 13:
-                printf("Source file: ");
-                scanf("%s", src);
-                printf("Destination file: ");
-                scanf("%s", dst);
-                if (fs_mv(src, dst) == 0) fs_log("move", src);
-                break;
-            case 14:
-                if (fs_defragment() == 0) fs_log("defragment", NULL);
-                break;
-            case 15:
-                if (fs_check_integrity() == 0) fs_log("check_integrity", NULL);
-                break;
-            case 16:
-                printf("Enter backup file name: ");
-                scanf("%s", backup);
-                if (fs_backup(backup) == 0) fs_log("backup", backup);
-                break;
-            case 17:
-                printf("Enter backup to restore: ");
-                scanf("%s", backup);
-                if (fs_restore(backup) == 0) fs_log("restore", backup);
-                break;
-            case 18:
-                printf("Enter file name to display: ");
-                scanf("%s", filename);
-                if (fs_cat(filename) == 0) fs_log("cat", filename);
-                break;
-            case 19:
-                printf("First file to compare: ");
-                scanf("%s", src);
-                printf("Second file to compare: ");
-                scanf("%s", dst);
-                if (fs_diff(src, dst) == 0) fs_log("diff", src);
-                break;
-            case 20:
-                // Show the log file
-                fs_cat(LOG_FILE);
-                break;
-            case 21:
-                printf("Exiting.\n");
-                fs_log("exit", NULL);
-                return EXIT_SUCCESS;
-            default:
-                printf("Invalid choice!\n");
-        }
-    }
-
-    return EXIT_SUCCESS;
-}
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <locale.h>
+#include <unistd.h>   // getopt
+#include "fs.h"
+#include "cmd.h"
+#include "server.h"
+
+#define MAX_DATA_SIZE 1024
+#define LOG_FILE      OPLOG_TEXT_NAME
+
+// Kütüphane mesajları: hatalar stderr'e, ilerleme satırları (verbose ise) stdout'a
+static int cli_verbose = 1;
+
+static void cli_log(FsLogLevel level, const char *message, void *user_data) {
+    (void)user_data;
+    if (level == FS_LOG_ERROR) fprintf(stderr, "%s\n", message);
+    else if (cli_verbose)      printf("%s\n", message);
+}
+
+void print_menu() {
+    printf("\n=== SimpleFS Menu ===\n");
+    printf(" 1. Create file\n");
+    printf(" 2. Delete file\n");
+    printf(" 3. Write to file\n");
+    printf(" 4. Read from file\n");
+    printf(" 5. List files\n");
+    printf(" 6. Format disk\n");
+    printf(" 7. Rename file\n");
+    printf(" 8. Check file exists\n");
+    printf(" 9. Get file size\n");
+    printf("10. Append to file\n");
+    printf("11. Truncate file\n");
+    printf("12. Copy file\n");
+    printf("13. Move file\n");
+    printf("14. Defragment disk\n");
+    printf("15. Check integrity\n");
+    printf("16. Backup disk\n");
+    printf("17. Restore backup\n");
+    printf("18. Show file contents (cat)\n");
+    printf("19. Compare two files (diff)\n");
+    printf("20. Show operation log\n");
+    printf("21. Exit\n");
+    printf("22. Format disk (dedup mode)\n");
+    printf("23. Show dedup stats\n");
+    printf("24. Enable/disable statistics\n");
+    printf("25. Show statistics\n");
+    printf("26. Dump statistics as JSON\n");
+    printf("27. Punch hole in file\n");
+    printf("28. Show space report\n");
+    printf("29. Format disk (inline small files)\n");
+    printf("30. Import host directory\n");
+    printf("31. Export all files to host directory\n");
+    printf("32. Format disk (log-structured)\n");
+    printf("33. Show log-structured stats\n");
+    printf("34. Resize disk image\n");
+    printf("Choice: ");
+}
+
+static void handle_read_file(void) {
+    char filename[256];
+    printf("Enter filename to read: ");
+    scanf("%255s", filename);
+
+    int choice;
+    printf("Read mode:\n");
+    printf("1. Read full file\n");
+    printf("2. Read partial (offset + size)\n");
+    printf("Choose option: ");
+    scanf("%d", &choice);
+
+    char *buffer = malloc(BLOCK_SIZE * 10); // Gerekirse arttırılabilir
+    if (!buffer) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return;
+    }
+
+    ssize_t result = -1;
+
+    if (choice == 1) {
+        result = fs_read_all(filename, buffer);
+        if (result > 0) {
+            printf("=== File Content ===\n");
+            fwrite(buffer, 1, result, stdout);
+            printf("\n====================\n");
+        }
+    } else if (choice == 2) {
+        uint32_t offset;
+        size_t size;
+        printf("Enter offset: ");
+        scanf("%u", &offset);
+        printf("Enter number of bytes to read: ");
+        scanf("%zu", &size);
+
+        result = fs_read(filename, offset, size, buffer);
+        if (result > 0) {
+            printf("Read data: ");
+            fwrite(buffer, 1, result, stdout);
+            printf("\n");
+        }
+    } else {
+        printf("Invalid option.\n");
+    }
+    /****************************** */
+    if (result > 0) {
+        fs_log("read", filename);
+    }
+/*********************************** */
+    free(buffer);
+}
+
+static void print_usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s [-d IMAGE] [-c COMMANDS | -f SCRIPT | -s] [-e]\n"
+            "       %s [-d IMAGE] -S SOCKET [-W N]\n"
+            "  -d IMAGE     use IMAGE instead of %s ('a.sim,b.sim,...' stripes across files)\n"
+            "  -c COMMANDS  run ';'-separated commands and exit\n"
+            "  -f SCRIPT    run commands from SCRIPT ('-' = stdin) and exit\n"
+            "  -s           run commands from stdin and exit\n"
+            "  -e           stop at the first failing command\n"
+            "  -S SOCKET    serve clients (libsimplefsclient) on a Unix socket until SIGINT/SIGTERM\n"
+            "  -W N         server worker threads (default %d)\n"
+            "Without -c/-f/-s/-S the interactive menu is started.\n",
+            prog, prog, DISK_NAME, SERVER_DEFAULT_WORKERS);
+    cmd_print_help(stderr);
+}
+
+// SIMPLEFS_TRACE=FILE ile ayrıntılı iz baştan kaydedilir (fsreplay ile oynatılır);
+// disk imajı hazır olduktan sonra çağrılır
+static void start_env_trace(void) {
+    const char *env_trace = getenv("SIMPLEFS_TRACE");
+    if (env_trace && *env_trace && fs_trace_start(env_trace) < 0) {
+        fprintf(stderr, "SIMPLEFS_TRACE: cannot record to '%s'\n", env_trace);
+    }
+}
+
+// Batch modu: istem yok, stdout'a yalnızca sonuçlar yazılır
+static int run_batch(const char *commands, const char *script, int stop_on_error) {
+    static char outbuf[1 << 16];
+    setvbuf(stdout, outbuf, _IOFBF, sizeof(outbuf));
+    cli_verbose = 0;
+
+    if (!disk_exists() && fs_format() != 0) {
+        fprintf(stderr, "Disk format failed.\n");
+        return EXIT_FAILURE;
+    }
+    start_env_trace();
+
+    int failures = 0;
+    if (commands) {
+        failures = cmd_run_line(commands, stop_on_error ? CMD_STOP_ON_ERROR : 0);
+    } else if (strcmp(script, "-") == 0) {
+        failures = cmd_run_stream(stdin, stop_on_error);
+    } else {
+        FILE *f = fopen(script, "r");
+        if (!f) {
+            perror("script");
+            return EXIT_FAILURE;
+        }
+        failures = cmd_run_stream(f, stop_on_error);
+        fclose(f);
+    }
+    fflush(stdout);
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+// Sunucu modu: imaj hazırlanır ve istemciler soket kapanana kadar karşılanır
+static int run_server(const char *socket_path, int workers) {
+    cli_verbose = 0;
+    int rc = !disk_exists() ? fs_format() : fs_mount();
+    if (rc != 0) {
+        fprintf(stderr, "Cannot open disk image '%s'.\n", disk_path());
+        return EXIT_FAILURE;
+    }
+    start_env_trace();
+    return server_run(socket_path, workers) < 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+int main(int argc, char **argv) {
+    const char *commands = NULL, *script = NULL, *socket_path = NULL;
+    int stop_on_error = 0, workers = SERVER_DEFAULT_WORKERS, opt;
+
+    fs_set_log_callback(cli_log, NULL);
+
+    // SIMPLEFS_STATS=1 ile istatistikler baştan açık başlar
+    const char *env_stats = getenv("SIMPLEFS_STATS");
+    int stats_on = env_stats && strcmp(env_stats, "0") != 0;
+    fs_stats_enable(stats_on);
+
+    // SIMPLEFS_ALLOC=best-fit gibi bir değerle yer ayırma politikası seçilir
+    const char *env_alloc = getenv("SIMPLEFS_ALLOC");
+    if (env_alloc) {
+        int policy = alloc_policy_parse(env_alloc);
+        if (policy < 0) fprintf(stderr, "SIMPLEFS_ALLOC: unknown policy '%s'\n", env_alloc);
+        else fs_set_alloc_policy((AllocPolicy)policy);
+    }
+
+    while ((opt = getopt(argc, argv, "d:c:f:seS:W:h")) != -1) {
+        switch (opt) {
+            case 'd':
+                if (disk_set_path(optarg) < 0) return EXIT_FAILURE;
+                break;
+            case 'c': commands = optarg; break;
+            case 'f': script = optarg; break;
+            case 's': script = "-"; break;
+            case 'e': stop_on_error = 1; break;
+            case 'S': socket_path = optarg; break;
+            case 'W': workers = atoi(optarg); break;
+            case 'h':
+                print_usage(argv[0]);
+                return EXIT_SUCCESS;
+            default:
+                print_usage(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if (socket_path) {
+        return run_server(socket_path, workers);
+    }
+    if (commands || script) {
+        return run_batch(commands, script, stop_on_error);
+    }
+
+    int choice;
+    char filename[256], newname[256], src[256], dst[256], backup[256];
+    char data[MAX_DATA_SIZE];
+    //uint32_t offset, size, filesize;
+    ssize_t res;
+    uint32_t size, filesize;
+
+
+
+
+    // ✅ disk.sim varsa sadece metadata yükle, yoksa formatla
+    if (!disk_exists()) {
+        if (fs_format() != 0) {
+            fprintf(stderr, "Disk format failed. Exiting.\n");
+            return EXIT_FAILURE;
+        }
+        fs_log("format", NULL);
+        printf("disk.sim created and formatted successfully.\n");
+    } else {
+        if (fs_mount() != 0) {
+            fprintf(stderr, "Failed to read existing disk metadata.\n");
+            return EXIT_FAILURE;
+        }
+        printf("disk.sim found. Loaded existing disk.\n");
+    }
+    start_env_trace();
+
+    while (1) {
+        print_menu();
+        if (scanf("%d", &choice) != 1) {
+            fprintf(stderr, "Invalid input!\n");
+            int c; while ((c = getchar()) != '\n' && c != EOF);
+            continue;
+        }
+        switch (choice) {
+            case 1:
+                printf("Enter file name to create: ");
+                scanf("%s", filename);
+                if (fs_create(filename) == 0) fs_log("create", filename);
+                break;
+            case 2:
+                printf("Enter file name to delete: ");
+                scanf("%s", filename);
+                if (fs_delete(filename) == 0) fs_log("delete", filename);
+                break;
+            case 3:
+                printf("Enter file name: ");
+                scanf("%s", filename);
+                printf("Enter data to write (max %d chars): ", MAX_DATA_SIZE-1);
+                getchar();
+                fgets(data, MAX_DATA_SIZE, stdin);
+                data[strcspn(data, "\n")] = '\0';
+                size = (uint32_t)strlen(data);
+                if ((res = fs_write(filename, data, size)) >= 0) {
+                    fs_log("write", filename);
+                }
+                break;
+            case 4:
+                handle_read_file(); 
+                break;
+            case 5:
+                if (fs_ls() == 0) fs_log("ls", NULL);
+                break;
+            case 6:
+                if (fs_format() == 0) fs_log("format", NULL);
+                break;
+            case 7:
+                printf("Enter old file name: ");
+                scanf("%s", filename);
+                printf("Enter new file name: ");
+                scanf("%s", newname);
+                if (fs_rename(filename, newname) == 0) fs_log("rename", filename);
+                break;
+            case 8:
+                printf("Enter file name to check: ");
+                scanf("%s", filename);
+                printf(fs_exists(filename) ? "File exists.\n" : "File does not exist.\n");
+                fs_log("exists", filename);
+                break;
+            case 9:
+                printf("Enter file name to get size: ");
+                scanf("%s", filename);
+                if (fs_size(filename, &filesize) == 0) {
+                    printf("%s size: %u bytes\n", filename, filesize);
+                    fs_log("size", filename);
+                }
+                break;
+            case 10:
+                printf("Enter file name: ");
+                scanf("%s", filename);
+                printf("Enter data to append (max %d chars): ", MAX_DATA_SIZE-1);
+                getchar();
+                fgets(data, MAX_DATA_SIZE, stdin);
+                data[strcspn(data, "\n")] = '\0';
+                size = (uint32_t)strlen(data);
+                if ((res = fs_append(filename, data, size)) >= 0) fs_log("append", filename);
+                break;
+            case 11:
+                printf("Enter file name to truncate: ");
+                scanf("%s", filename);
+                printf("Enter new size (bytes): ");
+                scanf("%u", &size);
+                if (fs_truncate(filename, size) == 0) fs_log("truncate", filename);
+                break;
+            case 12:
+                printf("Source file: ");
+                scanf("%s", src);
+                printf("Destination file: ");
+                scanf("%s", dst);
+                if (fs_copy(src, dst) == 0) fs_log("copy", src);
+                break;
+            case 13:
+                printf("Source file: ");
+                scanf("%s", src);
+                printf("Destination file: ");
+                scanf("%s", dst);
+                if (fs_mv(src, dst) == 0) fs_log("move", src);
+                break;
+            case 14:
+                if (fs_defragment() == 0) fs_log("defragment", NULL);
+                break;
+            case 15:
+                if (fs_check_integrity() == 0) fs_log("check_integrity", NULL);
+                break;
+            case 16:
+                printf("Enter backup file name: ");
+                scanf("%s", backup);
+                if (fs_backup(backup) == 0) fs_log("backup", backup);
+                break;
+            case 17:
+                printf("Enter backup to restore: ");
+                scanf("%s", backup);
+                if (fs_restore(backup) == 0) fs_log("restore", backup);
+                break;
+            case 18:
+                printf("Enter file name to display: ");
+                scanf("%s", filename);
+                if (fs_cat(filename) == 0) fs_log("cat", filename);
+                break;
+            case 19:
+                printf("First file to compare: ");
+                scanf("%s", src);
+                printf("Second file to compare: ");
+                scanf("%s", dst);
+                if (fs_diff(src, dst) == 0) fs_log("diff", src);
+                break;
+            case 20:
+                // Show the log file
+                fs_cat(LOG_FILE);
+                break;
+            case 21:
+                printf("Exiting.\n");
+                fs_log("exit", NULL);
+                return EXIT_SUCCESS;
+            case 22:
+                if (fs_format_mode(FS_FORMAT_DEDUP) == 0) fs_log("format_dedup", NULL);
+                break;
+            case 23:
+                if (fs_dedup_report() == 0) fs_log("dedup_stats", NULL);
+                break;
+            case 24:
+                stats_on = !stats_on;
+                fs_stats_enable(stats_on);
+                printf("Statistics %s.\n", stats_on ? "enabled" : "disabled");
+                break;
+            case 25:
+                fs_stats_report();
+                break;
+            case 26:
+                printf("Enter JSON output file name: ");
+                scanf("%255s", backup);
+                if (fs_stats_dump_json(backup) == 0) printf("Statistics written to %s\n", backup);
+                break;
+            case 27:
+                printf("Enter file name: ");
+                scanf("%s", filename);
+                printf("Enter offset and length (bytes): ");
+                if (scanf("%u %u", &filesize, &size) != 2) break;
+                if (fs_punch_hole(filename, filesize, size) == 0) fs_log("punch", filename);
+                break;
+            case 28:
+                fs_space_report();
+                break;
+            case 29:
+                if (fs_format_mode(FS_FORMAT_INLINE) == 0) fs_log("format_inline", NULL);
+                break;
+            case 30:
+            case 31: {
+                printf("Enter host directory: ");
+                scanf("%255s", backup);
+                int n = choice == 30 ? fs_import_dir(backup) : fs_export_dir(backup);
+                if (n < 0) break;
+                printf("%d files %s\n", n, choice == 30 ? "imported" : "exported");
+                fs_log(choice == 30 ? "import-dir" : "export-dir", backup);
+                break;
+            }
+            case 32:
+                if (fs_format_mode(FS_FORMAT_LOG) == 0) fs_log("format_log", NULL);
+                break;
+            case 33:
+                if (fs_lfs_report() == 0) fs_log("lfs_stats", NULL);
+                break;
+            case 34:
+                printf("Enter new image size (KB): ");
+                if (scanf("%u", &size) != 1 || size > UINT32_MAX / 1024) break;
+                if (fs_resize(size * 1024) == 0) fs_log("resize", NULL);
+                break;
+            default:
+                printf("Invalid choice!\n");
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
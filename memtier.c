@@ -0,0 +1,347 @@
+// memtier.c — sık erişilen dosyalar için bellek katmanı
+//
+// Her kayıt bir dosyanın blok aralığını ve sıcaklığını tutar; belleğe alınmış
+// kayıtların verisi mmap(MAP_ANONYMOUS) ile ayrılan bölgededir. Bellekteki
+// aralıklar birbiriyle çakışmaz: bir aralık alınırken veya büyürken çakıştığı
+// aralıklar önce diske indirilir. Kirli kısım bayt aralığı olarak izlenir ve
+// geri yazımda blok sınırlarına genişletilir. Diske inen aralığın blokları
+// blok önbelleğinden düşürülür; aralık bellekteyken önbelleğe giren kopyalar
+// bayat olabilir, ama okumalar önce bu katmana baktığından görülmez.
+#define _GNU_SOURCE             // mremap, MAP_ANONYMOUS
+
+#include "memtier.h"
+#include "disk.h"
+#include "bcache.h"
+
+#include <sys/mman.h>   // mmap, mremap, munmap
+#include <string.h>
+
+typedef struct {
+    uint32_t first;             // Dosyanın ilk bloğu
+    uint32_t count;             // Blok sayısı (0 = boş kayıt)
+    uint32_t heat;              // Erişim sayısı, zamanla yarıya iner
+    uint8_t *data;              // Bellekteki kopya (NULL = diskte, aday)
+    size_t   mapped;            // data bölgesinin boyutu
+    size_t   dirty_lo;          // Kirli bayt aralığı (lo == hi: temiz)
+    size_t   dirty_hi;
+} Entry;
+
+static Entry        entries[MEMTIER_ENTRIES];
+static uint64_t     limit;
+static uint64_t     resident_bytes;
+static uint32_t     ticks;
+static MemTierStats st;
+
+static uint64_t lo_of(const Entry *e) {
+    return (uint64_t)e->first * BLOCK_SIZE;
+}
+
+static uint64_t len_of(const Entry *e) {
+    return (uint64_t)e->count * BLOCK_SIZE;
+}
+
+static int overlaps(uint64_t a, uint64_t an, uint64_t b, uint64_t bn) {
+    return a < b + bn && b < a + an;
+}
+
+static void mark_dirty(Entry *e, size_t lo, size_t hi) {
+    if (e->dirty_lo == e->dirty_hi) {
+        e->dirty_lo = lo;
+        e->dirty_hi = hi;
+        return;
+    }
+    if (lo < e->dirty_lo) e->dirty_lo = lo;
+    if (hi > e->dirty_hi) e->dirty_hi = hi;
+}
+
+// Kirli blokları diske yazar; kopya bellekte kalır
+static int write_back(Entry *e) {
+    if (e->dirty_lo == e->dirty_hi) return 0;
+    uint32_t b0 = (uint32_t)(e->dirty_lo / BLOCK_SIZE);
+    uint32_t b1 = (uint32_t)((e->dirty_hi + BLOCK_SIZE - 1) / BLOCK_SIZE);
+    int rc = disk_phys_write(e->first + b0, b1 - b0, e->data + (size_t)b0 * BLOCK_SIZE);
+    if (rc < 0) return rc;
+    st.writeback_bytes += (uint64_t)(b1 - b0) * BLOCK_SIZE;
+    e->dirty_lo = e->dirty_hi = 0;
+    return 0;
+}
+
+static void release(Entry *e) {
+    bcache_invalidate(e->first, e->count);
+    munmap(e->data, e->mapped);
+    resident_bytes -= e->mapped;
+    e->data = NULL;
+    e->mapped = 0;
+}
+
+// Aralığı diske indirir; kayıt aday olarak sıcaklığıyla kalır
+static int demote(Entry *e) {
+    int rc = write_back(e);
+    if (rc < 0) return rc;
+    release(e);
+    st.demotions++;
+    return 0;
+}
+
+// [first, first+count) ile çakışan bellekteki aralıkları (skip hariç) indirir
+static int evict_blocks(uint32_t first, uint32_t count, const Entry *skip) {
+    for (int i = 0; i < MEMTIER_ENTRIES; ++i) {
+        Entry *e = &entries[i];
+        if (e == skip || !e->data || !overlaps(e->first, e->count, first, count)) continue;
+        int rc = demote(e);
+        if (rc < 0) return rc;
+    }
+    return 0;
+}
+
+// Sınırın altında need bayt yer açar; yalnızca heat'ten soğuk aralıklar
+// indirilir. 1: yer açıldı, 0: yer yok
+static int make_room(uint64_t need, uint32_t heat, const Entry *skip) {
+    while (resident_bytes + need > limit) {
+        Entry *cold = NULL;
+        for (int i = 0; i < MEMTIER_ENTRIES; ++i) {
+            Entry *e = &entries[i];
+            if (e == skip || !e->data || e->heat >= heat) continue;
+            if (!cold || e->heat < cold->heat) cold = e;
+        }
+        if (!cold) return 0;
+        int rc = demote(cold);
+        if (rc < 0) return rc;
+    }
+    return 1;
+}
+
+static int promote(Entry *e) {
+    size_t len = (size_t)len_of(e);
+    if (len > limit) return 0;
+    int rc = evict_blocks(e->first, e->count, e);
+    if (rc < 0) return rc;
+    if ((rc = make_room(len, e->heat, e)) <= 0) return rc;
+    void *p = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) return 0;          // Bellek yoksa aralık diskte kalır
+    if ((rc = disk_phys_read(e->first, e->count, p)) < 0) {
+        munmap(p, len);
+        return rc;
+    }
+    e->data = p;
+    e->mapped = len;
+    e->dirty_lo = e->dirty_hi = 0;
+    resident_bytes += len;
+    st.promotions++;
+    return 0;
+}
+
+// Dosya büyüdü ya da küçüldü: bellekteki kopya yeni boya uyarlanır. Küçülmede
+// kesilen kuyruk başka bir dosyaya geçmiş olabileceğinden önce diske yazılır.
+static int resize(Entry *e, uint32_t count) {
+    size_t old = e->mapped, len = (size_t)count * BLOCK_SIZE;
+    int rc;
+    if (count == e->count) return 0;
+    if (count < e->count) {
+        if (e->dirty_hi > len && (rc = write_back(e)) < 0) return rc;
+        bcache_invalidate(e->first + count, e->count - count);
+        void *p = mremap(e->data, old, len, 0);
+        if (p == MAP_FAILED) return demote(e);
+        e->mapped = len;
+        e->count = count;
+        resident_bytes -= old - len;
+        if (e->dirty_hi > len) e->dirty_hi = len;
+        if (e->dirty_lo > e->dirty_hi) e->dirty_lo = e->dirty_hi;
+        return 0;
+    }
+    if (len > limit) return demote(e);
+    if ((rc = evict_blocks(e->first + e->count, count - e->count, e)) < 0) return rc;
+    if ((rc = make_room(len - old, e->heat, e)) < 0) return rc;
+    if (rc == 0) return demote(e);
+    void *p = mremap(e->data, old, len, MREMAP_MAYMOVE);
+    if (p == MAP_FAILED) return demote(e);
+    e->data = p;
+    e->mapped = len;
+    resident_bytes += len - old;
+    if ((rc = disk_phys_read(e->first + e->count, count - e->count, e->data + old)) < 0) return rc;
+    e->count = count;
+    return 0;
+}
+
+static void decay(void) {
+    for (int i = 0; i < MEMTIER_ENTRIES; ++i) {
+        Entry *e = &entries[i];
+        e->heat >>= 1;
+        if (!e->heat && !e->data) e->count = 0;
+    }
+}
+
+static Entry *find(uint32_t first) {
+    for (int i = 0; i < MEMTIER_ENTRIES; ++i) {
+        if (entries[i].count && entries[i].first == first) return &entries[i];
+    }
+    return NULL;
+}
+
+// Yeni aday için boş kayıt, yoksa en soğuk aday (bellekteki kayıtlar atılmaz)
+static Entry *victim(void) {
+    Entry *best = NULL;
+    for (int i = 0; i < MEMTIER_ENTRIES; ++i) {
+        Entry *e = &entries[i];
+        if (e->data) continue;
+        if (!e->count) return e;
+        if (!best || e->heat < best->heat) best = e;
+    }
+    return best;
+}
+
+// Aralık tamamen bellekteki bir kaydın içindeyse o kayıt
+static Entry *containing(uint64_t offset, size_t len) {
+    if (!resident_bytes || !len) return NULL;
+    for (int i = 0; i < MEMTIER_ENTRIES; ++i) {
+        Entry *e = &entries[i];
+        if (e->data && offset >= lo_of(e) && offset + len <= lo_of(e) + len_of(e)) return e;
+    }
+    return NULL;
+}
+
+int memtier_set_limit(uint64_t bytes) {
+    limit = bytes;
+    int rc = make_room(0, UINT32_MAX, NULL);
+    if (rc < 0) return rc;
+    if (!limit) memset(entries, 0, sizeof(entries));
+    return 0;
+}
+
+uint64_t memtier_limit(void) {
+    return limit;
+}
+
+int memtier_access(uint32_t first, uint32_t count) {
+    if (!limit || !count || first >= DATA_BLOCKS) return 0;
+    if (count > DATA_BLOCKS - first) count = DATA_BLOCKS - first;
+    if (++ticks % MEMTIER_DECAY_TICKS == 0) decay();
+
+    Entry *e = find(first);
+    if (!e) {
+        if (!(e = victim())) return 0;
+        *e = (Entry){ .first = first, .count = count };
+    }
+    if (e->heat < UINT32_MAX) e->heat++;
+    if (e->data) return resize(e, count);
+    e->count = count;
+    return e->heat >= MEMTIER_PROMOTE_HEAT ? promote(e) : 0;
+}
+
+int memtier_read(uint64_t offset, void *buf, size_t len) {
+    Entry *e = containing(offset, len);
+    if (!e) return 0;
+    memcpy(buf, e->data + (offset - lo_of(e)), len);
+    st.read_hits++;
+    return 1;
+}
+
+int memtier_write(uint64_t offset, const void *buf, size_t len) {
+    Entry *e = containing(offset, len);
+    if (!e) return 0;
+    size_t at = (size_t)(offset - lo_of(e));
+    memcpy(e->data + at, buf, len);
+    mark_dirty(e, at, at + len);
+    st.write_hits++;
+    return 1;
+}
+
+// Çakışan her kayıt için kesişimi kopyalar (to_mem: tampondan belleğe)
+static void copy_overlap(uint64_t offset, uint8_t *buf, size_t len, int to_mem) {
+    if (!resident_bytes || !len) return;
+    for (int i = 0; i < MEMTIER_ENTRIES; ++i) {
+        Entry *e = &entries[i];
+        if (!e->data || !overlaps(lo_of(e), len_of(e), offset, len)) continue;
+        uint64_t lo = lo_of(e) > offset ? lo_of(e) : offset;
+        uint64_t hi = lo_of(e) + len_of(e) < offset + len ? lo_of(e) + len_of(e) : offset + len;
+        size_t at = (size_t)(lo - lo_of(e)), n = (size_t)(hi - lo);
+        if (!to_mem) {
+            memcpy(buf + (lo - offset), e->data + at, n);
+            continue;
+        }
+        if (buf) memcpy(e->data + at, buf + (lo - offset), n);
+        else     memset(e->data + at, 0, n);
+        mark_dirty(e, at, at + n);
+    }
+}
+
+void memtier_overlay(uint64_t offset, void *buf, size_t len) {
+    copy_overlap(offset, buf, len, 0);
+}
+
+void memtier_update(uint64_t offset, const void *buf, size_t len) {
+    copy_overlap(offset, (uint8_t *)buf, len, 1);
+}
+
+// Hiçbir dosyanın kullanmadığı bloklar: tamamen içeride kalan kayıtların
+// verisi ölüdür, diske yazılmadan bırakılır
+void memtier_discard(uint32_t first, uint32_t count) {
+    for (int i = 0; i < MEMTIER_ENTRIES; ++i) {
+        Entry *e = &entries[i];
+        if (!e->count || e->first < first || e->first + e->count > first + count) continue;
+        if (e->data) release(e);
+        memset(e, 0, sizeof(*e));
+    }
+}
+
+int memtier_evict(uint64_t offset, uint64_t len) {
+    if (!resident_bytes || !len) return 0;
+    uint32_t first = (uint32_t)(offset / BLOCK_SIZE);
+    return evict_blocks(first, (uint32_t)((offset + len - 1) / BLOCK_SIZE) - first + 1, NULL);
+}
+
+uint64_t memtier_extent_end(uint64_t pos) {
+    Entry *e = containing(pos, 1);
+    return e ? lo_of(e) + len_of(e) : 0;
+}
+
+uint64_t memtier_next_start(uint64_t pos) {
+    uint64_t best = UINT64_MAX;
+    for (int i = 0; resident_bytes && i < MEMTIER_ENTRIES; ++i) {
+        const Entry *e = &entries[i];
+        if (!e->data || lo_of(e) + len_of(e) <= pos) continue;
+        uint64_t at = lo_of(e) > pos ? lo_of(e) : pos;
+        if (at < best) best = at;
+    }
+    return best;
+}
+
+int memtier_flush(void) {
+    int rc = 0;
+    for (int i = 0; resident_bytes && i < MEMTIER_ENTRIES; ++i) {
+        if (!entries[i].data) continue;
+        int r = write_back(&entries[i]);
+        if (r < 0 && rc == 0) rc = r;
+    }
+    return rc;
+}
+
+int memtier_dirty(void) {
+    for (int i = 0; resident_bytes && i < MEMTIER_ENTRIES; ++i) {
+        if (entries[i].data && entries[i].dirty_lo != entries[i].dirty_hi) return 1;
+    }
+    return 0;
+}
+
+void memtier_clear(void) {
+    for (int i = 0; i < MEMTIER_ENTRIES; ++i) {
+        if (entries[i].data) munmap(entries[i].data, entries[i].mapped);
+    }
+    memset(entries, 0, sizeof(entries));
+    resident_bytes = 0;
+    ticks = 0;
+}
+
+void memtier_stats(MemTierStats *out) {
+    *out = st;
+    out->limit = limit;
+    out->resident_bytes = resident_bytes;
+    out->resident = 0;
+    for (int i = 0; i < MEMTIER_ENTRIES; ++i) {
+        if (entries[i].data) out->resident++;
+    }
+}
+
+void memtier_reset_stats(void) {
+    memset(&st, 0, sizeof(st));
+}
@@ -0,0 +1,64 @@
+#ifndef MEMTIER_H
+#define MEMTIER_H
+
+#include <stdint.h>     // uint32_t, uint64_t
+#include <stddef.h>     // size_t
+
+// Bellek katmanı: sık erişilen dosyaların blok aralıkları anonim bellekte
+// tutulur ve bu aralıklara gelen okuma/yazımlar diske gitmeden karşılanır.
+// Katman geri yazımlıdır (write-back): bellekteki kopya yetkilidir, kirli
+// kısımlar geri indirilirken, memtier_flush'ta (disk_sync) ve program
+// çıkışında diske yazılır. Dosya katmanı her erişimde aralığı bildirir
+// (memtier_access); sıcaklığı MEMTIER_PROMOTE_HEAT'e ulaşan aralık sınıra
+// sığıyorsa belleğe alınır, yer açmak için daha soğuk aralıklar diske
+// indirilir. Sıcaklıklar MEMTIER_DECAY_TICKS erişimde bir yarıya iner.
+// Sınır 0 iken (varsayılan) katman kapalıdır. Offset'ler veri bölgesine
+// göredir; yalnızca düz modda (dedup olmadan) kullanılır.
+#define MEMTIER_ENTRIES      64       // İzlenen aralık sayısı (bellekteki + aday)
+#define MEMTIER_PROMOTE_HEAT 4        // Belleğe alınmak için gereken sıcaklık
+#define MEMTIER_DECAY_TICKS  256      // Sıcaklıkların yarıya indiği erişim sayısı
+
+typedef struct {
+    uint64_t limit;             // Bellek sınırı (bayt, 0 = kapalı)
+    uint64_t resident_bytes;    // Bellekte tutulan bayt
+    uint32_t resident;          // Bellekteki aralık sayısı
+    uint64_t read_hits;         // Tamamen bellekten karşılanan okumalar
+    uint64_t write_hits;        // Tamamen belleğe yapılan yazımlar
+    uint64_t promotions;        // Belleğe alınan aralıklar
+    uint64_t demotions;         // Diske indirilen aralıklar
+    uint64_t writeback_bytes;   // Kirli olduğu için diske yazılan bayt
+} MemTierStats;
+
+int      memtier_set_limit(uint64_t bytes);       // Küçültmek soğuk aralıkları indirir
+uint64_t memtier_limit(void);
+
+// Dosya katmanından erişim ipucu: [first, first+count) bloklarındaki dosyaya
+// erişildi. Aralık belleğe alınabilir, boyu değiştiyse bellekteki kopya uyarlanır.
+int  memtier_access(uint32_t first, uint32_t count);
+
+// Aralık tamamen bellekteyse kopyalar ve 1 döner; değilse 0 (diske gidilmeli)
+int  memtier_read(uint64_t offset, void *buf, size_t len);
+int  memtier_write(uint64_t offset, const void *buf, size_t len);
+
+// Diskle yapılan G/Ç'den sonra bellekteki kısımlarla uzlaştırma: okunan
+// tamponun bellekteki kısımları üstüne yazılır / yazılan baytlar bellekteki
+// kopyaya yansıtılır (buf NULL ise sıfırlanır)
+void memtier_overlay(uint64_t offset, void *buf, size_t len);
+void memtier_update(uint64_t offset, const void *buf, size_t len);
+
+void memtier_discard(uint32_t first, uint32_t count);  // Tamamen boşalan aralıkları yazmadan bırak
+int  memtier_evict(uint64_t offset, uint64_t len);     // Çakışan aralıkları yaz ve bırak
+
+// Delik sorguları için: pos'u içeren aralığın sonu (yoksa 0) ve pos'tan
+// sonra bellekte başlayan ilk veri (yoksa UINT64_MAX)
+uint64_t memtier_extent_end(uint64_t pos);
+uint64_t memtier_next_start(uint64_t pos);
+
+int  memtier_flush(void);                       // Kirli kısımları diske yaz, bellekte tut
+int  memtier_dirty(void);                       // Yazılmamış kirli kısım var mı
+void memtier_clear(void);                       // Her şeyi yazmadan bırak (format/restore)
+
+void memtier_stats(MemTierStats *out);
+void memtier_reset_stats(void);
+
+#endif // MEMTIER_H
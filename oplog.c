@@ -0,0 +1,354 @@
+// oplog.c — tamponlu, asenkron işlem günlüğü
+//
+// fs_log artık dosya açıp kapatmaz: kayıt bellekteki halka tampona kopyalanır
+// ve arka plandaki yazıcı iş parçacığı biriken kayıtları tek bir write() ile
+// ikili log dosyasına ekler. Zaman damgası yalnızca metin dökümünde biçimlenir.
+#define _POSIX_C_SOURCE 200809L
+
+#include "oplog.h"
+#include "fserr.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define RING_SLOTS   1024
+#define OP_MAX       31
+#define NAME_MAX_LEN 255
+#define REC_HDR_SIZE 10                          // ts_us (8) + op_len (1) + name_len (1)
+#define REC_MAX_SIZE (REC_HDR_SIZE + OP_MAX + NAME_MAX_LEN)
+
+typedef struct {
+    uint64_t ts_us;
+    uint8_t  op_len;
+    uint8_t  name_len;
+    uint8_t  has_name;
+    char     op[OP_MAX];
+    char     name[NAME_MAX_LEN];
+} OpLogSlot;
+
+static OpLogSlot ring[RING_SLOTS];
+static uint64_t  head_seq;       // Üreticilerin yazacağı sıradaki kayıt
+static uint64_t  tail_seq;       // Yazıcının alacağı sıradaki kayıt
+static uint64_t  durable_seq;    // Bu sıra numarasından küçük tüm kayıtlar dosyada
+static uint64_t  attempts;       // Başlatılan yazım turları (kayıtları halkadan alan)
+static uint64_t  attempts_done;  // Biten yazım turları
+static int       write_err;      // Son yazımın sonucu (0 ya da FsError)
+static int       flush_req;
+static int       stopping;
+static int       started;
+
+static OpLogConfig cfg = {
+    OPLOG_PERIODIC, 200, RING_SLOTS / 4, 1024 * 1024, 4, 0
+};
+
+static pthread_mutex_t lock      = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  not_empty = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t  not_full  = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t  flushed   = PTHREAD_COND_INITIALIZER;
+static pthread_t       writer;
+
+static int      log_fd = -1;
+static uint64_t log_bytes;
+static uint8_t  batch[RING_SLOTS * REC_MAX_SIZE];
+
+void oplog_default_config(OpLogConfig *out) {
+    out->durability        = OPLOG_PERIODIC;
+    out->flush_interval_ms = 200;
+    out->batch_records     = RING_SLOTS / 4;
+    out->max_file_bytes    = 1024 * 1024;
+    out->max_files         = 4;
+    out->fsync_on_flush    = 0;
+}
+
+int oplog_configure(const OpLogConfig *in) {
+    if (!in || in->flush_interval_ms == 0 || in->batch_records == 0 ||
+        in->batch_records > RING_SLOTS) {
+        FS_FAIL(FS_ERR_INVALID, "oplog_configure: invalid configuration");
+    }
+    pthread_mutex_lock(&lock);
+    cfg = *in;
+    pthread_cond_signal(&not_empty);
+    pthread_mutex_unlock(&lock);
+    return 0;
+}
+
+static uint64_t now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+static void rotated_name(char *out, size_t len, uint32_t n) {
+    if (n == 0) snprintf(out, len, "%s", OPLOG_FILENAME);
+    else        snprintf(out, len, "%s.%u", OPLOG_FILENAME, n);
+}
+
+static int open_log(void) {
+    log_fd = open(OPLOG_FILENAME, O_WRONLY | O_CREAT | O_APPEND, 0666);
+    if (log_fd < 0) FS_FAIL(FS_ERR_IO, "oplog: open: %s", strerror(errno));
+    struct stat st;
+    log_bytes = (fstat(log_fd, &st) == 0) ? (uint64_t)st.st_size : 0;
+    if (log_bytes == 0) {
+        if (write(log_fd, OPLOG_MAGIC, 8) != 8) {
+            int err = errno;
+            close(log_fd);
+            log_fd = -1;
+            unlink(OPLOG_FILENAME);         // Yarım başlık bir sonraki denemede yeniden yazılır
+            FS_FAIL(FS_ERR_IO, "oplog: write header: %s", strerror(err));
+        }
+        log_bytes = 8;
+    }
+    return 0;
+}
+
+// fs_operations.bin -> .1 -> .2 ... (en eskisi silinir)
+static void rotate_log(uint32_t max_files) {
+    char from[64], to[64];
+    close(log_fd);
+    log_fd = -1;
+    for (uint32_t n = max_files; n > 0; --n) {
+        rotated_name(from, sizeof(from), n - 1);
+        rotated_name(to, sizeof(to), n);
+        rename(from, to);
+    }
+    open_log();
+}
+
+static size_t encode(const OpLogSlot *s, uint8_t *out) {
+    for (int i = 0; i < 8; ++i) out[i] = (uint8_t)(s->ts_us >> (8 * i));
+    out[8] = s->op_len;
+    out[9] = s->has_name ? s->name_len : 0xFF;
+    memcpy(out + REC_HDR_SIZE, s->op, s->op_len);
+    memcpy(out + REC_HDR_SIZE + s->op_len, s->name, s->name_len);
+    return REC_HDR_SIZE + s->op_len + s->name_len;
+}
+
+// Kilit dışında: partiyi dosyaya ekler (len 0 ise yalnızca önceki turun
+// başarısız fdatasync'i yinelenir). Kısa yazımda dosya eski boyuna kesilir,
+// kayıtlar halkada kalır ve sonraki turda yeniden denenir. 1: kayıtlar dosyada
+// ama fdatasync başarısız (yeniden yazılmaz), < 0: kayıtlar yazılmadı.
+static int write_batch(const OpLogConfig *c, size_t len) {
+    if (log_fd < 0 && open_log() < 0) return FS_ERR_IO;
+    ssize_t n = len ? write(log_fd, batch, len) : 0;
+    if (n != (ssize_t)len) {
+        if (n < 0) FS_ERROR("oplog: write: %s", strerror(errno));
+        else       FS_ERROR("oplog: short write (%zd of %zu bytes)", n, len);
+        if (n > 0 && ftruncate(log_fd, (off_t)log_bytes) < 0) {
+            // Yarım kayıt kaldırılamadı: dosya yeniden açılıp boyu okunur
+            close(log_fd);
+            log_fd = -1;
+        }
+        return FS_ERR_IO;
+    }
+    log_bytes += len;
+    int rc = 0;
+    if (c->fsync_on_flush && fdatasync(log_fd) < 0) {
+        FS_ERROR("oplog: fdatasync: %s", strerror(errno));
+        rc = 1;
+    }
+    if (c->max_file_bytes && log_bytes >= c->max_file_bytes) rotate_log(c->max_files);
+    return rc;
+}
+
+static void *writer_main(void *arg) {
+    (void)arg;
+    pthread_mutex_lock(&lock);
+    for (;;) {
+        while (!stopping && !flush_req && head_seq == tail_seq) {
+            pthread_cond_wait(&not_empty, &lock);
+        }
+        // Periyodik modda toplu yazım için biraz daha bekle; son yazım
+        // başarısızsa yeniden denemeden önce de beklenir
+        if (!stopping && !flush_req && (write_err || (cfg.durability == OPLOG_PERIODIC &&
+            head_seq - tail_seq < cfg.batch_records))) {
+            struct timespec until;
+            clock_gettime(CLOCK_REALTIME, &until);
+            until.tv_sec  += cfg.flush_interval_ms / 1000;
+            until.tv_nsec += (long)(cfg.flush_interval_ms % 1000) * 1000000L;
+            if (until.tv_nsec >= 1000000000L) { until.tv_sec++; until.tv_nsec -= 1000000000L; }
+            while (!stopping && !flush_req && (write_err || head_seq - tail_seq < cfg.batch_records)) {
+                if (pthread_cond_timedwait(&not_empty, &lock, &until) == ETIMEDOUT) break;
+            }
+        }
+
+        // Kayıtlar yazılana kadar halkada kalır (tail_seq ilerlemez)
+        OpLogConfig c = cfg;
+        uint64_t attempt = ++attempts;
+        uint64_t end = head_seq;
+        size_t len = 0;
+        for (uint64_t s = tail_seq; s < end; ++s) {
+            len += encode(&ring[s % RING_SLOTS], batch + len);
+        }
+        int unsynced = durable_seq < tail_seq;
+        flush_req = 0;
+        int done = stopping;
+        pthread_mutex_unlock(&lock);
+
+        int rc = len > 0 || unsynced ? write_batch(&c, len) : 0;
+
+        pthread_mutex_lock(&lock);
+        if (rc >= 0) tail_seq = end;
+        if (rc == 0) durable_seq = end;
+        write_err = rc == 0 ? 0 : FS_ERR_IO;
+        attempts_done = attempt;
+        pthread_cond_broadcast(&not_full);
+        pthread_cond_broadcast(&flushed);
+        // Kapanışta yazılamayan kayıtlar bırakılır (hata bildirildi)
+        if (done && (head_seq == tail_seq || rc < 0)) break;
+    }
+    pthread_mutex_unlock(&lock);
+    return NULL;
+}
+
+// Çağıran kilidi tutarken yazıcıyı gerekirse başlatır
+static int ensure_started(void) {
+    if (started) return 0;
+    if (pthread_create(&writer, NULL, writer_main, NULL) != 0) {
+        FS_FAIL(FS_ERR_IO, "oplog: writer thread could not be started");
+    }
+    started = 1;
+    return 0;
+}
+
+int oplog_append(const char *operation, const char *filename) {
+    if (!operation) return FS_ERR_INVALID;
+    uint64_t ts = now_us();
+
+    pthread_mutex_lock(&lock);
+    if (stopping || ensure_started() < 0) {
+        pthread_mutex_unlock(&lock);
+        return FS_ERR_IO;
+    }
+    while (head_seq - tail_seq == RING_SLOTS) {
+        if (write_err) {
+            // Dosya yazılamıyor ve halka dolu: kayıt alınmaz, çağıran bloklanmaz
+            pthread_mutex_unlock(&lock);
+            FS_FAIL(FS_ERR_IO, "oplog: log file not writable, record dropped");
+        }
+        pthread_cond_wait(&not_full, &lock);
+    }
+    OpLogSlot *s = &ring[head_seq % RING_SLOTS];
+    size_t op_len = strlen(operation);
+    s->ts_us = ts;
+    s->op_len = (uint8_t)(op_len > OP_MAX ? OP_MAX : op_len);
+    memcpy(s->op, operation, s->op_len);
+    s->has_name = filename != NULL;
+    s->name_len = 0;
+    if (filename) {
+        size_t name_len = strlen(filename);
+        s->name_len = (uint8_t)(name_len > NAME_MAX_LEN ? NAME_MAX_LEN : name_len);
+        memcpy(s->name, filename, s->name_len);
+    }
+    uint64_t seq = head_seq++;
+
+    int rc = 0;
+    if (cfg.durability == OPLOG_FLUSH_PER_OP) {
+        uint64_t want = attempts + 1;       // Kaydı kapsayan ilk yeni tur
+        flush_req = 1;                      // Hata sonrası bekleme atlanır
+        pthread_cond_signal(&not_empty);
+        while (durable_seq <= seq && attempts_done < want) pthread_cond_wait(&flushed, &lock);
+        if (durable_seq <= seq) rc = write_err ? write_err : FS_ERR_IO;
+    } else if (head_seq - tail_seq == 1 || head_seq - tail_seq >= cfg.batch_records) {
+        pthread_cond_signal(&not_empty);
+    }
+    pthread_mutex_unlock(&lock);
+    return rc;
+}
+
+// Bekleyen kayıtlar yazılıp (fsync_on_flush ise diske indirilip) bitene kadar
+// bekler; yazım başarısızsa FS_ERR_IO (kayıtlar halkada kalır, yeniden denenir)
+int oplog_flush(void) {
+    int rc = 0;
+    pthread_mutex_lock(&lock);
+    if (started) {
+        uint64_t target = head_seq, want = attempts + 1;
+        flush_req = 1;
+        pthread_cond_signal(&not_empty);
+        while (durable_seq < target && attempts_done < want) pthread_cond_wait(&flushed, &lock);
+        if (durable_seq < target) rc = write_err ? write_err : FS_ERR_IO;
+    }
+    pthread_mutex_unlock(&lock);
+    return rc;
+}
+
+static int export_file(const char *path, FILE *out) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return errno == ENOENT ? 0 : FS_ERR_IO;
+
+    char magic[8];
+    if (fread(magic, 1, 8, f) != 8 || memcmp(magic, OPLOG_MAGIC, 8) != 0) {
+        fclose(f);
+        FS_FAIL(FS_ERR_CORRUPT, "oplog_export: '%s' is not an operation log", path);
+    }
+    uint8_t hdr[REC_HDR_SIZE];
+    char op[OP_MAX + 1], name[NAME_MAX_LEN + 1];
+    while (fread(hdr, 1, REC_HDR_SIZE, f) == REC_HDR_SIZE) {
+        uint64_t ts = 0;
+        for (int i = 0; i < 8; ++i) ts |= (uint64_t)hdr[i] << (8 * i);
+        uint8_t op_len = hdr[8];
+        int has_name = hdr[9] != 0xFF;
+        uint8_t name_len = has_name ? hdr[9] : 0;
+        if (op_len > OP_MAX ||
+            fread(op, 1, op_len, f) != op_len ||
+            fread(name, 1, name_len, f) != name_len) {
+            break;
+        }
+        op[op_len] = '\0';
+        name[name_len] = '\0';
+
+        time_t sec = (time_t)(ts / 1000000u);
+        struct tm tm;
+        char timestr[64];
+        localtime_r(&sec, &tm);
+        strftime(timestr, sizeof(timestr), "%Y-%m-%d %H:%M:%S", &tm);
+        if (has_name)
+            fprintf(out, "[%s] %s('%s')\n", timestr, op, name);
+        else
+            fprintf(out, "[%s] %s\n", timestr, op);
+    }
+    fclose(f);
+    return 0;
+}
+
+int oplog_export(FILE *out) {
+    oplog_flush();
+    pthread_mutex_lock(&lock);
+    uint32_t max_files = cfg.max_files;
+    pthread_mutex_unlock(&lock);
+    char path[64];
+    for (uint32_t n = max_files + 1; n > 0; --n) {
+        rotated_name(path, sizeof(path), n - 1);
+        int rc = export_file(path, out);
+        if (rc < 0) return rc;
+    }
+    return 0;
+}
+
+void oplog_shutdown(void) {
+    pthread_mutex_lock(&lock);
+    if (!started || stopping) {
+        pthread_mutex_unlock(&lock);
+        return;
+    }
+    stopping = 1;
+    pthread_cond_signal(&not_empty);
+    pthread_mutex_unlock(&lock);
+    pthread_join(writer, NULL);
+    if (log_fd >= 0) {
+        close(log_fd);
+        log_fd = -1;
+    }
+}
+
+// Program bittiğinde bekleyen kayıtları yaz
+__attribute__((destructor))
+static void cleanup_oplog(void) {
+    oplog_shutdown();
+}
@@ -0,0 +1,33 @@
+#ifndef OPLOG_H
+#define OPLOG_H
+
+#include <stdint.h>     // uint32_t
+#include <stdio.h>      // FILE
+
+#define OPLOG_FILENAME  "fs_operations.bin"   // Aktif ikili log dosyası (.1, .2 ... döndürülmüş olanlar)
+#define OPLOG_MAGIC     "SFSLOG01"            // Dosya başlığı (8 byte)
+#define OPLOG_TEXT_NAME "fs_operations.log"   // fs_cat/fs_size'ın günlük için tanıdığı ad
+
+// Kalıcılık modu
+typedef enum {
+    OPLOG_PERIODIC    = 0,   // Kayıtlar toplu halde, periyodik olarak yazılır (varsayılan)
+    OPLOG_FLUSH_PER_OP = 1   // Her kayıt, fs_log dönmeden önce dosyaya yazılır (yazılamazsa FS_ERR_IO)
+} OpLogDurability;
+
+typedef struct {
+    OpLogDurability durability;
+    uint32_t flush_interval_ms;   // Periyodik modda en fazla bekleme süresi
+    uint32_t batch_records;       // Bu kadar kayıt birikince yazıcı beklemeden uyanır
+    uint32_t max_file_bytes;      // Aktif dosya bu boyutu aşınca döndürülür (0 = döndürme yok)
+    uint32_t max_files;           // Saklanacak döndürülmüş dosya sayısı
+    int      fsync_on_flush;      // Her toplu yazımdan sonra fdatasync
+} OpLogConfig;
+
+void oplog_default_config(OpLogConfig *cfg);
+int  oplog_configure(const OpLogConfig *cfg);
+int  oplog_append(const char *operation, const char *filename);  // Halka tampona kayıt ekle
+int  oplog_flush(void);                                         // Bekleyen kayıtlar yazılana kadar bekle (hata: FS_ERR_IO)
+int  oplog_export(FILE *out);                                   // İkili logları metin olarak dök
+void oplog_shutdown(void);                                      // Yazıcıyı boşalt ve durdur
+
+#endif // OPLOG_H
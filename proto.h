@@ -0,0 +1,51 @@
+#ifndef PROTO_H
+#define PROTO_H
+
+#include "disk.h"       // DISK_SIZE
+
+// simplefs sunucusu ile istemci kütüphanesi arasındaki ikili protokol.
+// Tüm tamsayılar little-endian. Her çerçeve kendisinden sonraki bayt
+// sayısını veren 4 byte'lık uzunlukla başlar. İstemci yanıtları beklemeden
+// birden çok istek gönderebilir; sunucu bir bağlantının isteklerini geldiği
+// sırayla çalıştırır ve yanıtları aynı sırayla, istek kimliğiyle döndürür.
+//
+// İstek:  len (4) | id (4) | op (1) | name_len (1) | name2_len (1) | 0 (1) |
+//         offset (8) | size (4) | arg (4) | name | name2 | veri
+// Yanıt:  len (4) | id (4) | result (8) | veri
+#define FSP_REQ_HDR      28
+#define FSP_RESP_HDR     16
+#define FSP_MAX_DATA     DISK_SIZE                      // Tek istekte en fazla veri
+#define FSP_MAX_FRAME    (FSP_REQ_HDR + 2 * 255 + FSP_MAX_DATA)
+#define FSP_ENTRY_SIZE   48     // fs_list kaydı: name (32) | size (4) | start_block (4) | created (8)
+
+// İşlem kodları; alanların anlamı fs.h'deki karşılığıyla aynıdır.
+// Yanıt verisi: READ/PREAD/FREAD okunan baytlar, SIZE boyut (4), LIST kayıtlar.
+typedef enum {
+    FSP_FORMAT = 1,         // arg = FS_FORMAT_* bayrakları
+    FSP_CREATE,
+    FSP_DELETE,
+    FSP_WRITE,              // veri
+    FSP_READ,               // offset, size
+    FSP_APPEND,             // veri
+    FSP_SIZE,
+    FSP_EXISTS,
+    FSP_RENAME,             // name -> name2
+    FSP_TRUNCATE,           // size = yeni boyut
+    FSP_PUNCH_HOLE,         // offset, size
+    FSP_COPY,               // name -> name2
+    FSP_MV,                 // name -> name2
+    FSP_LIST,               // size = en fazla kayıt
+    FSP_SYNC,
+    FSP_DEFRAGMENT,
+    FSP_CHECK_INTEGRITY,
+    FSP_OPEN,               // arg = FS_O_* bayrakları
+    FSP_CLOSE,              // arg = tanıtıcı
+    FSP_PREAD,              // arg = tanıtıcı, offset, size
+    FSP_PWRITE,             // arg = tanıtıcı, offset, veri
+    FSP_FREAD,              // arg = tanıtıcı, size
+    FSP_FWRITE,             // arg = tanıtıcı, veri
+    FSP_SEEK,               // arg = tanıtıcı, offset (int64), size = whence
+    FSP_OP_COUNT
+} FspOp;
+
+#endif // PROTO_H
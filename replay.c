@@ -0,0 +1,383 @@
+// replay.c — iz oynatıcı (fsreplay)
+//
+// fs_trace_start ile kaydedilen izi taze bir imaj üzerinde yeniden çalıştırır.
+// İzin başındaki anlık görüntü (format kipi, dosyalar ve boyutları) önce
+// zamanlanmadan kurulur; ardından kayıtlar ya olabildiğince hızlı ya da
+// kaydedilen aralıklarla (-t, -x) oynatılır. Her işlem için oynatma ve kayıt
+// gecikmeleri ile sonucu kayıttan farklı olan çağrı sayısı raporlanır.
+// Veri içeriği izde olmadığından yazımlar sabit bir desenle yapılır.
+#define _POSIX_C_SOURCE 200809L
+
+#include "fs.h"
+#include "trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define REPLAY_IMAGE "replay.sim"
+
+typedef struct {
+    double  *lat;             // oynatma gecikmeleri (saniye)
+    double  *rec;             // kayıttaki gecikmeler (saniye)
+    size_t   count;
+    size_t   cap;
+    uint64_t bytes;
+    uint32_t errors;
+    uint32_t diverged;        // başarı/başarısızlık kayıttakinden farklı
+} OpStats;
+
+static int  csv_output = 0;
+static int  force_dedup = 0;
+static int  force_inline = 0;
+static int  force_log = 0;
+static uint32_t image_flags = 0;      // Oynatma imajının format bayrakları
+static int  fdmap[FS_MAX_OPEN];       // kayıttaki tanıtıcı -> oynatmadaki tanıtıcı
+
+static uint8_t *buf;
+static size_t   buf_cap;
+
+static FsIoVec *vec;
+static int      vec_cap;
+
+// Sonucu aktarılan bayt sayısı olan işlemler
+static const uint8_t is_io[TRACE_OP_MAX] = {
+    [TRACE_WRITE] = 1, [TRACE_READ] = 1, [TRACE_READ_ALL] = 1, [TRACE_APPEND] = 1,
+    [TRACE_PREAD] = 1, [TRACE_PWRITE] = 1, [TRACE_FREAD] = 1, [TRACE_FWRITE] = 1,
+    [TRACE_READV] = 1, [TRACE_WRITEV] = 1, [TRACE_APPENDV] = 1
+};
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void *xrealloc(void *p, size_t n) {
+    p = realloc(p, n);
+    if (!p) { perror("fsreplay: realloc"); exit(EXIT_FAILURE); }
+    return p;
+}
+
+// Yazım deseni; okumalar da aynı tampona yapılır
+static uint8_t *buffer(uint64_t len) {
+    if (len > buf_cap) {
+        size_t cap = buf_cap ? buf_cap : DISK_SIZE;
+        while (cap < len) cap *= 2;
+        buf = xrealloc(buf, cap);
+        for (size_t i = 0; i < cap; ++i) buf[i] = (uint8_t)('a' + (i * 7 + i / 13) % 26);
+        buf_cap = cap;
+    }
+    return buf;
+}
+
+static void add(OpStats *s, double lat, double rec, int64_t r, int io, int64_t recorded) {
+    if (s->count == s->cap) {
+        s->cap = s->cap ? s->cap * 2 : 256;
+        s->lat = xrealloc(s->lat, s->cap * sizeof(*s->lat));
+        s->rec = xrealloc(s->rec, s->cap * sizeof(*s->rec));
+    }
+    s->lat[s->count] = lat;
+    s->rec[s->count] = rec;
+    s->count++;
+    if (r < 0) s->errors++;
+    else if (io) s->bytes += (uint64_t)r;
+    if ((r < 0) != (recorded < 0)) s->diverged++;
+}
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile(const double *sorted, size_t n, double p) {
+    if (n == 0) return 0;
+    size_t idx = (size_t)(p * n + 0.999999);
+    if (idx == 0) idx = 1;
+    if (idx > n) idx = n;
+    return sorted[idx - 1];
+}
+
+static void report(const char *name, OpStats *s, const char *mode, double wall) {
+    if (s->count == 0) return;
+    qsort(s->lat, s->count, sizeof(*s->lat), cmp_double);
+    qsort(s->rec, s->count, sizeof(*s->rec), cmp_double);
+    double total = 0;
+    for (size_t i = 0; i < s->count; ++i) total += s->lat[i];
+    double secs = wall > 0 ? wall : total;     // toplam satırı duvar saatiyle
+    double ops_sec = secs > 0 ? s->count / secs : 0;
+    double mb_sec  = secs > 0 ? (s->bytes / (1024.0 * 1024.0)) / secs : 0;
+    double p50 = percentile(s->lat, s->count, 0.50) * 1e6;
+    double p99 = percentile(s->lat, s->count, 0.99) * 1e6;
+    double p999 = percentile(s->lat, s->count, 0.999) * 1e6;
+    double max = s->lat[s->count - 1] * 1e6;
+    double r50 = percentile(s->rec, s->count, 0.50) * 1e6;
+    double r99 = percentile(s->rec, s->count, 0.99) * 1e6;
+
+    if (csv_output) {
+        printf("%s,%s,%zu,%u,%u,%llu,%.6f,%.1f,%.3f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f\n",
+               name, mode, s->count, s->errors, s->diverged, (unsigned long long)s->bytes,
+               secs, ops_sec, mb_sec, p50, p99, p999, max, r50, r99);
+    } else {
+        printf("{\"op\":\"%s\",\"mode\":\"%s\",\"ops\":%zu,\"errors\":%u,\"diverged\":%u,"
+               "\"bytes\":%llu,\"seconds\":%.6f,\"ops_per_sec\":%.1f,\"mb_per_sec\":%.3f,"
+               "\"p50_us\":%.2f,\"p99_us\":%.2f,\"p999_us\":%.2f,\"max_us\":%.2f,"
+               "\"recorded_p50_us\":%.2f,\"recorded_p99_us\":%.2f}\n",
+               name, mode, s->count, s->errors, s->diverged, (unsigned long long)s->bytes,
+               secs, ops_sec, mb_sec, p50, p99, p999, max, r50, r99);
+    }
+}
+
+static int map_fd(uint32_t recorded) {
+    return recorded < FS_MAX_OPEN ? fdmap[recorded] : -1;
+}
+
+static int format_image(uint32_t flags) {
+    if (force_dedup)       image_flags = FS_FORMAT_DEDUP;
+    else if (force_inline) image_flags = FS_FORMAT_INLINE;
+    else if (force_log)    image_flags = FS_FORMAT_LOG;
+    else                   image_flags = flags;
+    return fs_format_mode(image_flags);
+}
+
+// Anlık görüntü kaydı: izin başladığı andaki durumu kur (zamanlanmaz)
+static int apply_snapshot(const TraceRecord *r) {
+    if (r->op == TRACE_FORMAT) return format_image(r->arg);
+    if (r->op == TRACE_RESIZE) return fs_resize((uint32_t)r->len);
+    if (r->op != TRACE_CREATE) return 0;
+    int rc = fs_create(r->name);
+    if (rc >= 0 && r->len) rc = (int)fs_write(r->name, buffer(r->len), (size_t)r->len);
+    return rc < 0 ? rc : 0;
+}
+
+// Tek bir kaydı (vektörlü çağrıda ilk elemanı, n eleman) çalıştırır
+static int64_t execute(const TraceRecord *r, int n) {
+    uint32_t u;
+    switch (r->op) {
+        case TRACE_FORMAT:     return format_image(r->arg);
+        case TRACE_CREATE:     return fs_create(r->name);
+        case TRACE_DELETE:     return fs_delete(r->name);
+        case TRACE_WRITE:      return fs_write(r->name, buffer(r->len), (size_t)r->len);
+        case TRACE_READ:       return fs_read(r->name, (uint32_t)r->offset, (size_t)r->len, buffer(r->len));
+        case TRACE_READ_ALL:
+            if (fs_size(r->name, &u) < 0) u = 0;
+            return fs_read_all(r->name, buffer(u ? u : 1));
+        case TRACE_RENAME:     return fs_rename(r->name, r->name2);
+        case TRACE_EXISTS:     return fs_exists(r->name);
+        case TRACE_SIZE:       return fs_size(r->name, &u);
+        case TRACE_APPEND:     return fs_append(r->name, buffer(r->len), (size_t)r->len);
+        case TRACE_TRUNCATE:   return fs_truncate(r->name, (uint32_t)r->len);
+        case TRACE_PUNCH_HOLE: return fs_punch_hole(r->name, (uint32_t)r->offset, (uint32_t)r->len);
+        case TRACE_FALLOCATE:  return fs_fallocate(r->name, (uint32_t)r->offset, (uint32_t)r->len, (int)r->arg);
+        case TRACE_COPY:       return fs_copy(r->name, r->name2);
+        case TRACE_MV:         return fs_mv(r->name, r->name2);
+        case TRACE_DEFRAGMENT: return fs_defragment();
+        case TRACE_RESIZE:     return fs_resize((uint32_t)r->len);
+        case TRACE_SYNC:       return fs_sync();
+        case TRACE_OPEN: {
+            int fd = fs_open(r->name, (int)r->arg);
+            if (r->result >= 0 && r->result < FS_MAX_OPEN) fdmap[r->result] = fd;
+            return fd;
+        }
+        case TRACE_CLOSE: {
+            int rc = fs_close(map_fd(r->arg));
+            if (r->arg < FS_MAX_OPEN) fdmap[r->arg] = -1;
+            return rc;
+        }
+        case TRACE_PREAD:  return fs_pread(map_fd(r->arg), buffer(r->len), (size_t)r->len, (uint32_t)r->offset);
+        case TRACE_PWRITE: return fs_pwrite(map_fd(r->arg), buffer(r->len), (size_t)r->len, (uint32_t)r->offset);
+        case TRACE_FREAD:  return fs_fread(map_fd(r->arg), buffer(r->len), (size_t)r->len);
+        case TRACE_FWRITE: return fs_fwrite(map_fd(r->arg), buffer(r->len), (size_t)r->len);
+        case TRACE_SEEK:   return fs_seek(map_fd(r->arg), (int64_t)r->offset, (int)r->len);
+        case TRACE_READV:  return fs_readv(vec, n);
+        case TRACE_WRITEV: return fs_writev(vec, n);
+        case TRACE_APPENDV: {
+            // Toplam uzunluk kayıttaki tampon sayısına eşit bölünür
+            int cnt = r->arg ? (int)r->arg : 1;
+            struct iovec *iov = calloc((size_t)cnt, sizeof(*iov));
+            if (!iov) return FS_ERR_NO_MEMORY;
+            uint8_t *p = buffer(r->len);
+            for (int i = 0; i < cnt; ++i) {
+                iov[i].iov_base = p;
+                iov[i].iov_len = (size_t)(r->len / cnt + (i == cnt - 1 ? r->len % cnt : 0));
+                p += iov[i].iov_len;
+            }
+            ssize_t rc = fs_appendv(r->name, iov, cnt);
+            free(iov);
+            return rc;
+        }
+        default:
+            return FS_ERR_INVALID;
+    }
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s [-t] [-x SPEED] [-o json|csv] [-D | -I | -G] [-C] [-A] [-P POLICY] [-d IMAGE] TRACE\n"
+            "  -t            keep the recorded pacing between calls (default: as fast as possible)\n"
+            "  -x SPEED      recorded pacing scaled by SPEED (2 = twice as fast), implies -t\n"
+            "  -o FORMAT     json (JSON lines, default) or csv\n"
+            "  -D            replay on a dedup-formatted image regardless of the trace\n"
+            "  -I            replay on an image with inline small files regardless of the trace\n"
+            "  -G            replay on a log-structured image regardless of the trace\n"
+            "  -C            disable the block cache and read-ahead\n"
+            "  -A            disable append buffering\n"
+            "  -P POLICY     allocation policy (first-fit, best-fit, next-fit, size-class)\n"
+            "  -d IMAGE      replay image path (default %s), overwritten\n"
+            "Record a trace with fs_trace_start(), 'trace start FILE' or SIMPLEFS_TRACE=FILE.\n",
+            prog, REPLAY_IMAGE);
+}
+
+int main(int argc, char **argv) {
+    const char *image = REPLAY_IMAGE;
+    int paced = 0, no_cache = 0, no_append_buf = 0, opt;
+    double speed = 1.0;
+
+    while ((opt = getopt(argc, argv, "tx:o:DIGCAP:d:h")) != -1) {
+        switch (opt) {
+            case 't': paced = 1; break;
+            case 'x': speed = strtod(optarg, NULL); paced = 1; break;
+            case 'o': csv_output = strcmp(optarg, "csv") == 0; break;
+            case 'D': force_dedup = 1; break;
+            case 'I': force_inline = 1; break;
+            case 'G': force_log = 1; break;
+            case 'C': no_cache = 1; break;
+            case 'A': no_append_buf = 1; break;
+            case 'P': {
+                int p = alloc_policy_parse(optarg);
+                if (p < 0) {
+                    fprintf(stderr, "fsreplay: unknown allocation policy '%s'\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                fs_set_alloc_policy((AllocPolicy)p);
+                break;
+            }
+            case 'd': image = optarg; break;
+            case 'h': usage(argv[0]); return EXIT_SUCCESS;
+            default:  usage(argv[0]); return EXIT_FAILURE;
+        }
+    }
+    if (optind != argc - 1 || speed <= 0) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    FILE *in = fopen(argv[optind], "rb");
+    if (!in) { perror(argv[optind]); return EXIT_FAILURE; }
+    if (trace_read_header(in) < 0) {
+        fprintf(stderr, "fsreplay: '%s' is not a trace file\n", argv[optind]);
+        fclose(in);
+        return EXIT_FAILURE;
+    }
+    if (disk_set_path(image) < 0) return EXIT_FAILURE;
+    fs_cache_enable(!no_cache);
+    fs_append_buffer_enable(!no_append_buf);
+    if (format_image(0) < 0) {
+        fprintf(stderr, "fsreplay: cannot format '%s'\n", image);
+        return EXIT_FAILURE;
+    }
+    for (int i = 0; i < FS_MAX_OPEN; ++i) fdmap[i] = -1;
+
+    static OpStats ops[TRACE_OP_MAX];
+    OpStats all;
+    memset(&all, 0, sizeof(all));
+    TraceRecord r, next;
+    int have_next = 0, rc = 1, snapshot_errors = 0;
+    uint64_t first_ts = 0;
+    int started = 0;
+    double t_start = 0, t_end = 0;
+
+    for (;;) {
+        if (have_next) {
+            r = next;
+            have_next = 0;
+        } else if ((rc = trace_read_next(in, &r)) <= 0) {
+            break;
+        }
+        if (r.op == 0 || r.op >= TRACE_OP_MAX) continue;
+        if (r.flags & TRACE_F_SNAPSHOT) {
+            if (apply_snapshot(&r) < 0) snapshot_errors++;
+            continue;
+        }
+        if (r.flags & TRACE_F_CONT) continue;       // Başı kaybolmuş vektör elemanı
+
+        // Vektörlü çağrı: ardından gelen devam kayıtlarını topla
+        int n = 0;
+        if (r.op == TRACE_READV || r.op == TRACE_WRITEV) {
+            TraceRecord seg = r;
+            for (;;) {
+                if (n == vec_cap) {
+                    vec_cap = vec_cap ? vec_cap * 2 : 16;
+                    vec = xrealloc(vec, (size_t)vec_cap * sizeof(*vec));
+                }
+                char *name = malloc(sizeof(seg.name));
+                if (!name) { perror("fsreplay: malloc"); return EXIT_FAILURE; }
+                memcpy(name, seg.name, sizeof(seg.name));
+                vec[n++] = (FsIoVec){ name, (uint32_t)seg.offset, NULL, (size_t)seg.len };
+                if ((rc = trace_read_next(in, &next)) <= 0) break;
+                if (!(next.flags & TRACE_F_CONT) || next.op != r.op) {
+                    have_next = 1;
+                    break;
+                }
+                seg = next;
+            }
+            uint64_t total = 0;
+            for (int i = 0; i < n; ++i) total += vec[i].len;
+            uint8_t *p = buffer(total ? total : 1);
+            for (int i = 0; i < n; ++i) {
+                vec[i].base = p;
+                p += vec[i].len;
+            }
+        }
+
+        if (!started) {
+            started = 1;
+            first_ts = r.ts_ns;
+            t_start = now_sec();
+        }
+        if (paced) {
+            double due = t_start + (double)(r.ts_ns - first_ts) * 1e-9 / speed;
+            double wait = due - now_sec();
+            if (wait > 0) {
+                struct timespec ts = { (time_t)wait, (long)((wait - (time_t)wait) * 1e9) };
+                nanosleep(&ts, NULL);
+            }
+        }
+
+        double t0 = now_sec();
+        int64_t res = execute(&r, n);
+        double lat = now_sec() - t0;
+        add(&ops[r.op], lat, r.lat_ns * 1e-9, res, is_io[r.op], r.result);
+        add(&all, lat, r.lat_ns * 1e-9, res, is_io[r.op], r.result);
+        for (int i = 0; i < n; ++i) free((void *)vec[i].filename);
+        if (rc < 0) break;
+    }
+    t_end = now_sec();
+    fclose(in);
+    if (rc < 0) fprintf(stderr, "fsreplay: trace is truncated, replayed up to the damaged record\n");
+    if (snapshot_errors) fprintf(stderr, "fsreplay: %d snapshot records could not be applied\n", snapshot_errors);
+
+    char mode[64];
+    const char *kind = (image_flags & FS_FORMAT_DEDUP) ? "dedup"
+                     : (image_flags & FS_FORMAT_INLINE) ? "inline"
+                     : (image_flags & FS_FORMAT_LOG) ? "log" : "plain";
+    if (paced) snprintf(mode, sizeof(mode), "%s-paced-x%g", kind, speed);
+    else       snprintf(mode, sizeof(mode), "%s-asap", kind);
+
+    if (csv_output) {
+        printf("op,mode,ops,errors,diverged,bytes,seconds,ops_per_sec,mb_per_sec,"
+               "p50_us,p99_us,p999_us,max_us,recorded_p50_us,recorded_p99_us\n");
+    }
+    for (int op = 1; op < TRACE_OP_MAX; ++op) {
+        report(trace_op_name(op), &ops[op], mode, 0);
+        free(ops[op].lat);
+        free(ops[op].rec);
+    }
+    report("total", &all, mode, started ? t_end - t_start : 0);
+    free(all.lat);
+    free(all.rec);
+    free(vec);
+    free(buf);
+    return EXIT_SUCCESS;
+}
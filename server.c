@@ -0,0 +1,486 @@
+// server.c — Unix soketi üzerinden çok istemcili sunucu modu
+//
+// Ana iş parçacığı bağlantıları kabul eder ve poll ile gelen baytları okur;
+// tamamlanan her istek çerçevesi bağlantının kuyruğuna eklenir ve bağlantı
+// çalışma kuyruğuna konur. İşçi havuzu bağlantıları alıp isteklerini sırayla
+// çalıştırır ve yanıtları yazar; böylece bir istemcinin ardışık (pipelined)
+// istekleri sırasını korurken farklı istemciler paralel ilerler. Dosya sistemi
+// çağrıları fs.h'nin kendi paylaşımlı/özel kilidiyle korunur; sunucu ek bir
+// kilit tutmaz. Tanıtıcı tablosu (owned) bağlantıya özeldir ve bir bağlantının
+// istekleri aynı anda tek işçide çalıştığından ayrıca kilit gerektirmez.
+#define _POSIX_C_SOURCE 200809L
+
+#include "server.h"
+#include "proto.h"
+#include "fs.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#define CONN_QUEUE_MAX  256     // Bu kadar istek birikince bağlantı okunmaz
+#define CONN_BATCH      16      // İşçi sırayı başkasına bırakmadan önce en fazla
+#define MAX_CONNS       256
+
+typedef struct Req {
+    struct Req *next;
+    uint32_t    id;
+    uint8_t     op;
+    uint64_t    offset;
+    uint32_t    size;
+    uint32_t    arg;
+    char       *name;
+    char       *name2;
+    uint8_t    *data;
+    size_t      data_len;
+} Req;
+
+typedef struct Conn {
+    int             fd;
+    pthread_mutex_t lock;       // Kuyruk, scheduled, closing
+    Req            *head, *tail;
+    unsigned        qlen;
+    int             scheduled;  // Çalışma kuyruğunda ya da bir işçide
+    int             closing;    // İstemci ayrıldı; kuyruk bitince serbest bırakılır
+    struct Conn    *next_run;
+    uint8_t        *in;         // Yalnızca ana iş parçacığı: okunmuş, çözülmemiş baytlar
+    size_t          in_len, in_cap;
+    uint8_t         owned[FS_MAX_OPEN];     // Bu bağlantının açtığı tanıtıcılar
+} Conn;
+
+static pthread_mutex_t run_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  run_cond = PTHREAD_COND_INITIALIZER;
+static Conn *run_head, *run_tail;
+static int   stopping;
+static int   wake_pipe[2] = { -1, -1 };
+static volatile sig_atomic_t got_signal;
+
+static void put_le(uint8_t *out, uint64_t v, int n) {
+    for (int i = 0; i < n; ++i) out[i] = (uint8_t)(v >> (8 * i));
+}
+
+static uint64_t get_le(const uint8_t *in, int n) {
+    uint64_t v = 0;
+    for (int i = 0; i < n; ++i) v |= (uint64_t)in[i] << (8 * i);
+    return v;
+}
+
+static void wake_dispatcher(void) {
+    char c = 1;
+    ssize_t n = write(wake_pipe[1], &c, 1);
+    (void)n;
+}
+
+static void on_signal(int sig) {
+    (void)sig;
+    got_signal = 1;
+    wake_dispatcher();
+}
+
+// Kilit tutulmadan, bağlantıya artık kimse erişmezken
+static void conn_free(Conn *c) {
+    for (int fd = 0; fd < FS_MAX_OPEN; ++fd) {
+        if (c->owned[fd]) fs_close(fd);
+    }
+    for (Req *r = c->head, *n; r; r = n) {
+        n = r->next;
+        free(r);
+    }
+    close(c->fd);
+    pthread_mutex_destroy(&c->lock);
+    free(c->in);
+    free(c);
+}
+
+static void run_push(Conn *c) {
+    pthread_mutex_lock(&run_lock);
+    c->next_run = NULL;
+    if (run_tail) run_tail->next_run = c;
+    else run_head = c;
+    run_tail = c;
+    pthread_cond_signal(&run_cond);
+    pthread_mutex_unlock(&run_lock);
+}
+
+static int send_all(int fd, struct iovec *iov, int cnt) {
+    while (cnt > 0) {
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = iov;
+        msg.msg_iovlen = (size_t)cnt;
+        ssize_t n = sendmsg(fd, &msg, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+        while (cnt > 0 && (size_t)n >= iov->iov_len) {
+            n -= (ssize_t)iov->iov_len;
+            iov++;
+            cnt--;
+        }
+        if (cnt > 0) {
+            iov->iov_base = (uint8_t *)iov->iov_base + n;
+            iov->iov_len -= (size_t)n;
+        }
+    }
+    return 0;
+}
+
+// Tanıtıcı bu bağlantıya mı ait (başka istemcinin tanıtıcısı kullanılamaz)
+static int conn_fd(const Conn *c, uint32_t fd) {
+    return fd < FS_MAX_OPEN && c->owned[fd] ? (int)fd : -1;
+}
+
+// İsteği çalıştırır; yanıt verisi *out / *out_len
+static int64_t execute(Conn *c, const Req *r, uint8_t **out, size_t *out_len) {
+    uint32_t u;
+    int fd;
+    *out = NULL;
+    *out_len = 0;
+    switch (r->op) {
+        case FSP_FORMAT:     return fs_format_mode(r->arg);
+        case FSP_CREATE:     return fs_create(r->name);
+        case FSP_DELETE:     return fs_delete(r->name);
+        case FSP_WRITE:      return fs_write(r->name, r->data, r->data_len);
+        case FSP_APPEND:     return fs_append(r->name, r->data, r->data_len);
+        case FSP_EXISTS:     return fs_exists(r->name);
+        case FSP_RENAME:     return fs_rename(r->name, r->name2);
+        case FSP_TRUNCATE:   return fs_truncate(r->name, r->size);
+        case FSP_PUNCH_HOLE: return fs_punch_hole(r->name, (uint32_t)r->offset, r->size);
+        case FSP_COPY:       return fs_copy(r->name, r->name2);
+        case FSP_MV:         return fs_mv(r->name, r->name2);
+        case FSP_SYNC:       return fs_sync();
+        case FSP_DEFRAGMENT: return fs_defragment();
+        case FSP_CHECK_INTEGRITY: return fs_check_integrity();
+        case FSP_SIZE: {
+            int rc = fs_size(r->name, &u);
+            if (rc < 0) return rc;
+            if (!(*out = malloc(4))) return FS_ERR_NO_MEMORY;
+            put_le(*out, u, 4);
+            *out_len = 4;
+            return rc;
+        }
+        case FSP_READ:
+        case FSP_PREAD:
+        case FSP_FREAD: {
+            if (r->size > FSP_MAX_DATA) return FS_ERR_INVALID;
+            if (!(*out = malloc(r->size ? r->size : 1))) return FS_ERR_NO_MEMORY;
+            ssize_t n;
+            if (r->op == FSP_READ) {
+                n = fs_read(r->name, (uint32_t)r->offset, r->size, *out);
+            } else if ((fd = conn_fd(c, r->arg)) < 0) {
+                n = FS_ERR_BADF;
+            } else if (r->op == FSP_PREAD) {
+                n = fs_pread(fd, *out, r->size, (uint32_t)r->offset);
+            } else {
+                n = fs_fread(fd, *out, r->size);
+            }
+            if (n > 0) *out_len = (size_t)n;
+            return n;
+        }
+        case FSP_LIST: {
+            FileEntry entries[MAX_FILES];
+            int n = fs_list(entries, MAX_FILES);
+            if (n < 0) return n;
+            uint32_t cnt = (uint32_t)n < r->size ? (uint32_t)n : r->size;
+            if (!(*out = malloc((size_t)cnt * FSP_ENTRY_SIZE + 1))) return FS_ERR_NO_MEMORY;
+            for (uint32_t i = 0; i < cnt; ++i) {
+                uint8_t *p = *out + (size_t)i * FSP_ENTRY_SIZE;
+                memcpy(p, entries[i].name, 32);
+                put_le(p + 32, entries[i].size, 4);
+                put_le(p + 36, entries[i].start_block, 4);
+                put_le(p + 40, (uint64_t)(int64_t)entries[i].created, 8);
+            }
+            *out_len = (size_t)cnt * FSP_ENTRY_SIZE;
+            return n;
+        }
+        case FSP_OPEN: {
+            int rc = fs_open(r->name, (int)r->arg);
+            if (rc >= 0 && rc < FS_MAX_OPEN) c->owned[rc] = 1;
+            return rc;
+        }
+        case FSP_CLOSE:
+            if ((fd = conn_fd(c, r->arg)) < 0) return FS_ERR_BADF;
+            c->owned[fd] = 0;
+            return fs_close(fd);
+        case FSP_PWRITE:
+            if ((fd = conn_fd(c, r->arg)) < 0) return FS_ERR_BADF;
+            return fs_pwrite(fd, r->data, r->data_len, (uint32_t)r->offset);
+        case FSP_FWRITE:
+            if ((fd = conn_fd(c, r->arg)) < 0) return FS_ERR_BADF;
+            return fs_fwrite(fd, r->data, r->data_len);
+        case FSP_SEEK:
+            if ((fd = conn_fd(c, r->arg)) < 0) return FS_ERR_BADF;
+            return fs_seek(fd, (int64_t)r->offset, (int)r->size);
+        default:
+            return FS_ERR_UNSUPPORTED;
+    }
+}
+
+static void serve(Conn *c, Req *r) {
+    uint8_t *out;
+    size_t out_len;
+    int64_t result = execute(c, r, &out, &out_len);
+
+    uint8_t hdr[FSP_RESP_HDR];
+    put_le(hdr, FSP_RESP_HDR - 4 + out_len, 4);
+    put_le(hdr + 4, r->id, 4);
+    put_le(hdr + 8, (uint64_t)result, 8);
+    struct iovec iov[2] = { { hdr, sizeof(hdr) }, { out, out_len } };
+    send_all(c->fd, iov, out_len ? 2 : 1);   // İstemci ayrıldıysa yanıt düşer
+    free(out);
+}
+
+static void *worker_main(void *arg) {
+    (void)arg;
+    for (;;) {
+        pthread_mutex_lock(&run_lock);
+        while (!stopping && !run_head) pthread_cond_wait(&run_cond, &run_lock);
+        if (!run_head) {
+            pthread_mutex_unlock(&run_lock);
+            break;
+        }
+        Conn *c = run_head;
+        run_head = c->next_run;
+        if (!run_head) run_tail = NULL;
+        pthread_mutex_unlock(&run_lock);
+
+        for (int done = 0; ; ++done) {
+            pthread_mutex_lock(&c->lock);
+            Req *r = done < CONN_BATCH ? c->head : NULL;
+            if (!r) {
+                int more = c->head != NULL, release = !more && c->closing;
+                if (!more) c->scheduled = 0;
+                pthread_mutex_unlock(&c->lock);
+                if (more) run_push(c);            // Sırayı diğer bağlantılara bırak
+                else if (release) conn_free(c);
+                break;
+            }
+            c->head = r->next;
+            if (!c->head) c->tail = NULL;
+            int was_full = c->qlen-- == CONN_QUEUE_MAX;
+            pthread_mutex_unlock(&c->lock);
+            if (was_full) wake_dispatcher();     // Bağlantı yeniden okunabilir
+            serve(c, r);
+            free(r);
+        }
+    }
+    return NULL;
+}
+
+// Tamponda tamamlanmış çerçeveleri isteğe çevirip kuyruğa ekler; protokol hatasında -1
+static int parse_frames(Conn *c) {
+    size_t pos = 0;
+    int rc = 0;
+    while (c->in_len - pos >= 4) {
+        uint32_t len = (uint32_t)get_le(c->in + pos, 4);
+        if (len < FSP_REQ_HDR - 4 || len > FSP_MAX_FRAME - 4) { rc = -1; break; }
+        if (c->in_len - pos < 4 + (size_t)len) break;
+        const uint8_t *p = c->in + pos;
+        uint8_t n1 = p[9], n2 = p[10];
+        if ((size_t)FSP_REQ_HDR + n1 + n2 > 4 + (size_t)len) { rc = -1; break; }
+        size_t data_len = 4 + (size_t)len - FSP_REQ_HDR - n1 - n2;
+
+        Req *r = malloc(sizeof(*r) + n1 + 1 + n2 + 1 + data_len);
+        if (!r) { rc = -1; break; }
+        r->next = NULL;
+        r->id = (uint32_t)get_le(p + 4, 4);
+        r->op = p[8];
+        r->offset = get_le(p + 12, 8);
+        r->size = (uint32_t)get_le(p + 20, 4);
+        r->arg = (uint32_t)get_le(p + 24, 4);
+        r->name = (char *)(r + 1);
+        r->name2 = r->name + n1 + 1;
+        r->data = (uint8_t *)r->name2 + n2 + 1;
+        r->data_len = data_len;
+        memcpy(r->name, p + FSP_REQ_HDR, n1);
+        r->name[n1] = '\0';
+        memcpy(r->name2, p + FSP_REQ_HDR + n1, n2);
+        r->name2[n2] = '\0';
+        memcpy(r->data, p + FSP_REQ_HDR + n1 + n2, data_len);
+        pos += 4 + (size_t)len;
+
+        pthread_mutex_lock(&c->lock);
+        if (c->tail) c->tail->next = r;
+        else c->head = r;
+        c->tail = r;
+        c->qlen++;
+        int schedule = !c->scheduled;
+        c->scheduled = 1;
+        pthread_mutex_unlock(&c->lock);
+        if (schedule) run_push(c);
+    }
+    memmove(c->in, c->in + pos, c->in_len - pos);
+    c->in_len -= pos;
+    return rc;
+}
+
+// Okunabilir bağlantıdan gelen baytları al; bağlantı kapandıysa -1
+static int conn_read(Conn *c) {
+    if (c->in_cap - c->in_len < 64 * 1024) {
+        size_t cap = c->in_cap ? c->in_cap * 2 : 128 * 1024;
+        if (cap > FSP_MAX_FRAME + 64 * 1024) cap = FSP_MAX_FRAME + 64 * 1024;
+        if (cap > c->in_cap) {
+            uint8_t *in = realloc(c->in, cap);
+            if (!in) return -1;
+            c->in = in;
+            c->in_cap = cap;
+        }
+    }
+    ssize_t n = recv(c->fd, c->in + c->in_len, c->in_cap - c->in_len, MSG_DONTWAIT);
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) return 0;
+    if (n <= 0) return -1;
+    c->in_len += (size_t)n;
+    return parse_frames(c);
+}
+
+// İstemci ayrıldı: kuyrukta iş kalmadıysa hemen, yoksa son işi yapan işçi bırakır
+static void conn_close(Conn *c) {
+    pthread_mutex_lock(&c->lock);
+    c->closing = 1;
+    int release = !c->scheduled;
+    pthread_mutex_unlock(&c->lock);
+    if (release) conn_free(c);
+}
+
+static int listen_on(const char *path) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "server: socket path too long: %s\n", path);
+        return -1;
+    }
+    strcpy(addr.sun_path, path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) { perror("server: socket"); return -1; }
+    // Soket dosyası yalnızca sahibine açık (0600) oluşturulur: imaja erişim
+    // bu dosyaya bağlanabilenlerle sınırlıdır
+    mode_t old_mask = umask(0177);
+    int rc = bind(fd, (struct sockaddr *)&addr, sizeof(addr));
+    if (rc < 0 && errno == EADDRINUSE) {
+        // Eski bir sunucudan kalan soket dosyası mı, yoksa çalışan bir sunucu mu?
+        int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+        int alive = probe >= 0 && connect(probe, (struct sockaddr *)&addr, sizeof(addr)) == 0;
+        if (probe >= 0) close(probe);
+        if (alive) {
+            fprintf(stderr, "server: another server is listening on %s\n", path);
+            umask(old_mask);
+            close(fd);
+            return -1;
+        }
+        unlink(path);
+        rc = bind(fd, (struct sockaddr *)&addr, sizeof(addr));
+    }
+    umask(old_mask);
+    if (rc < 0 || listen(fd, 64) < 0) {
+        fprintf(stderr, "server: cannot listen on %s: %s\n", path, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int server_run(const char *socket_path, int workers) {
+    if (workers <= 0) workers = SERVER_DEFAULT_WORKERS;
+    if (workers > SERVER_MAX_WORKERS) workers = SERVER_MAX_WORKERS;
+    int lfd = listen_on(socket_path);
+    if (lfd < 0) return FS_ERR_IO;
+    if (pipe(wake_pipe) < 0 || fcntl(wake_pipe[0], F_SETFL, O_NONBLOCK) < 0 ||
+        fcntl(wake_pipe[1], F_SETFL, O_NONBLOCK) < 0) {
+        perror("server: pipe");
+        close(lfd);
+        return FS_ERR_IO;
+    }
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    pthread_t tids[SERVER_MAX_WORKERS];
+    int started = 0;
+    for (; started < workers; ++started) {
+        if (pthread_create(&tids[started], NULL, worker_main, NULL) != 0) break;
+    }
+    if (started == 0) {
+        fprintf(stderr, "server: cannot start workers\n");
+        close(lfd);
+        return FS_ERR_IO;
+    }
+    fprintf(stderr, "server: listening on %s (%d workers)\n", socket_path, started);
+
+    Conn *conns[MAX_CONNS];
+    int nconns = 0;
+    struct pollfd pfd[MAX_CONNS + 2];
+    Conn *polled[MAX_CONNS];
+    while (!got_signal) {
+        pfd[0] = (struct pollfd){ lfd, nconns < MAX_CONNS ? POLLIN : 0, 0 };
+        pfd[1] = (struct pollfd){ wake_pipe[0], POLLIN, 0 };
+        int np = 2;
+        for (int i = 0; i < nconns; ++i) {
+            pthread_mutex_lock(&conns[i]->lock);
+            int full = conns[i]->qlen >= CONN_QUEUE_MAX;
+            pthread_mutex_unlock(&conns[i]->lock);
+            if (full) continue;                  // İşçiler yetişene kadar okuma
+            polled[np - 2] = conns[i];
+            pfd[np++] = (struct pollfd){ conns[i]->fd, POLLIN, 0 };
+        }
+        if (poll(pfd, (nfds_t)np, -1) < 0) {
+            if (errno == EINTR) continue;
+            perror("server: poll");
+            break;
+        }
+        if (pfd[1].revents) {
+            char drain[64];
+            while (read(wake_pipe[0], drain, sizeof(drain)) > 0) {}
+        }
+        for (int i = 2; i < np; ++i) {
+            if (!pfd[i].revents) continue;
+            Conn *c = polled[i - 2];
+            if (conn_read(c) == 0) continue;
+            for (int k = 0; k < nconns; ++k) {
+                if (conns[k] == c) {
+                    conns[k] = conns[--nconns];
+                    break;
+                }
+            }
+            conn_close(c);
+        }
+        if (pfd[0].revents & POLLIN) {
+            int cfd = accept(lfd, NULL, NULL);
+            Conn *c = cfd >= 0 ? calloc(1, sizeof(*c)) : NULL;
+            if (c) {
+                c->fd = cfd;
+                pthread_mutex_init(&c->lock, NULL);
+                conns[nconns++] = c;
+            } else if (cfd >= 0) {
+                close(cfd);
+            }
+        }
+    }
+
+    // Yeni istek alma; işçiler kuyruktaki işleri bitirip çıkar
+    close(lfd);
+    unlink(socket_path);
+    pthread_mutex_lock(&run_lock);
+    stopping = 1;
+    pthread_cond_broadcast(&run_cond);
+    pthread_mutex_unlock(&run_lock);
+    for (int i = 0; i < started; ++i) pthread_join(tids[i], NULL);
+    for (int i = 0; i < nconns; ++i) conn_free(conns[i]);
+    close(wake_pipe[0]);
+    close(wake_pipe[1]);
+    fprintf(stderr, "server: stopped\n");
+    return fs_sync();
+}
@@ -0,0 +1,13 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+// Sunucu modu: disk imajının tek sahibi olarak Unix soketinden proto.h
+// protokolüyle istek karşılar (istemci: fsclient.h). Çağıran imajı önceden
+// açmış/formatlamış olmalıdır. SIGINT/SIGTERM alınana kadar döner ve çıkarken
+// bekleyen yazımları fs_sync ile diske aktarır, soket dosyasını siler.
+#define SERVER_DEFAULT_WORKERS 4
+#define SERVER_MAX_WORKERS     64
+
+int server_run(const char *socket_path, int workers);
+
+#endif // SERVER_H
@@ -0,0 +1,390 @@
+// share.c — imajın süreçler arasında paylaşımı: danışma kilitleri ve nesil
+//
+// Kilitler ayrı bir tanıtıcı (aygıt 0'ın O_RDWR kopyası) üzerinde OFD
+// kilitleridir: tanıtıcıya bağlı olduklarından disk_reset'in kapattığı
+// disk_fds'ten etkilenmezler ve süreç bitince çekirdek tarafından bırakılır.
+// Kilit baytları:
+//   [0, METADATA_SIZE)            metadata (her çağrı, paylaşımlı ya da özel)
+//   METADATA_SIZE + veri konumu   veri aralıkları (yalnızca paylaşımlı çağrılarda)
+//   DISK_SIZE + 0                 varlık: imajı açan her süreç paylaşımlı tutar
+//   DISK_SIZE + 1                 kira: imajı tek başına açmış süreç özel tutar
+//   DISK_SIZE + 2                 nesil kelimesinin oku-değiştir-yaz'ı
+// Platform OFD kilitlerini desteklemiyorsa ya da imaj henüz yoksa kilit
+// alınmaz; davranış tek süreçli eski davranıştır.
+//
+// Çağrılar share_begin'den share_end'e kadar modülün mutex'ini tutar; kira
+// tutulurken çalışan izleyici iş parçacığı durumu yalnızca çağrı dışındayken
+// yazar. İzleyici varlık baytına mutex'siz bakar ve isteği yield_req ile de
+// bildirir: ard arda çağrı yapan süreçte kirayı sıradaki çağrı bırakır.
+#define _GNU_SOURCE             // F_OFD_SETLK, F_OFD_SETLKW, F_OFD_GETLK
+
+#include "share.h"
+#include "disk.h"
+#include "stats.h"
+#include "fserr.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stddef.h>     // offsetof
+#include <string.h>
+#include <time.h>       // nanosleep
+#include <unistd.h>
+
+#define LOCK_PRESENCE   ((uint64_t)DISK_SIZE + 0)
+#define LOCK_LEASE      ((uint64_t)DISK_SIZE + 1)
+#define LOCK_GEN        ((uint64_t)DISK_SIZE + 2)
+#define GEN_OFFSET      ((off_t)offsetof(DiskMetadata, flags))
+#define GEN_LIMIT       (SHARE_GEN_MASK >> SHARE_GEN_SHIFT)
+#define BUSY_POLL_MS    5
+
+enum { MODE_NONE, MODE_OWNER, MODE_SHARED, MODE_EXCLUSIVE };
+
+static int        lock_fd = -1;
+static int        mode;                 // Süren çağrının kilit kipi (MODE_NONE = çağrı dışında)
+static int        lease;                // Kira baytı tutuluyor: kilitsiz çalışılır
+static int        have_gen;             // gen_seen imajdan okundu
+static int        meta_ok;              // Bellekteki metadata gen_seen'deki imajla aynı
+static int        stale;                // Çağrı sırasında başka süreç yazdı (önbellekler bayat olabilir)
+static uint32_t   gen_seen;             // Bu sürecin bildiği son nesil
+static uint32_t   op_gen;               // Süren çağrı yazarsa imaja konacak nesil
+static int        op_published;         // Süren çağrı nesli metadata ile yazdı
+static uint64_t   op_mark;              // Çağrı başındaki yazım sayacı
+static uint64_t   writes;               // İmaja yapılan yazımlar (her iş parçacığından)
+static uint32_t   lease_retry;          // Kirayı yeniden denemeden önce geçecek çağrılar
+static int        yield_req;            // İzleyici başka süreç gördü (atomik)
+static int      (*release_fn)(void);
+static ShareStats st;
+
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  wake = PTHREAD_COND_INITIALIZER;
+static pthread_t       watcher;
+static int             started, stopping;
+
+static uint32_t gen_next(uint32_t gen) {
+    return (gen + 1) & GEN_LIMIT;
+}
+
+#ifdef F_OFD_SETLK
+
+// Kilit çağrısı; 0 ya da errno ile -1 (EINTR'de yeniden denenir)
+static int lock_call(int cmd, struct flock *fl) {
+    for (;;) {
+        STATS_SYSCALL(1);
+        if (fcntl(lock_fd, cmd, fl) == 0) return 0;
+        if (errno != EINTR) return -1;
+    }
+}
+
+// Aralığı kilitler / bırakır (type F_UNLCK); wait 0 ise meşgulse EAGAIN
+static int lock_bytes(short type, uint64_t start, uint64_t len, int wait) {
+    struct flock fl;
+    memset(&fl, 0, sizeof(fl));             // OFD kilitlerinde l_pid 0 olmalı
+    fl.l_type   = type;
+    fl.l_whence = SEEK_SET;
+    fl.l_start  = (off_t)start;
+    fl.l_len    = (off_t)len;
+    if (lock_call(F_OFD_SETLK, &fl) == 0) return 0;
+    if (!wait || (errno != EAGAIN && errno != EACCES)) return -1;
+    st.lock_waits++;
+    return lock_call(F_OFD_SETLKW, &fl);
+}
+
+// Başka bir tanıtıcı aralıkta type ile çakışan kilit tutuyor mu (1/0, hata -1)
+static int lock_held(short type, uint64_t start) {
+    struct flock fl;
+    memset(&fl, 0, sizeof(fl));
+    fl.l_type   = type;
+    fl.l_whence = SEEK_SET;
+    fl.l_start  = (off_t)start;
+    fl.l_len    = 1;
+    if (lock_call(F_OFD_GETLK, &fl) < 0) return -1;
+    return fl.l_type != F_UNLCK;
+}
+
+// Kilit tanıtıcısını açar ve varlık baytını alır. Kira başka süreçteyse
+// SHARE_BUSY_WAIT_MS boyunca bırakılmasını bekler. İmaj yoksa (henüz
+// formatlanmadı) kilitsiz devam edilir; sonraki çağrı yeniden dener.
+static int share_open(void) {
+    const char *path = disk_device(0);
+    STATS_SYSCALL(1);
+    lock_fd = open(path, O_RDWR | O_CLOEXEC);
+    if (lock_fd < 0) return 0;
+    if (lock_bytes(F_RDLCK, LOCK_PRESENCE, 1, 1) < 0) {
+        int err = errno;
+        share_close();
+        if (err == EINVAL || err == ENOSYS) return 0;    // Dosya sistemi OFD kilidini desteklemiyor
+        FS_FAIL(FS_ERR_IO, "share: cannot lock '%s': %s", path, strerror(err));
+    }
+    for (int waited = 0; ; waited += BUSY_POLL_MS) {
+        int held = lock_held(F_RDLCK, LOCK_LEASE);
+        if (held == 0) return 0;
+        if (held < 0 || waited >= SHARE_BUSY_WAIT_MS) {
+            share_close();
+            if (held < 0) FS_FAIL(FS_ERR_IO, "share: cannot query locks on '%s'", path);
+            FS_FAIL(FS_ERR_BUSY, "share: '%s' is leased by another process that did not release it", path);
+        }
+        struct timespec ts = { 0, BUSY_POLL_MS * 1000000L };
+        nanosleep(&ts, NULL);
+    }
+}
+
+#else   // OFD kilitleri yok: tek süreçli davranış
+
+static int lock_bytes(short type, uint64_t start, uint64_t len, int wait) {
+    (void)type; (void)start; (void)len; (void)wait;
+    return 0;
+}
+
+static int lock_held(short type, uint64_t start) {
+    (void)type; (void)start;
+    return 0;
+}
+
+static int share_open(void) {
+    return 0;
+}
+
+#endif
+
+static int read_word(uint32_t *word) {
+    STATS_SYSCALL(1);
+    if (pread(lock_fd, word, sizeof(*word), GEN_OFFSET) != (ssize_t)sizeof(*word)) {
+        FS_FAIL(FS_ERR_IO, "share: cannot read generation of '%s'", disk_device(0));
+    }
+    return 0;
+}
+
+static void set_gen(uint32_t gen) {
+    gen_seen = gen;
+    have_gen = 1;
+    metadata.flags = (metadata.flags & ~SHARE_GEN_MASK) | (gen << SHARE_GEN_SHIFT);
+}
+
+// Mutex tutulurken, çağrı dışında: bekleyen durumu yazar ve kirayı bırakır.
+// Kira tutulurken başka süreç yoktu; açılmakta olan süreç önbellek
+// tutmadığından yalnızca veri yazan çağrıların nesli yayımlanmamış olabilir.
+static void share_yield(void) {
+    mode = MODE_OWNER;
+    op_mark = __atomic_load_n(&writes, __ATOMIC_RELAXED);
+    op_published = 0;
+    op_gen = gen_next(gen_seen);
+    if (release_fn) release_fn();
+    mode = MODE_NONE;
+    lock_bytes(F_UNLCK, LOCK_LEASE, 1, 0);
+    lease = 0;
+    lease_retry = SHARE_LEASE_RETRY;
+    __atomic_store_n(&yield_req, 0, __ATOMIC_RELAXED);
+    st.yields++;
+}
+
+static void *watcher_main(void *arg) {
+    (void)arg;
+    pthread_mutex_lock(&lock);
+    while (!stopping) {
+        if (!lease) {
+            pthread_cond_wait(&wake, &lock);
+            continue;
+        }
+        pthread_mutex_unlock(&lock);
+        struct timespec ts = { 0, SHARE_POLL_MS * 1000000L };
+        nanosleep(&ts, NULL);
+        int others = lock_held(F_WRLCK, LOCK_PRESENCE) > 0;
+        if (others) __atomic_store_n(&yield_req, 1, __ATOMIC_RELAXED);
+        pthread_mutex_lock(&lock);
+        if (others && lease && !stopping) share_yield();
+    }
+    pthread_mutex_unlock(&lock);
+    return NULL;
+}
+
+int share_begin(int exclusive) {
+    pthread_mutex_lock(&lock);
+    int rc = lock_fd < 0 ? share_open() : 0;
+    if (rc < 0) {
+        pthread_mutex_unlock(&lock);
+        return rc;
+    }
+    if (lease && __atomic_load_n(&yield_req, __ATOMIC_RELAXED)) share_yield();
+    op_mark = __atomic_load_n(&writes, __ATOMIC_RELAXED);
+    op_published = 0;
+    if (lock_fd < 0 || lease) {
+        mode = MODE_OWNER;
+        op_gen = gen_next(gen_seen);
+        return meta_ok ? SHARE_CURRENT : SHARE_RELOAD;
+    }
+    if (lock_bytes(exclusive ? F_WRLCK : F_RDLCK, 0, METADATA_SIZE, 1) < 0) {
+        int err = errno;
+        pthread_mutex_unlock(&lock);
+        FS_FAIL(FS_ERR_IO, "share: cannot lock metadata of '%s': %s", disk_device(0), strerror(err));
+    }
+    st.locks++;
+    mode = exclusive ? MODE_EXCLUSIVE : MODE_SHARED;
+    uint32_t word;
+    if ((rc = read_word(&word)) < 0) {
+        share_end(1);
+        return rc;
+    }
+    st.validations++;
+    uint32_t gen = word >> SHARE_GEN_SHIFT;
+    op_gen = gen_next(gen);
+    if (have_gen && (gen != gen_seen || stale)) {
+        st.reloads++;
+        stale = meta_ok = 0;
+        return SHARE_CHANGED;
+    }
+    return meta_ok ? SHARE_CURRENT : SHARE_RELOAD;
+}
+
+// Yalnızca veri yazan çağrının neslini yayımlar. Paylaşımlı kipte başka
+// süreçler de aynı anda yayımlayabildiğinden kelime ayrı bir baytla korunur
+// ve imajdaki değerin üstüne artırılır.
+static void share_publish(void) {
+    int guard = mode == MODE_SHARED;
+    if (guard && lock_bytes(F_WRLCK, LOCK_GEN, 1, 1) < 0) {
+        stale = 1;
+        return;
+    }
+    uint32_t word, gen = op_gen;
+    if (read_word(&word) == 0) {
+        if (guard) {
+            if ((word >> SHARE_GEN_SHIFT) != gen_seen) stale = 1;
+            gen = gen_next(word >> SHARE_GEN_SHIFT);
+        }
+        word = (word & ~SHARE_GEN_MASK) | (gen << SHARE_GEN_SHIFT);
+        STATS_SYSCALL(1);
+        if (pwrite(lock_fd, &word, sizeof(word), GEN_OFFSET) == (ssize_t)sizeof(word)) {
+            set_gen(gen);
+            st.publishes++;
+        } else {
+            FS_ERROR("share: cannot publish generation of '%s': %s", disk_device(0), strerror(errno));
+        }
+    }
+    if (guard) lock_bytes(F_UNLCK, LOCK_GEN, 1, 0);
+}
+
+void share_end(int failed) {
+    if (mode == MODE_NONE) return;
+    // Kira tutulurken önbellek tutan başka süreç yoktur: yayımlamaya gerek yok
+    if (mode != MODE_OWNER && !op_published && __atomic_load_n(&writes, __ATOMIC_RELAXED) != op_mark) {
+        share_publish();
+    }
+    if (failed) meta_ok = 0;
+    // Metadata ve veri aralıkları tek çağrıda bırakılır
+    if (mode != MODE_OWNER) lock_bytes(F_UNLCK, 0, DISK_SIZE, 0);
+    mode = MODE_NONE;
+    pthread_mutex_unlock(&lock);
+}
+
+int share_hold(int pending) {
+    if (lock_fd < 0 || lease) return 1;
+    if (lease_retry) {
+        lease_retry--;
+    } else {
+        lease_retry = SHARE_LEASE_RETRY;
+        if (lock_bytes(F_WRLCK, LOCK_LEASE, 1, 0) == 0) {
+            // Kira alındıktan sonra bakılır: açılmakta olan süreç ya burada
+            // görülür ya da kirayı görüp bekler. Kirayı bırakacak izleyici
+            // başlatılamazsa kira tutulmaz.
+            if (lock_held(F_WRLCK, LOCK_PRESENCE) == 0 &&
+                (started || pthread_create(&watcher, NULL, watcher_main, NULL) == 0)) {
+                started = 1;
+                lease = 1;
+                lease_retry = 0;
+                __atomic_store_n(&yield_req, 0, __ATOMIC_RELAXED);
+                pthread_cond_signal(&wake);
+                return 1;
+            }
+            lock_bytes(F_UNLCK, LOCK_LEASE, 1, 0);
+        }
+    }
+    if (pending) st.state_flushes++;
+    return 0;
+}
+
+void share_set_release(int (*release)(void)) {
+    release_fn = release;
+}
+
+void share_shutdown(void) {
+    pthread_mutex_lock(&lock);
+    int was = started;
+    stopping = 1;
+    pthread_cond_signal(&wake);
+    pthread_mutex_unlock(&lock);
+    if (was) pthread_join(watcher, NULL);
+    pthread_mutex_lock(&lock);
+    started = stopping = 0;
+    pthread_mutex_unlock(&lock);
+}
+
+int share_lock_range(uint64_t offset, uint64_t len, int exclusive) {
+    if (mode != MODE_SHARED || len == 0) return 0;
+    if (lock_bytes(exclusive ? F_WRLCK : F_RDLCK, METADATA_SIZE + offset, len, 1) < 0) {
+        FS_FAIL(FS_ERR_IO, "share: cannot lock data range of '%s': %s", disk_device(0), strerror(errno));
+    }
+    st.range_locks++;
+    // Metadata kilidinden sonra yalnızca yerinde yazan paylaşımlı çağrılar
+    // yayımlayabilir: metadata aynı kalır, veri önbellekleri bayat olabilir
+    uint32_t word;
+    int rc = read_word(&word);
+    if (rc < 0) return rc;
+    uint32_t gen = word >> SHARE_GEN_SHIFT;
+    if (gen == gen_seen) return 0;
+    set_gen(gen);
+    op_gen = gen_next(gen);
+    st.reloads++;
+    return 1;
+}
+
+uint32_t share_next_gen(void) {
+    return mode != MODE_NONE ? op_gen : gen_next(gen_seen);
+}
+
+void share_gen_written(uint32_t gen) {
+    set_gen(gen);
+    meta_ok = 1;
+    if (mode != MODE_NONE) op_published = 1;
+}
+
+void share_loaded(uint32_t gen) {
+    gen_seen = gen;
+    have_gen = meta_ok = 1;
+    stale = 0;
+}
+
+int share_current(void) {
+    return mode != MODE_NONE && meta_ok;
+}
+
+void share_forget(void) {
+    meta_ok = 0;
+}
+
+void share_note_write(void) {
+    __atomic_fetch_add(&writes, 1, __ATOMIC_RELAXED);
+}
+
+void share_close(void) {
+    if (lock_fd >= 0) {
+        close(lock_fd);         // Tanıtıcının tüm kilitleri bırakılır
+        STATS_SYSCALL(1);
+    }
+    lock_fd = -1;
+    lease = have_gen = meta_ok = stale = yield_req = 0;
+    lease_retry = 0;
+    mode = MODE_NONE;
+}
+
+void share_stats(ShareStats *out) {
+    pthread_mutex_lock(&lock);
+    *out = st;
+    out->lease = (uint32_t)lease;
+    pthread_mutex_unlock(&lock);
+}
+
+void share_reset_stats(void) {
+    pthread_mutex_lock(&lock);
+    memset(&st, 0, sizeof(st));
+    pthread_mutex_unlock(&lock);
+}
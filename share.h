@@ -0,0 +1,83 @@
+#ifndef SHARE_H
+#define SHARE_H
+
+#include <stdint.h>     // uint32_t, uint64_t
+
+// Çoklu süreç erişimi: aynı imajı açan süreçler imaj dosyası üzerinde
+// danışma kilitleriyle (fcntl OFD kilitleri, aygıt 0) sıraya girer.
+//
+// - Her fs.h çağrısı metadata aralığını [0, METADATA_SIZE) kilitler: okuyan
+//   çağrılar paylaşımlı, değiştirenler özel kilit alır.
+// - Paylaşımlı kilitle çalışan çağrılar dokundukları veri aralığını da
+//   kilitler (okuma paylaşımlı, dosyayı büyütmeyen fs_pwrite/fs_fwrite özel);
+//   ayrık aralıklara yazan süreçler aynı anda çalışabilir.
+// - metadata.flags'in üst 24 biti imajın neslidir. İmajı değiştiren her çağrı
+//   nesli bir artırır (metadata yazımıyla birlikte, yalnızca veri yazdıysa
+//   çağrı sonunda); süreç metadata'yı bellekte tutar ve çağrı başında 4 baytlık
+//   tek okumayla doğrular. Nesil değişmişse metadata yeniden okunur, önbellekler
+//   ve çeviri katmanlarının durumu bırakılır.
+// - İmajı açan tek süreç ilk çağrıdan sonra kira baytını özel tutar ve
+//   çağrılarını kilitsiz, nesil okumadan çalıştırır; bellekte bekleyen
+//   yazımlar (ekleme tamponları, ön ayırmalar, bellek katmanının kirli
+//   kısımları, günlük yapılı modun eşlemesi, bekleyen delmeler) çağrılar
+//   arasında kalabilir. Kirayı tutan süreçte bir izleyici iş parçacığı
+//   SHARE_POLL_MS'de bir varlık baytına bakar; imajı açmak isteyen süreç
+//   görülünce (ya da sıradaki çağrının başında) durum diske yazılır ve kira
+//   bırakılır. Yeni süreç kiranın bırakılmasını SHARE_BUSY_WAIT_MS bekler,
+//   kira bırakılmazsa (tutan süreç uzun bir çağrıdaysa) FS_ERR_BUSY alır.
+//   Başka süreç varken bekleyen durum her çağrının sonunda yazılır.
+//
+// Kilit baytları: metadata ve veri aralıkları imajdaki konumlarıdır; varlık,
+// kira ve nesil baytları DISK_SIZE'ın ötesindedir (dosyada yer tutmaz).
+#define SHARE_GEN_SHIFT     8
+#define SHARE_GEN_MASK      0xFFFFFF00u
+#define SHARE_BUSY_WAIT_MS  2000
+#define SHARE_POLL_MS       10
+#define SHARE_LEASE_RETRY   64      // Kira alınamazsa yeniden denemeden önceki çağrı sayısı
+
+enum { SHARE_CURRENT = 0, SHARE_RELOAD = 1, SHARE_CHANGED = 2 };
+
+typedef struct {
+    uint64_t locks;             // Alınan metadata kilitleri
+    uint64_t lock_waits;        // Başka süreci beklemek zorunda kalanlar
+    uint64_t range_locks;       // Veri aralığı kilitleri
+    uint64_t validations;       // Nesil okumaları
+    uint64_t reloads;           // Başka süreç imajı değiştirdiği için yeniden yükleme
+    uint64_t publishes;         // Yalnızca nesil kelimesinin yazıldığı çağrılar
+    uint64_t state_flushes;     // Başka süreç olduğu için çağrı sonunda yazılan durum
+    uint64_t yields;            // Başka süreç açtığı için bırakılan kira
+    uint32_t lease;             // Kira şu an tutuluyor
+} ShareStats;
+
+// Çağrı başı: kilitleri alır ve nesli doğrular. SHARE_RELOAD: metadata
+// diskten yeniden okunmalı (bu süreçte başarısız bir çağrı belleği bozmuş
+// olabilir), SHARE_CHANGED: imaj başka süreçte değişti. < 0: FsError.
+int  share_begin(int exclusive);
+// Çağrı sonu: yazım olduysa nesli yayımlar, kilitleri bırakır
+void share_end(int failed);
+// Çağrı sonunda, share_end'den önce: 1 = kira tutuluyor (ya da alındı),
+// bekleyen durum kalabilir; 0 = başka süreç var, pending ise durum yazılmalı
+int  share_hold(int pending);
+// Kira bırakılırken bekleyen durumu diske yazan işlev (fs.c kaydeder)
+void share_set_release(int (*release)(void));
+// İzleyici iş parçacığını durdurur (çıkışta ve imaj değişmeden önce)
+void share_shutdown(void);
+// Paylaşımlı çağrıda veri bölgesi aralığını kilitler (diğer durumlarda hiçbir
+// şey yapmaz). 1: kilit beklenirken başka süreç yerinde yazım yaptı, veri
+// önbellekleri bırakılmalı; < 0: FsError.
+int  share_lock_range(uint64_t offset, uint64_t len, int exclusive);
+
+// disk.c için: metadata yazımına konacak nesil ve yazıldığının bildirimi,
+// tam okumadan sonra bellekteki neslin kaydı, metadata'nın geçerliliği
+uint32_t share_next_gen(void);
+void     share_gen_written(uint32_t gen);
+void     share_loaded(uint32_t gen);
+int      share_current(void);       // Çağrı içinde ve bellekteki metadata doğrulanmış
+void     share_forget(void);        // Bellekteki metadata diskle aynı değil
+void     share_note_write(void);    // İmaja veri yazıldı (her iş parçacığından)
+void     share_close(void);         // İmaj değişiyor: kilitleri bırak (önce share_shutdown)
+
+void share_stats(ShareStats *out);
+void share_reset_stats(void);
+
+#endif // SHARE_H
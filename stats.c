@@ -0,0 +1,185 @@
+// stats.c — işlem sayaçları ve logaritmik kovalı gecikme histogramları
+//
+// Histogramlar HDR tarzındadır: her ikinin kuvveti aralığı 8 doğrusal alt
+// kovaya bölünür, böylece nanosaniyeden saniyelere kadar her değer en fazla
+// %12.5 göreli hatayla sabit boyutlu bir dizide tutulur. Sayaçlar atomik
+// (relaxed) artırılır; ölçüm kapalıyken kayıt fonksiyonları hiç çağrılmaz.
+#define _POSIX_C_SOURCE 200809L
+
+#include "stats.h"
+
+#include <string.h>
+#include <time.h>
+
+#define HIST_SUB_BITS 3
+#define HIST_SUB      (1u << HIST_SUB_BITS)
+#define HIST_BUCKETS  ((64 - HIST_SUB_BITS + 1) * HIST_SUB)
+
+typedef struct {
+    uint64_t calls;
+    uint64_t errors;
+    uint64_t bytes;
+    uint64_t total_ns;
+    uint64_t min_ns;
+    uint64_t max_ns;
+    uint64_t hist[HIST_BUCKETS];
+} OpStats;
+
+static const char *op_names[STAT_OP_COUNT] = {
+    "fs_format", "fs_create", "fs_delete", "fs_write", "fs_read",
+    "fs_read_all", "fs_ls", "fs_rename", "fs_exists", "fs_size",
+    "fs_append", "fs_truncate", "fs_copy", "fs_mv", "fs_defragment",
+    "fs_check_integrity", "fs_backup", "fs_restore", "fs_cat",
+    "fs_diff", "fs_log", "fs_list",
+    "fs_open", "fs_close", "fs_pread", "fs_pwrite", "fs_fread", "fs_fwrite",
+    "fs_punch_hole", "fs_sync", "fs_readv", "fs_writev", "fs_appendv",
+    "fs_map", "fs_map_flush", "fs_unmap", "fs_seek",
+    "fs_import", "fs_export", "fs_fallocate", "fs_resize",
+    "disk_read_metadata", "disk_write_metadata", "disk_read_block",
+    "disk_write_block", "disk_read_data", "disk_write_data",
+    "disk_phys_read", "disk_phys_write", "disk_discard", "disk_zero_range",
+    "disk_readv_data", "disk_writev_data"
+};
+
+int stats_enabled = 0;
+static OpStats  ops[STAT_OP_COUNT];
+static uint64_t syscalls;
+
+#define ADD(var, n) __atomic_fetch_add(&(var), (n), __ATOMIC_RELAXED)
+
+uint64_t stats_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static unsigned bucket_of(uint64_t v) {
+    if (v < HIST_SUB) return (unsigned)v;
+    unsigned msb = 63u - (unsigned)__builtin_clzll(v);
+    unsigned shift = msb - HIST_SUB_BITS;
+    return (shift + 1) * HIST_SUB + (unsigned)((v >> shift) & (HIST_SUB - 1));
+}
+
+// Kovaya düşen en büyük değer (HDR "highest equivalent value")
+static uint64_t bucket_high(unsigned idx) {
+    if (idx < HIST_SUB) return idx;
+    unsigned shift = idx / HIST_SUB - 1;
+    uint64_t mant = HIST_SUB + idx % HIST_SUB;
+    return ((mant + 1) << shift) - 1;
+}
+
+void stats_record(StatOp op, uint64_t start_ns, int ok, uint64_t bytes) {
+    uint64_t d = stats_now_ns() - start_ns;
+    OpStats *s = &ops[op];
+    ADD(s->calls, 1);
+    if (!ok) ADD(s->errors, 1);
+    if (bytes) ADD(s->bytes, bytes);
+    ADD(s->total_ns, d);
+    ADD(s->hist[bucket_of(d)], 1);
+
+    uint64_t cur = __atomic_load_n(&s->max_ns, __ATOMIC_RELAXED);
+    while (d > cur && !__atomic_compare_exchange_n(&s->max_ns, &cur, d, 1,
+                                                   __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {}
+    cur = __atomic_load_n(&s->min_ns, __ATOMIC_RELAXED);
+    while ((cur == 0 || d < cur) &&
+           !__atomic_compare_exchange_n(&s->min_ns, &cur, d, 1,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {}
+}
+
+void stats_add_syscalls(uint64_t n) {
+    ADD(syscalls, n);
+}
+
+void stats_set_enabled(int on) {
+    stats_enabled = on ? 1 : 0;
+}
+
+void stats_reset(void) {
+    memset(ops, 0, sizeof(ops));
+    syscalls = 0;
+}
+
+uint64_t stats_syscalls(void) {
+    return __atomic_load_n(&syscalls, __ATOMIC_RELAXED);
+}
+
+static uint64_t hist_percentile(const OpStats *s, double p) {
+    if (s->calls == 0) return 0;
+    uint64_t target = (uint64_t)(p * s->calls + 0.999999);
+    if (target == 0) target = 1;
+    uint64_t seen = 0;
+    for (unsigned i = 0; i < HIST_BUCKETS; ++i) {
+        seen += s->hist[i];
+        if (seen >= target) {
+            uint64_t v = bucket_high(i);
+            return v > s->max_ns ? s->max_ns : v;
+        }
+    }
+    return s->max_ns;
+}
+
+void stats_summary(StatOp op, StatSummary *out) {
+    const OpStats *s = &ops[op];
+    out->name     = op_names[op];
+    out->calls    = s->calls;
+    out->errors   = s->errors;
+    out->bytes    = s->bytes;
+    out->total_ns = s->total_ns;
+    out->min_ns   = s->min_ns;
+    out->max_ns   = s->max_ns;
+    out->p50_ns   = hist_percentile(s, 0.50);
+    out->p90_ns   = hist_percentile(s, 0.90);
+    out->p99_ns   = hist_percentile(s, 0.99);
+    out->p999_ns  = hist_percentile(s, 0.999);
+}
+
+int stats_report(FILE *out) {
+    fprintf(out, "=== Statistics (%s) ===\n", stats_enabled ? "enabled" : "disabled");
+    fprintf(out, "%-20s %10s %7s %12s %10s %10s %10s %10s\n",
+            "operation", "calls", "errors", "bytes", "avg_us", "p50_us", "p99_us", "max_us");
+    for (int op = 0; op < STAT_OP_COUNT; ++op) {
+        StatSummary s;
+        stats_summary((StatOp)op, &s);
+        if (!s.calls) continue;
+        fprintf(out, "%-20s %10llu %7llu %12llu %10.2f %10.2f %10.2f %10.2f\n",
+                s.name, (unsigned long long)s.calls, (unsigned long long)s.errors,
+                (unsigned long long)s.bytes, s.total_ns / 1e3 / s.calls,
+                s.p50_ns / 1e3, s.p99_ns / 1e3, s.max_ns / 1e3);
+    }
+    fprintf(out, "syscalls issued: %llu\n", (unsigned long long)stats_syscalls());
+    return 0;
+}
+
+int stats_dump_json(FILE *out) {
+    fprintf(out, "{\"enabled\":%s,\"syscalls\":%llu,\"ops\":{",
+            stats_enabled ? "true" : "false", (unsigned long long)stats_syscalls());
+    int first = 1;
+    for (int op = 0; op < STAT_OP_COUNT; ++op) {
+        StatSummary s;
+        stats_summary((StatOp)op, &s);
+        if (!s.calls) continue;
+        fprintf(out, "%s\"%s\":{\"calls\":%llu,\"errors\":%llu,\"bytes\":%llu,"
+                "\"total_ns\":%llu,\"min_ns\":%llu,\"max_ns\":%llu,"
+                "\"p50_ns\":%llu,\"p90_ns\":%llu,\"p99_ns\":%llu,\"p999_ns\":%llu,"
+                "\"histogram\":[",
+                first ? "" : ",", s.name,
+                (unsigned long long)s.calls, (unsigned long long)s.errors,
+                (unsigned long long)s.bytes, (unsigned long long)s.total_ns,
+                (unsigned long long)s.min_ns, (unsigned long long)s.max_ns,
+                (unsigned long long)s.p50_ns, (unsigned long long)s.p90_ns,
+                (unsigned long long)s.p99_ns, (unsigned long long)s.p999_ns);
+        // Yalnızca dolu kovalar: [üst sınır ns, adet]
+        int first_bucket = 1;
+        for (unsigned i = 0; i < HIST_BUCKETS; ++i) {
+            if (!ops[op].hist[i]) continue;
+            fprintf(out, "%s[%llu,%llu]", first_bucket ? "" : ",",
+                    (unsigned long long)bucket_high(i),
+                    (unsigned long long)ops[op].hist[i]);
+            first_bucket = 0;
+        }
+        fprintf(out, "]}");
+        first = 0;
+    }
+    fprintf(out, "}}\n");
+    return 0;
+}
@@ -0,0 +1,81 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdint.h>     // uint64_t
+#include <stdio.h>      // FILE
+
+// Ölçülen giriş noktaları (fs.h API'si ve disk.c blok fonksiyonları)
+typedef enum {
+    STAT_FS_FORMAT, STAT_FS_CREATE, STAT_FS_DELETE, STAT_FS_WRITE, STAT_FS_READ,
+    STAT_FS_READ_ALL, STAT_FS_LS, STAT_FS_RENAME, STAT_FS_EXISTS, STAT_FS_SIZE,
+    STAT_FS_APPEND, STAT_FS_TRUNCATE, STAT_FS_COPY, STAT_FS_MV, STAT_FS_DEFRAGMENT,
+    STAT_FS_CHECK_INTEGRITY, STAT_FS_BACKUP, STAT_FS_RESTORE, STAT_FS_CAT,
+    STAT_FS_DIFF, STAT_FS_LOG, STAT_FS_LIST,
+    STAT_FS_OPEN, STAT_FS_CLOSE, STAT_FS_PREAD, STAT_FS_PWRITE, STAT_FS_FREAD, STAT_FS_FWRITE,
+    STAT_FS_PUNCH_HOLE, STAT_FS_SYNC, STAT_FS_READV, STAT_FS_WRITEV, STAT_FS_APPENDV,
+    STAT_FS_MAP, STAT_FS_MAP_FLUSH, STAT_FS_UNMAP, STAT_FS_SEEK,
+    STAT_FS_IMPORT, STAT_FS_EXPORT, STAT_FS_FALLOCATE, STAT_FS_RESIZE,
+    STAT_DISK_READ_METADATA, STAT_DISK_WRITE_METADATA, STAT_DISK_READ_BLOCK,
+    STAT_DISK_WRITE_BLOCK, STAT_DISK_READ_DATA, STAT_DISK_WRITE_DATA,
+    STAT_DISK_PHYS_READ, STAT_DISK_PHYS_WRITE, STAT_DISK_DISCARD, STAT_DISK_ZERO_RANGE,
+    STAT_DISK_READV_DATA, STAT_DISK_WRITEV_DATA,
+    STAT_OP_COUNT
+} StatOp;
+
+// Bir giriş noktasının özet istatistikleri (süreler nanosaniye)
+typedef struct {
+    const char *name;
+    uint64_t calls;
+    uint64_t errors;
+    uint64_t bytes;
+    uint64_t total_ns;
+    uint64_t min_ns;
+    uint64_t max_ns;
+    uint64_t p50_ns;
+    uint64_t p90_ns;
+    uint64_t p99_ns;
+    uint64_t p999_ns;
+} StatSummary;
+
+extern int stats_enabled;   // Kapalıyken her çağrının maliyeti tek bir dal
+
+uint64_t stats_now_ns(void);
+void     stats_record(StatOp op, uint64_t start_ns, int ok, uint64_t bytes);
+void     stats_add_syscalls(uint64_t n);
+
+void     stats_set_enabled(int on);
+void     stats_reset(void);
+void     stats_summary(StatOp op, StatSummary *out);
+uint64_t stats_syscalls(void);
+int      stats_report(FILE *out);       // Okunabilir tablo
+int      stats_dump_json(FILE *out);    // Makine-okunur döküm
+
+#ifdef SIMPLEFS_NO_STATS
+#define STATS_BEGIN()                    ((uint64_t)0)
+#define STATS_END(op, t0, ok, bytes)     ((void)(t0))
+#define STATS_SYSCALL(n)                 ((void)0)
+#else
+#define STATS_BEGIN()                    (stats_enabled ? stats_now_ns() : 0)
+#define STATS_END(op, t0, ok, bytes) \
+    do { if (stats_enabled) stats_record((op), (t0), (ok), (bytes)); } while (0)
+#define STATS_SYSCALL(n) \
+    do { if (stats_enabled) stats_add_syscalls(n); } while (0)
+#endif
+
+// Sarmalayıcı gövdesi: call'ı çalıştır, süresini ve sonucunu kaydet, sonucu döndür.
+// STATS_CALL_IO dönüş değerini aktarılan bayt sayısı olarak da sayar.
+#define STATS_CALL(op, type, call) do {                                   \
+        uint64_t t0_ = STATS_BEGIN();                                      \
+        type r_ = (call);                                                  \
+        STATS_END((op), t0_, r_ >= 0, 0);                                  \
+        return r_;                                                         \
+    } while (0)
+
+#define STATS_CALL_IO(op, type, call) do {                                \
+        uint64_t t0_ = STATS_BEGIN();                                      \
+        type r_ = (call);                                                  \
+        STATS_END((op), t0_, r_ >= 0, r_ > 0 ? (uint64_t)r_ : 0);          \
+        return r_;                                                         \
+    } while (0)
+
+#endif // STATS_H
@@ -0,0 +1,380 @@
+// stripe.c — çok aygıtlı (şeritli) veri bölgesi; bkz. stripe.h
+#define _GNU_SOURCE             // fallocate, preadv/pwritev, SEEK_DATA / SEEK_HOLE
+
+#include "stripe.h"
+#include "disk.h"
+#include "dio.h"
+#include "bufpool.h"
+#include "stats.h"
+#include "fserr.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>     // IOV_MAX
+#include <pthread.h>
+#include <string.h>     // strerror
+#include <unistd.h>     // pread, pwrite, lseek, fdatasync
+
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
+#define STACK_PIECES 64         // Bu kadar parçaya kadar yığında, fazlası karalama alanında
+
+enum { JOB_READ, JOB_WRITE, JOB_PUNCH, JOB_SYNC };
+
+// Bir isteğin aygıtlara dağılan işlerinin tamamlanma sayacı
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t  done;
+    int             left;
+} StripeBatch;
+
+typedef struct StripeJob {
+    struct StripeJob *next;
+    StripeBatch      *batch;
+    int               op;       // JOB_*
+    off_t             pos;      // Aygıt dosyasındaki başlangıç
+    struct iovec     *iov;      // READ/WRITE: pos'tan itibaren bitişik tamponlar
+    int               iovcnt;
+    uint64_t          len;      // Toplam bayt (PUNCH: delik uzunluğu)
+    int               err;      // 0 veya errno
+} StripeJob;
+
+typedef struct {
+    int             fd;
+    pthread_t       thread;
+    int             started;
+    int             stopping;
+    pthread_mutex_t lock;
+    pthread_cond_t  work;
+    StripeJob      *head, *tail;    // İş kuyruğu (FIFO)
+} StripeDev;
+
+static StripeDev devs[STRIPE_MAX_DEVICES];
+static int       ndev;              // 0 = katman bağlı değil
+static uint64_t  unit;              // Parça boyutu (bayt)
+
+int stripe_active(void) {
+    return ndev > 1;
+}
+
+uint64_t stripe_member_size(int count, uint32_t stripe_blocks) {
+    uint64_t u = (uint64_t)stripe_blocks * BLOCK_SIZE;
+    uint64_t chunks = (DATA_SIZE + u - 1) / u;
+    return METADATA_SIZE + (chunks + (uint64_t)count - 1) / (uint64_t)count * u;
+}
+
+// Veri bölgesi offset'inin aygıt dosyasındaki konumu
+static off_t chunk_pos(uint64_t offset) {
+    uint64_t c = offset / unit;
+    return METADATA_SIZE + (off_t)((c / (uint64_t)ndev) * unit + offset % unit);
+}
+
+static int chunk_dev(uint64_t offset) {
+    return (int)(offset / unit % (uint64_t)ndev);
+}
+
+// Delik açar; dosya sistemi desteklemiyorsa sıfır yazar. errno döner.
+static int punch(int fd, off_t pos, uint64_t len) {
+#ifdef FALLOC_FL_PUNCH_HOLE
+    STATS_SYSCALL(1);
+    if (fallocate(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, pos, (off_t)len) == 0) return 0;
+    if (errno != EOPNOTSUPP && errno != ENOSYS) return errno;
+#endif
+    static const uint8_t zeros[8 * BLOCK_SIZE];
+    while (len > 0) {
+        size_t n = len < sizeof(zeros) ? (size_t)len : sizeof(zeros);
+        ssize_t wr;
+        if (dio_enabled()) {
+            wr = dio_pwrite(fd, zeros, n, pos);
+        } else {
+            wr = pwrite(fd, zeros, n, pos);
+            STATS_SYSCALL(1);
+        }
+        if (wr != (ssize_t)n) return wr < 0 ? errno : EIO;
+        pos += (off_t)n;
+        len -= n;
+    }
+    return 0;
+}
+
+static void job_run(StripeDev *d, StripeJob *j) {
+    j->err = 0;
+    if (j->op == JOB_SYNC) {
+        STATS_SYSCALL(1);
+        if (fdatasync(d->fd) < 0) j->err = errno;
+        return;
+    }
+    if (j->op == JOB_PUNCH) {
+        j->err = punch(d->fd, j->pos, j->len);
+        return;
+    }
+    int write = j->op == JOB_WRITE;
+    struct iovec *iov = j->iov;
+    int cnt = j->iovcnt;
+    off_t pos = j->pos;
+    while (cnt > 0) {
+        int n = cnt < IOV_MAX ? cnt : IOV_MAX;
+        ssize_t r;
+        if (dio_enabled()) {            // aygıt tanıtıcıları O_DIRECT (bkz. disk_set_direct)
+            r = dio_rwv(d->fd, iov, n, pos, write);
+        } else {
+            r = write ? pwritev(d->fd, iov, n, pos) : preadv(d->fd, iov, n, pos);
+            STATS_SYSCALL(1);
+        }
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) {                   // Aygıt dosyası beklenenden kısa
+            j->err = r < 0 ? errno : EIO;
+            return;
+        }
+        pos += r;
+        // Tamamlanan tamponları atla, yarım kalanı kısalt
+        while (cnt > 0 && (size_t)r >= iov->iov_len) {
+            r -= (ssize_t)iov->iov_len;
+            iov++;
+            cnt--;
+        }
+        if (cnt > 0) {
+            iov->iov_base = (uint8_t *)iov->iov_base + r;
+            iov->iov_len -= (size_t)r;
+        }
+    }
+}
+
+static void *dev_main(void *arg) {
+    StripeDev *d = arg;
+    pthread_mutex_lock(&d->lock);
+    for (;;) {
+        while (!d->stopping && !d->head) pthread_cond_wait(&d->work, &d->lock);
+        if (!d->head) break;
+        StripeJob *j = d->head;
+        d->head = j->next;
+        if (!d->head) d->tail = NULL;
+        pthread_mutex_unlock(&d->lock);
+
+        job_run(d, j);
+        StripeBatch *b = j->batch;
+        pthread_mutex_lock(&b->lock);
+        if (--b->left == 0) pthread_cond_signal(&b->done);
+        pthread_mutex_unlock(&b->lock);
+
+        pthread_mutex_lock(&d->lock);
+    }
+    pthread_mutex_unlock(&d->lock);
+    return NULL;
+}
+
+// İşi aygıtın kuyruğuna ekler; iş parçacığı ilk işte başlatılır
+static int dev_submit(StripeDev *d, StripeJob *j) {
+    pthread_mutex_lock(&d->lock);
+    if (!d->started) {
+        if (pthread_create(&d->thread, NULL, dev_main, d) != 0) {
+            pthread_mutex_unlock(&d->lock);
+            return -1;
+        }
+        d->started = 1;
+    }
+    j->next = NULL;
+    if (d->tail) d->tail->next = j;
+    else         d->head = j;
+    d->tail = j;
+    pthread_cond_signal(&d->work);
+    pthread_mutex_unlock(&d->lock);
+    return 0;
+}
+
+// Aygıt başına birer işi çalıştırır. Paralel modda ilki dışındakiler aygıt
+// kuyruklarına verilir, ilki çağıranda yürütülür ve hepsi beklenir; küçük
+// isteklerde iş parçacığı geçişi aktarımdan pahalı olduğundan sırayla.
+static int run_jobs(StripeJob *jobs, const int *dev_of, int count, int parallel, const char *who) {
+    StripeBatch b = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, 0 };
+    int first = 0;
+    if (parallel && count > 1) {
+        b.left = count - 1;
+        for (int i = 1; i < count; ++i) {
+            jobs[i].batch = &b;
+            if (dev_submit(&devs[dev_of[i]], &jobs[i]) < 0) {
+                job_run(&devs[dev_of[i]], &jobs[i]);
+                pthread_mutex_lock(&b.lock);
+                b.left--;
+                pthread_mutex_unlock(&b.lock);
+            }
+        }
+        job_run(&devs[dev_of[0]], &jobs[0]);
+        pthread_mutex_lock(&b.lock);
+        while (b.left) pthread_cond_wait(&b.done, &b.lock);
+        pthread_mutex_unlock(&b.lock);
+        first = count;
+    }
+    for (int i = first; i < count; ++i) job_run(&devs[dev_of[i]], &jobs[i]);
+
+    for (int i = 0; i < count; ++i) {
+        if (jobs[i].err) FS_FAIL(FS_ERR_IO, "%s: device %d: %s", who, dev_of[i], strerror(jobs[i].err));
+    }
+    return 0;
+}
+
+int stripe_attach(const int *fds, int count, uint32_t stripe_blocks) {
+    if (count < 2 || count > STRIPE_MAX_DEVICES || stripe_blocks == 0 || stripe_blocks > DATA_BLOCKS) {
+        FS_FAIL(FS_ERR_INVALID, "stripe_attach: bad geometry (%d devices, %u blocks)", count, stripe_blocks);
+    }
+    stripe_detach();
+    for (int i = 0; i < count; ++i) {
+        StripeDev *d = &devs[i];
+        memset(d, 0, sizeof(*d));
+        d->fd = fds[i];
+        pthread_mutex_init(&d->lock, NULL);
+        pthread_cond_init(&d->work, NULL);
+    }
+    ndev = count;
+    unit = (uint64_t)stripe_blocks * BLOCK_SIZE;
+    return 0;
+}
+
+void stripe_detach(void) {
+    for (int i = 0; i < ndev; ++i) {
+        StripeDev *d = &devs[i];
+        pthread_mutex_lock(&d->lock);
+        d->stopping = 1;
+        pthread_cond_signal(&d->work);
+        pthread_mutex_unlock(&d->lock);
+        if (d->started) pthread_join(d->thread, NULL);
+        pthread_mutex_destroy(&d->lock);
+        pthread_cond_destroy(&d->work);
+    }
+    ndev = 0;
+}
+
+int stripe_locate(uint64_t offset, uint64_t len, off_t *pos_out) {
+    if (!stripe_active() || len == 0 || offset / unit != (offset + len - 1) / unit) return -1;
+    *pos_out = chunk_pos(offset);
+    return devs[chunk_dev(offset)].fd;
+}
+
+// Aralığı parça sınırlarında böler. Bitişik bir aralıkta bir aygıta düşen
+// parçalar aygıt dosyasında da bitişiktir (c, c + n, ... ardışık satırlar),
+// bu yüzden her aygıt tek bir işle (tek konum + tampon listesi) karşılanır.
+ssize_t stripe_rw(uint64_t offset, const struct iovec *iov, int iovcnt, int write) {
+    const char *who = write ? "stripe_write" : "stripe_read";
+    int count_of[STRIPE_MAX_DEVICES] = { 0 };
+    uint64_t total = 0;
+    int pieces = 0;
+
+    // 1. geçiş: aygıt başına parça sayısı
+    uint64_t at = offset;
+    for (int i = 0; i < iovcnt; ++i) {
+        size_t left = iov[i].iov_len;
+        while (left > 0) {
+            size_t n = (size_t)(unit - at % unit);
+            if (n > left) n = left;
+            count_of[chunk_dev(at)]++;
+            pieces++;
+            at += n;
+            left -= n;
+        }
+        total += iov[i].iov_len;
+    }
+    if (total == 0) return 0;
+
+    struct iovec stack_vec[STACK_PIECES];
+    ScratchMark mark = scratch_mark();
+    struct iovec *vec = pieces <= STACK_PIECES ? stack_vec : scratch_alloc((size_t)pieces * sizeof(*vec));
+    if (!vec) FS_FAIL(FS_ERR_NO_MEMORY, "%s: malloc", who);
+
+    StripeJob jobs[STRIPE_MAX_DEVICES];
+    int dev_of[STRIPE_MAX_DEVICES], job_of[STRIPE_MAX_DEVICES], njobs = 0, next = 0;
+    for (int d = 0; d < ndev; ++d) {
+        job_of[d] = -1;
+        if (!count_of[d]) continue;
+        memset(&jobs[njobs], 0, sizeof(jobs[njobs]));
+        jobs[njobs].op  = write ? JOB_WRITE : JOB_READ;
+        jobs[njobs].iov = vec + next;
+        dev_of[njobs] = d;
+        job_of[d] = njobs++;
+        next += count_of[d];
+    }
+
+    // 2. geçiş: parçaları aygıtların bölgelerine yerleştir
+    at = offset;
+    for (int i = 0; i < iovcnt; ++i) {
+        uint8_t *base = iov[i].iov_base;
+        size_t left = iov[i].iov_len;
+        while (left > 0) {
+            size_t n = (size_t)(unit - at % unit);
+            if (n > left) n = left;
+            StripeJob *j = &jobs[job_of[chunk_dev(at)]];
+            if (j->iovcnt == 0) j->pos = chunk_pos(at);
+            j->iov[j->iovcnt].iov_base = base;
+            j->iov[j->iovcnt].iov_len  = n;
+            j->iovcnt++;
+            j->len += n;
+            base += n;
+            at += n;
+            left -= n;
+        }
+    }
+
+    int rc = run_jobs(jobs, dev_of, njobs, total >= STRIPE_PARALLEL_MIN, who);
+    scratch_release(mark);
+    return rc < 0 ? rc : (ssize_t)total;
+}
+
+int stripe_punch(uint64_t offset, uint64_t len) {
+    StripeJob jobs[STRIPE_MAX_DEVICES];
+    int dev_of[STRIPE_MAX_DEVICES], job_of[STRIPE_MAX_DEVICES], njobs = 0;
+    for (int d = 0; d < ndev; ++d) job_of[d] = -1;
+    while (len > 0) {
+        uint64_t n = unit - offset % unit;
+        if (n > len) n = len;
+        int d = chunk_dev(offset);
+        if (job_of[d] < 0) {
+            memset(&jobs[njobs], 0, sizeof(jobs[njobs]));
+            jobs[njobs].op  = JOB_PUNCH;
+            jobs[njobs].pos = chunk_pos(offset);
+            dev_of[njobs] = d;
+            job_of[d] = njobs++;
+        }
+        jobs[job_of[d]].len += n;
+        offset += n;
+        len -= n;
+    }
+    return run_jobs(jobs, dev_of, njobs, 0, "stripe_punch");
+}
+
+int64_t stripe_seek(uint64_t offset, int hole) {
+#if defined(SEEK_DATA) && defined(SEEK_HOLE)
+    int no_more_data[STRIPE_MAX_DEVICES] = { 0 };
+    while (offset < DATA_SIZE) {
+        uint64_t end = (offset / unit + 1) * unit;
+        if (end > DATA_SIZE) end = DATA_SIZE;
+        int d = chunk_dev(offset);
+        if (!no_more_data[d]) {
+            off_t pos = chunk_pos(offset);
+            off_t q = lseek(devs[d].fd, pos, hole ? SEEK_HOLE : SEEK_DATA);
+            STATS_SYSCALL(1);
+            if (q < 0) {
+                if (errno != ENXIO) return hole ? DATA_SIZE : (int64_t)offset;
+                if (hole) return (int64_t)offset;       // dosya sonundan sonrası delik
+                no_more_data[d] = 1;                    // bu aygıtta ileride veri yok
+            } else if ((uint64_t)(q - pos) < end - offset) {
+                return (int64_t)(offset + (uint64_t)(q - pos));
+            }
+        }
+        offset = end;
+    }
+    return DATA_SIZE;
+#else
+    return hole ? DATA_SIZE : (int64_t)offset;
+#endif
+}
+
+int stripe_sync(void) {
+    StripeJob jobs[STRIPE_MAX_DEVICES];
+    int dev_of[STRIPE_MAX_DEVICES];
+    for (int d = 0; d < ndev; ++d) {
+        memset(&jobs[d], 0, sizeof(jobs[d]));
+        jobs[d].op = JOB_SYNC;
+        dev_of[d] = d;
+    }
+    return run_jobs(jobs, dev_of, ndev, 1, "stripe_sync");
+}
@@ -0,0 +1,33 @@
+#ifndef STRIPE_H
+#define STRIPE_H
+
+#include <stdint.h>     // uint32_t, uint64_t
+#include <sys/types.h>  // off_t, ssize_t
+#include <sys/uio.h>    // struct iovec
+
+// Şeritleme katmanı (RAID-0): veri bölgesi birden çok imaj dosyasına (aygıt)
+// stripe_blocks bloğluk parçalar halinde sırayla dağıtılır. Parça c, c % n
+// numaralı aygıtta METADATA_SIZE + (c / n) * parça boyutu konumunda durur;
+// metadata yalnızca 0. aygıtın başındadır, diğer aygıtlarda bu alan boştur.
+// Her aygıtın kendi iş kuyruğu ve iş parçacığı vardır: birden çok aygıta
+// yayılan bir istek aygıt başına tek bitişik preadv/pwritev'e bölünür ve
+// aygıtlar paralel çalışır. Offset'ler veri bölgesinin başına göredir.
+#define STRIPE_MAX_DEVICES    16
+#define STRIPE_DEFAULT_BLOCKS 8                   // 4 KB parça
+#define STRIPE_PARALLEL_MIN   (16 * 1024)         // Bundan küçük istekler çağıranda sırayla
+
+int      stripe_attach(const int *fds, int count, uint32_t stripe_blocks);
+void     stripe_detach(void);                     // iş parçacıklarını durdurur (fd'ler kapatılmaz)
+int      stripe_active(void);                     // birden çok aygıt bağlı mı
+uint64_t stripe_member_size(int count, uint32_t stripe_blocks);   // aygıt dosyası boyutu
+
+// Aralığın tek bir parçada kalıyorsa aygıt fd'si ve dosyadaki konumu (bellek
+// eşlemesi için); parça sınırını aşıyorsa -1
+int      stripe_locate(uint64_t offset, uint64_t len, off_t *pos_out);
+
+ssize_t  stripe_rw(uint64_t offset, const struct iovec *iov, int iovcnt, int write);
+int      stripe_punch(uint64_t offset, uint64_t len);   // delik aç (desteklenmezse sıfır yaz)
+int64_t  stripe_seek(uint64_t offset, int hole);        // SEEK_DATA / SEEK_HOLE karşılığı
+int      stripe_sync(void);                             // tüm aygıtlarda fdatasync (paralel)
+
+#endif // STRIPE_H
@@ -0,0 +1,124 @@
+// test_defrag.c — fs_defragment'in seyrek dosyalardaki delikleri koruduğunu
+// ve yerinde kalan dosyaları yeniden yazmadığını denetler (make test)
+#define _POSIX_C_SOURCE 200809L
+
+#include "fs.h"
+#include "disk.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define IMAGE "test_defrag.sim"
+
+static int failures;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); failures++; } \
+} while (0)
+
+static uint64_t allocated(void) {
+    uint64_t size = 0, alloc = 0;
+    CHECK(disk_usage(&size, &alloc) == 0);
+    return alloc;
+}
+
+static void fill(char *buf, size_t len, int seed) {
+    for (size_t i = 0; i < len; ++i) buf[i] = (char)('a' + (seed + i) % 26);
+}
+
+static int fs_put(const char *name, uint32_t offset, const void *data, size_t len) {
+    int fd = fs_open(name, FS_O_RDWR);
+    if (fd < 0) return fd;
+    ssize_t n = fs_pwrite(fd, data, len, offset);
+    fs_close(fd);
+    return n == (ssize_t)len ? 0 : -1;
+}
+
+// Yerinde kalan seyrek dosya: ana makinede ayrılan yer değişmemeli
+static void test_in_place(void) {
+    char head[1000];
+    fill(head, sizeof(head), 1);
+    CHECK(fs_format() == 0);
+    CHECK(fs_create("sparse") == 0);
+    CHECK(fs_write("sparse", head, sizeof(head)) == (ssize_t)sizeof(head));
+    CHECK(fs_truncate("sparse", 300000) == 0);
+    CHECK(fs_sync() == 0);
+    uint64_t before = allocated();
+    CHECK(fs_defragment() == 0);
+    CHECK(fs_sync() == 0);
+    uint64_t after = allocated();
+    printf("in place: allocated %llu -> %llu bytes\n", (unsigned long long)before, (unsigned long long)after);
+    CHECK(after <= before);
+}
+
+// Taşınan seyrek dosya: delikler delik kalmalı, veri ve sıfırlar korunmalı
+static void test_moved(void) {
+    static char big[64 * 1024], got[300000];
+    char head[1000], tail[700];
+    fill(big, sizeof(big), 2);
+    fill(head, sizeof(head), 3);
+    fill(tail, sizeof(tail), 4);
+    CHECK(fs_format() == 0);
+    CHECK(fs_create("gap") == 0);
+    CHECK(fs_write("gap", big, sizeof(big)) == (ssize_t)sizeof(big));
+    CHECK(fs_create("sparse") == 0);
+    CHECK(fs_write("sparse", head, sizeof(head)) == (ssize_t)sizeof(head));
+    CHECK(fs_truncate("sparse", 300000) == 0);
+    CHECK(fs_put("sparse", 200000, tail, sizeof(tail)) == 0);
+    CHECK(fs_delete("gap") == 0);
+    CHECK(fs_sync() == 0);
+    uint64_t before = allocated();
+    CHECK(fs_defragment() == 0);
+    CHECK(fs_sync() == 0);
+    uint64_t after = allocated();
+    printf("moved: allocated %llu -> %llu bytes\n", (unsigned long long)before, (unsigned long long)after);
+    CHECK(after <= before);
+
+    CHECK(fs_read("sparse", 0, sizeof(got), got) == (ssize_t)sizeof(got));
+    CHECK(memcmp(got, head, sizeof(head)) == 0);
+    CHECK(memcmp(got + 200000, tail, sizeof(tail)) == 0);
+    int zeros = 1;
+    for (size_t i = sizeof(head); i < sizeof(got); ++i) {
+        if ((i < 200000 || i >= 200000 + sizeof(tail)) && got[i]) zeros = 0;
+    }
+    CHECK(zeros);
+    CHECK(fs_check_integrity() == 0);
+}
+
+// Kısa mesafeli taşıma: hedef dosyanın kendi eski alanıyla çakışır
+static void test_overlap(void) {
+    static char data[40000], got[40000];
+    char small[600];
+    fill(data, sizeof(data), 5);
+    fill(small, sizeof(small), 6);
+    memset(data + 10000, 0, 20000);
+    CHECK(fs_format() == 0);
+    CHECK(fs_create("small") == 0);
+    CHECK(fs_write("small", small, sizeof(small)) == (ssize_t)sizeof(small));
+    CHECK(fs_create("f") == 0);
+    CHECK(fs_write("f", data, 10000) == 10000);
+    CHECK(fs_truncate("f", 30000) == 0);
+    CHECK(fs_put("f", 30000, data + 30000, 10000) == 0);
+    CHECK(fs_delete("small") == 0);
+    CHECK(fs_defragment() == 0);
+    CHECK(fs_read("f", 0, sizeof(got), got) == (ssize_t)sizeof(got));
+    CHECK(memcmp(got, data, sizeof(data)) == 0);
+    CHECK(fs_check_integrity() == 0);
+}
+
+int main(void) {
+    unlink(IMAGE);
+    if (disk_set_path(IMAGE) < 0) return EXIT_FAILURE;
+    test_in_place();
+    test_moved();
+    test_overlap();
+    unlink(IMAGE);
+    if (failures) {
+        fprintf(stderr, "test_defrag: %d check(s) failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("test_defrag: OK\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,193 @@
+// trace.c — ayrıntılı iş yükü izi (yakalama ve okuma)
+//
+// Kayıtlar bellekteki bir tampona kodlanır ve tampon dolduğunda tek write()
+// ile iz dosyasına eklenir; iz kapalıyken sarmalayıcıların maliyeti tek bir
+// dal. Kayıt biçimi (little-endian): ts_ns (8), lat_ns (8), result (8),
+// offset (8), len (8), arg (4), op (1), flags (1), ad uzunlukları (1 + 1),
+// ardından adlar. Kayıtlar çağrıların bitiş sırasıyla yazılır.
+#define _POSIX_C_SOURCE 200809L
+
+#include "trace.h"
+#include "fserr.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define REC_HDR_SIZE 48
+#define REC_MAX_SIZE (REC_HDR_SIZE + 2 * TRACE_NAME_MAX)
+#define TRACE_BUF    (64 * 1024)
+
+int trace_enabled = 0;
+_Thread_local int trace_nest = 0;
+
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static int      trace_fd = -1;
+static uint64_t start_ns;
+static uint8_t  buf[TRACE_BUF];
+static size_t   buf_len;
+
+static const char *op_names[TRACE_OP_MAX] = {
+    NULL, "format", "create", "delete", "write", "read", "read_all", "rename",
+    "exists", "size", "append", "truncate", "punch_hole", "copy", "mv",
+    "defragment", "sync", "open", "close", "pread", "pwrite", "fread", "fwrite",
+    "seek", "readv", "writev", "appendv", "fallocate", "resize"
+};
+
+const char *trace_op_name(int op) {
+    return op > 0 && op < TRACE_OP_MAX ? op_names[op] : "unknown";
+}
+
+uint64_t trace_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void put_le(uint8_t *out, uint64_t v, int n) {
+    for (int i = 0; i < n; ++i) out[i] = (uint8_t)(v >> (8 * i));
+}
+
+static uint64_t get_le(const uint8_t *in, int n) {
+    uint64_t v = 0;
+    for (int i = 0; i < n; ++i) v |= (uint64_t)in[i] << (8 * i);
+    return v;
+}
+
+// Kilit tutulurken
+static int flush_locked(void) {
+    size_t done = 0;
+    while (done < buf_len) {
+        ssize_t n = write(trace_fd, buf + done, buf_len - done);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            buf_len = 0;
+            FS_FAIL(FS_ERR_IO, "trace: write: %s", strerror(errno));
+        }
+        done += (size_t)n;
+    }
+    buf_len = 0;
+    return 0;
+}
+
+int trace_open(const char *path) {
+    if (!path || !*path) FS_FAIL(FS_ERR_INVALID, "trace: invalid path");
+    pthread_mutex_lock(&lock);
+    if (trace_fd >= 0) {
+        pthread_mutex_unlock(&lock);
+        FS_FAIL(FS_ERR_EXISTS, "trace: a trace is already being recorded");
+    }
+    trace_fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (trace_fd < 0) {
+        pthread_mutex_unlock(&lock);
+        FS_FAIL(FS_ERR_IO, "trace: open '%s': %s", path, strerror(errno));
+    }
+    memcpy(buf, TRACE_MAGIC, 8);
+    buf_len = 8;
+    start_ns = trace_now_ns();
+    pthread_mutex_unlock(&lock);
+    return 0;
+}
+
+void trace_set_enabled(int on) {
+    pthread_mutex_lock(&lock);
+    trace_enabled = on && trace_fd >= 0;
+    pthread_mutex_unlock(&lock);
+}
+
+int trace_close(void) {
+    pthread_mutex_lock(&lock);
+    trace_enabled = 0;
+    int rc = 0;
+    if (trace_fd >= 0) {
+        rc = flush_locked();
+        if (close(trace_fd) < 0 && rc == 0) rc = FS_ERR_IO;
+        trace_fd = -1;
+    }
+    pthread_mutex_unlock(&lock);
+    return rc;
+}
+
+static size_t encode(const TraceRecord *r, uint8_t *out) {
+    size_t n1 = strnlen(r->name, TRACE_NAME_MAX), n2 = strnlen(r->name2, TRACE_NAME_MAX);
+    put_le(out,      r->ts_ns, 8);
+    put_le(out + 8,  r->lat_ns, 8);
+    put_le(out + 16, (uint64_t)r->result, 8);
+    put_le(out + 24, r->offset, 8);
+    put_le(out + 32, r->len, 8);
+    put_le(out + 40, r->arg, 4);
+    out[44] = r->op;
+    out[45] = r->flags;
+    out[46] = (uint8_t)n1;
+    out[47] = (uint8_t)n2;
+    memcpy(out + REC_HDR_SIZE, r->name, n1);
+    memcpy(out + REC_HDR_SIZE + n1, r->name2, n2);
+    return REC_HDR_SIZE + n1 + n2;
+}
+
+void trace_emit(const TraceRecord *rec) {
+    pthread_mutex_lock(&lock);
+    if (trace_fd >= 0) {
+        if (buf_len + REC_MAX_SIZE > sizeof(buf)) flush_locked();
+        buf_len += encode(rec, buf + buf_len);
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+void trace_record(TraceOp op, uint8_t flags, uint64_t t0_ns, int64_t result,
+                  const char *name, const char *name2, uint64_t offset, uint64_t len,
+                  uint32_t arg) {
+    uint64_t now = trace_now_ns();
+    TraceRecord r;
+    memset(&r, 0, sizeof(r));
+    r.ts_ns  = t0_ns > start_ns ? t0_ns - start_ns : 0;
+    r.lat_ns = now - t0_ns;
+    r.result = result;
+    r.offset = offset;
+    r.len    = len;
+    r.arg    = arg;
+    r.op     = (uint8_t)op;
+    r.flags  = flags;
+    if (name)  strncpy(r.name, name, TRACE_NAME_MAX);
+    if (name2) strncpy(r.name2, name2, TRACE_NAME_MAX);
+    trace_emit(&r);
+}
+
+int trace_read_header(FILE *in) {
+    char magic[8];
+    if (fread(magic, 1, 8, in) != 8 || memcmp(magic, TRACE_MAGIC, 8) != 0) {
+        FS_FAIL(FS_ERR_CORRUPT, "trace: not a trace file");
+    }
+    return 0;
+}
+
+int trace_read_next(FILE *in, TraceRecord *rec) {
+    uint8_t hdr[REC_HDR_SIZE];
+    size_t n = fread(hdr, 1, REC_HDR_SIZE, in);
+    if (n == 0) return 0;
+    if (n != REC_HDR_SIZE) FS_FAIL(FS_ERR_CORRUPT, "trace: truncated record");
+    memset(rec, 0, sizeof(*rec));
+    rec->ts_ns  = get_le(hdr, 8);
+    rec->lat_ns = get_le(hdr + 8, 8);
+    rec->result = (int64_t)get_le(hdr + 16, 8);
+    rec->offset = get_le(hdr + 24, 8);
+    rec->len    = get_le(hdr + 32, 8);
+    rec->arg    = (uint32_t)get_le(hdr + 40, 4);
+    rec->op     = hdr[44];
+    rec->flags  = hdr[45];
+    if (hdr[46] > TRACE_NAME_MAX || hdr[47] > TRACE_NAME_MAX ||
+        fread(rec->name, 1, hdr[46], in) != hdr[46] ||
+        fread(rec->name2, 1, hdr[47], in) != hdr[47]) {
+        FS_FAIL(FS_ERR_CORRUPT, "trace: truncated record");
+    }
+    return 1;
+}
+
+// Program bittiğinde tampondaki kayıtları yaz
+__attribute__((destructor))
+static void cleanup_trace(void) {
+    trace_close();
+}
@@ -0,0 +1,101 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>     // uint64_t
+#include <stdio.h>      // FILE
+
+#include "stats.h"      // STATS_BEGIN / STATS_END
+
+// Ayrıntılı iş yükü izi: her fs.h çağrısı için işlem, dosya, offset, uzunluk,
+// zaman damgası, gecikme ve sonuç kaydedilir. fsreplay izi taze bir imaj
+// üzerinde yeniden çalıştırır. Veri içeriği kaydedilmez, yalnızca boyutları.
+#define TRACE_MAGIC "SFSTRC01"      // Dosya başlığı (8 byte)
+
+// Kayıttaki işlem kodları; dosya biçiminin parçasıdır, değerler değişmez
+typedef enum {
+    TRACE_FORMAT     = 1,   // arg = FS_FORMAT_* bayrakları
+    TRACE_CREATE     = 2,
+    TRACE_DELETE     = 3,
+    TRACE_WRITE      = 4,   // len
+    TRACE_READ       = 5,   // offset, len
+    TRACE_READ_ALL   = 6,
+    TRACE_RENAME     = 7,   // name -> name2
+    TRACE_EXISTS     = 8,
+    TRACE_SIZE       = 9,
+    TRACE_APPEND     = 10,  // len
+    TRACE_TRUNCATE   = 11,  // len = yeni boyut
+    TRACE_PUNCH_HOLE = 12,  // offset, len
+    TRACE_COPY       = 13,  // name -> name2
+    TRACE_MV         = 14,  // name -> name2
+    TRACE_DEFRAGMENT = 15,
+    TRACE_SYNC       = 16,
+    TRACE_OPEN       = 17,  // arg = FS_O_* bayrakları, result = tanıtıcı
+    TRACE_CLOSE      = 18,  // arg = tanıtıcı
+    TRACE_PREAD      = 19,  // arg = tanıtıcı, offset, len
+    TRACE_PWRITE     = 20,  // arg = tanıtıcı, offset, len
+    TRACE_FREAD      = 21,  // arg = tanıtıcı, len
+    TRACE_FWRITE     = 22,  // arg = tanıtıcı, len
+    TRACE_SEEK       = 23,  // arg = tanıtıcı, offset, len = whence
+    TRACE_READV      = 24,  // eleman başına bir kayıt: name, offset, len
+    TRACE_WRITEV     = 25,  // eleman başına bir kayıt: name, offset, len
+    TRACE_APPENDV    = 26,  // len = toplam, arg = tampon sayısı
+    TRACE_FALLOCATE  = 27,  // offset, len, arg = FS_FALLOC_* bayrakları
+    TRACE_RESIZE     = 28,  // len = imaj boyutu
+    TRACE_OP_MAX     = 29
+} TraceOp;
+
+// Kayıt bayrakları
+#define TRACE_F_SNAPSHOT 0x01   // İz başladığında var olan durum (zamanlanmaz)
+#define TRACE_F_CONT     0x02   // Önceki kaydın vektör çağrısının devamı
+
+#define TRACE_NAME_MAX 31
+
+typedef struct {
+    uint64_t ts_ns;             // İz başlangıcından itibaren
+    uint64_t lat_ns;            // Çağrının süresi (vektörde yalnızca ilk eleman)
+    int64_t  result;            // Dönüş değeri
+    uint64_t offset;
+    uint64_t len;
+    uint32_t arg;
+    uint8_t  op;                // TraceOp
+    uint8_t  flags;             // TRACE_F_*
+    char     name[TRACE_NAME_MAX + 1];
+    char     name2[TRACE_NAME_MAX + 1];
+} TraceRecord;
+
+extern int trace_enabled;                  // Kapalıyken her çağrının maliyeti tek bir dal
+extern _Thread_local int trace_nest;       // İç içe fs.h çağrıları (fs_mv -> fs_copy) kaydedilmez
+
+uint64_t trace_now_ns(void);
+int      trace_open(const char *path);     // Dosyayı oluştur, başlığı yaz (kayıt henüz kapalı)
+void     trace_set_enabled(int on);
+int      trace_close(void);                // Kaydı durdur, tamponu yaz, dosyayı kapat
+void     trace_emit(const TraceRecord *rec);
+void     trace_record(TraceOp op, uint8_t flags, uint64_t t0_ns, int64_t result,
+                      const char *name, const char *name2, uint64_t offset, uint64_t len,
+                      uint32_t arg);
+
+const char *trace_op_name(int op);
+int         trace_read_header(FILE *in);                 // 0 ya da FS_ERR_CORRUPT
+int         trace_read_next(FILE *in, TraceRecord *rec); // 1: kayıt, 0: dosya sonu, < 0: hata
+
+// Sarmalayıcı gövdesi: STATS_CALL / STATS_CALL_IO gibi, iz açıksa çağrıyı da kaydeder
+#define TRACE_CALL_(sop, io, type, call, top, name, name2, off, len, arg) do {        \
+        uint64_t t0_ = STATS_BEGIN();                                               \
+        uint64_t tt_ = trace_enabled && !trace_nest ? trace_now_ns() : 0;           \
+        if (tt_) trace_nest++;                                                      \
+        type r_ = (call);                                                           \
+        STATS_END((sop), t0_, r_ >= 0, (io) && r_ > 0 ? (uint64_t)r_ : 0);          \
+        if (tt_) {                                                                  \
+            trace_nest--;                                                           \
+            trace_record((top), 0, tt_, (int64_t)r_, (name), (name2), (off), (len), (arg)); \
+        }                                                                           \
+        return r_;                                                                  \
+    } while (0)
+
+#define TRACE_CALL(sop, type, call, top, name, name2, off, len, arg) \
+    TRACE_CALL_(sop, 0, type, call, top, name, name2, off, len, arg)
+#define TRACE_CALL_IO(sop, type, call, top, name, name2, off, len, arg) \
+    TRACE_CALL_(sop, 1, type, call, top, name, name2, off, len, arg)
+
+#endif // TRACE_H
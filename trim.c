@@ -0,0 +1,178 @@
+// trim.c — serbest kalan fiziksel blokları imaj dosyasında delme
+//
+// Bekleyen bloklar blok başına bir baytlık haritada tutulur (DATA_BLOCKS
+// bayt). Delme her zaman kilit tutulurken yapılır: trim_cancel'dan dönen bir
+// yazım, bloğunun sonradan delinmeyeceğinden emin olur. Delme hataları
+// yalnızca sayılır; delinemeyen blok imajda yer tutmaya devam eder.
+#define _POSIX_C_SOURCE 200809L
+
+#include "trim.h"
+#include "disk.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+
+static uint8_t   pending[DATA_BLOCKS];
+static uint32_t  npending;
+static struct timespec oldest;            // İlk bekleyen bloğun eklendiği an
+static int       batching;
+static TrimStats st;
+static int       started, stopping;
+
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  work = PTHREAD_COND_INITIALIZER;
+static pthread_t       worker;
+
+// Kilit tutulurken: aralığı deler ve sayaçları günceller
+static int punch_run(uint32_t first, uint32_t count) {
+    int rc = disk_phys_punch(first, count);
+    st.punch_calls++;
+    if (rc < 0) st.errors++;
+    else        st.punched += count;
+    return rc;
+}
+
+// Kilit tutulurken: bekleyen tüm bitişik aralıkları deler, ilk hatayı döner
+static int punch_pending_locked(void) {
+    int rc = 0;
+    for (uint32_t b = 0; npending && b < DATA_BLOCKS; ) {
+        if (!pending[b]) {
+            b++;
+            continue;
+        }
+        uint32_t end = b;
+        while (end < DATA_BLOCKS && pending[end]) pending[end++] = 0;
+        npending -= end - b;
+        int prc = punch_run(b, end - b);
+        if (rc == 0) rc = prc;
+        b = end;
+    }
+    return rc;
+}
+
+static void *worker_main(void *arg) {
+    (void)arg;
+    pthread_mutex_lock(&lock);
+    for (;;) {
+        while (!stopping && npending == 0) pthread_cond_wait(&work, &lock);
+        // Parti dolana ya da en eski blok yeterince bekleyene kadar biriktir
+        if (!stopping && npending < TRIM_BATCH_BLOCKS) {
+            struct timespec until = oldest;
+            until.tv_sec  += TRIM_DELAY_MS / 1000;
+            until.tv_nsec += (long)(TRIM_DELAY_MS % 1000) * 1000000L;
+            if (until.tv_nsec >= 1000000000L) { until.tv_sec++; until.tv_nsec -= 1000000000L; }
+            while (!stopping && npending && npending < TRIM_BATCH_BLOCKS) {
+                if (pthread_cond_timedwait(&work, &lock, &until) == ETIMEDOUT) break;
+            }
+        }
+        if (stopping) break;
+        punch_pending_locked();
+    }
+    pthread_mutex_unlock(&lock);
+    return NULL;
+}
+
+int trim_batching(void) {
+    pthread_mutex_lock(&lock);
+    int on = batching;
+    pthread_mutex_unlock(&lock);
+    return on;
+}
+
+void trim_set_batching(int on) {
+    pthread_mutex_lock(&lock);
+    batching = on ? 1 : 0;
+    if (!batching) punch_pending_locked();
+    pthread_mutex_unlock(&lock);
+}
+
+int trim_queue(uint32_t pblock, uint32_t count) {
+    if (pblock >= DATA_BLOCKS || count == 0) return 0;
+    if (count > DATA_BLOCKS - pblock) count = DATA_BLOCKS - pblock;
+
+    int rc = 0;
+    pthread_mutex_lock(&lock);
+    st.queued += count;
+    if (!batching) {
+        rc = punch_run(pblock, count);
+    } else {
+        if (!started && !stopping && pthread_create(&worker, NULL, worker_main, NULL) == 0) started = 1;
+        if (npending == 0) clock_gettime(CLOCK_REALTIME, &oldest);
+        for (uint32_t b = pblock; b < pblock + count; ++b) {
+            npending += !pending[b];
+            pending[b] = 1;
+        }
+        if (!started || stopping) rc = punch_pending_locked();    // İş parçacığı yok: hemen del
+        else if (npending >= TRIM_BATCH_BLOCKS) pthread_cond_signal(&work);
+    }
+    pthread_mutex_unlock(&lock);
+    return rc;
+}
+
+void trim_cancel(uint32_t pblock, uint32_t count) {
+    if (pblock >= DATA_BLOCKS || count == 0) return;
+    if (count > DATA_BLOCKS - pblock) count = DATA_BLOCKS - pblock;
+    pthread_mutex_lock(&lock);
+    for (uint32_t b = pblock; npending && b < pblock + count; ++b) {
+        if (!pending[b]) continue;
+        pending[b] = 0;
+        npending--;
+        st.cancelled++;
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+int trim_flush(void) {
+    pthread_mutex_lock(&lock);
+    int rc = punch_pending_locked();
+    pthread_mutex_unlock(&lock);
+    return rc;
+}
+
+int trim_pending(void) {
+    pthread_mutex_lock(&lock);
+    int any = npending != 0;
+    pthread_mutex_unlock(&lock);
+    return any;
+}
+
+void trim_drop(void) {
+    pthread_mutex_lock(&lock);
+    memset(pending, 0, sizeof(pending));
+    npending = 0;
+    pthread_mutex_unlock(&lock);
+}
+
+void trim_stats(TrimStats *out) {
+    pthread_mutex_lock(&lock);
+    *out = st;
+    out->pending = npending;
+    pthread_mutex_unlock(&lock);
+}
+
+void trim_reset_stats(void) {
+    pthread_mutex_lock(&lock);
+    memset(&st, 0, sizeof(st));
+    pthread_mutex_unlock(&lock);
+}
+
+void trim_shutdown(void) {
+    pthread_mutex_lock(&lock);
+    if (!started || stopping) {
+        pthread_mutex_unlock(&lock);
+        return;
+    }
+    stopping = 1;
+    pthread_cond_signal(&work);
+    pthread_mutex_unlock(&lock);
+    pthread_join(worker, NULL);
+}
+
+// Program bittiğinde iş parçacığını durdur; bekleyenleri disk.c'nin
+// çıkış temizliği (disk_flush) deler
+__attribute__((destructor))
+static void cleanup_trim(void) {
+    trim_shutdown();
+}
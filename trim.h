@@ -0,0 +1,43 @@
+#ifndef TRIM_H
+#define TRIM_H
+
+#include <stdint.h>     // uint32_t, uint64_t
+
+// Ana makineye yer iadesi: hiçbir dosyanın (dedup'ta hiçbir mantıksal bloğun,
+// günlük yapılı modda hiçbir canlı verinin) kullanmadığı fiziksel veri
+// blokları imaj dosyasında delik yapılır (fallocate PUNCH_HOLE), böylece
+// imaj dosyasının diskte kapladığı yer gerçek kullanımı izler.
+//
+// Varsayılan olarak bloklar bırakıldıkları anda delinir. Toplu mod açıkken
+// bloklar bekleyen bir haritaya eklenir; arka plan iş parçacığı TRIM_BATCH_BLOCKS
+// blok biriktiğinde ya da ilk bekleyen blok TRIM_DELAY_MS beklediğinde
+// bitişik aralıkları tek çağrıyla deler. Yeniden yazılacak bir bloğun bekleyen
+// delmesi yazımdan önce iptal edilir (trim_cancel); iş parçacığı delerken kilit
+// tutulduğundan iptal süren delmenin bitmesini bekler. trim_flush (disk_flush)
+// bekleyenleri çağıranın iş parçacığında deler.
+#define TRIM_BATCH_BLOCKS  256
+#define TRIM_DELAY_MS      200
+
+typedef struct {
+    uint64_t queued;            // Bırakılan bloklar
+    uint64_t punched;           // Delinen bloklar
+    uint64_t punch_calls;       // Delme çağrıları (bitişik aralık başına bir)
+    uint64_t cancelled;         // Delinmeden önce yeniden yazılan bloklar
+    uint64_t errors;            // Başarısız delmeler (yer iade edilmez, veri etkilenmez)
+    uint32_t pending;           // Şu an bekleyen bloklar
+} TrimStats;
+
+int  trim_batching(void);
+void trim_set_batching(int on);                      // Kapatmak bekleyenleri hemen deler
+
+int  trim_queue(uint32_t pblock, uint32_t count);    // Fiziksel bloklar artık kullanılmıyor
+void trim_cancel(uint32_t pblock, uint32_t count);   // Bloklar yeniden yazılacak
+int  trim_flush(void);                               // Bekleyenleri şimdi del
+void trim_drop(void);                                // Bekleyenleri unut (imaj değişiyor)
+int  trim_pending(void);                             // Delinmeyi bekleyen blok var mı
+
+void trim_stats(TrimStats *out);
+void trim_reset_stats(void);
+void trim_shutdown(void);                            // İş parçacığını durdur
+
+#endif // TRIM_H